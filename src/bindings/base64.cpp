@@ -1,122 +1,293 @@
-/* 
+/*
    base64.cpp and base64.h
 
    base64 encoding and decoding with C++.
 
-   Version: 1.01.00
-
-   Copyright (C) 2004-2017 René Nyffenegger
-
-   This source code is provided 'as-is', without any express or implied
-   warranty. In no event will the author be held liable for any damages
-   arising from the use of this software.
-
-   Permission is granted to anyone to use this software for any purpose,
-   including commercial applications, and to alter it and redistribute it
-   freely, subject to the following restrictions:
-
-   1. The origin of this source code must not be misrepresented; you must not
-      claim that you wrote the original source code. If you use this source code
-      in a product, an acknowledgment in the product documentation would be
-      appreciated but is not required.
-
-   2. Altered source versions must be plainly marked as such, and must not be
-      misrepresented as being the original source code.
-
-   3. This notice may not be removed or altered from any source distribution.
-
-   René Nyffenegger rene.nyffenegger@adp-gmbh.ch
-
+   Version 1 was based on the implementation by René Nyffenegger (2004-2017).
+   Version 2 keeps its std::string interface but converts into preallocated
+   buffers and adds SIMD block conversion following the algorithms described
+   by Wojciech Muła and Daniel Lemire ("Faster Base64 Encoding and Decoding
+   using AVX2 Instructions").
 */
 
 #include "base64.h"
-#include <iostream>
-
-static const std::string base64_chars = 
+#include <cstring>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define BASE64_NEON
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// SSSE3 is beyond the x86-64 baseline (SSE2): the kernels are compiled for
+// it per function and only used when the CPU reports it
+#define BASE64_SSSE3
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BASE64_SSSE3_TARGET
+#else
+#include <cpuid.h>
+#define BASE64_SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#include <tmmintrin.h>
+#endif
+
+static const char base64_chars[] =
              "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
              "abcdefghijklmnopqrstuvwxyz"
              "0123456789+/";
 
+// character -> 6 bit value, 0xFF for characters outside the alphabet
+struct base64_decode_table
+{
+  unsigned char values[256];
+  base64_decode_table()
+  {
+    memset(values, 0xFF, sizeof(values));
+    for (int i = 0; i < 64; i++)
+      values[(unsigned char)base64_chars[i]] = (unsigned char)i;
+  }
+};
+static const base64_decode_table decode_table;
 
-static inline bool is_base64(unsigned char c) {
-  return (isalnum(c) || (c == '+') || (c == '/'));
+size_t base64_encoded_length(size_t len)
+{
+  return 4 * ((len + 2) / 3);
 }
 
-std::string base64_encode(unsigned char const* bytes_to_encode, unsigned int in_len) {
-  std::string ret;
-  int i = 0;
-  int j = 0;
-  unsigned char char_array_3[3];
-  unsigned char char_array_4[4];
-
-  while (in_len--) {
-    char_array_3[i++] = *(bytes_to_encode++);
-    if (i == 3) {
-      char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-      char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-      char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-      char_array_4[3] = char_array_3[2] & 0x3f;
-
-      for(i = 0; (i <4) ; i++)
-        ret += base64_chars[char_array_4[i]];
-      i = 0;
-    }
-  }
+size_t base64_decoded_max_length(size_t len)
+{
+  return 3 * ((len + 3) / 4);
+}
 
-  if (i)
+#if defined(BASE64_SSSE3)
+static bool has_ssse3()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 1);
+  return 0 != (info[2] & (1 << 9));
+#else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  return 0 != (ecx & bit_SSSE3);
+#endif
+}
+static const bool use_ssse3 = has_ssse3();
+
+// 12 input bytes -> 16 characters per step; reads 16 bytes
+BASE64_SSSE3_TARGET static size_t encode_blocks_ssse3(const unsigned char* in, size_t len, char* out)
+{
+  size_t done = 0;
+  const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  while (len - done >= 16)
   {
-    for(j = i; j < 3; j++)
-      char_array_3[j] = '\0';
-
-    char_array_4[0] = ( char_array_3[0] & 0xfc) >> 2;
-    char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-    char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-
-    for (j = 0; (j < i + 1); j++)
-      ret += base64_chars[char_array_4[j]];
-
-    while((i++ < 3))
-      ret += '=';
-
+    __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + done)), shuffle);
+    const __m128i t0 = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    __m128i offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    offsets = _mm_or_si128(offsets, _mm_and_si128(less, _mm_set1_epi8(13)));
+    offsets = _mm_shuffle_epi8(shift_lut, offsets);
+    _mm_storeu_si128((__m128i*)out, _mm_add_epi8(offsets, indices));
+    out += 16;
+    done += 12;
   }
+  return done;
+}
 
-  return ret;
+// 16 characters -> 12 bytes per step; writes 16 bytes. Stops at the first
+// block holding a character outside the alphabet (padding included).
+BASE64_SSSE3_TARGET static size_t decode_blocks_ssse3(const char* in, size_t len, unsigned char* out, size_t out_len)
+{
+  size_t done = 0;
+  size_t written = 0;
+  const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  while (len - done >= 16 && out_len - written >= 16)
+  {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(in + done));
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+    const __m128i lo_nibbles = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+      break;
+
+    const __m128i eq_2f = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x2F));
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    const __m128i values = _mm_add_epi8(v, roll);
+    const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i bytes = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128((__m128i*)(out + written), _mm_shuffle_epi8(bytes, pack));
+    done += 16;
+    written += 12;
+  }
+  return done;
+}
+#endif
+
+#if defined(BASE64_NEON)
+// 48 input bytes -> 64 characters per step
+static size_t encode_blocks_neon(const unsigned char* in, size_t len, char* out)
+{
+  const uint8x16x4_t table = vld1q_u8_x4((const uint8_t*)base64_chars);
+  const uint8x16_t mask = vdupq_n_u8(0x3F);
+  size_t done = 0;
+  while (len - done >= 48)
+  {
+    const uint8x16x3_t v = vld3q_u8(in + done);
+    uint8x16x4_t chars;
+    chars.val[0] = vqtbl4q_u8(table, vshrq_n_u8(v.val[0], 2));
+    chars.val[1] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(v.val[0], 4), vshrq_n_u8(v.val[1], 4)), mask));
+    chars.val[2] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(v.val[1], 2), vshrq_n_u8(v.val[2], 6)), mask));
+    chars.val[3] = vqtbl4q_u8(table, vandq_u8(v.val[2], mask));
+    vst4q_u8((uint8_t*)out, chars);
+    out += 64;
+    done += 48;
+  }
+  return done;
+}
 
+// 64 characters -> 48 bytes per step, stops at the first block holding a
+// character outside the alphabet
+static size_t decode_blocks_neon(const char* in, size_t len, unsigned char* out)
+{
+  const unsigned char* values = decode_table.values;
+  const uint8x16x4_t low = vld1q_u8_x4(values);
+  const uint8x16x4_t high = vld1q_u8_x4(values + 64);
+  const uint8x16_t offset = vdupq_n_u8(64);
+  size_t done = 0;
+  while (len - done >= 64)
+  {
+    const uint8x16x4_t v = vld4q_u8((const uint8_t*)in + done);
+    uint8x16_t d[4];
+    uint8x16_t invalid = vdupq_n_u8(0);
+    for (int i = 0; i < 4; i++)
+    {
+      // table lookups return 0 for indices >= 64, so each character hits
+      // at most one of the two halves; characters >= 128 hit neither
+      d[i] = vorrq_u8(vqtbl4q_u8(low, v.val[i]), vqtbl4q_u8(high, vsubq_u8(v.val[i], offset)));
+      invalid = vorrq_u8(invalid, vorrq_u8(d[i], vandq_u8(v.val[i], vdupq_n_u8(0x80))));
+    }
+    if (vmaxvq_u8(invalid) > 63)
+      break;
+
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(d[0], 2), vshrq_n_u8(d[1], 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(d[1], 4), vshrq_n_u8(d[2], 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(d[2], 6), d[3]);
+    vst3q_u8(out, bytes);
+    out += 48;
+    done += 64;
+  }
+  return done;
 }
+#endif
+
+size_t base64_encode(unsigned char const* bytes, size_t len, char* out)
+{
+  size_t i = 0;
+  char* p = out;
+#if defined(BASE64_NEON)
+  i = encode_blocks_neon(bytes, len, p);
+  p += 4 * (i / 3);
+#elif defined(BASE64_SSSE3)
+  if (use_ssse3)
+  {
+    i = encode_blocks_ssse3(bytes, len, p);
+    p += 4 * (i / 3);
+  }
+#endif
 
-std::string base64_decode(std::string const& encoded_string) {
-  int in_len = static_cast<int>(encoded_string.size());
-  int i = 0;
-  int j = 0;
-  int in_ = 0;
-  unsigned char char_array_4[4], char_array_3[3];
-  std::string ret;
+  for (; i + 3 <= len; i += 3)
+  {
+    const unsigned int triple = ((unsigned int)bytes[i] << 16) | ((unsigned int)bytes[i + 1] << 8) | bytes[i + 2];
+    p[0] = base64_chars[(triple >> 18) & 0x3F];
+    p[1] = base64_chars[(triple >> 12) & 0x3F];
+    p[2] = base64_chars[(triple >> 6) & 0x3F];
+    p[3] = base64_chars[triple & 0x3F];
+    p += 4;
+  }
 
-  while (in_len-- && ( encoded_string[in_] != '=') && is_base64(encoded_string[in_])) {
-    char_array_4[i++] = encoded_string[in_]; in_++;
-    if (i ==4) {
-      for (i = 0; i <4; i++)
-        char_array_4[i] = static_cast<unsigned char>(base64_chars.find(char_array_4[i]));
+  const size_t rest = len - i;
+  if (rest)
+  {
+    const unsigned int triple = ((unsigned int)bytes[i] << 16) | (rest > 1 ? (unsigned int)bytes[i + 1] << 8 : 0);
+    p[0] = base64_chars[(triple >> 18) & 0x3F];
+    p[1] = base64_chars[(triple >> 12) & 0x3F];
+    p[2] = rest > 1 ? base64_chars[(triple >> 6) & 0x3F] : '=';
+    p[3] = '=';
+    p += 4;
+  }
+  return (size_t)(p - out);
+}
 
-      char_array_3[0] = ( char_array_4[0] << 2       ) + ((char_array_4[1] & 0x30) >> 4);
-      char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-      char_array_3[2] = ((char_array_4[2] & 0x3) << 6) +   char_array_4[3];
+size_t base64_decode(char const* chars, size_t len, unsigned char* out)
+{
+  size_t i = 0;
+  unsigned char* p = out;
+#if defined(BASE64_NEON)
+  i = decode_blocks_neon(chars, len, p);
+  p += 3 * (i / 4);
+#elif defined(BASE64_SSSE3)
+  if (use_ssse3)
+  {
+    i = decode_blocks_ssse3(chars, len, p, base64_decoded_max_length(len));
+    p += 3 * (i / 4);
+  }
+#endif
 
-      for (i = 0; (i < 3); i++)
-        ret += char_array_3[i];
-      i = 0;
+  const unsigned char* values = decode_table.values;
+  unsigned int accumulator = 0;
+  int count = 0;
+  for (; i < len; i++)
+  {
+    const unsigned char value = values[(unsigned char)chars[i]];
+    if (value > 63)
+      break;
+    accumulator = (accumulator << 6) | value;
+    if (++count == 4)
+    {
+      p[0] = (unsigned char)(accumulator >> 16);
+      p[1] = (unsigned char)(accumulator >> 8);
+      p[2] = (unsigned char)accumulator;
+      p += 3;
+      accumulator = 0;
+      count = 0;
     }
   }
 
-  if (i) {
-    for (j = 0; j < i; j++)
-      char_array_4[j] = static_cast<unsigned char>(base64_chars.find(char_array_4[j]));
-
-    char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-    char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-
-    for (j = 0; (j < i - 1); j++) ret += char_array_3[j];
+  // partial group before padding or the end of the input
+  if (count >= 2)
+  {
+    accumulator <<= 6 * (4 - count);
+    *p++ = (unsigned char)(accumulator >> 16);
+    if (count == 3)
+      *p++ = (unsigned char)(accumulator >> 8);
   }
+  return (size_t)(p - out);
+}
 
+std::string base64_encode(unsigned char const* bytes_to_encode, unsigned int in_len) {
+  std::string ret;
+  ret.resize(base64_encoded_length(in_len));
+  if (in_len > 0)
+    base64_encode(bytes_to_encode, in_len, &ret[0]);
+  return ret;
+}
+
+std::string base64_decode(std::string const& encoded_string) {
+  std::string ret;
+  ret.resize(base64_decoded_max_length(encoded_string.size()));
+  if (!ret.empty())
+    ret.resize(base64_decode(encoded_string.data(), encoded_string.size(), (unsigned char*)&ret[0]));
   return ret;
 }
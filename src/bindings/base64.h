@@ -1,13 +1,32 @@
 //
 //  base64 encoding and decoding with C++.
-//  Version: 1.01.00
+//  Version: 2.00.00
+//
+//  Encodes into and decodes from caller provided buffers so large archives
+//  are converted without intermediate copies. Blocks of 48 (NEON) or 12
+//  (SSSE3) bytes are converted with SIMD instructions when the CPU has
+//  them; everything else goes through the scalar table code.
 //
 
 #ifndef BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A
 #define BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A
 
+#include <cstddef>
 #include <string>
 
+// Number of characters base64_encode writes for len bytes, padding included
+size_t base64_encoded_length(size_t len);
+// Upper bound for the number of bytes base64_decode writes for len characters
+size_t base64_decoded_max_length(size_t len);
+
+// Writes base64_encoded_length(len) characters to out (no terminator)
+size_t base64_encode(unsigned char const* bytes, size_t len, char* out);
+// Decodes up to the first '=' or non base64 character and returns the
+// number of bytes written to out. out must hold base64_decoded_max_length(len)
+// bytes even when fewer are decoded: the SSSE3 path stores 16 bytes for
+// every 12 it decodes and relies on that room past the last whole block.
+size_t base64_decode(char const* chars, size_t len, unsigned char* out);
+
 std::string base64_encode(unsigned char const* , unsigned int len);
 std::string base64_decode(std::string const& s);
 
@@ -1,5 +1,13 @@
 #include "bindings.h"
 
+#if !defined(ON_WASM_COMPILE)
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#endif
+
 const std::string version = ON::VersionQuartetAsString();
 
 #if defined(ON_PYTHON_COMPILE)
@@ -86,8 +94,12 @@ EMSCRIPTEN_BINDINGS(rhino3dm) {
   initGroupBindings(m);
   initExtensionsBindings(m);
   initDracoBindings(m);
+  initGltfBindings(m);
   initRTreeBindings(m);
   initLinetypeBindings(m);
+  initHiddenLineDrawingBindings(m);
+  initAnnotationTessellationBindings(m);
+  initTileSetBindings(m);
 }
 
 #if defined(ON_PYTHON_COMPILE)
@@ -149,6 +161,24 @@ BND_LIST NullList()
 #endif
 }
 
+BND_DICT CreateDict()
+{
+#if defined(ON_PYTHON_COMPILE)
+  return py::dict();
+#else
+  return emscripten::val::object();
+#endif
+}
+
+void SetDictItem(BND_DICT& d, const char* key, const ON__UINT64& value)
+{
+#if defined(ON_PYTHON_COMPILE)
+  d[key] = (unsigned long long)value;
+#else
+  d.set(key, (double)value);
+#endif
+}
+
 BND_DateTime CreateDateTime(struct tm t)
 {
 #if defined(ON_PYTHON_COMPILE)
@@ -173,3 +203,78 @@ BND_DateTime CreateDateTime(struct tm t)
                    0);
 #endif
 }
+
+int ParallelThreadCount(int threadCount)
+{
+#if defined(ON_WASM_COMPILE)
+  return 1;
+#else
+  if (threadCount > 0)
+    return threadCount;
+  unsigned int hardware_threads = std::thread::hardware_concurrency();
+  return hardware_threads > 0 ? (int)hardware_threads : 1;
+#endif
+}
+
+void ParallelFor(int count, int threadCount, const std::function<void(int)>& func)
+{
+  if (count <= 0)
+    return;
+  threadCount = ParallelThreadCount(threadCount);
+  if (threadCount > count)
+    threadCount = count;
+
+  if (threadCount <= 1)
+  {
+    for (int i = 0; i < count; i++)
+      func(i);
+    return;
+  }
+
+#if !defined(ON_WASM_COMPILE)
+#if defined(ON_PYTHON_COMPILE)
+  // workers never call back into python, so let other python threads run.
+  // Nested calls from a worker run without the GIL and have none to release.
+  std::unique_ptr<py::gil_scoped_release> release;
+  if (PyGILState_Check())
+    release.reset(new py::gil_scoped_release());
+#endif
+
+  // the first exception stops handing out work and is rethrown once every
+  // thread has finished
+  std::atomic<int> next(0);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto worker = [&]()
+  {
+    for (int i = next++; i < count; i = next++)
+    {
+      try
+      {
+        func(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+        next = count;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (int i = 1; i < threadCount; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads)
+    thread.join();
+
+#if defined(ON_PYTHON_COMPILE)
+  release.reset();
+#endif
+  if (error)
+    std::rethrow_exception(error);
+#endif
+}
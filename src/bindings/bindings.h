@@ -3,6 +3,9 @@
 // no need to export RH_C_FUNCTION in these libraries
 #define RH_C_FUNCTION
 
+#include <functional>
+#include <vector>
+
 #if defined(__EMSCRIPTEN__)
 #define ON_WASM_COMPILE
 #else
@@ -142,6 +145,70 @@ void Append(BND_LIST& list, const T& value)
 
 BND_DateTime CreateDateTime(struct tm t);
 
+// Dictionaries built natively for reports (python dict / javascript object)
+BND_DICT CreateDict();
+template<typename T>
+void SetDictItem(BND_DICT& d, const char* key, const T& value)
+{
+#if defined(ON_PYTHON_COMPILE)
+  d[key] = value;
+#else
+  d.set(key, value);
+#endif
+}
+// byte counts; javascript receives a number, which is exact up to 2^53
+void SetDictItem(BND_DICT& d, const char* key, const ON__UINT64& value);
+
+// Packed numeric arrays handed back to the caller in one piece instead of
+// as lists of wrapper objects. Python receives a typed memoryview (usable
+// with numpy.frombuffer / numpy.asarray), javascript receives a typed array.
+#if defined(ON_PYTHON_COMPILE)
+typedef py::object BND_BUFFER;
+#endif
+
+#if defined(ON_WASM_COMPILE)
+typedef emscripten::val BND_BUFFER;
+#endif
+
+template<typename T> struct BND_BufferTraits;
+template<> struct BND_BufferTraits<float> { static const char* Format() { return "f"; } static const char* JsType() { return "Float32Array"; } };
+template<> struct BND_BufferTraits<double> { static const char* Format() { return "d"; } static const char* JsType() { return "Float64Array"; } };
+template<> struct BND_BufferTraits<int> { static const char* Format() { return "i"; } static const char* JsType() { return "Int32Array"; } };
+template<> struct BND_BufferTraits<unsigned int> { static const char* Format() { return "I"; } static const char* JsType() { return "Uint32Array"; } };
+template<> struct BND_BufferTraits<short> { static const char* Format() { return "h"; } static const char* JsType() { return "Int16Array"; } };
+template<> struct BND_BufferTraits<unsigned short> { static const char* Format() { return "H"; } static const char* JsType() { return "Uint16Array"; } };
+template<> struct BND_BufferTraits<signed char> { static const char* Format() { return "b"; } static const char* JsType() { return "Int8Array"; } };
+template<> struct BND_BufferTraits<unsigned char> { static const char* Format() { return "B"; } static const char* JsType() { return "Uint8Array"; } };
+
+template<typename T>
+BND_BUFFER CreateBuffer(const T* data, size_t count)
+{
+#if defined(ON_PYTHON_COMPILE)
+  py::bytes raw(reinterpret_cast<const char*>(data), count * sizeof(T));
+  py::object memoryview = py::module_::import("builtins").attr("memoryview");
+  return memoryview(raw).attr("cast")(BND_BufferTraits<T>::Format());
+#else
+  emscripten::val typedArray = emscripten::val::global(BND_BufferTraits<T>::JsType());
+  return typedArray.new_(emscripten::typed_memory_view(count, data));
+#endif
+}
+
+template<typename T>
+BND_BUFFER CreateBuffer(const std::vector<T>& data)
+{
+  return CreateBuffer<T>(data.data(), data.size());
+}
+
+// Number of worker threads to use when a caller passes threadCount.
+// Values <= 0 mean "use all hardware threads". Always 1 for web assembly.
+int ParallelThreadCount(int threadCount);
+
+// Calls func(i) for every i in [0, count) spread over threadCount threads.
+// func must not touch python or javascript objects. The first exception
+// thrown by func is rethrown after all threads have stopped. Runs serially
+// in web assembly builds.
+void ParallelFor(int count, int threadCount, const std::function<void(int)>& func);
+
 #include "bnd_color.h"
 #include "bnd_file_utilities.h"
 #include "bnd_uuid.h"
@@ -211,8 +278,14 @@ BND_DateTime CreateDateTime(struct tm t);
 #include "bnd_viewport.h"
 #include "bnd_group.h"
 #include "bnd_mesh_modifiers.h"
+#include "bnd_archive_profile.h"
+#include "bnd_base64_archive.h"
 #include "bnd_extensions.h"
 #include "bnd_3dm_attributes.h"
 #include "bnd_draco.h"
+#include "bnd_gltf.h"
 #include "bnd_rtree.h"
 #include "bnd_linetype.h"
+#include "bnd_hiddenlinedrawing.h"
+#include "bnd_annotationtessellation.h"
+#include "bnd_tileset.h"
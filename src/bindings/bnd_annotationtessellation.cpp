@@ -0,0 +1,918 @@
+#include "bindings.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+
+// Polygon triangulation by ear clipping with hole bridging, a port of
+// mapbox/earcut without the z-order index. Glyph contours are small enough
+// that the quadratic ear search is not a concern.
+namespace
+{
+struct EarNode
+{
+  int i = 0;
+  double x = 0.0;
+  double y = 0.0;
+  EarNode* prev = nullptr;
+  EarNode* next = nullptr;
+  bool steiner = false;
+};
+
+class Earcut
+{
+public:
+  // points: x,y pairs. rings: point offsets, outer ring first then holes.
+  // Appends triangles as point indices.
+  void Triangulate(const std::vector<double>& points, const std::vector<int>& rings, std::vector<unsigned int>& triangles)
+  {
+    m_triangles = &triangles;
+    EarNode* outer = LinkedList(points, rings[0], rings[1], true);
+    if (nullptr == outer || outer->next == outer->prev)
+      return;
+    if (rings.size() > 2)
+      outer = EliminateHoles(points, rings, outer);
+    EarcutLinked(outer, 0);
+  }
+
+private:
+  std::deque<EarNode> m_nodes;
+  std::vector<unsigned int>* m_triangles = nullptr;
+
+  static double Area(const EarNode* p, const EarNode* q, const EarNode* r)
+  {
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+  }
+
+  static bool Equals(const EarNode* a, const EarNode* b)
+  {
+    return a->x == b->x && a->y == b->y;
+  }
+
+  static int Sign(double v)
+  {
+    return v > 0.0 ? 1 : (v < 0.0 ? -1 : 0);
+  }
+
+  static bool PointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+  {
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+      (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+      (bx - px) * (cy - py) >= (cx - px) * (by - py);
+  }
+
+  static bool OnSegment(const EarNode* p, const EarNode* q, const EarNode* r)
+  {
+    return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+      q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+  }
+
+  static bool Intersects(const EarNode* p1, const EarNode* q1, const EarNode* p2, const EarNode* q2)
+  {
+    const int o1 = Sign(Area(p1, q1, p2));
+    const int o2 = Sign(Area(p1, q1, q2));
+    const int o3 = Sign(Area(p2, q2, p1));
+    const int o4 = Sign(Area(p2, q2, q1));
+    if (o1 != o2 && o3 != o4)
+      return true;
+    if (o1 == 0 && OnSegment(p1, p2, q1)) return true;
+    if (o2 == 0 && OnSegment(p1, q2, q1)) return true;
+    if (o3 == 0 && OnSegment(p2, p1, q2)) return true;
+    if (o4 == 0 && OnSegment(p2, q1, q2)) return true;
+    return false;
+  }
+
+  static bool IntersectsPolygon(const EarNode* a, const EarNode* b)
+  {
+    const EarNode* p = a;
+    do
+    {
+      if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i && Intersects(p, p->next, a, b))
+        return true;
+      p = p->next;
+    } while (p != a);
+    return false;
+  }
+
+  static bool LocallyInside(const EarNode* a, const EarNode* b)
+  {
+    return Area(a->prev, a, a->next) < 0.0
+      ? Area(a, b, a->next) >= 0.0 && Area(a, a->prev, b) >= 0.0
+      : Area(a, b, a->prev) < 0.0 || Area(a, a->next, b) < 0.0;
+  }
+
+  static bool MiddleInside(const EarNode* a, const EarNode* b)
+  {
+    const EarNode* p = a;
+    bool inside = false;
+    const double px = (a->x + b->x) / 2.0;
+    const double py = (a->y + b->y) / 2.0;
+    do
+    {
+      if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+        (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+        inside = !inside;
+      p = p->next;
+    } while (p != a);
+    return inside;
+  }
+
+  static bool IsValidDiagonal(const EarNode* a, const EarNode* b)
+  {
+    return a->next->i != b->i && a->prev->i != b->i && !IntersectsPolygon(a, b) &&
+      ((LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&
+        (Area(a->prev, a, b->prev) != 0.0 || Area(a, b->prev, b) != 0.0)) ||
+       (Equals(a, b) && Area(a->prev, a, a->next) > 0.0 && Area(b->prev, b, b->next) > 0.0));
+  }
+
+  EarNode* InsertNode(int i, double x, double y, EarNode* last)
+  {
+    m_nodes.emplace_back();
+    EarNode* p = &m_nodes.back();
+    p->i = i;
+    p->x = x;
+    p->y = y;
+    if (nullptr == last)
+    {
+      p->prev = p;
+      p->next = p;
+    }
+    else
+    {
+      p->next = last->next;
+      p->prev = last;
+      last->next->prev = p;
+      last->next = p;
+    }
+    return p;
+  }
+
+  static void RemoveNode(EarNode* p)
+  {
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+  }
+
+  EarNode* LinkedList(const std::vector<double>& points, int start, int end, bool clockwise)
+  {
+    double sum = 0.0;
+    for (int i = start, j = end - 1; i < end; j = i++)
+      sum += (points[2 * j] - points[2 * i]) * (points[2 * i + 1] + points[2 * j + 1]);
+
+    EarNode* last = nullptr;
+    if (clockwise == (sum > 0.0))
+    {
+      for (int i = start; i < end; i++)
+        last = InsertNode(i, points[2 * i], points[2 * i + 1], last);
+    }
+    else
+    {
+      for (int i = end - 1; i >= start; i--)
+        last = InsertNode(i, points[2 * i], points[2 * i + 1], last);
+    }
+    if (last && Equals(last, last->next))
+    {
+      RemoveNode(last);
+      last = last->next;
+    }
+    return last;
+  }
+
+  static EarNode* FilterPoints(EarNode* start, EarNode* end = nullptr)
+  {
+    if (nullptr == start)
+      return start;
+    if (nullptr == end)
+      end = start;
+    EarNode* p = start;
+    bool again;
+    do
+    {
+      again = false;
+      if (!p->steiner && (Equals(p, p->next) || Area(p->prev, p, p->next) == 0.0))
+      {
+        RemoveNode(p);
+        p = end = p->prev;
+        if (p == p->next)
+          break;
+        again = true;
+      }
+      else
+      {
+        p = p->next;
+      }
+    } while (again || p != end);
+    return end;
+  }
+
+  static bool IsEar(const EarNode* ear)
+  {
+    const EarNode* a = ear->prev;
+    const EarNode* b = ear;
+    const EarNode* c = ear->next;
+    if (Area(a, b, c) >= 0.0)
+      return false; // reflex
+
+    const double x0 = std::min(a->x, std::min(b->x, c->x));
+    const double y0 = std::min(a->y, std::min(b->y, c->y));
+    const double x1 = std::max(a->x, std::max(b->x, c->x));
+    const double y1 = std::max(a->y, std::max(b->y, c->y));
+    for (const EarNode* p = c->next; p != a; p = p->next)
+    {
+      if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+        PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+        Area(p->prev, p, p->next) >= 0.0)
+        return false;
+    }
+    return true;
+  }
+
+  void EmitTriangle(const EarNode* a, const EarNode* b, const EarNode* c)
+  {
+    m_triangles->push_back((unsigned int)a->i);
+    m_triangles->push_back((unsigned int)b->i);
+    m_triangles->push_back((unsigned int)c->i);
+  }
+
+  void EarcutLinked(EarNode* ear, int pass)
+  {
+    if (nullptr == ear)
+      return;
+    EarNode* stop = ear;
+    while (ear->prev != ear->next)
+    {
+      EarNode* prev = ear->prev;
+      EarNode* next = ear->next;
+      if (IsEar(ear))
+      {
+        EmitTriangle(prev, ear, next);
+        RemoveNode(ear);
+        ear = next->next;
+        stop = next->next;
+        continue;
+      }
+      ear = next;
+      if (ear == stop)
+      {
+        if (0 == pass)
+          EarcutLinked(FilterPoints(ear), 1);
+        else if (1 == pass)
+          EarcutLinked(CureLocalIntersections(FilterPoints(ear)), 2);
+        else
+          SplitEarcut(ear);
+        break;
+      }
+    }
+  }
+
+  EarNode* CureLocalIntersections(EarNode* start)
+  {
+    EarNode* p = start;
+    do
+    {
+      EarNode* a = p->prev;
+      EarNode* b = p->next->next;
+      if (!Equals(a, b) && Intersects(a, p, p->next, b) && LocallyInside(a, b) && LocallyInside(b, a))
+      {
+        EmitTriangle(a, p, b);
+        RemoveNode(p);
+        RemoveNode(p->next);
+        p = start = b;
+      }
+      p = p->next;
+    } while (p != start);
+    return FilterPoints(p);
+  }
+
+  void SplitEarcut(EarNode* start)
+  {
+    EarNode* a = start;
+    do
+    {
+      EarNode* b = a->next->next;
+      while (b != a->prev)
+      {
+        if (a->i != b->i && IsValidDiagonal(a, b))
+        {
+          EarNode* c = SplitPolygon(a, b);
+          a = FilterPoints(a, a->next);
+          c = FilterPoints(c, c->next);
+          EarcutLinked(a, 0);
+          EarcutLinked(c, 0);
+          return;
+        }
+        b = b->next;
+      }
+      a = a->next;
+    } while (a != start);
+  }
+
+  EarNode* SplitPolygon(EarNode* a, EarNode* b)
+  {
+    m_nodes.emplace_back(*a);
+    EarNode* a2 = &m_nodes.back();
+    m_nodes.emplace_back(*b);
+    EarNode* b2 = &m_nodes.back();
+    EarNode* an = a->next;
+    EarNode* bp = b->prev;
+    a->next = b;
+    b->prev = a;
+    a2->next = an;
+    an->prev = a2;
+    b2->next = a2;
+    a2->prev = b2;
+    bp->next = b2;
+    b2->prev = bp;
+    return b2;
+  }
+
+  static EarNode* Leftmost(EarNode* start)
+  {
+    EarNode* p = start;
+    EarNode* leftmost = start;
+    do
+    {
+      if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+        leftmost = p;
+      p = p->next;
+    } while (p != start);
+    return leftmost;
+  }
+
+  static bool SectorContainsSector(const EarNode* m, const EarNode* p)
+  {
+    return Area(m->prev, m, p->prev) < 0.0 && Area(p->next, m, m->next) < 0.0;
+  }
+
+  static EarNode* FindHoleBridge(const EarNode* hole, EarNode* outer)
+  {
+    EarNode* p = outer;
+    const double hx = hole->x;
+    const double hy = hole->y;
+    double qx = -ON_DBL_MAX;
+    EarNode* m = nullptr;
+    do
+    {
+      if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+      {
+        const double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+        if (x <= hx && x > qx)
+        {
+          qx = x;
+          m = p->x < p->next->x ? p : p->next;
+          if (x == hx)
+            return m;
+        }
+      }
+      p = p->next;
+    } while (p != outer);
+    if (nullptr == m)
+      return nullptr;
+
+    const EarNode* stop = m;
+    const double mx = m->x;
+    const double my = m->y;
+    double tan_min = ON_DBL_MAX;
+    p = m;
+    do
+    {
+      if (hx >= p->x && p->x >= mx && hx != p->x &&
+        PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+      {
+        const double tan = fabs(hy - p->y) / (hx - p->x);
+        if (LocallyInside(p, hole) &&
+          (tan < tan_min || (tan == tan_min && (p->x > m->x || (p->x == m->x && SectorContainsSector(m, p))))))
+        {
+          m = p;
+          tan_min = tan;
+        }
+      }
+      p = p->next;
+    } while (p != stop);
+    return m;
+  }
+
+  EarNode* EliminateHoles(const std::vector<double>& points, const std::vector<int>& rings, EarNode* outer)
+  {
+    std::vector<EarNode*> queue;
+    for (size_t r = 1; r + 1 < rings.size(); r++)
+    {
+      EarNode* list = LinkedList(points, rings[r], rings[r + 1], false);
+      if (nullptr == list)
+        continue;
+      if (list == list->next)
+        list->steiner = true;
+      queue.push_back(Leftmost(list));
+    }
+    std::sort(queue.begin(), queue.end(), [](const EarNode* a, const EarNode* b) { return a->x < b->x; });
+    for (EarNode* hole : queue)
+    {
+      EarNode* bridge = FindHoleBridge(hole, outer);
+      if (nullptr == bridge)
+        continue;
+      EarNode* bridge_reverse = SplitPolygon(bridge, hole);
+      FilterPoints(bridge_reverse, bridge_reverse->next);
+      outer = FilterPoints(bridge, bridge->next);
+    }
+    return outer;
+  }
+};
+}
+
+// One glyph tessellated in glyph space: capital letters are 1 unit tall and
+// the pen starts at the origin.
+struct BND_GlyphShape
+{
+  std::vector<double> m_points;          // x,y pairs
+  std::vector<int> m_contours = { 0 };   // point offsets per contour
+  std::vector<unsigned int> m_triangles; // filled glyphs only
+  double m_advance = 0.0;
+  bool m_single_stroke = false;
+};
+
+// Flattens a Bezier span to within tolerance using the bound on the second
+// differences of its control points
+static void AppendFlattenedBezier(const ON_BezierCurve& bezier, double tolerance, std::vector<double>& points)
+{
+  const int degree = bezier.Degree();
+  int segments = 1;
+  if (degree > 1)
+  {
+    double m = 0.0;
+    ON_3dPoint p0, p1, p2;
+    for (int i = 0; i + 2 < bezier.CVCount(); i++)
+    {
+      bezier.GetCV(i, p0);
+      bezier.GetCV(i + 1, p1);
+      bezier.GetCV(i + 2, p2);
+      m = std::max(m, (p0 - 2.0 * p1 + p2).Length());
+    }
+    segments = (int)ceil(sqrt(degree * (degree - 1) * m / (8.0 * tolerance)));
+    segments = std::min(std::max(segments, 1), 64);
+  }
+
+  for (int k = 0; k <= segments; k++)
+  {
+    const ON_3dPoint p = bezier.PointAt((double)k / segments);
+    const size_t n = points.size();
+    if (n >= 2 && points[n - 2] == p.x && points[n - 1] == p.y)
+      continue;
+    points.push_back(p.x);
+    points.push_back(p.y);
+  }
+}
+
+static void AppendFlattenedCurve(const ON_Curve& curve, double tolerance, std::vector<double>& points)
+{
+  ON_NurbsCurve nurbs;
+  if (!curve.GetNurbForm(nurbs))
+    return;
+  ON_BezierCurve bezier;
+  for (int span = 0; span < nurbs.SpanCount(); span++)
+  {
+    if (nurbs.ConvertSpanToBezier(span, bezier))
+      AppendFlattenedBezier(bezier, tolerance, points);
+  }
+}
+
+static bool PointInContour(const BND_GlyphShape& shape, int contour, double x, double y)
+{
+  bool inside = false;
+  const int start = shape.m_contours[contour];
+  const int end = shape.m_contours[contour + 1];
+  for (int i = start, j = end - 1; i < end; j = i++)
+  {
+    const double xi = shape.m_points[2 * i], yi = shape.m_points[2 * i + 1];
+    const double xj = shape.m_points[2 * j], yj = shape.m_points[2 * j + 1];
+    if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+      inside = !inside;
+  }
+  return inside;
+}
+
+static double ContourArea(const BND_GlyphShape& shape, int contour)
+{
+  double area = 0.0;
+  const int start = shape.m_contours[contour];
+  const int end = shape.m_contours[contour + 1];
+  for (int i = start, j = end - 1; i < end; j = i++)
+    area += shape.m_points[2 * j] * shape.m_points[2 * i + 1] - shape.m_points[2 * i] * shape.m_points[2 * j + 1];
+  return 0.5 * area;
+}
+
+// Contours nested an odd number of times are holes of the smallest contour
+// around them (even-odd fill). TrueType and PostScript glyphs fill by
+// nonzero winding; the two agree for the separate, nested contours of most
+// glyphs, but where contours of one glyph overlap even-odd leaves a hole.
+static void TriangulateGlyph(BND_GlyphShape& shape)
+{
+  const int contour_count = (int)shape.m_contours.size() - 1;
+  std::vector<int> depth(contour_count, 0);
+  std::vector<int> parent(contour_count, -1);
+  std::vector<double> area(contour_count);
+  for (int c = 0; c < contour_count; c++)
+    area[c] = fabs(ContourArea(shape, c));
+
+  for (int c = 0; c < contour_count; c++)
+  {
+    const int first = shape.m_contours[c];
+    if (shape.m_contours[c + 1] - first < 3)
+      continue;
+    const double x = shape.m_points[2 * first];
+    const double y = shape.m_points[2 * first + 1];
+    for (int other = 0; other < contour_count; other++)
+    {
+      if (other == c || area[other] <= area[c] || !PointInContour(shape, other, x, y))
+        continue;
+      depth[c]++;
+      if (parent[c] < 0 || area[other] < area[parent[c]])
+        parent[c] = other;
+    }
+  }
+
+  Earcut earcut;
+  for (int c = 0; c < contour_count; c++)
+  {
+    if (depth[c] % 2 != 0 || shape.m_contours[c + 1] - shape.m_contours[c] < 3)
+      continue;
+
+    // outer ring followed by its holes, copied so earcut sees one array
+    std::vector<int> members = { c };
+    for (int h = 0; h < contour_count; h++)
+    {
+      if (parent[h] == c && depth[h] % 2 != 0 && shape.m_contours[h + 1] - shape.m_contours[h] >= 3)
+        members.push_back(h);
+    }
+    std::vector<double> points;
+    std::vector<int> rings = { 0 };
+    std::vector<unsigned int> map;
+    for (int member : members)
+    {
+      for (int i = shape.m_contours[member]; i < shape.m_contours[member + 1]; i++)
+      {
+        points.push_back(shape.m_points[2 * i]);
+        points.push_back(shape.m_points[2 * i + 1]);
+        map.push_back((unsigned int)i);
+      }
+      rings.push_back((int)map.size());
+    }
+
+    std::vector<unsigned int> triangles;
+    earcut.Triangulate(points, rings, triangles);
+    for (unsigned int index : triangles)
+      shape.m_triangles.push_back(map[index]);
+  }
+}
+
+static std::shared_ptr<const BND_GlyphShape> TessellateGlyph(const ON_FontGlyph& glyph, bool single_stroke, double tolerance)
+{
+  std::shared_ptr<BND_GlyphShape> shape = std::make_shared<BND_GlyphShape>();
+  shape->m_single_stroke = single_stroke;
+
+  ON_ClassArray< ON_SimpleArray< ON_Curve* > > contours;
+  ON_3dVector advance = ON_3dVector::ZeroVector;
+  glyph.GetGlyphContours(single_stroke, 1.0, contours, nullptr, &advance);
+  shape->m_advance = advance.x;
+
+  for (int c = 0; c < contours.Count(); c++)
+  {
+    const size_t start = shape->m_points.size();
+    for (int k = 0; k < contours[c].Count(); k++)
+    {
+      ON_Curve* curve = contours[c][k];
+      if (curve)
+        AppendFlattenedCurve(*curve, tolerance, shape->m_points);
+      delete curve;
+    }
+    // closed contours repeat their start point; drop it, outlines close
+    // themselves when they are emitted
+    const size_t n = shape->m_points.size();
+    if (!single_stroke && n - start >= 4 && shape->m_points[start] == shape->m_points[n - 2] && shape->m_points[start + 1] == shape->m_points[n - 1])
+      shape->m_points.resize(n - 2);
+    if (shape->m_points.size() > start)
+      shape->m_contours.push_back((int)(shape->m_points.size() / 2));
+  }
+
+  if (!single_stroke)
+    TriangulateGlyph(*shape);
+  return shape;
+}
+
+// Managed glyphs live as long as the process, so their address identifies
+// (font, code point)
+class BND_GlyphCache
+{
+public:
+  std::shared_ptr<const BND_GlyphShape> Get(const ON_FontGlyph* glyph, bool single_stroke, double tolerance)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::shared_ptr<const BND_GlyphShape>& shape = m_shapes[Key(glyph, single_stroke, tolerance)];
+    if (!shape)
+      shape = TessellateGlyph(*glyph, single_stroke, tolerance);
+    return shape;
+  }
+
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shapes.clear();
+  }
+
+  int Count()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)m_shapes.size();
+  }
+
+private:
+  typedef std::tuple<const ON_FontGlyph*, bool, double> Key;
+  std::mutex m_mutex;
+  std::map<Key, std::shared_ptr<const BND_GlyphShape>> m_shapes;
+};
+
+static BND_GlyphCache& GlyphCache()
+{
+  static BND_GlyphCache cache;
+  return cache;
+}
+
+void BND_AnnotationTessellation::ClearGlyphCache()
+{
+  GlyphCache().Clear();
+}
+
+int BND_AnnotationTessellation::GlyphCacheCount()
+{
+  return GlyphCache().Count();
+}
+
+bool BND_AnnotationTessellation::GlyphOutlinesAvailable()
+{
+  // the font engine does not change while the process runs, so one capital
+  // letter of the default font answers for every glyph
+  static const bool available = []()
+  {
+    const ON_Font* font = ON_Font::Default.ManagedFont();
+    const ON_FontGlyph* glyph = font ? font->CodePointGlyph('H') : nullptr;
+    return nullptr != glyph && !TessellateGlyph(*glyph, false, 0.01)->m_points.empty();
+  }();
+  return available;
+}
+
+void BND_AnnotationTessellation::Add(const ON_Annotation& annotation, const ON_DimStyle& dimstyle, const ON_Xform& xform, const ON_UUID& id)
+{
+  const ON_TextContent* text = annotation.Text();
+  const ON_TextRunArray* runs = text ? text->TextRuns(false) : nullptr;
+  if (nullptr == runs || runs->Count() < 1)
+    return;
+
+  ON_Xform text_xform;
+  if (!annotation.GetTextXform(nullptr, &dimstyle, dimstyle.DimScale(), text_xform))
+    return;
+  text_xform = xform * text_xform;
+
+  const unsigned int source = (unsigned int)m_source_ids.size();
+  bool used = false;
+  for (int r = 0; r < runs->Count(); r++)
+  {
+    const ON_TextRun* run = (*runs)[r];
+    if (nullptr == run || (run->Type() != ON_TextRun::RunType::kText && run->Type() != ON_TextRun::RunType::kField))
+      continue;
+    const ON_Font* font = run->Font() ? run->Font()->ManagedFont() : nullptr;
+    const wchar_t* display = run->DisplayString();
+    if (nullptr == font || nullptr == display)
+      continue;
+
+    const bool single_stroke = font->IsSingleStrokeFont();
+    const double height = run->TextHeight();
+    const ON_2dVector offset = run->Offset();
+    const ON_Xform run_xform = text_xform * ON_Xform::TranslationTransformation(offset.x, offset.y, 0.0) * ON_Xform::DiagonalTransformation(height);
+
+    double pen = 0.0;
+    const int length = (int)wcslen(display);
+    for (int i = 0; i < length;)
+    {
+      ON__UINT32 code_point = 0;
+      ON_UnicodeErrorParameters e = ON_UnicodeErrorParameters::MaskErrors;
+      const int consumed = ON_DecodeWideChar(display + i, length - i, &e, &code_point);
+      i += consumed > 0 ? consumed : 1;
+
+      const ON_FontGlyph* glyph = font->CodePointGlyph(code_point);
+      if (nullptr == glyph)
+        continue;
+      std::shared_ptr<const BND_GlyphShape> shape = GlyphCache().Get(glyph, single_stroke, m_tolerance);
+      m_used_glyphs.push_back(shape.get());
+      m_glyph_count++;
+
+      const ON_Xform glyph_xform = run_xform * ON_Xform::TranslationTransformation(pen, 0.0, 0.0);
+      pen += shape->m_advance;
+      if (shape->m_points.empty())
+        continue;
+      used = true;
+
+      if (m_fill && !shape->m_single_stroke)
+      {
+        const unsigned int base = (unsigned int)(m_vertices.size() / 3);
+        for (size_t k = 0; k + 1 < shape->m_points.size(); k += 2)
+        {
+          const ON_3dPoint p = glyph_xform * ON_3dPoint(shape->m_points[k], shape->m_points[k + 1], 0.0);
+          m_vertices.push_back((float)p.x);
+          m_vertices.push_back((float)p.y);
+          m_vertices.push_back((float)p.z);
+        }
+        for (unsigned int index : shape->m_triangles)
+          m_indices.push_back(base + index);
+        for (size_t t = 0; t < shape->m_triangles.size() / 3; t++)
+          m_triangle_sources.push_back(source);
+        continue;
+      }
+
+      for (size_t c = 0; c + 1 < shape->m_contours.size(); c++)
+      {
+        const int start = shape->m_contours[c];
+        const int end = shape->m_contours[c + 1];
+        for (int k = start; k <= end; k++)
+        {
+          if (k == end && shape->m_single_stroke)
+            break;
+          const int index = k == end ? start : k;
+          const ON_3dPoint p = glyph_xform * ON_3dPoint(shape->m_points[2 * index], shape->m_points[2 * index + 1], 0.0);
+          m_points.push_back((float)p.x);
+          m_points.push_back((float)p.y);
+          m_points.push_back((float)p.z);
+        }
+        m_offsets.push_back((int)(m_points.size() / 3));
+        m_polyline_sources.push_back(source);
+      }
+    }
+  }
+
+  if (used)
+    m_source_ids.push_back(id);
+}
+
+static void AddModelAnnotation(BND_AnnotationTessellation& rc, const ONX_Model& model, const ON_ModelComponentReference& compref, const ON_UUID& id, const ON_Xform& xform, int depth)
+{
+  const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+  const ON_Geometry* geometry = geometryComponent ? geometryComponent->Geometry(nullptr) : nullptr;
+  if (nullptr == geometry)
+    return;
+
+  const ON_InstanceRef* iref = ON_InstanceRef::Cast(geometry);
+  if (iref)
+  {
+    // guard against definitions that reference themselves
+    if (depth > 16)
+      return;
+    const ON_ModelComponentReference& idef_compref = model.ComponentFromId(ON_ModelComponent::Type::InstanceDefinition, iref->m_instance_definition_uuid);
+    const ON_InstanceDefinition* idef = ON_InstanceDefinition::Cast(idef_compref.ModelComponent());
+    if (nullptr == idef)
+      return;
+    const ON_Xform instance_xform = xform * iref->m_xform;
+    const ON_SimpleArray<ON_UUID>& ids = idef->InstanceGeometryIdList();
+    for (int i = 0; i < ids.Count(); i++)
+    {
+      ON_ModelComponentReference child = model.ComponentFromId(ON_ModelComponent::Type::ModelGeometry, ids[i]);
+      AddModelAnnotation(rc, model, child, id, instance_xform, depth + 1);
+    }
+    return;
+  }
+
+  const ON_Annotation* annotation = ON_Annotation::Cast(geometry);
+  if (nullptr == annotation)
+    return;
+  const ON_DimStyle* parent = ON_DimStyle::Cast(model.DimensionStyleFromId(annotation->DimensionStyleId()).ModelComponent());
+  rc.Add(*annotation, annotation->DimensionStyle(parent ? *parent : ON_DimStyle::Default), xform, id);
+}
+
+BND_AnnotationTessellation* BND_AnnotationTessellation::FromFile3dm(const BND_ONXModel& model, bool fill, double tolerance)
+{
+  BND_AnnotationTessellation* rc = new BND_AnnotationTessellation();
+  rc->m_fill = fill;
+  if (tolerance > 0.0)
+    rc->m_tolerance = tolerance;
+
+  const ONX_Model& onx_model = *model.m_model.get();
+  ONX_ModelComponentIterator iterator(onx_model, ON_ModelComponent::Type::ModelGeometry);
+  for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+  {
+    const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    const ON_3dmObjectAttributes* attributes = geometryComponent ? geometryComponent->Attributes(nullptr) : nullptr;
+    if (nullptr == attributes || !attributes->IsVisible() || attributes->IsInstanceDefinitionObject())
+      continue;
+    const ON_Layer* layer = ON_Layer::Cast(onx_model.ComponentFromIndex(ON_ModelComponent::Type::Layer, attributes->m_layer_index).ModelComponent());
+    if (layer && !layer->IsVisible())
+      continue;
+    AddModelAnnotation(*rc, onx_model, compref, geometryComponent->Id(), ON_Xform::IdentityTransformation, 0);
+  }
+  rc->CountUniqueGlyphs();
+  return rc;
+}
+
+BND_AnnotationTessellation* BND_AnnotationTessellation::FromAnnotation(const BND_AnnotationBase& annotation, const BND_DimensionStyle* dimstyle, bool fill, double tolerance)
+{
+  const ON_Annotation* _annotation = ON_Annotation::Cast(annotation.GeometryPointer());
+  if (nullptr == _annotation)
+    return nullptr;
+
+  BND_AnnotationTessellation* rc = new BND_AnnotationTessellation();
+  rc->m_fill = fill;
+  if (tolerance > 0.0)
+    rc->m_tolerance = tolerance;
+  const ON_DimStyle& parent = (dimstyle && dimstyle->m_dimstyle) ? *dimstyle->m_dimstyle : ON_DimStyle::Default;
+  rc->Add(*_annotation, _annotation->DimensionStyle(parent), ON_Xform::IdentityTransformation, ON_nil_uuid);
+  rc->CountUniqueGlyphs();
+  return rc;
+}
+
+void BND_AnnotationTessellation::CountUniqueGlyphs()
+{
+  std::sort(m_used_glyphs.begin(), m_used_glyphs.end());
+  m_unique_glyph_count = (int)(std::unique(m_used_glyphs.begin(), m_used_glyphs.end()) - m_used_glyphs.begin());
+  m_used_glyphs.clear();
+}
+
+BND_TUPLE BND_AnnotationTessellation::SourceIds() const
+{
+#if defined(ON_PYTHON_COMPILE) && defined(NANOBIND)
+  py::list ids;
+  for (const ON_UUID& id : m_source_ids)
+    ids.append(ON_UUID_to_Binding(id));
+  return py::tuple(ids);
+#else
+  BND_TUPLE rc = CreateTuple((int)m_source_ids.size());
+  for (int i = 0; i < (int)m_source_ids.size(); i++)
+    SetTuple(rc, i, ON_UUID_to_Binding(m_source_ids[i]));
+  return rc;
+#endif
+}
+
+BND_BoundingBox BND_AnnotationTessellation::BoundingBox() const
+{
+  ON_BoundingBox bbox;
+  for (size_t i = 0; i + 2 < m_vertices.size(); i += 3)
+    bbox.Set(ON_3dPoint(m_vertices[i], m_vertices[i + 1], m_vertices[i + 2]), bbox.IsValid());
+  for (size_t i = 0; i + 2 < m_points.size(); i += 3)
+    bbox.Set(ON_3dPoint(m_points[i], m_points[i + 1], m_points[i + 2]), bbox.IsValid());
+  return BND_BoundingBox(bbox);
+}
+
+
+#if defined(ON_PYTHON_COMPILE)
+
+void initAnnotationTessellationBindings(rh3dmpymodule& m)
+{
+  py::class_<BND_AnnotationTessellation>(m, "AnnotationTessellation")
+    .def_static("FromFile3dm", &BND_AnnotationTessellation::FromFile3dm, py::arg("file3dm"), py::arg("fill")=true, py::arg("tolerance")=0.01)
+    .def_static("FromAnnotation", &BND_AnnotationTessellation::FromAnnotation, py::arg("annotation"), py::arg("dimstyle")=nullptr, py::arg("fill")=true, py::arg("tolerance")=0.01)
+    .def_static("ClearGlyphCache", &BND_AnnotationTessellation::ClearGlyphCache)
+    .def_static("GlyphCacheCount", &BND_AnnotationTessellation::GlyphCacheCount)
+    .def_property_readonly_static("GlyphOutlinesAvailable", [](py::object /*self*/) { return BND_AnnotationTessellation::GlyphOutlinesAvailable(); })
+    .def_property_readonly("VertexCount", &BND_AnnotationTessellation::VertexCount)
+    .def_property_readonly("TriangleCount", &BND_AnnotationTessellation::TriangleCount)
+    .def_property_readonly("Vertices", &BND_AnnotationTessellation::Vertices)
+    .def_property_readonly("Indices", &BND_AnnotationTessellation::Indices)
+    .def_property_readonly("TriangleSourceIndices", &BND_AnnotationTessellation::TriangleSourceIndices)
+    .def_property_readonly("PolylineCount", &BND_AnnotationTessellation::PolylineCount)
+    .def_property_readonly("PointCount", &BND_AnnotationTessellation::PointCount)
+    .def_property_readonly("Points", &BND_AnnotationTessellation::Points)
+    .def_property_readonly("PolylineOffsets", &BND_AnnotationTessellation::PolylineOffsets)
+    .def_property_readonly("PolylineSourceIndices", &BND_AnnotationTessellation::PolylineSourceIndices)
+    .def_property_readonly("SourceIds", &BND_AnnotationTessellation::SourceIds)
+    .def_property_readonly("GlyphCount", &BND_AnnotationTessellation::GlyphCount)
+    .def_property_readonly("UniqueGlyphCount", &BND_AnnotationTessellation::UniqueGlyphCount)
+    .def_property_readonly("BoundingBox", &BND_AnnotationTessellation::BoundingBox)
+    ;
+}
+
+#endif
+
+#if defined(ON_WASM_COMPILE)
+using namespace emscripten;
+
+void initAnnotationTessellationBindings(void*)
+{
+  class_<BND_AnnotationTessellation>("AnnotationTessellation")
+    .class_function("fromFile3dm", &BND_AnnotationTessellation::FromFile3dm, allow_raw_pointers())
+    .class_function("fromAnnotation", &BND_AnnotationTessellation::FromAnnotation, allow_raw_pointers())
+    .class_function("clearGlyphCache", &BND_AnnotationTessellation::ClearGlyphCache)
+    .class_function("glyphCacheCount", &BND_AnnotationTessellation::GlyphCacheCount)
+    .class_function("glyphOutlinesAvailable", &BND_AnnotationTessellation::GlyphOutlinesAvailable)
+    .property("vertexCount", &BND_AnnotationTessellation::VertexCount)
+    .property("triangleCount", &BND_AnnotationTessellation::TriangleCount)
+    .property("vertices", &BND_AnnotationTessellation::Vertices)
+    .property("indices", &BND_AnnotationTessellation::Indices)
+    .property("triangleSourceIndices", &BND_AnnotationTessellation::TriangleSourceIndices)
+    .property("polylineCount", &BND_AnnotationTessellation::PolylineCount)
+    .property("pointCount", &BND_AnnotationTessellation::PointCount)
+    .property("points", &BND_AnnotationTessellation::Points)
+    .property("polylineOffsets", &BND_AnnotationTessellation::PolylineOffsets)
+    .property("polylineSourceIndices", &BND_AnnotationTessellation::PolylineSourceIndices)
+    .property("sourceIds", &BND_AnnotationTessellation::SourceIds)
+    .property("glyphCount", &BND_AnnotationTessellation::GlyphCount)
+    .property("uniqueGlyphCount", &BND_AnnotationTessellation::UniqueGlyphCount)
+    .property("boundingBox", &BND_AnnotationTessellation::BoundingBox)
+    ;
+}
+#endif
@@ -0,0 +1,66 @@
+#include "bindings.h"
+
+#pragma once
+
+#if defined(ON_PYTHON_COMPILE)
+void initAnnotationTessellationBindings(rh3dmpymodule& m);
+#else
+void initAnnotationTessellationBindings(void* m);
+#endif
+
+// Text of annotation objects (text, leaders, dimensions) turned into
+// geometry a viewer can draw without a font engine. Filled fonts become
+// triangles, single stroke fonts and fill == false become polylines.
+// Coordinates are world coordinates. Glyph outlines are tessellated once per
+// (font, glyph, tolerance) and shared by every annotation through a process
+// wide cache.
+class BND_AnnotationTessellation
+{
+public:
+  // tolerance is relative to the height of capital letters
+  static BND_AnnotationTessellation* FromFile3dm(const class BND_ONXModel& model, bool fill, double tolerance);
+  static BND_AnnotationTessellation* FromAnnotation(const class BND_AnnotationBase& annotation, const class BND_DimensionStyle* dimstyle, bool fill, double tolerance);
+  static void ClearGlyphCache();
+  static int GlyphCacheCount();
+  // Glyph outlines come from the platform font engine. Builds without one
+  // (Linux and web assembly, where FreeType is not compiled in) still count
+  // glyphs but produce no triangles or polylines for them.
+  static bool GlyphOutlinesAvailable();
+
+  int VertexCount() const { return (int)(m_vertices.size() / 3); }
+  int TriangleCount() const { return (int)(m_indices.size() / 3); }
+  BND_BUFFER Vertices() const { return CreateBuffer(m_vertices); }
+  BND_BUFFER Indices() const { return CreateBuffer(m_indices); }
+  BND_BUFFER TriangleSourceIndices() const { return CreateBuffer(m_triangle_sources); }
+
+  int PolylineCount() const { return (int)m_polyline_sources.size(); }
+  int PointCount() const { return (int)(m_points.size() / 3); }
+  BND_BUFFER Points() const { return CreateBuffer(m_points); }
+  BND_BUFFER PolylineOffsets() const { return CreateBuffer(m_offsets); }
+  BND_BUFFER PolylineSourceIndices() const { return CreateBuffer(m_polyline_sources); }
+
+  BND_TUPLE SourceIds() const;
+  int GlyphCount() const { return m_glyph_count; }
+  int UniqueGlyphCount() const { return m_unique_glyph_count; }
+  BND_BoundingBox BoundingBox() const;
+
+  void Add(const ON_Annotation& annotation, const ON_DimStyle& dimstyle, const ON_Xform& xform, const ON_UUID& id);
+
+public:
+  bool m_fill = true;
+  double m_tolerance = 0.01;
+
+  std::vector<float> m_vertices;                 // x,y,z per vertex
+  std::vector<unsigned int> m_indices;           // 3 per triangle
+  std::vector<unsigned int> m_triangle_sources;  // index into SourceIds() per triangle
+  std::vector<float> m_points;                   // x,y,z per polyline point
+  std::vector<int> m_offsets = { 0 };            // PolylineCount()+1 point offsets
+  std::vector<unsigned int> m_polyline_sources;  // index into SourceIds() per polyline
+  std::vector<ON_UUID> m_source_ids;
+  int m_glyph_count = 0;
+  int m_unique_glyph_count = 0;
+
+private:
+  void CountUniqueGlyphs();
+  std::vector<const void*> m_used_glyphs; // glyph shapes referenced, with repeats
+};
@@ -0,0 +1,174 @@
+#include "bnd_archive_chunks.h"
+
+#include <cstring>
+
+static const size_t ARCHIVE_HEADER_SIZE = 32;
+static const size_t CHUNK_HEADER_SIZE = 12;
+
+bool BND_ReadArchiveChunk(const unsigned char* data, size_t size, size_t pos, BND_ArchiveChunk& chunk)
+{
+  if (pos > size || size - pos < CHUNK_HEADER_SIZE)
+    return false;
+  memcpy(&chunk.m_tcode, data + pos, 4);
+  memcpy(&chunk.m_value, data + pos + 4, 8);
+  chunk.m_begin = pos;
+  chunk.m_content = pos + CHUNK_HEADER_SIZE;
+  chunk.m_end = chunk.m_content;
+  if (0 == (chunk.m_tcode & TCODE_SHORT))
+  {
+    if (chunk.m_value < 0 || (ON__UINT64)chunk.m_value > size - chunk.m_content)
+      return false;
+    if (0 != (chunk.m_tcode & TCODE_CRC) && chunk.m_value < 4)
+      return false;
+    chunk.m_end += (size_t)chunk.m_value;
+  }
+  return true;
+}
+
+bool BND_ObjectRecord::Matches(const ON_Geometry& geometry) const
+{
+  return 0 != m_geometry_end &&
+    m_object_type == (unsigned int)geometry.ObjectType() &&
+    m_class_id == geometry.ClassId()->Uuid();
+}
+
+bool BND_ReadObjectRecord(const unsigned char* data, size_t size, size_t pos, BND_ObjectRecord& record)
+{
+  record = BND_ObjectRecord();
+  if (!BND_ReadArchiveChunk(data, size, pos, record.m_chunk) || TCODE_OBJECT_RECORD != record.m_chunk.m_tcode)
+    return false;
+
+  const size_t end = record.m_chunk.DataEnd();
+  BND_ArchiveChunk type, cls, uuid;
+  if (!BND_ReadArchiveChunk(data, end, record.m_chunk.m_content, type) || TCODE_OBJECT_RECORD_TYPE != type.m_tcode)
+    return true;
+  if (!BND_ReadArchiveChunk(data, end, type.m_end, cls) || TCODE_OPENNURBS_CLASS != cls.m_tcode)
+    return true;
+  if (!BND_ReadArchiveChunk(data, cls.DataEnd(), cls.m_content, uuid) || TCODE_OPENNURBS_CLASS_UUID != uuid.m_tcode || uuid.DataEnd() - uuid.m_content < 16)
+    return true;
+
+  record.m_object_type = (unsigned int)type.m_value;
+  memcpy(&record.m_class_id, data + uuid.m_content, 16);
+  record.m_geometry_end = cls.m_end;
+  return true;
+}
+
+bool BND_ArchiveLayout::Read(const unsigned char* data, size_t size)
+{
+  // chunk values are read as little endian 8 byte integers
+  if (ON::Endian() != ON::endian::little_endian || size < ARCHIVE_HEADER_SIZE)
+    return false;
+  int version = 0;
+  for (size_t i = 24; i < ARCHIVE_HEADER_SIZE; i++)
+  {
+    if (data[i] >= '0' && data[i] <= '9')
+      version = version * 10 + (data[i] - '0');
+  }
+  if (version < 50)
+    return false;
+
+  bool haveTable = false;
+  for (size_t pos = ARCHIVE_HEADER_SIZE; pos < size; pos = m_end_of_file.m_end)
+  {
+    if (!BND_ReadArchiveChunk(data, size, pos, m_end_of_file))
+      return false;
+    if (TCODE_OBJECT_TABLE == m_end_of_file.m_tcode)
+    {
+      if (haveTable)
+        return false;
+      m_object_table = m_end_of_file;
+      haveTable = true;
+    }
+  }
+  // the end mark holds the 8 byte archive length
+  if (!haveTable || TCODE_ENDOFFILE != m_end_of_file.m_tcode || 8 != m_end_of_file.DataEnd() - m_end_of_file.m_content)
+    return false;
+
+  m_records.clear();
+  const size_t end = m_object_table.DataEnd();
+  size_t pos = m_object_table.m_content;
+  for (BND_ObjectRecord record; pos < end && BND_ReadObjectRecord(data, end, pos, record); pos = record.m_chunk.m_end)
+    m_records.push_back(record);
+
+  BND_ArchiveChunk endOfTable;
+  if (!BND_ReadArchiveChunk(data, end, pos, endOfTable) || TCODE_ENDOFTABLE != endOfTable.m_tcode || endOfTable.m_end != end)
+    return false;
+  m_table_tail = pos;
+  return true;
+}
+
+bool BND_ComponentIndicesAreSequential(const ONX_Model& model)
+{
+  const ON_ModelComponent::Type indexed[] = {
+    ON_ModelComponent::Type::Image, ON_ModelComponent::Type::TextureMapping,
+    ON_ModelComponent::Type::RenderMaterial, ON_ModelComponent::Type::LinePattern,
+    ON_ModelComponent::Type::Layer, ON_ModelComponent::Type::Group,
+    ON_ModelComponent::Type::DimStyle, ON_ModelComponent::Type::HatchPattern,
+    ON_ModelComponent::Type::InstanceDefinition
+  };
+  for (ON_ModelComponent::Type type : indexed)
+  {
+    ONX_ModelComponentIterator iterator(model, type);
+    int index = 0;
+    for (const ON_ModelComponent* component = iterator.FirstComponent(); component; component = iterator.NextComponent())
+    {
+      if (component->IsSystemComponent())
+        continue;
+      if (component->Index() != index++)
+        return false;
+    }
+  }
+  return true;
+}
+
+BND_ObjectTableSplice::BND_ObjectTableSplice(const unsigned char* source, const BND_ArchiveLayout& layout)
+  : m_source(source), m_layout(layout)
+{
+}
+
+void BND_ObjectTableSplice::AddBytes(const unsigned char* bytes, size_t count)
+{
+  if (0 == count)
+    return;
+  m_pieces.emplace_back(bytes, count);
+  m_length += count;
+}
+
+void BND_ObjectTableSplice::AddChunkHeader(ON__UINT32 tcode, ON__INT64 value)
+{
+  m_headers.emplace_back();
+  unsigned char* header = m_headers.back().data();
+  memcpy(header, &tcode, 4);
+  memcpy(header + 4, &value, 8);
+  AddBytes(header, CHUNK_HEADER_SIZE);
+}
+
+bool BND_ObjectTableSplice::Write(const std::function<bool(const void*, size_t)>& put) const
+{
+  const BND_ArchiveChunk& table = m_layout.m_object_table;
+  const BND_ArchiveChunk& endOfFile = m_layout.m_end_of_file;
+  const size_t tail = table.m_end - m_layout.m_table_tail;
+
+  unsigned char header[CHUNK_HEADER_SIZE];
+  const ON__INT64 tableLength = (ON__INT64)(m_length + tail);
+  memcpy(header, &table.m_tcode, 4);
+  memcpy(header + 4, &tableLength, 8);
+
+  // the end mark stores the archive length; keep whatever offset the
+  // source archive used
+  ON__INT64 archiveLength = 0;
+  memcpy(&archiveLength, m_source + endOfFile.m_content, 8);
+  archiveLength += tableLength - (ON__INT64)(table.m_end - table.m_content);
+
+  if (!put(m_source, table.m_begin) || !put(header, CHUNK_HEADER_SIZE))
+    return false;
+  for (const auto& piece : m_pieces)
+  {
+    if (!put(piece.first, piece.second))
+      return false;
+  }
+  return put(m_source + m_layout.m_table_tail, tail) &&
+    put(m_source + table.m_end, endOfFile.m_content - table.m_end) &&
+    put(&archiveLength, 8) &&
+    put(m_source + endOfFile.m_content + 8, endOfFile.m_end - endOfFile.m_content - 8);
+}
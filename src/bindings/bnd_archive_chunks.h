@@ -0,0 +1,86 @@
+#include "bindings.h"
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <functional>
+
+// Chunk level view of a 3dm archive, used to rebuild the object table of an
+// archive from records serialized somewhere else (a source file, per thread
+// buffers) while every other byte is copied.
+//
+// 3dm files start with a 32 byte "3D Geometry File Format" header followed
+// by chunks. From archive version 50 on a chunk header is a 4 byte typecode
+// and an 8 byte value; short chunks keep their data in the value, big chunks
+// are followed by value bytes of content. Typecodes with TCODE_CRC set end
+// their content with a CRC32 of the bytes written directly into that chunk,
+// which for object records and tables (whose content is nothing but other
+// chunks) does not change when the nested chunks do.
+struct BND_ArchiveChunk
+{
+  ON__UINT32 m_tcode = 0;
+  ON__INT64 m_value = 0;
+  size_t m_begin = 0;    // header
+  size_t m_content = 0;  // first content byte
+  size_t m_end = 0;      // one past the content, including any CRC
+
+  size_t DataEnd() const { return (0 == (m_tcode & TCODE_SHORT) && 0 != (m_tcode & TCODE_CRC)) ? m_end - 4 : m_end; }
+};
+
+bool BND_ReadArchiveChunk(const unsigned char* data, size_t size, size_t pos, BND_ArchiveChunk& chunk);
+
+// An object record written by ON_BinaryArchive::Write3dmObject is a type
+// chunk and the geometry class chunk followed by attributes, attribute user
+// data and an end chunk. m_geometry_end marks the end of the class chunk and
+// is 0 when the record does not start that way.
+struct BND_ObjectRecord
+{
+  BND_ArchiveChunk m_chunk;
+  size_t m_geometry_end = 0;
+  unsigned int m_object_type = 0;
+  ON_UUID m_class_id = ON_nil_uuid;
+
+  // true when the record holds geometry of this type and class
+  bool Matches(const ON_Geometry& geometry) const;
+};
+
+bool BND_ReadObjectRecord(const unsigned char* data, size_t size, size_t pos, BND_ObjectRecord& record);
+
+// The object table and end of file chunks of a whole archive
+struct BND_ArchiveLayout
+{
+  BND_ArchiveChunk m_object_table;
+  BND_ArchiveChunk m_end_of_file;
+  std::vector<BND_ObjectRecord> m_records;
+  size_t m_table_tail = 0;  // end of table chunk (and table CRC) after the last record
+
+  // false for archives before version 50 and anything unexpected
+  bool Read(const unsigned char* data, size_t size);
+};
+
+// Reusing object bytes outside ONX_Model::Write means writing attributes
+// with the model's own component indices, which only match what
+// ONX_Model::Write stores when they run 0,1,2,... in table order.
+bool BND_ComponentIndicesAreSequential(const ONX_Model& model);
+
+// Builds an archive identical to a source archive except for the content of
+// its object table. The end of file chunk is adjusted for the new length.
+class BND_ObjectTableSplice
+{
+public:
+  BND_ObjectTableSplice(const unsigned char* source, const BND_ArchiveLayout& layout);
+
+  // bytes must stay valid until Write returns
+  void AddBytes(const unsigned char* bytes, size_t count);
+  void AddChunkHeader(ON__UINT32 tcode, ON__INT64 value);
+
+  bool Write(const std::function<bool(const void*, size_t)>& put) const;
+
+private:
+  const unsigned char* m_source;
+  const BND_ArchiveLayout& m_layout;
+  std::vector<std::pair<const unsigned char*, size_t>> m_pieces;
+  std::deque<std::array<unsigned char, 12>> m_headers;
+  ON__UINT64 m_length = 0;
+};
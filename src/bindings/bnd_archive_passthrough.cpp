@@ -0,0 +1,316 @@
+#include "bnd_archive_passthrough.h"
+#include "bnd_archive_chunks.h"
+#include "mapped_file.h"
+
+#include <mutex>
+#include <unordered_map>
+
+static std::mutex& ExposedMutex()
+{
+  static std::mutex m;
+  return m;
+}
+
+struct TrackedComponent
+{
+  int m_owners = 0;
+  bool m_exposed = false;
+};
+
+// Components some passthrough may reuse source bytes for, by runtime serial
+// number. Entries live only as long as a passthrough tracks them.
+static std::unordered_map<ON__UINT64, TrackedComponent>& TrackedComponents()
+{
+  static std::unordered_map<ON__UINT64, TrackedComponent> components;
+  return components;
+}
+
+static void Track(ON__UINT64 serialNumber, bool exposed)
+{
+  TrackedComponent& tracked = TrackedComponents()[serialNumber];
+  tracked.m_owners++;
+  tracked.m_exposed = tracked.m_exposed || exposed;
+}
+
+static void Untrack(ON__UINT64 serialNumber)
+{
+  auto found = TrackedComponents().find(serialNumber);
+  if (found != TrackedComponents().end() && --found->second.m_owners <= 0)
+    TrackedComponents().erase(found);
+}
+
+void BND_ArchivePassthrough::MarkExposed(const ON_ModelComponent* component)
+{
+  if (nullptr == component)
+    return;
+  std::lock_guard<std::mutex> lock(ExposedMutex());
+  // untracked components have no source bytes anyone would reuse
+  auto found = TrackedComponents().find(component->RuntimeSerialNumber());
+  if (found != TrackedComponents().end())
+    found->second.m_exposed = true;
+}
+
+bool BND_ArchivePassthrough::IsExposed(ON__UINT64 runtimeSerialNumber)
+{
+  std::lock_guard<std::mutex> lock(ExposedMutex());
+  auto found = TrackedComponents().find(runtimeSerialNumber);
+  return found == TrackedComponents().end() || found->second.m_exposed;
+}
+
+BND_ArchivePassthrough::~BND_ArchivePassthrough()
+{
+  std::lock_guard<std::mutex> lock(ExposedMutex());
+  for (const ComponentState& state : m_components)
+    Untrack(state.m_serial_number);
+  for (ON__UINT64 serialNumber : m_objects)
+    Untrack(serialNumber);
+}
+
+bool BND_ArchivePassthrough::ComponentState::operator==(const ComponentState& other) const
+{
+  return m_type == other.m_type && m_serial_number == other.m_serial_number &&
+    m_content_version == other.m_content_version && m_deleted == other.m_deleted;
+}
+
+std::vector<BND_ArchivePassthrough::ComponentState> BND_ArchivePassthrough::Components(const ONX_Model& model)
+{
+  std::vector<ComponentState> rc;
+  for (unsigned int i = 0; i < 256; i++)
+  {
+    const ON_ModelComponent::Type type = ON_ModelComponent::ComponentTypeFromUnsigned(i);
+    if (ON_ModelComponent::Type::Unset == type || ON_ModelComponent::Type::Mixed == type || ON_ModelComponent::Type::ModelGeometry == type)
+      continue;
+    ONX_ModelComponentIterator iterator(model, type);
+    for (const ON_ModelComponent* component = iterator.FirstComponent(); component; component = iterator.NextComponent())
+    {
+      ComponentState state;
+      state.m_type = type;
+      state.m_serial_number = component->RuntimeSerialNumber();
+      state.m_content_version = component->ContentVersionNumber();
+      state.m_deleted = component->IsDeleted();
+      rc.push_back(state);
+    }
+  }
+  return rc;
+}
+
+bool BND_ArchivePassthrough::SerializeDocument(const ONX_Model& model, std::string& bytes)
+{
+  ON_Write3dmBufferArchive archive(0, 0, 0, 0);
+  if (!archive.Write3dmStartSection(0, static_cast<const char*>(model.m_sStartSectionComments)) ||
+    !archive.Write3dmProperties(model.m_properties) ||
+    !archive.Write3dmSettings(model.m_settings))
+    return false;
+  bytes.assign((const char*)archive.Buffer(), (size_t)archive.SizeOfArchive());
+  return true;
+}
+
+bool BND_ArchivePassthrough::RecordSource(const wchar_t* path)
+{
+  std::error_code ec;
+  const std::filesystem::path p(path);
+  m_size = std::filesystem::file_size(p, ec);
+  if (ec)
+    return false;
+  m_modified = std::filesystem::last_write_time(p, ec);
+  if (ec)
+    return false;
+  m_path = path;
+  return true;
+}
+
+bool BND_ArchivePassthrough::SourceUnchanged() const
+{
+  std::error_code ec;
+  const std::filesystem::path p(m_path);
+  const std::uintmax_t size = std::filesystem::file_size(p, ec);
+  if (ec || size != m_size)
+    return false;
+  const std::filesystem::file_time_type modified = std::filesystem::last_write_time(p, ec);
+  return !ec && modified == m_modified;
+}
+
+std::shared_ptr<BND_ArchivePassthrough> BND_ArchivePassthrough::Create(const ONX_Model& model, const wchar_t* path)
+{
+  if (model.m_3dm_file_version < 50)
+    return nullptr;
+
+  // attributes of reused records are written again outside ONX_Model::Write
+  if (!BND_ComponentIndicesAreSequential(model))
+    return nullptr;
+
+  std::shared_ptr<BND_ArchivePassthrough> rc = std::make_shared<BND_ArchivePassthrough>();
+  if (!rc->RecordSource(path) || !SerializeDocument(model, rc->m_document))
+    return nullptr;
+  rc->m_archive_version = model.m_3dm_file_version;
+  rc->m_components = Components(model);
+
+  ONX_ModelComponentIterator iterator(model, ON_ModelComponent::Type::ModelGeometry);
+  for (const ON_ModelComponent* component = iterator.FirstComponent(); component; component = iterator.NextComponent())
+    rc->m_objects.push_back(component->RuntimeSerialNumber());
+
+  std::lock_guard<std::mutex> lock(ExposedMutex());
+  for (const ComponentState& state : rc->m_components)
+    Track(state.m_serial_number, false);
+  for (ON__UINT64 serialNumber : rc->m_objects)
+    Track(serialNumber, false);
+  return rc;
+}
+
+bool BND_ArchivePassthrough::Write(const ONX_Model& model, const wchar_t* path, int version)
+{
+  if (!SourceUnchanged())
+    return false;
+
+  // tables other than the object table are copied from the source, so they
+  // have to be exactly what was read
+  if (Components(model) != m_components)
+    return false;
+  for (const ComponentState& state : m_components)
+  {
+    if (IsExposed(state.m_serial_number))
+      return false;
+  }
+  std::string document;
+  if (!SerializeDocument(model, document) || document != m_document)
+    return false;
+
+  ON_Write3dmBufferArchive fresh(0, 0, version, 0);
+  if (!fresh.Write3dmStartSection(version, static_cast<const char*>(model.m_sStartSectionComments)))
+    return false;
+  if (fresh.Archive3dmVersion() != m_archive_version)
+    return false;
+  if (!fresh.Write3dmProperties(model.m_properties) || !fresh.Write3dmSettings(model.m_settings))
+    return false;
+  fresh.SetReferencedComponentIndexMapping(false);
+  if (!fresh.BeginWrite3dmObjectTable())
+    return false;
+
+  // source bytes are copied from the mapping straight into the new file
+  mapped_file source;
+  if (!source.open(m_path.c_str()) || source.size() != m_size || !SourceUnchanged())
+    return false;
+
+  BND_ArchiveLayout layout;
+  if (!layout.Read(source.data(), source.size()) || layout.m_records.size() != m_objects.size())
+    return false;
+
+  std::unordered_map<ON__UINT64, size_t> recordIndex;
+  for (size_t i = 0; i < m_objects.size(); i++)
+    recordIndex[m_objects[i]] = i;
+
+  // Every object gets one record in the fresh archive: the whole record when
+  // its geometry has to be written again, otherwise a record for a stand in
+  // point that carries the object's attributes.
+  struct PlannedObject
+  {
+    const BND_ObjectRecord* m_source = nullptr;
+    size_t m_fresh_begin = 0;
+    size_t m_fresh_end = 0;
+  };
+  std::vector<PlannedObject> planned;
+  const ON_Point standIn;
+  std::vector<ON__UINT64> written;
+  std::vector<ON__UINT64> serialized;
+
+  ONX_ModelComponentIterator iterator(model, ON_ModelComponent::Type::ModelGeometry);
+  for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+  {
+    const ON_ModelGeometryComponent* component = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    const ON_Geometry* geometry = component ? component->Geometry(nullptr) : nullptr;
+    if (nullptr == geometry)
+      return false;
+    const ON__UINT64 serialNumber = component->RuntimeSerialNumber();
+
+    PlannedObject item;
+    auto found = recordIndex.find(serialNumber);
+    if (found != recordIndex.end() && !IsExposed(serialNumber))
+    {
+      const BND_ObjectRecord& record = layout.m_records[found->second];
+      if (0 != record.m_geometry_end)
+      {
+        // records and objects are paired by read order; a mismatch means
+        // Read skipped or reordered something and nothing can be trusted
+        if (!record.Matches(*geometry))
+          return false;
+        item.m_source = &record;
+      }
+    }
+
+    item.m_fresh_begin = (size_t)fresh.CurrentPosition();
+    const bool rc = item.m_source
+      ? fresh.Write3dmObject(standIn, component->Attributes(nullptr))
+      : fresh.Write3dmModelGeometryComponent(*component);
+    if (!rc)
+      return false;
+    item.m_fresh_end = (size_t)fresh.CurrentPosition();
+    planned.push_back(item);
+    written.push_back(serialNumber);
+    if (nullptr == item.m_source)
+      serialized.push_back(serialNumber);
+  }
+
+  const unsigned char* freshData = (const unsigned char*)fresh.Buffer();
+  const size_t freshSize = (size_t)fresh.SizeOfArchive();
+
+  BND_ObjectTableSplice splice(source.data(), layout);
+  for (const PlannedObject& item : planned)
+  {
+    if (nullptr == item.m_source)
+    {
+      splice.AddBytes(freshData + item.m_fresh_begin, item.m_fresh_end - item.m_fresh_begin);
+      continue;
+    }
+
+    // source type and geometry class chunks, attributes and everything
+    // after them from the stand in record
+    BND_ObjectRecord standInRecord;
+    if (!BND_ReadObjectRecord(freshData, freshSize, item.m_fresh_begin, standInRecord) || 0 == standInRecord.m_geometry_end)
+      return false;
+    const BND_ArchiveChunk& chunk = item.m_source->m_chunk;
+    const size_t geometryLength = item.m_source->m_geometry_end - chunk.m_content;
+    const size_t attributesLength = standInRecord.m_chunk.DataEnd() - standInRecord.m_geometry_end;
+    const size_t crcLength = chunk.m_end - chunk.DataEnd();
+
+    splice.AddChunkHeader(chunk.m_tcode, (ON__INT64)(geometryLength + attributesLength + crcLength));
+    splice.AddBytes(source.data() + chunk.m_content, geometryLength);
+    splice.AddBytes(freshData + standInRecord.m_geometry_end, attributesLength);
+    splice.AddBytes(source.data() + chunk.DataEnd(), crcLength);
+  }
+
+  // write next to the destination and move it into place so writing over
+  // the source file itself is safe
+  const std::wstring target(path);
+  const std::wstring temporary = target + L".tmp";
+  FILE* fp = ON::OpenFile(temporary.c_str(), L"wb");
+  if (nullptr == fp)
+    return false;
+  const bool ok = splice.Write([fp](const void* p, size_t n) { return 0 == n || fwrite(p, 1, n, fp) == n; });
+  ON::CloseFile(fp);
+  // Windows refuses to replace a file that is still mapped
+  source.close();
+
+  std::error_code ec;
+  if (ok)
+    std::filesystem::rename(std::filesystem::path(temporary), std::filesystem::path(target), ec);
+  if (!ok || ec)
+  {
+    std::filesystem::remove(std::filesystem::path(temporary), ec);
+    return false;
+  }
+
+  // the new file lines up with the model the same way, so it becomes the
+  // source for the next save. Objects whose geometry was serialized stay
+  // exposed: they are new or script code may still hold them.
+  if (!RecordSource(path))
+    m_size = 0;
+  std::lock_guard<std::mutex> lock(ExposedMutex());
+  for (ON__UINT64 serialNumber : written)
+    Track(serialNumber, false);
+  for (ON__UINT64 serialNumber : serialized)
+    TrackedComponents()[serialNumber].m_exposed = true;
+  for (ON__UINT64 serialNumber : m_objects)
+    Untrack(serialNumber);
+  m_objects.swap(written);
+  return true;
+}
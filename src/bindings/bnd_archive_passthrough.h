@@ -0,0 +1,57 @@
+#include "bindings.h"
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Re-saves a model that was read from a 3dm file without re-serializing the
+// objects that were never handed out to script code. Everything outside the
+// object table is copied from the source file, object geometry that is still
+// clean is copied as the original (compressed) chunk bytes, and only the
+// attributes of those objects plus the geometry of edited and new objects
+// are written again. Anything the source file can not vouch for makes
+// Write return false so the caller falls back to ONX_Model::Write.
+class BND_ArchivePassthrough
+{
+public:
+  // nullptr when the model can not be re-saved this way (old archive
+  // version, unusual component indices, unreadable file)
+  static std::shared_ptr<BND_ArchivePassthrough> Create(const ONX_Model& model, const wchar_t* path);
+  ~BND_ArchivePassthrough();
+
+  // Writes model to path. Returns false, leaving path untouched, whenever
+  // the result could differ from what ONX_Model::Write would store.
+  bool Write(const ONX_Model& model, const wchar_t* path, int version);
+
+  // Wrappers that let script code edit a model component in place report
+  // the component here; its source bytes are never reused afterwards.
+  // Exposure is only kept for components of models that have a passthrough
+  // and is dropped with that passthrough.
+  static void MarkExposed(const ON_ModelComponent* component);
+  static bool IsExposed(ON__UINT64 runtimeSerialNumber);
+
+private:
+  struct ComponentState
+  {
+    ON_ModelComponent::Type m_type = ON_ModelComponent::Type::Unset;
+    ON__UINT64 m_serial_number = 0;
+    ON__UINT64 m_content_version = 0;
+    bool m_deleted = false;
+    bool operator==(const ComponentState& other) const;
+  };
+
+  static std::vector<ComponentState> Components(const ONX_Model& model);
+  static bool SerializeDocument(const ONX_Model& model, std::string& bytes);
+  bool SourceUnchanged() const;
+  bool RecordSource(const wchar_t* path);
+
+  std::wstring m_path;
+  std::uintmax_t m_size = 0;
+  std::filesystem::file_time_type m_modified;
+  int m_archive_version = 0;
+  std::string m_document;                    // start section, properties and settings as written at Read
+  std::vector<ComponentState> m_components;  // every non-object component at Read
+  std::vector<ON__UINT64> m_objects;         // object runtime serial numbers in object table order
+};
@@ -0,0 +1,203 @@
+#include "bindings.h"
+
+#include <algorithm>
+
+void BND_ArchiveProfile::Start()
+{
+  m_tables.clear();
+  m_objects.clear();
+  m_total_bytes = 0;
+  m_total_seconds = 0.0;
+  m_start = std::chrono::steady_clock::now();
+  m_last = m_start;
+  m_last_table = ON_3dmArchiveTableType::Unset;
+}
+
+void BND_ArchiveProfile::Record(ON_3dmArchiveTableType table, size_t bytes)
+{
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  TableStats& stats = m_tables[(unsigned int)table];
+  stats.m_seconds += std::chrono::duration<double>(now - m_last).count();
+  stats.m_bytes += bytes;
+  m_total_bytes += bytes;
+  m_last = now;
+  m_last_table = table;
+}
+
+void BND_ArchiveProfile::Finish()
+{
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  m_tables[(unsigned int)m_last_table].m_seconds += std::chrono::duration<double>(now - m_last).count();
+  m_last = now;
+  m_total_seconds = std::chrono::duration<double>(now - m_start).count();
+}
+
+double BND_ArchiveProfile::Now() const
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+static const char* TableName(ON_3dmArchiveTableType table)
+{
+  switch (table)
+  {
+  case ON_3dmArchiveTableType::start_section: return "startSection";
+  case ON_3dmArchiveTableType::properties_table: return "properties";
+  case ON_3dmArchiveTableType::settings_table: return "settings";
+  case ON_3dmArchiveTableType::bitmap_table: return "bitmaps";
+  case ON_3dmArchiveTableType::texture_mapping_table: return "textureMappings";
+  case ON_3dmArchiveTableType::material_table: return "materials";
+  case ON_3dmArchiveTableType::linetype_table: return "linetypes";
+  case ON_3dmArchiveTableType::layer_table: return "layers";
+  case ON_3dmArchiveTableType::group_table: return "groups";
+  case ON_3dmArchiveTableType::text_style_table: return "textStyles";
+  case ON_3dmArchiveTableType::leader_style_table: return "leaderStyles";
+  case ON_3dmArchiveTableType::dimension_style_table: return "dimStyles";
+  case ON_3dmArchiveTableType::light_table: return "lights";
+  case ON_3dmArchiveTableType::hatchpattern_table: return "hatchPatterns";
+  case ON_3dmArchiveTableType::instance_definition_table: return "instanceDefinitions";
+  case ON_3dmArchiveTableType::object_table: return "objects";
+  case ON_3dmArchiveTableType::historyrecord_table: return "historyRecords";
+  case ON_3dmArchiveTableType::user_table: return "userData";
+  case ON_3dmArchiveTableType::end_mark: return "endMark";
+  default: break;
+  }
+  return "other";
+}
+
+// Number of records the model holds for a table, -1 when not tracked
+static int TableRecordCount(const ONX_Model* model, ON_3dmArchiveTableType table)
+{
+  if (nullptr == model)
+    return -1;
+  ON_ModelComponent::Type type = ON_ModelComponent::Type::Unset;
+  switch (table)
+  {
+  case ON_3dmArchiveTableType::bitmap_table: type = ON_ModelComponent::Type::Image; break;
+  case ON_3dmArchiveTableType::texture_mapping_table: type = ON_ModelComponent::Type::TextureMapping; break;
+  case ON_3dmArchiveTableType::material_table: type = ON_ModelComponent::Type::RenderMaterial; break;
+  case ON_3dmArchiveTableType::linetype_table: type = ON_ModelComponent::Type::LinePattern; break;
+  case ON_3dmArchiveTableType::layer_table: type = ON_ModelComponent::Type::Layer; break;
+  case ON_3dmArchiveTableType::group_table: type = ON_ModelComponent::Type::Group; break;
+  case ON_3dmArchiveTableType::text_style_table: type = ON_ModelComponent::Type::TextStyle; break;
+  case ON_3dmArchiveTableType::dimension_style_table: type = ON_ModelComponent::Type::DimStyle; break;
+  case ON_3dmArchiveTableType::light_table: type = ON_ModelComponent::Type::RenderLight; break;
+  case ON_3dmArchiveTableType::hatchpattern_table: type = ON_ModelComponent::Type::HatchPattern; break;
+  case ON_3dmArchiveTableType::instance_definition_table: type = ON_ModelComponent::Type::InstanceDefinition; break;
+  case ON_3dmArchiveTableType::object_table: type = ON_ModelComponent::Type::ModelGeometry; break;
+  case ON_3dmArchiveTableType::historyrecord_table: type = ON_ModelComponent::Type::HistoryRecord; break;
+  case ON_3dmArchiveTableType::user_table: return model->m_userdata_table.Count();
+  default: return -1;
+  }
+  return (int)model->ActiveAndDeletedComponentCount(type);
+}
+
+BND_DICT BND_ArchiveProfile::ToDict(const char* operation, bool success, const ONX_Model* model, const ON_wString& errorLog, int slowestCount) const
+{
+  BND_DICT rc = CreateDict();
+  SetDictItem(rc, "operation", std::string(operation));
+  SetDictItem(rc, "success", success);
+  SetDictItem(rc, "totalSeconds", m_total_seconds);
+  SetDictItem(rc, "totalBytes", m_total_bytes);
+
+  BND_DICT tables = CreateDict();
+  for (const auto& item : m_tables)
+  {
+    const ON_3dmArchiveTableType table = (ON_3dmArchiveTableType)item.first;
+    BND_DICT entry = CreateDict();
+    SetDictItem(entry, "seconds", item.second.m_seconds);
+    SetDictItem(entry, "bytes", item.second.m_bytes);
+    const int count = TableRecordCount(success ? model : nullptr, table);
+    if (count >= 0)
+      SetDictItem(entry, "count", count);
+    SetDictItem(tables, TableName(table), entry);
+  }
+  SetDictItem(rc, "tables", tables);
+
+  // objects grouped by class, e.g. all ON_Brep with their render meshes
+  struct TypeStats { int m_count = 0; double m_seconds = 0.0; ON__UINT64 m_bytes = 0; ON__UINT64 m_memory_bytes = 0; };
+  std::map<std::string, TypeStats> types;
+  for (const ObjectStats& object : m_objects)
+  {
+    TypeStats& stats = types[object.m_class_name ? object.m_class_name : "unknown"];
+    stats.m_count++;
+    stats.m_seconds += object.m_seconds;
+    stats.m_bytes += object.m_bytes;
+    stats.m_memory_bytes += object.m_memory_bytes;
+  }
+  BND_DICT objectTypes = CreateDict();
+  for (const auto& item : types)
+  {
+    BND_DICT entry = CreateDict();
+    SetDictItem(entry, "count", item.second.m_count);
+    SetDictItem(entry, "seconds", item.second.m_seconds);
+    SetDictItem(entry, "bytes", item.second.m_bytes);
+    SetDictItem(entry, "memoryBytes", item.second.m_memory_bytes);
+    SetDictItem(objectTypes, item.first.c_str(), entry);
+  }
+  SetDictItem(rc, "objectTypes", objectTypes);
+
+  std::vector<const ObjectStats*> slowest;
+  slowest.reserve(m_objects.size());
+  for (const ObjectStats& object : m_objects)
+    slowest.push_back(&object);
+  const size_t keep = std::min(slowest.size(), (size_t)std::max(slowestCount, 0));
+  std::partial_sort(slowest.begin(), slowest.begin() + keep, slowest.end(),
+    [](const ObjectStats* a, const ObjectStats* b) { return a->m_seconds > b->m_seconds; });
+
+#if defined(ON_PYTHON_COMPILE)
+  BND_LIST slowestObjects;
+#else
+  BND_LIST slowestObjects = emscripten::val::array();
+#endif
+  for (size_t i = 0; i < keep; i++)
+  {
+    BND_DICT entry = CreateDict();
+    SetDictItem(entry, "id", ON_UUID_to_Binding(slowest[i]->m_id));
+    SetDictItem(entry, "type", std::string(slowest[i]->m_class_name ? slowest[i]->m_class_name : "unknown"));
+    SetDictItem(entry, "seconds", slowest[i]->m_seconds);
+    SetDictItem(entry, "bytes", slowest[i]->m_bytes);
+    SetDictItem(entry, "memoryBytes", slowest[i]->m_memory_bytes);
+    Append(slowestObjects, entry);
+  }
+  SetDictItem(rc, "slowestObjects", slowestObjects);
+
+  SetDictItem(rc, "errorLog", std::wstring(errorLog.Array() ? errorLog.Array() : L""));
+  return rc;
+}
+
+bool BND_ProfiledModelRead(ONX_Model& model, ON_BinaryArchive& archive, BND_ArchiveProfile& profile, ON_TextLog* log)
+{
+  profile.Start();
+  bool rc = model.IncrementalReadBegin(archive, true, 0, log);
+  while (rc)
+  {
+    const double start = profile.Now();
+    const ON__UINT64 position = archive.CurrentPosition();
+    ON_ModelComponentReference compref;
+    if (!model.IncrementalReadModelGeometry(archive, true, true, true, 0, compref))
+    {
+      rc = false;
+      break;
+    }
+    if (compref.IsEmpty())
+      break; // end of object table
+
+    BND_ArchiveProfile::ObjectStats stats;
+    stats.m_id = compref.ModelComponentId();
+    stats.m_seconds = profile.Now() - start;
+    stats.m_bytes = archive.CurrentPosition() - position;
+    const ON_ModelGeometryComponent* component = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    const ON_Geometry* geometry = component ? component->Geometry(nullptr) : nullptr;
+    if (geometry)
+    {
+      stats.m_class_name = geometry->ClassId()->ClassName();
+      stats.m_memory_bytes = geometry->SizeOf();
+    }
+    profile.m_objects.push_back(stats);
+  }
+  if (rc)
+    rc = model.IncrementalReadFinish(archive, true, 0, log);
+  profile.Finish();
+  return rc;
+}
@@ -0,0 +1,78 @@
+#include "bindings.h"
+
+#pragma once
+
+#include <chrono>
+#include <map>
+
+// Timing and size statistics collected while a 3dm archive is read or
+// written. Time between two archive reads (or writes) is charged to the
+// table that is active at the second one, so parsing cost lands on the
+// table being parsed.
+class BND_ArchiveProfile
+{
+public:
+  struct TableStats
+  {
+    double m_seconds = 0.0;
+    ON__UINT64 m_bytes = 0;
+  };
+
+  struct ObjectStats
+  {
+    ON_UUID m_id = ON_nil_uuid;
+    const char* m_class_name = nullptr;
+    double m_seconds = 0.0;
+    ON__UINT64 m_bytes = 0;
+    ON__UINT64 m_memory_bytes = 0;
+  };
+
+  void Start();
+  void Record(ON_3dmArchiveTableType table, size_t bytes);
+  void Finish();
+  double Now() const;
+
+  // Structured report; slowestCount limits the "slowestObjects" list
+  BND_DICT ToDict(const char* operation, bool success, const ONX_Model* model, const ON_wString& errorLog, int slowestCount) const;
+
+public:
+  std::map<unsigned int, TableStats> m_tables; // keyed by ON_3dmArchiveTableType
+  std::vector<ObjectStats> m_objects;          // only filled when reading
+  ON__UINT64 m_total_bytes = 0;
+  double m_total_seconds = 0.0;
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::time_point m_last;
+  ON_3dmArchiveTableType m_last_table = ON_3dmArchiveTableType::Unset;
+};
+
+// Wraps any concrete archive (ON_BinaryFile, ON_Read3dmBufferArchive,
+// ON_Write3dmBufferArchive) and feeds every low level read or write into
+// a BND_ArchiveProfile.
+template <class ArchiveBase>
+class BND_ProfilingArchive : public ArchiveBase
+{
+public:
+  using ArchiveBase::ArchiveBase;
+  BND_ArchiveProfile m_profile;
+
+protected:
+  size_t Internal_ReadOverride(size_t count, void* buffer) override
+  {
+    const size_t rc = ArchiveBase::Internal_ReadOverride(count, buffer);
+    m_profile.Record(this->Active3dmTable(), rc);
+    return rc;
+  }
+
+  size_t Internal_WriteOverride(size_t count, const void* buffer) override
+  {
+    const size_t rc = ArchiveBase::Internal_WriteOverride(count, buffer);
+    m_profile.Record(this->Active3dmTable(), rc);
+    return rc;
+  }
+};
+
+// Same result as ONX_Model::Read(archive, log) but reads the object table
+// one object at a time so each object can be timed.
+bool BND_ProfiledModelRead(ONX_Model& model, ON_BinaryArchive& archive, BND_ArchiveProfile& profile, ON_TextLog* log);
@@ -0,0 +1,341 @@
+#include "bnd_archive_writer.h"
+#include "bnd_archive_chunks.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+static const size_t ARCHIVE_HEADER_SIZE = 32;
+static const size_t CHUNK_HEADER_SIZE = 12;
+
+// Writes a model with its object table left out. Positions reported to the
+// archive run on as if the table were there, so chunk lengths and the end
+// mark are those of the complete archive. Bytes written to the table go
+// nowhere, uncompressed; everything else is compressed (or not) exactly
+// like the final archive and stored, the part after the table starting at
+// m_table_begin of Buffer().
+class BND_SkeletonArchive : public ON_Write3dmBufferArchive
+{
+public:
+  BND_SkeletonArchive(int version, bool compress)
+    : ON_Write3dmBufferArchive(0, 0, version, ON::Version())
+    , m_compress(compress)
+    , m_compressing(compress)
+  {
+    SetUseBufferCompression(compress);
+  }
+
+  // the object table chunk, header included, in the complete archive
+  ON__UINT64 m_table_begin = 0;
+  ON__UINT64 m_table_end = 0;
+  // false when the table was never written or a write straddled its ends
+  bool Complete() const { return Table::after == m_table && m_ok; }
+
+protected:
+  ON__UINT64 Internal_CurrentPositionOverride() const override
+  {
+    return m_position;
+  }
+
+  bool Internal_SeekFromCurrentPositionOverride(int byte_offset) override
+  {
+    if (byte_offset < 0 && (ON__UINT64)(-(ON__INT64)byte_offset) > m_position)
+      return false;
+    m_position = (ON__UINT64)((ON__INT64)m_position + byte_offset);
+    return SeekStored();
+  }
+
+  bool Internal_SeekToStartOverride() override
+  {
+    m_position = 0;
+    return SeekStored();
+  }
+
+  size_t Internal_WriteOverride(size_t count, const void* buffer) override
+  {
+    // the table header is written once the table is active and the next
+    // table starts where the object table chunk ended
+    const bool inTable = ON_3dmArchiveTableType::object_table == Active3dmTable();
+    if (inTable && Table::before == m_table)
+    {
+      m_table = Table::inside;
+      m_table_begin = m_position;
+    }
+    else if (!inTable && Table::inside == m_table)
+    {
+      m_table = Table::after;
+      m_table_end = m_position;
+    }
+
+    const bool compress = m_compress && !inTable;
+    if (compress != m_compressing)
+    {
+      SetUseBufferCompression(compress);
+      m_compressing = compress;
+    }
+
+    if (0 == count)
+      return 0;
+    const bool first = InTable(m_position);
+    if (first != InTable(m_position + count - 1))
+      m_ok = false;
+    if (first)
+    {
+      m_position += count;
+      return count;
+    }
+    const size_t rc = ON_Write3dmBufferArchive::Internal_WriteOverride(count, buffer);
+    m_position += rc;
+    return rc;
+  }
+
+private:
+  enum class Table { before, inside, after };
+
+  bool InTable(ON__UINT64 position) const
+  {
+    if (Table::before == m_table || position < m_table_begin)
+      return false;
+    return Table::inside == m_table || position < m_table_end;
+  }
+
+  // moves the stored position to match m_position; inside the table it
+  // stays where the table began
+  bool SeekStored()
+  {
+    if (InTable(m_position))
+      return true;
+    ON__UINT64 stored = m_position;
+    if (Table::after == m_table && m_position >= m_table_end)
+      stored -= m_table_end - m_table_begin;
+    const ON__INT64 offset = (ON__INT64)stored - (ON__INT64)ON_Write3dmBufferArchive::Internal_CurrentPositionOverride();
+    return 0 == offset || ON_Write3dmBufferArchive::Internal_SeekFromCurrentPositionOverride((int)offset);
+  }
+
+  const bool m_compress;
+  bool m_compressing;
+  Table m_table = Table::before;
+  ON__UINT64 m_position = 0;
+  bool m_ok = true;
+};
+
+// Object records for a contiguous run of model objects, in an archive of
+// their own that holds nothing else worth keeping
+struct BND_RecordBlock
+{
+  int m_first = 0;
+  int m_count = 0;
+  std::unique_ptr<ON_Write3dmBufferArchive> m_archive;
+  BND_ArchiveLayout m_layout;
+  bool m_done = false;
+  bool m_ok = false;
+};
+
+static void SetupArchive(ON_BinaryArchive& archive, const BND_File3dmWriteOptions& options)
+{
+  archive.SetShouldSerializeUserDataDefault(options.SaveUserData());
+  archive.SetUseBufferCompression(options.CompressBuffers());
+}
+
+static bool WriteBlock(const ONX_Model& model, const std::vector<const ON_ModelGeometryComponent*>& components, const BND_File3dmWriteOptions& options, BND_RecordBlock& block)
+{
+  const int version = options.VersionForWriting();
+  block.m_archive.reset(new ON_Write3dmBufferArchive(0, 0, version, ON::Version()));
+  ON_Write3dmBufferArchive& archive = *block.m_archive;
+  SetupArchive(archive, options);
+
+  // only the object table of this archive is used; properties are left
+  // empty since the preview image is the expensive part of them
+  const ON_3dmProperties properties;
+  if (!archive.Write3dmStartSection(version, nullptr) ||
+    !archive.Write3dmProperties(properties) ||
+    !archive.Write3dmSettings(model.m_settings))
+    return false;
+  // attributes keep the model's indices, see BND_ComponentIndicesAreSequential
+  archive.SetReferencedComponentIndexMapping(false);
+  if (!archive.BeginWrite3dmObjectTable())
+    return false;
+  for (int i = block.m_first; i < block.m_first + block.m_count; i++)
+  {
+    if (!archive.Write3dmModelGeometryComponent(*components[i]))
+      return false;
+  }
+  if (!archive.EndWrite3dmObjectTable() || !archive.Write3dmEndMark())
+    return false;
+
+  // every object has to come out as exactly one record of its own type
+  if (!block.m_layout.Read((const unsigned char*)archive.Buffer(), (size_t)archive.SizeOfArchive()) ||
+    (int)block.m_layout.m_records.size() != block.m_count)
+    return false;
+  for (int i = 0; i < block.m_count; i++)
+  {
+    if (!block.m_layout.m_records[i].Matches(*components[block.m_first + i]->Geometry(nullptr)))
+      return false;
+  }
+  return true;
+}
+
+// Reads the chunks in data[begin, end); false unless they end exactly at end
+static bool ReadChunkRun(const unsigned char* data, size_t begin, size_t end, BND_ArchiveChunk& last)
+{
+  for (size_t pos = begin; pos < end; pos = last.m_end)
+  {
+    if (!BND_ReadArchiveChunk(data, end, pos, last))
+      return false;
+  }
+  return begin < end;
+}
+
+// started is set once bytes go into archive; before that a false return
+// leaves archive untouched for the serial write
+static bool WriteModelParallel(const ONX_Model& model, ON_BinaryArchive& archive, const BND_File3dmWriteOptions& options, int threadCount, bool& started)
+{
+  const int version = options.VersionForWriting();
+  // version 5 annotation records are converted with the archive's
+  // dimension style table, which the block archives do not have
+  if (0 != version && version < 60)
+    return false;
+  if (!BND_ComponentIndicesAreSequential(model) || ON::Endian() != ON::endian::little_endian)
+    return false;
+
+  std::vector<const ON_ModelGeometryComponent*> components;
+  ONX_ModelComponentIterator iterator(model, ON_ModelComponent::Type::ModelGeometry);
+  for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+  {
+    const ON_ModelGeometryComponent* component = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    const ON_Geometry* geometry = component ? component->Geometry(nullptr) : nullptr;
+    // ONX_Model::Write puts lights in a table of their own; records and
+    // objects have to pair up one to one
+    if (nullptr == geometry || ON::light_object == geometry->ObjectType())
+      return false;
+    components.push_back(component);
+  }
+  if (components.empty())
+    return false;
+
+  BND_SkeletonArchive skeleton(version, options.CompressBuffers());
+  skeleton.SetShouldSerializeUserDataDefault(options.SaveUserData());
+  if (!model.Write(skeleton, version) || !skeleton.Complete())
+    return false;
+
+  // whole chunks before and after the table, the last one the end mark
+  // with the 8 byte archive length
+  const unsigned char* data = (const unsigned char*)skeleton.Buffer();
+  const size_t size = (size_t)skeleton.SizeOfArchive();
+  const size_t tableBegin = (size_t)skeleton.m_table_begin;
+  BND_ArchiveChunk last, endOfFile;
+  if (tableBegin > size || !ReadChunkRun(data, ARCHIVE_HEADER_SIZE, tableBegin, last) ||
+    !ReadChunkRun(data, tableBegin, size, endOfFile) ||
+    TCODE_ENDOFFILE != endOfFile.m_tcode || 8 != endOfFile.DataEnd() - endOfFile.m_content)
+    return false;
+
+  // several blocks per thread so one slow object does not hold up the rest
+  const int count = (int)components.size();
+  const int blockCount = std::min(count, threadCount * 8);
+  std::vector<BND_RecordBlock> blocks(blockCount);
+  for (int i = 0; i < blockCount; i++)
+  {
+    blocks[i].m_first = (int)((ON__INT64)count * i / blockCount);
+    blocks[i].m_count = (int)((ON__INT64)count * (i + 1) / blockCount) - blocks[i].m_first;
+  }
+
+  auto put = [&archive](const void* p, size_t n) { return 0 == n || archive.WriteByte(n, p); };
+
+  // Blocks are written to archive in order by whichever thread completes
+  // the next one due. A block is only started once it is within window of
+  // that one, which bounds the finished blocks waiting in memory. Blocks
+  // are claimed in order, so the one due never waits and a thread waiting
+  // for the window always gets to go on.
+  const int window = 2 * threadCount;
+  std::mutex mutex;
+  std::condition_variable advanced;
+  int next = 0;
+  bool failed = false;
+  ON__UINT64 tableHeader = 0;
+  ON__UINT64 tableLength = 0;
+  std::vector<unsigned char> tableTail;
+
+  auto flush = [&]()
+  {
+    for (; !failed && next < blockCount && blocks[next].m_done; next++)
+    {
+      BND_RecordBlock& block = blocks[next];
+      const unsigned char* blockData = (const unsigned char*)block.m_archive->Buffer();
+      const BND_ArchiveChunk& table = block.m_layout.m_object_table;
+      if (!block.m_ok)
+        failed = true;
+      else if (0 == next)
+      {
+        // the table length is filled in once all records are out
+        unsigned char header[CHUNK_HEADER_SIZE] = {};
+        memcpy(header, &table.m_tcode, 4);
+        tableTail.assign(blockData + block.m_layout.m_table_tail, blockData + table.m_end);
+        started = true;
+        failed = !put(data, tableBegin);
+        tableHeader = archive.CurrentPosition();
+        failed = failed || !put(header, CHUNK_HEADER_SIZE);
+      }
+      if (!failed)
+      {
+        const size_t recordsLength = block.m_layout.m_table_tail - table.m_content;
+        tableLength += recordsLength;
+        failed = !put(blockData + table.m_content, recordsLength);
+      }
+      block.m_archive.reset();
+    }
+    advanced.notify_all();
+  };
+
+  // the serial skeleton pass has already filled any lazily cached data
+  // (bounding boxes and the like) that writing an object computes
+  ParallelFor(blockCount, threadCount, [&](int i)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      advanced.wait(lock, [&]() { return failed || i < next + window; });
+      if (failed)
+        return;
+    }
+    const bool ok = WriteBlock(model, components, options, blocks[i]);
+    std::lock_guard<std::mutex> lock(mutex);
+    blocks[i].m_ok = ok;
+    blocks[i].m_done = true;
+    flush();
+  });
+  if (failed || next != blockCount)
+    return false;
+
+  // end of the table, its length, then the rest of the skeleton with the
+  // archive length in the end mark adjusted for the new table
+  tableLength += tableTail.size();
+  if (!put(tableTail.data(), tableTail.size()))
+    return false;
+  const ON__UINT64 tableEnd = archive.CurrentPosition();
+  const ON__INT64 length = (ON__INT64)tableLength;
+  if (!archive.SeekBackward(tableEnd - tableHeader - 4) || !put(&length, 8) || !archive.SeekForward(tableEnd - tableHeader - CHUNK_HEADER_SIZE))
+    return false;
+
+  ON__INT64 archiveLength = 0;
+  memcpy(&archiveLength, data + endOfFile.m_content, 8);
+  archiveLength += (ON__INT64)(CHUNK_HEADER_SIZE + tableLength) - (ON__INT64)(skeleton.m_table_end - skeleton.m_table_begin);
+  return put(data + tableBegin, endOfFile.m_content - tableBegin) &&
+    put(&archiveLength, 8) &&
+    put(data + endOfFile.m_content + 8, endOfFile.m_end - endOfFile.m_content - 8);
+}
+
+bool BND_WriteModel(const ONX_Model& model, ON_BinaryArchive& archive, const BND_File3dmWriteOptions& options)
+{
+  const int threadCount = ParallelThreadCount(options.ThreadCount());
+  if (threadCount > 1)
+  {
+    bool started = false;
+    const bool rc = WriteModelParallel(model, archive, options, threadCount, started);
+    if (started)
+      return rc;
+  }
+
+  SetupArchive(archive, options);
+  return model.Write(archive, options.VersionForWriting());
+}
@@ -0,0 +1,16 @@
+#include "bindings.h"
+
+#pragma once
+
+// Same bytes as ONX_Model::Write(archive, options.VersionForWriting()) with
+// the archive set up from options (user data, buffer compression).
+//
+// With more than one thread ONX_Model::Write first writes everything but
+// the object table into memory; object records it serializes go nowhere,
+// uncompressed. Contiguous blocks of objects are then serialized and
+// compressed into separate buffers on options.ThreadCount() threads and
+// handed to archive in order as they complete, at most a few blocks per
+// thread ahead of the one being written, so peak memory stays at the
+// skeleton plus that window. Models the blocks can not reproduce exactly
+// (lights, indices out of order, version 5) are written serially.
+bool BND_WriteModel(const ONX_Model& model, ON_BinaryArchive& archive, const class BND_File3dmWriteOptions& options);
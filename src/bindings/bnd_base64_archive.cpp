@@ -0,0 +1,128 @@
+#include "bindings.h"
+#include "base64.h"
+
+BND_Base64WriteArchive::BND_Base64WriteArchive(int archive_3dm_version, unsigned int archive_opennurbs_version)
+  : ON_BinaryArchive(ON::archive_mode::write3dm)
+{
+  if (archive_3dm_version > 0)
+    ON_SetBinaryArchiveOpenNURBSVersion(*this, archive_opennurbs_version);
+}
+
+std::string BND_Base64WriteArchive::TakeString()
+{
+  std::string rc;
+  rc.swap(m_encoded);
+  if (m_tail_count > 0)
+  {
+    const size_t at = rc.size();
+    rc.resize(at + 4);
+    base64_encode(m_tail, (size_t)m_tail_count, &rc[at]);
+  }
+  m_tail_count = 0;
+  m_length = 0;
+  m_position = 0;
+  return rc;
+}
+
+bool BND_Base64WriteArchive::AtEnd() const
+{
+  return m_position >= m_length;
+}
+
+bool BND_Base64WriteArchive::Flush()
+{
+  return true;
+}
+
+ON__UINT64 BND_Base64WriteArchive::Internal_CurrentPositionOverride() const
+{
+  return m_position;
+}
+
+bool BND_Base64WriteArchive::Internal_SeekFromCurrentPositionOverride(int byte_offset)
+{
+  if (byte_offset < 0 && (ON__UINT64)(-(ON__INT64)byte_offset) > m_position)
+    return false;
+  m_position = (ON__UINT64)((ON__INT64)m_position + byte_offset);
+  if (m_position > m_length)
+  {
+    // same as ON_Write3dmBufferArchive, seeking past the end extends with zeros
+    const std::vector<unsigned char> zeros((size_t)(m_position - m_length), 0);
+    Append(zeros.data(), zeros.size());
+  }
+  return true;
+}
+
+bool BND_Base64WriteArchive::Internal_SeekToStartOverride()
+{
+  m_position = 0;
+  return true;
+}
+
+size_t BND_Base64WriteArchive::Internal_ReadOverride(size_t, void*)
+{
+  return 0;
+}
+
+size_t BND_Base64WriteArchive::Internal_WriteOverride(size_t count, const void* buffer)
+{
+  const unsigned char* bytes = (const unsigned char*)buffer;
+  size_t done = 0;
+  while (done < count && m_position < m_length)
+    Overwrite(m_position++, bytes[done++]);
+  if (done < count)
+  {
+    Append(bytes + done, count - done);
+    m_position = m_length;
+  }
+  return count;
+}
+
+void BND_Base64WriteArchive::Append(const unsigned char* bytes, size_t count)
+{
+  m_length += count;
+  while (count > 0 && m_tail_count > 0)
+  {
+    m_tail[m_tail_count++] = *bytes++;
+    count--;
+    if (3 == m_tail_count)
+    {
+      const size_t at = m_encoded.size();
+      m_encoded.resize(at + 4);
+      base64_encode(m_tail, 3, &m_encoded[at]);
+      m_tail_count = 0;
+    }
+  }
+
+  const size_t whole = count - count % 3;
+  if (whole > 0)
+  {
+    const size_t at = m_encoded.size();
+    m_encoded.resize(at + base64_encoded_length(whole));
+    base64_encode(bytes, whole, &m_encoded[at]);
+    bytes += whole;
+    count -= whole;
+  }
+
+  while (count > 0)
+  {
+    m_tail[m_tail_count++] = *bytes++;
+    count--;
+  }
+}
+
+void BND_Base64WriteArchive::Overwrite(ON__UINT64 position, unsigned char byte)
+{
+  const size_t group = (size_t)(position / 3);
+  if (4 * group < m_encoded.size())
+  {
+    unsigned char decoded[3];
+    base64_decode(&m_encoded[4 * group], 4, decoded);
+    decoded[position % 3] = byte;
+    base64_encode(decoded, 3, &m_encoded[4 * group]);
+  }
+  else
+  {
+    m_tail[position - 3 * (m_encoded.size() / 4)] = byte;
+  }
+}
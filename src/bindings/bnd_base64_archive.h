@@ -0,0 +1,37 @@
+#include "bindings.h"
+
+#pragma once
+
+// Write-only 3dm archive that keeps nothing but the base64 text of what has
+// been written. Bytes are encoded as they arrive instead of first building
+// the whole binary archive and encoding it in a second pass. Writes that go
+// back into already encoded data (chunk lengths filled in when a chunk ends)
+// decode, patch and re-encode the four characters that hold the byte.
+class BND_Base64WriteArchive : public ON_BinaryArchive
+{
+public:
+  BND_Base64WriteArchive(int archive_3dm_version, unsigned int archive_opennurbs_version);
+
+  // Padded base64 text of the archive; the archive is empty afterwards
+  std::string TakeString();
+
+  bool AtEnd() const override;
+  bool Flush() override;
+
+protected:
+  ON__UINT64 Internal_CurrentPositionOverride() const override;
+  bool Internal_SeekFromCurrentPositionOverride(int byte_offset) override;
+  bool Internal_SeekToStartOverride() override;
+  size_t Internal_ReadOverride(size_t count, void* buffer) override;
+  size_t Internal_WriteOverride(size_t count, const void* buffer) override;
+
+private:
+  void Append(const unsigned char* bytes, size_t count);
+  void Overwrite(ON__UINT64 position, unsigned char byte);
+
+  std::string m_encoded;          // complete 4 character groups
+  unsigned char m_tail[3] = {};   // bytes after the last complete group
+  int m_tail_count = 0;
+  ON__UINT64 m_length = 0;
+  ON__UINT64 m_position = 0;
+};
@@ -5,6 +5,13 @@ BND_Bitmap::BND_Bitmap()
   SetTrackedPointer(new ON_Bitmap(), nullptr);
 }
 
+BND_Bitmap::BND_Bitmap(int width, int height, int bitsPerPixel)
+{
+  ON_WindowsBitmap* bitmap = new ON_WindowsBitmap();
+  bitmap->Create(width, height, bitsPerPixel);
+  SetTrackedPointer(bitmap, nullptr);
+}
+
 BND_Bitmap::BND_Bitmap(ON_Bitmap* bitmap, const ON_ModelComponentReference* compref)
 {
   SetTrackedPointer(bitmap, compref);
@@ -15,19 +22,160 @@ void BND_Bitmap::SetTrackedPointer(ON_Bitmap* bitmap, const ON_ModelComponentRef
   BND_CommonObject::SetTrackedPointer(bitmap, compref);
 }
 
+static int BytesPerPixel(BitmapPixelFormat format)
+{
+  switch (format)
+  {
+  case BitmapPixelFormat::Rgb8:
+    return 3;
+  case BitmapPixelFormat::Gray8:
+    return 1;
+  default:
+    return 4;
+  }
+}
+
+static void StorePixel(unsigned char* dst, BitmapPixelFormat format, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+  switch (format)
+  {
+  case BitmapPixelFormat::Rgba8:
+    dst[0] = r; dst[1] = g; dst[2] = b; dst[3] = a;
+    break;
+  case BitmapPixelFormat::Bgra8:
+    dst[0] = b; dst[1] = g; dst[2] = r; dst[3] = a;
+    break;
+  case BitmapPixelFormat::Rgb8:
+    dst[0] = r; dst[1] = g; dst[2] = b;
+    break;
+  case BitmapPixelFormat::Gray8:
+    // Rec. 601 luma
+    dst[0] = (unsigned char)((299 * r + 587 * g + 114 * b + 500) / 1000);
+    break;
+  }
+}
+
+bool BND_BitmapToPixels(const ON_Bitmap* bitmap, BitmapPixelFormat format, std::vector<unsigned char>& pixels)
+{
+  pixels.clear();
+  const ON_WindowsBitmap* dib = ON_WindowsBitmap::Cast(bitmap);
+  if (nullptr == dib || nullptr == dib->m_bmi || nullptr == dib->Bits(0))
+    return false;
+
+  const int width = dib->Width();
+  const int height = abs(dib->Height());
+  const int bpp = dib->BitsPerPixel();
+  if (width <= 0 || height <= 0)
+    return false;
+
+  // positive biHeight means the first scan line in memory is the bottom row
+  const bool bottomUp = dib->m_bmi->bmiHeader.biHeight > 0;
+  const int pixelSize = BytesPerPixel(format);
+  pixels.resize((size_t)width * height * pixelSize);
+
+  // 32 bit DIBs often leave the fourth byte at zero; only use it as alpha
+  // when some pixel sets it
+  bool useAlpha = false;
+  if (32 == bpp)
+  {
+    for (int row = 0; row < height && !useAlpha; row++)
+    {
+      const unsigned char* scan = dib->Bits(row);
+      for (int col = 0; col < width; col++)
+      {
+        if (scan[4 * col + 3] != 0)
+        {
+          useAlpha = true;
+          break;
+        }
+      }
+    }
+  }
+
+  for (int row = 0; row < height; row++)
+  {
+    const unsigned char* scan = dib->Bits(bottomUp ? height - 1 - row : row);
+    unsigned char* dst = pixels.data() + (size_t)row * width * pixelSize;
+    if (24 == bpp || 32 == bpp)
+    {
+      // DIB pixels are stored blue, green, red(, reserved)
+      const int stride = bpp / 8;
+      for (int col = 0; col < width; col++, scan += stride, dst += pixelSize)
+        StorePixel(dst, format, scan[2], scan[1], scan[0], useAlpha ? scan[3] : 255);
+    }
+    else
+    {
+      // palette and 16 bit formats
+      for (int col = 0; col < width; col++, dst += pixelSize)
+      {
+        const ON_Color c = dib->Pixel(col, scan);
+        StorePixel(dst, format, (unsigned char)c.Red(), (unsigned char)c.Green(), (unsigned char)c.Blue(), 255);
+      }
+    }
+  }
+  return true;
+}
+
+BND_BUFFER BND_Bitmap::ToPixels(BitmapPixelFormat format) const
+{
+  std::vector<unsigned char> pixels;
+  BND_BitmapToPixels(m_bitmap, format, pixels);
+  return CreateBuffer(pixels);
+}
+
+#if defined(ON_WASM_COMPILE)
+emscripten::val BND_Bitmap::Bits() const
+{
+  const unsigned char* bits = m_bitmap->Bits(0);
+  const size_t size = bits ? m_bitmap->SizeofImage() : 0;
+  return emscripten::val(emscripten::typed_memory_view(size, bits));
+}
+#endif
 
 #if defined(ON_PYTHON_COMPILE)
 
 void initBitmapBindings(rh3dmpymodule& m)
 {
+  py::enum_<BitmapPixelFormat>(m, "BitmapPixelFormat")
+    .value("Rgba8", BitmapPixelFormat::Rgba8)
+    .value("Bgra8", BitmapPixelFormat::Bgra8)
+    .value("Rgb8", BitmapPixelFormat::Rgb8)
+    .value("Gray8", BitmapPixelFormat::Gray8)
+    ;
+
+#if defined(NANOBIND) // temp workaround for buffer protocol
   py::class_<BND_Bitmap, BND_CommonObject>(m, "Bitmap")
+#else
+  py::class_<BND_Bitmap, BND_CommonObject>(m, "Bitmap", py::buffer_protocol())
+#endif
     .def(py::init<>())
+    .def(py::init<int, int, int>(), py::arg("width"), py::arg("height"), py::arg("bitsPerPixel")=32)
     .def_property_readonly("Width", &BND_Bitmap::Width)
     .def_property_readonly("Height", &BND_Bitmap::Height)
     .def_property_readonly("BitsPerPixel", &BND_Bitmap::BitsPerPixel)
     .def_property_readonly("SizeOfScan", &BND_Bitmap::SizeOfScan)
     .def_property_readonly("SizeOfImage", &BND_Bitmap::SizeOfImage)
     .def_property_readonly("Id", &BND_Bitmap::GetId)
+    .def("ToPixels", &BND_Bitmap::ToPixels, py::arg("format")=BitmapPixelFormat::Rgba8)
+#if !defined(NANOBIND)
+    // memoryview(bitmap) exposes the DIB scan lines in place
+    .def_buffer([](BND_Bitmap& b) -> py::buffer_info
+      {
+        static unsigned char empty = 0;
+        unsigned char* bits = b.m_bitmap->Bits(0);
+        const py::ssize_t rows = bits ? (py::ssize_t)abs(b.m_bitmap->Height()) : 0;
+        const py::ssize_t scan = bits ? (py::ssize_t)b.m_bitmap->SizeofScan() : 0;
+        return py::buffer_info
+        (
+          bits ? bits : &empty,                            /* Pointer to buffer */
+          sizeof(unsigned char),                           /* Size of one scalar */
+          py::format_descriptor<unsigned char>::format(),  /* Python struct-style format descriptor */
+          2,                                               /* Number of dimensions */
+          {rows, scan},                                    /* Buffer dimensions */
+          {scan, (py::ssize_t)1}                           /* Strides (in bytes) for each index */
+        );
+      })
+#endif
     ;
 }
 #endif
@@ -37,14 +185,24 @@ using namespace emscripten;
 
 void initBitmapBindings(void*)
 {
+  enum_<BitmapPixelFormat>("BitmapPixelFormat")
+    .value("Rgba8", BitmapPixelFormat::Rgba8)
+    .value("Bgra8", BitmapPixelFormat::Bgra8)
+    .value("Rgb8", BitmapPixelFormat::Rgb8)
+    .value("Gray8", BitmapPixelFormat::Gray8)
+    ;
+
   class_<BND_Bitmap, base<BND_CommonObject>>("Bitmap")
     .constructor<>()
+    .constructor<int, int, int>()
     .property("width", &BND_Bitmap::Width)
     .property("height", &BND_Bitmap::Height)
     .property("bitsPerPixel", &BND_Bitmap::BitsPerPixel)
     .property("sizeOfScan", &BND_Bitmap::SizeOfScan)
     .property("sizeOfImage", &BND_Bitmap::SizeOfImage)
     .property("id", &BND_Bitmap::GetId)
+    .function("toPixels", &BND_Bitmap::ToPixels)
+    .function("bits", &BND_Bitmap::Bits)
     ;
 }
 #endif
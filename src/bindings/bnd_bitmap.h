@@ -2,6 +2,14 @@
 
 #pragma once
 
+enum class BitmapPixelFormat : int
+{
+  Rgba8 = 0,
+  Bgra8 = 1,
+  Rgb8 = 2,
+  Gray8 = 3
+};
+
 #if defined(ON_PYTHON_COMPILE)
 void initBitmapBindings(rh3dmpymodule& m);
 #else
@@ -14,6 +22,8 @@ public:
   ON_Bitmap* m_bitmap = nullptr;
 public:
   BND_Bitmap();
+  // Uncompressed Windows DIB of the given size, bottom row first
+  BND_Bitmap(int width, int height, int bitsPerPixel);
   BND_Bitmap(ON_Bitmap* bitmap, const ON_ModelComponentReference* compref);
 
   int Width() const { return m_bitmap->Width(); }
@@ -27,7 +37,19 @@ public:
   //void SetFileReference(const ON_FileReference& file_reference);
   BND_UUID GetId() const { return ON_UUID_to_Binding( m_bitmap->Id()); }
   void SetFileFullPath(std::wstring path) { m_bitmap->SetFileFullPath(path.c_str(), true); }
+  // Pixels converted to format, rows ordered top to bottom. Empty for
+  // bitmaps without uncompressed bits (file references, embedded image files).
+  BND_BUFFER ToPixels(BitmapPixelFormat format) const;
+#if defined(ON_WASM_COMPILE)
+  // View over the DIB bits in wasm memory, no copy. Only valid until the
+  // bitmap is deleted or wasm memory grows.
+  emscripten::val Bits() const;
+#endif
 
 protected:
   void SetTrackedPointer(ON_Bitmap* bitmap, const ON_ModelComponentReference* compref);
-};
\ No newline at end of file
+};
+
+// Converts the uncompressed bits of a Windows DIB bitmap to 8 bit per
+// channel pixels, top row first. Returns false for any other bitmap.
+bool BND_BitmapToPixels(const ON_Bitmap* bitmap, BitmapPixelFormat format, std::vector<unsigned char>& pixels);
@@ -76,7 +76,8 @@ public:
     DIMSTYLE_PROPERTY(double, ToleranceLowerValue)
     DIMSTYLE_PROPERTY(double, ToleranceHeightScale)
     DIMSTYLE_PROPERTY(double, BaselineSpacing)
-    //DIMSTYLE_PROPERTY(double, DimensionScale)
+    double GetDimensionScale() const { return m_dimstyle->DimScale(); }
+    void SetDimensionScale(double scale) { m_dimstyle->SetDimScale(scale); }
     DIMSTYLE_PROPERTY(double, FixedExtensionLen)
     DIMSTYLE_PROPERTY(double, TextRotation)
     DIMSTYLE_PROPERTY(double, StackHeightScale)
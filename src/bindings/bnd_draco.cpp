@@ -29,10 +29,12 @@ BND_Draco* BND_Draco::CompressMesh(const BND_Mesh* m)
   return CompressMesh2(m, defaults);
 }
 
-BND_Draco* BND_Draco::CompressMesh2(const class BND_Mesh* m, const BND_DracoCompressionOptions& compressionOptions)
+bool BND_DracoEncodeTriangles(const BND_DracoTriangles& triangles, const BND_DracoCompressionOptions& compressionOptions, draco::EncoderBuffer& buffer, int attributeIds[4])
 {
-  if (nullptr == m)
-    return nullptr;
+  for (int i = 0; i < 4; i++)
+    attributeIds[i] = -1;
+  if (triangles.m_vertex_count < 1 || nullptr == triangles.m_positions || triangles.m_triangle_count < 1 || nullptr == triangles.m_indices)
+    return false;
 
   BND_DracoCompressionOptions options = compressionOptions;
   if (options.m_compression_level < 0)
@@ -46,154 +48,124 @@ BND_Draco* BND_Draco::CompressMesh2(const class BND_Mesh* m, const BND_DracoComp
   if (options.m_texcoord_quantization_bits > 30)
     options.m_texcoord_quantization_bits = 30;
 
-
-  const ON_Mesh* mesh = m->m_mesh;
-  const int triangleCount = mesh->TriangleCount() + mesh->QuadCount() * 2;
+  const int vertexCount = triangles.m_vertex_count;
   draco::Mesh dracoMesh;
-  dracoMesh.SetNumFaces(triangleCount);
-  dracoMesh.set_num_points(3 * triangleCount);
+  dracoMesh.set_num_points(vertexCount);
+  dracoMesh.SetNumFaces(triangles.m_triangle_count);
 
-  int VERTEX_ATTRIBUTE_POSITION = -1;
-  int NORMAL_ATTRIBUTE_POSITION = -1;
-  int TEXCOORD_ATTRIBUTE_POSITION = -1;
-  int COLOR_ATTRIBUTE_POSITION = -1;
+  const bool normals = options.m_include_normals && triangles.m_normals != nullptr;
+  const bool texcoords = options.m_include_texture_coords && triangles.m_texcoords != nullptr;
+  const bool colors = options.m_include_vertex_colors && triangles.m_colors != nullptr;
+  int attributes[4] = { -1, -1, -1, -1 };
   {
     draco::GeometryAttribute va;
     va.Init(draco::GeometryAttribute::POSITION, nullptr, 3, draco::DT_FLOAT32, false, 3 * sizeof(float), 0);
-    VERTEX_ATTRIBUTE_POSITION = dracoMesh.AddAttribute(va, false, mesh->m_V.UnsignedCount());
-    const ON_3fPoint* vertices = mesh->m_V.Array();
-    for (unsigned int i = 0; i < mesh->m_V.UnsignedCount(); i++)
-    {
-      const ON_3fPoint& vert = vertices[i];
-      dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetAttributeValue(draco::AttributeValueIndex(i), &vert.x);
-    }
+    attributes[0] = dracoMesh.AddAttribute(va, true, vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+      dracoMesh.attribute(attributes[0])->SetAttributeValue(draco::AttributeValueIndex(i), &triangles.m_positions[3 * i]);
   }
-
-  if (options.m_include_normals && mesh->m_N.Count() == mesh->m_V.Count())
+  if (normals)
   {
-    draco::GeometryAttribute normal_attrs;
-    normal_attrs.Init(draco::GeometryAttribute::NORMAL, nullptr, 3, draco::DT_FLOAT32, false, 3 * sizeof(float), 0);
-    NORMAL_ATTRIBUTE_POSITION = dracoMesh.AddAttribute(normal_attrs, false, mesh->m_N.UnsignedCount());
-    const ON_3fVector* normals = mesh->m_N.Array();
-    for (unsigned int i = 0; i < mesh->m_N.UnsignedCount(); i++)
-    {
-      const ON_3fVector& normal = normals[i];
-      dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetAttributeValue(draco::AttributeValueIndex(i), &normal.x);
-    }
+    draco::GeometryAttribute na;
+    na.Init(draco::GeometryAttribute::NORMAL, nullptr, 3, draco::DT_FLOAT32, false, 3 * sizeof(float), 0);
+    attributes[1] = dracoMesh.AddAttribute(na, true, vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+      dracoMesh.attribute(attributes[1])->SetAttributeValue(draco::AttributeValueIndex(i), &triangles.m_normals[3 * i]);
   }
-
-  if (options.m_include_texture_coords && mesh->m_T.Count() == mesh->m_V.Count())
+  if (texcoords)
   {
-    draco::GeometryAttribute tc_attrs;
-    tc_attrs.Init(draco::GeometryAttribute::TEX_COORD, nullptr, 2, draco::DT_FLOAT32, false, 2 * sizeof(float), 0);
-    TEXCOORD_ATTRIBUTE_POSITION = dracoMesh.AddAttribute(tc_attrs, false, mesh->m_T.UnsignedCount());
-    const ON_2fPoint* tcs = mesh->m_T.Array();
-    for (unsigned int i = 0; i < mesh->m_T.UnsignedCount(); i++)
-    {
-      const ON_2fPoint& texcoord = tcs[i];
-      dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetAttributeValue(draco::AttributeValueIndex(i), &texcoord.x);
-    }
+    draco::GeometryAttribute ta;
+    ta.Init(draco::GeometryAttribute::TEX_COORD, nullptr, 2, draco::DT_FLOAT32, false, 2 * sizeof(float), 0);
+    attributes[2] = dracoMesh.AddAttribute(ta, true, vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+      dracoMesh.attribute(attributes[2])->SetAttributeValue(draco::AttributeValueIndex(i), &triangles.m_texcoords[2 * i]);
   }
-
-  if (options.m_include_vertex_colors && mesh->m_C.Count() == mesh->m_V.Count())
+  if (colors)
   {
-    draco::GeometryAttribute color_attrs;
-    color_attrs.Init(draco::GeometryAttribute::COLOR, nullptr, 4, draco::DT_UINT8, false, 4 * sizeof(char), 0);
-    COLOR_ATTRIBUTE_POSITION = dracoMesh.AddAttribute(color_attrs, false, mesh->m_C.UnsignedCount());
-    const ON_Color* colors = mesh->m_C.Array();
-    for (unsigned int i = 0; i < mesh->m_C.UnsignedCount(); i++)
-    {
-      const ON_Color& color = colors[i];
-      char argb[4];
-      argb[0] = 255 - color.Alpha();
-      argb[1] = color.Red();
-      argb[2] = color.Green();
-      argb[3] = color.Blue();
-      dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetAttributeValue(draco::AttributeValueIndex(i), argb);
-    }
+    draco::GeometryAttribute ca;
+    ca.Init(draco::GeometryAttribute::COLOR, nullptr, 4, draco::DT_UINT8, triangles.m_normalized_colors, 4 * sizeof(char), 0);
+    attributes[3] = dracoMesh.AddAttribute(ca, true, vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+      dracoMesh.attribute(attributes[3])->SetAttributeValue(draco::AttributeValueIndex(i), &triangles.m_colors[4 * i]);
   }
 
-  unsigned int currentPointIndex = 0;
-  unsigned int currentNormalIndex = 0;
-  unsigned int currentTCIndex = 0;
-  unsigned int currentColorIndex = 0;
-  const ON_MeshFace* faces = mesh->m_F.Array();
-  for (unsigned int i = 0; i < mesh->m_F.UnsignedCount(); i++)
-  {
-    const ON_MeshFace& face = faces[i];
-    dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentPointIndex++), draco::AttributeValueIndex(face.vi[0]));
-    dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentPointIndex++), draco::AttributeValueIndex(face.vi[1]));
-    dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentPointIndex++), draco::AttributeValueIndex(face.vi[2]));
-    if (face.IsQuad())
-    {
-      dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentPointIndex++), draco::AttributeValueIndex(face.vi[2]));
-      dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentPointIndex++), draco::AttributeValueIndex(face.vi[3]));
-      dracoMesh.attribute(VERTEX_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentPointIndex++), draco::AttributeValueIndex(face.vi[0]));
-    }
-
-    if (NORMAL_ATTRIBUTE_POSITION >= 0)
-    {
-      dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentNormalIndex++), draco::AttributeValueIndex(face.vi[0]));
-      dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentNormalIndex++), draco::AttributeValueIndex(face.vi[1]));
-      dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentNormalIndex++), draco::AttributeValueIndex(face.vi[2]));
-      if (face.IsQuad())
-      {
-        dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentNormalIndex++), draco::AttributeValueIndex(face.vi[2]));
-        dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentNormalIndex++), draco::AttributeValueIndex(face.vi[3]));
-        dracoMesh.attribute(NORMAL_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentNormalIndex++), draco::AttributeValueIndex(face.vi[0]));
-      }
-    }
-
-    if (TEXCOORD_ATTRIBUTE_POSITION >= 0)
-    {
-      dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentTCIndex++), draco::AttributeValueIndex(face.vi[0]));
-      dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentTCIndex++), draco::AttributeValueIndex(face.vi[1]));
-      dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentTCIndex++), draco::AttributeValueIndex(face.vi[2]));
-      if (face.IsQuad())
-      {
-        dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentTCIndex++), draco::AttributeValueIndex(face.vi[2]));
-        dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentTCIndex++), draco::AttributeValueIndex(face.vi[3]));
-        dracoMesh.attribute(TEXCOORD_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentTCIndex++), draco::AttributeValueIndex(face.vi[0]));
-      }
-    }
-
-    if (COLOR_ATTRIBUTE_POSITION >= 0)
-    {
-      dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentColorIndex++), draco::AttributeValueIndex(face.vi[0]));
-      dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentColorIndex++), draco::AttributeValueIndex(face.vi[1]));
-      dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentColorIndex++), draco::AttributeValueIndex(face.vi[2]));
-      if (face.IsQuad())
-      {
-        dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentColorIndex++), draco::AttributeValueIndex(face.vi[2]));
-        dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentColorIndex++), draco::AttributeValueIndex(face.vi[3]));
-        dracoMesh.attribute(COLOR_ATTRIBUTE_POSITION)->SetPointMapEntry(draco::PointIndex(currentColorIndex++), draco::AttributeValueIndex(face.vi[0]));
-      }
-    }
-  }
-
-  // Add faces with identity mapping between vertex and corner indices.
-  // Duplicate vertices will get removed later.
-  for (int i = 0; i < triangleCount; i++)
+  for (int i = 0; i < triangles.m_triangle_count; i++)
   {
     draco::Mesh::Face face;
     for (int c = 0; c < 3; ++c)
-      face[c] = 3 * i + c;
+      face[c] = triangles.m_indices[3 * i + c];
     dracoMesh.SetFace(draco::FaceIndex(i), face);
   }
 
   draco::Encoder encoder;
   if (options.m_position_quantization_bits > 0)
     encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, options.m_position_quantization_bits);
-  if (options.m_include_normals && options.m_normals_quantization_bits > 0)
+  if (normals && options.m_normals_quantization_bits > 0)
     encoder.SetAttributeQuantization(draco::GeometryAttribute::NORMAL, options.m_normals_quantization_bits);
-  if (options.m_include_texture_coords && options.m_texcoord_quantization_bits > 0)
+  if (texcoords && options.m_texcoord_quantization_bits > 0)
     encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD, options.m_texcoord_quantization_bits);
   const int speed = 10 - options.m_compression_level;
   encoder.SetSpeedOptions(speed, speed);
 
+  if (!encoder.EncodeMeshToBuffer(dracoMesh, &buffer).ok())
+    return false;
+  for (int i = 0; i < 4; i++)
+    attributeIds[i] = attributes[i] >= 0 ? (int)dracoMesh.attribute(attributes[i])->unique_id() : -1;
+  return true;
+}
+
+BND_Draco* BND_Draco::CompressMesh2(const class BND_Mesh* m, const BND_DracoCompressionOptions& options)
+{
+  if (nullptr == m)
+    return nullptr;
+
+  const ON_Mesh* mesh = m->m_mesh;
+  const int vertexCount = mesh->m_V.Count();
+  BND_DracoTriangles triangles;
+  triangles.m_vertex_count = vertexCount;
+  triangles.m_positions = vertexCount > 0 ? &mesh->m_V.Array()->x : nullptr;
+  if (vertexCount > 0 && mesh->m_N.Count() == vertexCount)
+    triangles.m_normals = &mesh->m_N.Array()->x;
+  if (vertexCount > 0 && mesh->m_T.Count() == vertexCount)
+    triangles.m_texcoords = &mesh->m_T.Array()->x;
+
+  std::vector<unsigned char> argb;
+  if (vertexCount > 0 && mesh->m_C.Count() == vertexCount && options.m_include_vertex_colors)
+  {
+    argb.resize(4 * (size_t)vertexCount);
+    const ON_Color* colors = mesh->m_C.Array();
+    for (int i = 0; i < vertexCount; i++)
+    {
+      argb[4 * i + 0] = (unsigned char)(255 - colors[i].Alpha());
+      argb[4 * i + 1] = (unsigned char)colors[i].Red();
+      argb[4 * i + 2] = (unsigned char)colors[i].Green();
+      argb[4 * i + 3] = (unsigned char)colors[i].Blue();
+    }
+    triangles.m_colors = argb.data();
+  }
+
+  std::vector<unsigned int> indices;
+  indices.reserve(3 * (size_t)(mesh->TriangleCount() + 2 * mesh->QuadCount()));
+  const ON_MeshFace* faces = mesh->m_F.Array();
+  for (unsigned int i = 0; i < mesh->m_F.UnsignedCount(); i++)
+  {
+    const ON_MeshFace& face = faces[i];
+    indices.push_back((unsigned int)face.vi[0]);
+    indices.push_back((unsigned int)face.vi[1]);
+    indices.push_back((unsigned int)face.vi[2]);
+    if (face.IsQuad())
+    {
+      indices.push_back((unsigned int)face.vi[2]);
+      indices.push_back((unsigned int)face.vi[3]);
+      indices.push_back((unsigned int)face.vi[0]);
+    }
+  }
+  triangles.m_triangle_count = (int)(indices.size() / 3);
+  triangles.m_indices = indices.data();
+
   BND_Draco* rc = new BND_Draco();
-  draco::Status compressResult = encoder.EncodeMeshToBuffer(dracoMesh, rc->m_encoder_buffer);
-  if (!compressResult.ok())
+  int attributeIds[4];
+  if (!BND_DracoEncodeTriangles(triangles, options, *rc->m_encoder_buffer, attributeIds))
   {
     delete rc;
     rc = nullptr;
@@ -25,6 +25,25 @@ public:
   bool m_include_vertex_colors = true;
 };
 
+// Packed vertex attributes for BND_DracoEncodeTriangles. Every array holds
+// m_vertex_count tuples; optional arrays are left null when missing.
+struct BND_DracoTriangles
+{
+  int m_vertex_count = 0;
+  const float* m_positions = nullptr;       // xyz
+  const float* m_normals = nullptr;         // xyz
+  const float* m_texcoords = nullptr;       // uv
+  const unsigned char* m_colors = nullptr;  // four bytes, order chosen by the caller
+  bool m_normalized_colors = false;
+  int m_triangle_count = 0;
+  const unsigned int* m_indices = nullptr;  // three vertex indices per triangle
+};
+
+// Encode triangles with one draco point per vertex, applying the attribute
+// selection, quantization and speed of options. attributeIds receives the
+// draco unique ids of position, normal, texcoord and color (-1 when left out).
+bool BND_DracoEncodeTriangles(const BND_DracoTriangles& triangles, const BND_DracoCompressionOptions& options, draco::EncoderBuffer& buffer, int attributeIds[4]);
+
 class BND_Draco
 {
   class draco::EncoderBuffer* m_encoder_buffer;
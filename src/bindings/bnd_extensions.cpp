@@ -1,8 +1,14 @@
 #include "bindings.h"
 #include "base64.h"
+#include "bnd_archive_passthrough.h"
+#include "bnd_archive_writer.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <map>
 
 // TODO: Move some of this functionality into core opennurbs
-static bool SeekPastCompressedBuffer(ON_BinaryArchive& archive)
+static bool SeekPastCompressedBuffer(ON_BinaryArchive& archive, size_t* sizeof_buffer = nullptr)
 {
   if (!archive.ReadMode())
     return false;
@@ -14,6 +20,8 @@ static bool SeekPastCompressedBuffer(ON_BinaryArchive& archive)
   size_t sizeof__outbuffer;
   if (!archive.ReadCompressedBufferSize(&sizeof__outbuffer))
     return false;
+  if (sizeof_buffer)
+    *sizeof_buffer = sizeof__outbuffer;
 
   if (0 == sizeof__outbuffer)
     return true;
@@ -46,9 +54,59 @@ static bool SeekPastCompressedBuffer(ON_BinaryArchive& archive)
   return rc;
 }
 
+// Where each RDK embedded file lives inside the RDK document user data.
+// Built once per model so lookups don't re-parse the RDK XML and every
+// compressed buffer in front of the requested one.
+class BND_EmbeddedFileIndex
+{
+public:
+  struct Entry
+  {
+    ON_wString m_path;
+    ON_wString m_filename;
+    ON__UINT64 m_offset = 0; // start of the compressed buffer in the user data
+    size_t m_size = 0;       // uncompressed size
+    ON__UINT64 m_stored = 0; // bytes the compressed buffer takes in the user data
+  };
+
+  bool Build(const ONX_Model& model);
+  // Same matching as GetEmbeddedFileAsBase64: the first entry whose path
+  // matches, ignoring case unless strict, or whose file name matches when
+  // not strict. Returns -1 when nothing matches.
+  int Find(const wchar_t* path, bool strict) const;
+  bool Read(int index, std::vector<unsigned char>& bytes) const;
+  // the RDK document user data the entries point into, nullptr when none
+  const ONX_Model_UserData* UserData() const { return m_docud; }
+
+  std::vector<Entry> m_entries;
+
+private:
+  bool Build(const ONX_Model_UserData& docud);
+
+  const ONX_Model_UserData* m_docud = nullptr;
+  std::map<std::wstring, int> m_paths;
+  std::map<std::wstring, int> m_lower_paths;
+  std::map<std::wstring, int> m_lower_filenames;
+};
+
+static std::wstring LowerOrdinal(const ON_wString& s)
+{
+  return std::wstring(s.MapStringOrdinal(ON_StringMapOrdinalType::LowerOrdinal).Array());
+}
+
+bool BND_EmbeddedFileIndex::Build(const ONX_Model& model)
+{
+  const ON_SimpleArray<ONX_Model_UserData*>& userdata_table = model.m_userdata_table;
+  for (int i = 0; i < userdata_table.Count(); i++)
+  {
+    const ONX_Model_UserData* ud = userdata_table[i];
+    if (ud && Build(*ud))
+      return true;
+  }
+  return false;
+}
 
-static bool GetRDKEmbeddedFileHelper(ONX_Model_UserData& docud, ON_ClassArray<ON_wString>& paths,
-  const wchar_t* specificPath, ON_SimpleArray<unsigned char>* pathBuffer, bool strictSearch)
+bool BND_EmbeddedFileIndex::Build(const ONX_Model_UserData& docud)
 {
   if (!ONX_Model::IsRDKDocumentInformation(docud))
     return false;
@@ -62,69 +120,120 @@ static bool GetRDKEmbeddedFileHelper(ONX_Model_UserData& docud, ON_ClassArray<ON
   if (4 != version)
     return false;
 
-  //Read out the document data, and throw it away.
+  //Skip the document data
   {
     int slen = 0;
     if (!a.ReadInt(&slen))
-      return 0;
+      return false;
     if (slen <= 0)
-      return 0;
+      return false;
     if (slen + 4 > docud.m_goo.m_value)
-      return 0;
-    ON_String s;
-    s.SetLength(slen);
-    if (!a.ReadChar(slen, s.Array()))
-      return 0;
+      return false;
+    if (!a.SeekForward((size_t)slen))
+      return false;
   }
 
   unsigned int iCount = 0;
   if (!a.ReadInt(&iCount))
     return false;
 
-  ON_SimpleArray<unsigned char> buffer;
-  ON_wString searchFilename;
-  if (specificPath && pathBuffer)
-    ON_FileSystemPath::SplitPath(specificPath, nullptr, nullptr, &searchFilename);
-
-  int path_count = 0;
+  std::vector<Entry> entries;
   for (unsigned int i = 0; i < iCount; i++)
   {
-    ON_wString sPath;
-    if (!a.ReadString(sPath))
+    Entry entry;
+    if (!a.ReadString(entry.m_path))
       return false;
+    entry.m_offset = a.CurrentPosition();
+    if (!SeekPastCompressedBuffer(a, &entry.m_size))
+      break;
+    entry.m_stored = a.CurrentPosition() - entry.m_offset;
+    ON_FileSystemPath::SplitPath(entry.m_path, nullptr, nullptr, &entry.m_filename);
+    entries.push_back(entry);
+  }
+  if (entries.empty())
+    return false;
 
-    if (specificPath && pathBuffer)
-    {
-      bool pathMatch = sPath.EqualOrdinal(specificPath, !strictSearch);
-      if (!pathMatch && !strictSearch)
-      {
-        ON_wString filename;
-        ON_FileSystemPath::SplitPath(sPath, nullptr, nullptr, &filename);
-        pathMatch = filename.EqualOrdinal(searchFilename, true);
-      }
-      if (pathMatch)
-      {
-        size_t size;
-        if (!a.ReadCompressedBufferSize(&size))
-          return false;
+  m_docud = &docud;
+  m_entries.swap(entries);
+  for (int i = 0; i < (int)m_entries.size(); i++)
+  {
+    m_paths.emplace(std::wstring(m_entries[i].m_path.Array()), i);
+    m_lower_paths.emplace(LowerOrdinal(m_entries[i].m_path), i);
+    m_lower_filenames.emplace(LowerOrdinal(m_entries[i].m_filename), i);
+  }
+  return true;
+}
+
+int BND_EmbeddedFileIndex::Find(const wchar_t* path, bool strict) const
+{
+  if (nullptr == path)
+    return -1;
+  if (strict)
+  {
+    auto it = m_paths.find(path);
+    return it == m_paths.end() ? -1 : it->second;
+  }
 
-        bool bFailedCRC = false;
-        pathBuffer->Reserve(size);
-        if (!a.ReadCompressedBuffer(size, pathBuffer->Array(), &bFailedCRC))
-          return false;
+  int rc = -1;
+  auto it = m_lower_paths.find(LowerOrdinal(path));
+  if (it != m_lower_paths.end())
+    rc = it->second;
 
-        pathBuffer->SetCount((int)size);
-        return true;
-      }
-    }
+  ON_wString filename;
+  ON_FileSystemPath::SplitPath(path, nullptr, nullptr, &filename);
+  it = m_lower_filenames.find(LowerOrdinal(filename));
+  if (it != m_lower_filenames.end() && (rc < 0 || it->second < rc))
+    rc = it->second;
+  return rc;
+}
+
+// Safe to call from several threads at once, each call reads through its
+// own archive over the shared user data.
+bool BND_EmbeddedFileIndex::Read(int index, std::vector<unsigned char>& bytes) const
+{
+  bytes.clear();
+  if (nullptr == m_docud || index < 0 || index >= (int)m_entries.size())
+    return false;
+
+  const ONX_Model_UserData& docud = *m_docud;
+  ON_Read3dmBufferArchive a(docud.m_goo.m_value, docud.m_goo.m_goo, false, docud.m_usertable_3dm_version, docud.m_usertable_opennurbs_version);
+  if (!a.SeekFromStart(m_entries[index].m_offset))
+    return false;
+
+  size_t size = 0;
+  if (!a.ReadCompressedBufferSize(&size))
+    return false;
+  if (0 == size)
+    return true;
 
-    SeekPastCompressedBuffer(a);
+  bytes.resize(size);
+  bool bFailedCRC = false;
+  if (!a.ReadCompressedBuffer(size, bytes.data(), &bFailedCRC))
+  {
+    bytes.clear();
+    return false;
+  }
+  return true;
+}
 
-    paths.Append(sPath);
-    path_count++;
+const BND_EmbeddedFileIndex& BND_ONXModel::EmbeddedFileIndex() const
+{
+  if (!m_embedded_file_index)
+  {
+    m_embedded_file_index = std::make_shared<BND_EmbeddedFileIndex>();
+    m_embedded_file_index->Build(*m_model);
   }
+  return *m_embedded_file_index;
+}
 
-  return path_count > 0;
+static bool WriteBytesToFile(const std::wstring& path, const std::vector<unsigned char>& bytes)
+{
+  FILE* fp = ON::OpenFile(path.c_str(), L"wb");
+  if (nullptr == fp)
+    return false;
+  const bool rc = bytes.empty() || fwrite(bytes.data(), 1, bytes.size(), fp) == bytes.size();
+  ON::CloseFile(fp);
+  return rc;
 }
 
 std::string BND_ONXModel::GetEmbeddedFileAsBase64(std::wstring path)
@@ -134,20 +243,82 @@ std::string BND_ONXModel::GetEmbeddedFileAsBase64(std::wstring path)
 
 std::string BND_ONXModel::GetEmbeddedFileAsBase64Strict(std::wstring path, bool strict)
 {
-  ON_ClassArray<ON_wString> paths;
-  ON_SimpleArray<ONX_Model_UserData*>& userdata_table = m_model->m_userdata_table;
-  ON_SimpleArray<unsigned char> buffer;
-  for (int i = 0; i < userdata_table.Count(); i++)
+  const BND_EmbeddedFileIndex& index = EmbeddedFileIndex();
+  std::vector<unsigned char> buffer;
+  index.Read(index.Find(path.c_str(), strict), buffer);
+
+  std::string rc;
+  if (buffer.size() > 0)
   {
-    ONX_Model_UserData* ud = userdata_table[i];
-    if (ud && GetRDKEmbeddedFileHelper(*ud, paths, path.c_str(), &buffer, strict))
-      break;
+    rc = base64_encode(buffer.data(), (unsigned int)buffer.size());
   }
+  return rc;
+}
 
-  std::string rc;
-  if (buffer.Count() > 0)
+#if defined(ON_PYTHON_COMPILE)
+py::bytes BND_ONXModel::GetEmbeddedFileBytes(std::wstring path, bool strict) const
+{
+  const BND_EmbeddedFileIndex& index = EmbeddedFileIndex();
+  std::vector<unsigned char> buffer;
+  index.Read(index.Find(path.c_str(), strict), buffer);
+  return py::bytes((const char*)buffer.data(), buffer.size());
+}
+#else
+emscripten::val BND_ONXModel::GetEmbeddedFileBytes(std::wstring path, bool strict) const
+{
+  const BND_EmbeddedFileIndex& index = EmbeddedFileIndex();
+  std::vector<unsigned char> buffer;
+  index.Read(index.Find(path.c_str(), strict), buffer);
+  emscripten::val Uint8Array = emscripten::val::global("Uint8Array");
+  return Uint8Array.new_(emscripten::typed_memory_view(buffer.size(), buffer.data()));
+}
+#endif
+
+bool BND_ONXModel::ExtractEmbeddedFile(std::wstring path, std::wstring filename) const
+{
+  const BND_EmbeddedFileIndex& index = EmbeddedFileIndex();
+  std::vector<unsigned char> buffer;
+  if (!index.Read(index.Find(path.c_str(), false), buffer))
+    return false;
+  return WriteBytesToFile(filename, buffer);
+}
+
+std::vector<std::wstring> BND_ONXModel::ExtractAllEmbeddedFiles(std::wstring directory, int threadCount) const
+{
+  const BND_EmbeddedFileIndex& index = EmbeddedFileIndex();
+  const int count = (int)index.m_entries.size();
+
+  // destination names are picked up front, files with the same name from
+  // different source folders get " (2)", " (3)" ... appended
+  std::vector<std::wstring> destinations(count);
+  std::map<std::wstring, int> used;
+  for (int i = 0; i < count; i++)
+  {
+    const ON_wString& filename = index.m_entries[i].m_filename;
+    ON_wString name = filename;
+    int& uses = used[LowerOrdinal(filename)];
+    if (uses++ > 0)
+    {
+      ON_wString stem, ext;
+      ON_FileSystemPath::SplitPath(filename, nullptr, nullptr, &stem, &ext);
+      name.Format(L"%ls (%d)%ls", static_cast<const wchar_t*>(stem), uses, static_cast<const wchar_t*>(ext));
+    }
+    destinations[i] = std::wstring(ON_FileSystemPath::CombinePaths(directory.c_str(), false, name, true, false).Array());
+  }
+
+  std::vector<char> written(count, 0);
+  ParallelFor(count, ParallelThreadCount(threadCount), [&](int i)
+  {
+    std::vector<unsigned char> buffer;
+    if (index.Read(i, buffer) && WriteBytesToFile(destinations[i], buffer))
+      written[i] = 1;
+  });
+
+  std::vector<std::wstring> rc;
+  for (int i = 0; i < count; i++)
   {
-    rc = base64_encode(buffer.Array(), buffer.UnsignedCount());
+    if (written[i])
+      rc.push_back(destinations[i]);
   }
   return rc;
 }
@@ -220,12 +391,104 @@ void BND_ONXModel::Destroy()
 BND_ONXModel* BND_ONXModel::Read(std::wstring path)
 {
   ONX_Model* m = new ONX_Model();
-  if (!m->Read(path.c_str()))
+  bool read = false;
+  mapped_file file;
+  if (file.open(path.c_str()))
+  {
+    // parse straight out of the OS file cache; pages are shared with any
+    // other process reading the same file
+    ON_Read3dmBufferArchive archive(file.size(), file.data(), false, 0, 0);
+    archive.SetArchiveFullPath(path.c_str());
+    read = m->Read(archive);
+  }
+  else
+    read = m->Read(path.c_str());
+  if (!read)
   {
     delete m;
     return nullptr;
   }
-  return new BND_ONXModel(m);
+  BND_ONXModel* rc = new BND_ONXModel(m);
+  rc->m_passthrough = BND_ArchivePassthrough::Create(*m, path.c_str());
+  return rc;
+}
+
+template <class T>
+static BND_TUPLE ResultWithReport(const T& result, const BND_DICT& report)
+{
+#if defined(ON_PYTHON_COMPILE) && defined(NANOBIND)
+  return py::make_tuple(result, report);
+#else
+  BND_TUPLE rc = CreateTuple(2);
+  SetTuple(rc, 0, result);
+  SetTuple(rc, 1, report);
+  return rc;
+#endif
+}
+
+static BND_TUPLE ModelWithReport(ONX_Model* model, bool success, const BND_ArchiveProfile& profile, const ON_wString& errorLog, int slowestCount)
+{
+  BND_DICT report = profile.ToDict("read", success, model, errorLog, slowestCount);
+  BND_ONXModel* rc = nullptr;
+  if (success)
+    rc = new BND_ONXModel(model);
+  else
+    delete model;
+#if defined(ON_PYTHON_COMPILE) && defined(NANOBIND)
+  if (nullptr == rc)
+    return ResultWithReport(py::object(py::none()), report);
+  return ResultWithReport(py::cast(rc, py::rv_policy::take_ownership), report);
+#else
+  return ResultWithReport(rc, report);
+#endif
+}
+
+BND_TUPLE BND_ONXModel::ReadWithProfile(std::wstring path, int slowestCount)
+{
+  ON_wString errors;
+  ON_TextLog log(errors);
+  ONX_Model* model = new ONX_Model();
+  FILE* fp = ON::OpenFile(path.c_str(), L"rb");
+  if (nullptr == fp)
+  {
+    log.Print(L"Unable to open %ls\n", path.c_str());
+    BND_ArchiveProfile empty;
+    empty.Start();
+    empty.Finish();
+    return ModelWithReport(model, false, empty, errors, slowestCount);
+  }
+
+  BND_ProfilingArchive<ON_BinaryFile> archive(ON::archive_mode::read3dm, fp);
+  archive.SetArchiveFullPath(path.c_str());
+  const bool rc = BND_ProfiledModelRead(*model, archive, archive.m_profile, &log);
+  ON::CloseFile(fp);
+  return ModelWithReport(model, rc, archive.m_profile, errors, slowestCount);
+}
+
+BND_TUPLE BND_ONXModel::WriteWithProfile(std::wstring path, int version)
+{
+  ON_wString errors;
+  ON_TextLog log(errors);
+  bool rc = false;
+  BND_ArchiveProfile profile;
+  FILE* fp = ON::OpenFile(path.c_str(), L"wb");
+  if (fp)
+  {
+    BND_ProfilingArchive<ON_BinaryFile> archive(ON::archive_mode::write3dm, fp);
+    archive.SetArchiveFullPath(path.c_str());
+    archive.m_profile.Start();
+    rc = m_model->Write(archive, version, &log);
+    archive.m_profile.Finish();
+    profile = archive.m_profile;
+    ON::CloseFile(fp);
+  }
+  else
+  {
+    log.Print(L"Unable to open %ls\n", path.c_str());
+    profile.Start();
+    profile.Finish();
+  }
+  return ResultWithReport(rc, profile.ToDict("write", rc, m_model.get(), errors, 0));
 }
 
 std::string BND_ONXModel::ReadNotes(std::wstring path)
@@ -274,9 +537,32 @@ int BND_ONXModel::ReadArchiveVersion(std::wstring path)
 
 bool BND_ONXModel::Write(std::wstring path, int version)
 {
+  if (m_passthrough && m_passthrough->Write(*m_model, path.c_str(), version))
+    return true;
   return m_model->Write(path.c_str(), version);
 }
 
+bool BND_ONXModel::Write2(std::wstring path, const BND_File3dmWriteOptions* options)
+{
+  BND_File3dmWriteOptions defaults;
+  if (nullptr == options)
+    options = &defaults;
+
+  // reused records keep the compression and user data they were read with
+  if (options->CompressBuffers() && options->SaveUserData() &&
+    m_passthrough && m_passthrough->Write(*m_model, path.c_str(), options->VersionForWriting()))
+    return true;
+
+  FILE* fp = ON::OpenFile(path.c_str(), L"wb");
+  if (nullptr == fp)
+    return false;
+  ON_BinaryFile archive(ON::archive_mode::write3dm, fp);
+  archive.SetArchiveFullPath(path.c_str());
+  const bool rc = BND_WriteModel(*m_model, archive, *options);
+  ON::CloseFile(fp);
+  return rc;
+}
+
 std::wstring BND_ONXModel::GetStartSectionComments() const
 {
   ON_wString comments = m_model->m_sStartSectionComments;
@@ -620,9 +906,11 @@ BND_UUID BND_ONXModel_ObjectTable::Add(const BND_GeometryBase* geometry, const B
 
 BND_UUID BND_ONXModel_ObjectTable::AddObject(const class BND_FileObject* object)
 {
-  const ON_Geometry* g = object ? object->m_geometry->GeometryPointer() : nullptr;
-  ON_UUID rc = Internal_ONX_Model_AddModelGeometry(m_model.get(), g, object->m_attributes);
-  return ON_UUID_to_Binding(rc);
+  const ON_ModelGeometryComponent* component = object ? ON_ModelGeometryComponent::Cast(object->m_compref.ModelComponent()) : nullptr;
+  if (nullptr == component)
+    return ON_UUID_to_Binding(ON_nil_uuid);
+  ON_ModelComponentReference compref = m_model->AddModelGeometryComponent(component->Geometry(nullptr), component->Attributes(nullptr));
+  return ON_UUID_to_Binding(ON_ModelGeometryComponent::FromModelComponentRef(compref, &ON_ModelGeometryComponent::Unset)->Id());
 }
 
 BND_UUID BND_ONXModel_ObjectTable::AddInstanceObject1(const class BND_InstanceReferenceGeometry* instanceReference)
@@ -673,12 +961,14 @@ BND_UUID BND_ONXModel_ObjectTable::AddInstanceObject4(int idefIndex, const class
 void BND_ONXModel_ObjectTable::Delete(BND_UUID id)
 {
   ON_UUID _id = Binding_to_ON_UUID(id);
+  m_index->Invalidate();
   m_model->RemoveModelComponent(ON_ModelComponent::Type::ModelGeometry, _id);
 }
 
 void BND_ONXModel_ObjectTable::Delete2(std::string id)
 {
   ON_UUID _id = ON_UuidFromString(id.c_str());
+  m_index->Invalidate();
   m_model->RemoveModelComponent(ON_ModelComponent::Type::ModelGeometry, _id);
 }
 
@@ -689,30 +979,87 @@ int BND_ONXModel_ObjectTable::Count() const
   return count;
 }
 
-static BND_FileObject* FileObjectFromCompRef(ON_ModelComponentReference& compref)
+BND_FileObject* BND_FileObject::FromCompRef(const ON_ModelComponentReference& compref)
 {
-  BND_GeometryBase* geometry = dynamic_cast<BND_GeometryBase*>(BND_CommonObject::CreateWrapper(compref));
-  if (nullptr == geometry)
+  // every ON_Geometry gets at least a GeometryBase wrapper, so this is
+  // all GetGeometry and GetAttributes can fail on
+  const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+  if (nullptr == geometryComponent || nullptr == geometryComponent->Geometry(nullptr) || nullptr == geometryComponent->Attributes(nullptr))
     return nullptr;
+  return new BND_FileObject(compref);
+}
 
-  const ON_ModelComponent* model_component = compref.ModelComponent();
-  const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(model_component);
-  if (nullptr == geometryComponent)
+#if defined(ON_PYTHON_COMPILE)
+BND_FileObject::~BND_FileObject()
+{
+  delete m_geometry;
+  delete m_attributes;
+}
+#endif
+
+BND_GeometryBase* BND_FileObject::GetGeometry()
+{
+  if (nullptr == m_geometry)
+    m_geometry = dynamic_cast<BND_GeometryBase*>(BND_CommonObject::CreateWrapper(m_compref));
+  // the geometry can be edited in place from here on, so a later save has
+  // to serialize it instead of reusing the bytes it was read from
+  BND_ArchivePassthrough::MarkExposed(m_compref.ModelComponent());
+  return m_geometry;
+}
+
+BND_3dmObjectAttributes* BND_FileObject::GetAttributes()
+{
+  if (nullptr == m_attributes)
   {
-    delete geometry;
-    return nullptr;
+    const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(m_compref.ModelComponent());
+    ON_3dmObjectAttributes* attrs = geometryComponent ? const_cast<ON_3dmObjectAttributes*>(geometryComponent->Attributes(nullptr)) : nullptr;
+    if (attrs)
+      m_attributes = new BND_3dmObjectAttributes(attrs, &m_compref);
   }
+  return m_attributes;
+}
 
-  ON_3dmObjectAttributes* attrs = const_cast<ON_3dmObjectAttributes*>(geometryComponent->Attributes(nullptr));
-  if (nullptr == attrs)
+void BND_ObjectIndexCache::Update(const ONX_Model& model)
+{
+  // objects added anywhere (object table, instance definition geometry)
+  // change the count; deletes invalidate explicitly since a delete and an
+  // add leave it unchanged
+  const int count = model.ActiveComponentCount(ON_ModelComponent::Type::ModelGeometry) +
+    model.ActiveAndDeletedComponentCount(ON_ModelComponent::Type::RenderLight);
+  if (m_valid && count == m_count)
+    return;
+
+  m_comprefs.Empty();
+  m_comprefs.Reserve(count);
+  const ON_ModelComponent::Type types[] = { ON_ModelComponent::Type::ModelGeometry, ON_ModelComponent::Type::RenderLight };
+  for (ON_ModelComponent::Type type : types)
   {
-    delete geometry;
-    return nullptr;
+    ONX_ModelComponentIterator iterator(model, type);
+    for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+      m_comprefs.Append(compref);
   }
-  BND_FileObject* rc = new BND_FileObject();
-  rc->m_attributes = new BND_3dmObjectAttributes(attrs, &compref);
-  rc->m_geometry = geometry;
-  return rc;
+  m_count = count;
+  m_valid = true;
+}
+
+const ON_ModelComponentReference* BND_ObjectIndexCache::At(const ONX_Model& model, int index)
+{
+  Update(model);
+  if (index < 0 || index >= m_comprefs.Count())
+    return nullptr;
+  return &m_comprefs[index];
+}
+
+int BND_ObjectIndexCache::Count(const ONX_Model& model)
+{
+  Update(model);
+  return m_comprefs.Count();
+}
+
+BND_ONXModel_ObjectTable::BND_ONXModel_ObjectTable(std::shared_ptr<ONX_Model> m, std::shared_ptr<BND_ObjectIndexCache> index)
+{
+  m_model = m;
+  m_index = index ? index : std::make_shared<BND_ObjectIndexCache>();
 }
 
 BND_FileObject* BND_ONXModel_ObjectTable::ModelObjectAt(int index)
@@ -722,38 +1069,17 @@ BND_FileObject* BND_ONXModel_ObjectTable::ModelObjectAt(int index)
     return nullptr;
 #endif
 
-  if (0 == index)
-    m_compref_cache.Empty(); // clear cache every time we restart counting
-
-  if (m_compref_cache.Count() == 0)
-  {
-    m_compref_cache.Reserve(Count());
-    ONX_ModelComponentIterator iterator(*m_model.get(), ON_ModelComponent::Type::ModelGeometry);
-    ON_ModelComponentReference compref = iterator.FirstComponentReference();
-    while (!compref.IsEmpty())
-    {
-      m_compref_cache.Append(compref);
-      compref = iterator.NextComponentReference();
-    }
-
-    ONX_ModelComponentIterator iterator2(*m_model.get(), ON_ModelComponent::Type::RenderLight);
-    compref = iterator2.FirstComponentReference();
-    while (!compref.IsEmpty())
-    {
-      m_compref_cache.Append(compref);
-      compref = iterator2.NextComponentReference();
-    }
-  }
-
 #if defined(ON_PYTHON_COMPILE)
   if (index < 0)
-    index = m_compref_cache.Count() + index < 0 ? std::abs(index) : m_compref_cache.Count() + index;
-#endif
-
-  if (index < m_compref_cache.Count())
   {
-    return FileObjectFromCompRef(m_compref_cache[index]);
+    const int count = m_index->Count(*m_model);
+    index = count + index < 0 ? std::abs(index) : count + index;
   }
+#endif
+
+  const ON_ModelComponentReference* compref = m_index->At(*m_model, index);
+  if (compref)
+    return BND_FileObject::FromCompRef(*compref);
 
 #if defined(ON_PYTHON_COMPILE)
   throw py::index_error();
@@ -779,23 +1105,7 @@ BND_FileObject* BND_ONXModel_ObjectTable::FindId(BND_UUID id) const
 	ON_ModelComponentReference compref = m_model->ComponentFromId(ON_ModelComponent::Type::ModelGeometry, _id);
 	if (compref.IsEmpty())
 		return nullptr;
-
-	const ON_ModelComponent* model_component = compref.ModelComponent();
-	const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(model_component);
-	if (nullptr == geometryComponent)
-		return nullptr;
-
-	BND_GeometryBase* geometry = dynamic_cast<BND_GeometryBase*>(BND_CommonObject::CreateWrapper(compref));
-	if (nullptr == geometry)
-		return nullptr;
-	ON_3dmObjectAttributes* attrs = const_cast<ON_3dmObjectAttributes*>(geometryComponent->Attributes(nullptr));
-	if (nullptr == attrs)
-		return nullptr;
-
-	BND_FileObject* rc = new BND_FileObject();
-	rc->m_attributes = new BND_3dmObjectAttributes(attrs, &compref);
-	rc->m_geometry = geometry;
-	return rc;
+	return BND_FileObject::FromCompRef(compref);
 }
 
 int BND_File3dmMaterialTable::Add(const BND_Material& material)
@@ -1012,6 +1322,37 @@ BND_Bitmap* BND_File3dmBitmapTable::FindId(BND_UUID id)
   return nullptr;
 }
 
+BND_LIST BND_File3dmBitmapTable::ToPixels(BitmapPixelFormat format, int threadCount) const
+{
+  const int count = m_model->ActiveComponentCount(ON_ModelComponent::Type::Image);
+  std::vector<ON_ModelComponentReference> comprefs(count);
+  for (int i = 0; i < count; i++)
+    comprefs[i] = m_model->ImageFromIndex(i);
+
+  std::vector<std::vector<unsigned char>> pixels(count);
+  std::vector<char> converted(count, 0);
+  ParallelFor(count, ParallelThreadCount(threadCount), [&](int i)
+  {
+    const ON_Bitmap* bitmap = ON_Bitmap::Cast(comprefs[i].ModelComponent());
+    converted[i] = BND_BitmapToPixels(bitmap, format, pixels[i]) ? 1 : 0;
+  });
+
+#if defined(ON_PYTHON_COMPILE)
+  BND_LIST rc;
+#else
+  BND_LIST rc = emscripten::val::array();
+#endif
+  for (int i = 0; i < count; i++)
+  {
+#if defined(ON_PYTHON_COMPILE)
+    Append(rc, converted[i] ? CreateBuffer(pixels[i]) : py::object(py::none()));
+#else
+    Append(rc, converted[i] ? CreateBuffer(pixels[i]) : emscripten::val::null());
+#endif
+  }
+  return rc;
+}
+
 int BND_File3dmLayerTable::Add(const BND_Layer& layer)
 {
   const ON_Layer* l = layer.m_layer;
@@ -1152,13 +1493,9 @@ BND_TUPLE BND_File3dmGroupTable::GroupMembers(int groupIndex)
       const ON_3dmObjectAttributes* attrs = geometryComponent->Attributes(nullptr);
       if (attrs && attrs->IsInGroup(groupIndex))
       {
-        BND_GeometryBase* geometry = dynamic_cast<BND_GeometryBase*>(BND_CommonObject::CreateWrapper(compref));
-        if (geometry)
-        {
-          BND_FileObject* rc = FileObjectFromCompRef(compref);
-          if (rc)
-            fileObjects.Append(rc);
-        }
+        BND_FileObject* rc = BND_FileObject::FromCompRef(compref);
+        if (rc)
+          fileObjects.Append(rc);
       }
     }
     compref = iterator.NextComponentReference();
@@ -1186,13 +1523,9 @@ std::vector<BND_FileObject*> BND_File3dmGroupTable::GroupMembers2(int groupIndex
       const ON_3dmObjectAttributes* attrs = geometryComponent->Attributes(nullptr);
       if (attrs && attrs->IsInGroup(groupIndex))
       {
-        BND_GeometryBase* geometry = dynamic_cast<BND_GeometryBase*>(BND_CommonObject::CreateWrapper(compref));
-        if (geometry)
-        {
-          BND_FileObject* rc = FileObjectFromCompRef(compref);
-          if (rc)
-            fileObjects.Append(rc);
-        }
+        BND_FileObject* rc = BND_FileObject::FromCompRef(compref);
+        if (rc)
+          fileObjects.Append(rc);
       }
     }
     compref = iterator.NextComponentReference();
@@ -1594,15 +1927,9 @@ std::string BND_ONXModel::Encode2(const BND_File3dmWriteOptions* options)
   if (nullptr == options)
     options = &defaults;
 
-  ON_Write3dmBufferArchive archive(0, 0, options->VersionForWriting(), ON::Version());
-  archive.SetShouldSerializeUserDataDefault(options->SaveUserData());
-
-  m_model->Write(archive, options->VersionForWriting());
-  const unsigned char* buffer = (const unsigned char*)archive.Buffer();
-  size_t length = archive.SizeOfArchive();
-
-  std::string rc = base64_encode(buffer, (unsigned int)length);
-  return rc;
+  BND_Base64WriteArchive archive(options->VersionForWriting(), ON::Version());
+  BND_WriteModel(*m_model, archive, *options);
+  return archive.TakeString();
 }
 
 
@@ -1619,9 +1946,7 @@ emscripten::val BND_ONXModel::ToByteArray2(const BND_File3dmWriteOptions* option
     options = &defaults;
 
   ON_Write3dmBufferArchive archive(0, 0, options->VersionForWriting(), ON::Version());
-  archive.SetShouldSerializeUserDataDefault(options->SaveUserData());
-
-  m_model->Write(archive, options->VersionForWriting());
+  BND_WriteModel(*m_model, archive, *options);
   const unsigned char* buffer = (const unsigned char*)archive.Buffer();
   size_t length = archive.SizeOfArchive();
 
@@ -1634,7 +1959,8 @@ emscripten::val BND_ONXModel::ToByteArray2(const BND_File3dmWriteOptions* option
 
 BND_ONXModel* BND_ONXModel::FromByteArray(int length, const void* buffer)
 {
-  ON_Read3dmBufferArchive archive(length, buffer, true, 0, 0);
+  // the caller's buffer outlives the read, no need for the archive to copy it
+  ON_Read3dmBufferArchive archive(length, buffer, false, 0, 0);
 
   ONX_Model* model = new ONX_Model();
   if (!model->Read(archive)) {
@@ -1644,12 +1970,50 @@ BND_ONXModel* BND_ONXModel::FromByteArray(int length, const void* buffer)
   return new BND_ONXModel(model);
 }
 
+BND_TUPLE BND_ONXModel::FromByteArrayWithProfile(int length, const void* buffer, int slowestCount)
+{
+  ON_wString errors;
+  ON_TextLog log(errors);
+  ONX_Model* model = new ONX_Model();
+  BND_ProfilingArchive<ON_Read3dmBufferArchive> archive(length, buffer, false, 0, 0);
+  const bool rc = BND_ProfiledModelRead(*model, archive, archive.m_profile, &log);
+  return ModelWithReport(model, rc, archive.m_profile, errors, slowestCount);
+}
+
+#if defined(ON_WASM_COMPILE)
+BND_TUPLE BND_ONXModel::WasmFromByteArrayWithProfile(std::string sbuffer, int slowestCount)
+{
+  return FromByteArrayWithProfile((int)sbuffer.length(), sbuffer.c_str(), slowestCount);
+}
+
+BND_TUPLE BND_ONXModel::ToByteArrayWithProfile(const BND_File3dmWriteOptions* options) const
+{
+  BND_File3dmWriteOptions defaults;
+  if (nullptr == options)
+    options = &defaults;
+
+  ON_wString errors;
+  ON_TextLog log(errors);
+  BND_ProfilingArchive<ON_Write3dmBufferArchive> archive(0, 0, options->VersionForWriting(), ON::Version());
+  archive.SetShouldSerializeUserDataDefault(options->SaveUserData());
+  archive.SetUseBufferCompression(options->CompressBuffers());
+  archive.m_profile.Start();
+  const bool rc = m_model->Write(archive, options->VersionForWriting(), &log);
+  archive.m_profile.Finish();
+
+  emscripten::val Uint8Array = emscripten::val::global("Uint8Array");
+  emscripten::val bytes = Uint8Array.new_(emscripten::typed_memory_view(archive.SizeOfArchive(), (const unsigned char*)archive.Buffer()));
+  return ResultWithReport(bytes, archive.m_profile.ToDict("write", rc, m_model.get(), errors, 0));
+}
+#endif
+
 BND_ONXModel* BND_ONXModel::Decode(std::string buffer)
 {
-  std::string decoded = base64_decode(buffer);
-  int length = (int)decoded.length();
-  const unsigned char* c = (const unsigned char*)&decoded.at(0);
-  return FromByteArray(length, c);
+  std::vector<unsigned char> decoded(base64_decoded_max_length(buffer.length()));
+  const size_t length = base64_decode(buffer.data(), buffer.length(), decoded.data());
+  if (0 == length)
+    return nullptr;
+  return FromByteArray((int)length, decoded.data());
 }
 
 std::wstring BND_ONXModel::RdkXml() const
@@ -1669,6 +2033,264 @@ std::wstring BND_ONXModel::RdkXml() const
   return rc;
 }
 
+static void AddUserDataSize(const ON_Object* object, int& count, ON__UINT64& bytes)
+{
+  for (const ON_UserData* ud = object ? object->FirstUserData() : nullptr; ud; ud = ud->Next())
+  {
+    count++;
+    bytes += ud->SizeOf();
+  }
+}
+
+static void AddRenderMeshSize(const ON_Geometry* geometry, int& count, ON__UINT64& bytes)
+{
+  const ON_Brep* brep = ON_Brep::Cast(geometry);
+  if (brep)
+  {
+    for (int fi = 0; fi < brep->m_F.Count(); fi++)
+    {
+      const ON_Mesh* mesh = brep->m_F[fi].Mesh(ON::render_mesh);
+      if (mesh)
+      {
+        count++;
+        bytes += mesh->SizeOf();
+      }
+    }
+  }
+  const ON_Extrusion* extrusion = ON_Extrusion::Cast(geometry);
+  const ON_Mesh* mesh = extrusion ? extrusion->Mesh(ON::render_mesh) : nullptr;
+  if (mesh)
+  {
+    count++;
+    bytes += mesh->SizeOf();
+  }
+}
+
+static BND_DICT CountAndBytes(int count, ON__UINT64 bytes)
+{
+  BND_DICT rc = CreateDict();
+  SetDictItem(rc, "count", count);
+  SetDictItem(rc, "bytes", bytes);
+  return rc;
+}
+
+// Walks every component once and reads ON_Object::SizeOf() in place.
+// Render meshes and user data are reported on their own and subtracted
+// from the object they belong to, so each byte is counted once.
+BND_DICT BND_ONXModel::MemoryReport(int largestCount) const
+{
+  struct ObjectSize
+  {
+    ON_UUID m_id;
+    const char* m_class_name;
+    ON__UINT64 m_bytes;
+    ON__UINT64 m_render_mesh_bytes;
+    ON__UINT64 m_user_data_bytes;
+  };
+
+  static const std::pair<ON_ModelComponent::Type, const char*> tableTypes[] =
+  {
+    { ON_ModelComponent::Type::Image, "bitmaps" },
+    { ON_ModelComponent::Type::TextureMapping, "textureMappings" },
+    { ON_ModelComponent::Type::RenderMaterial, "materials" },
+    { ON_ModelComponent::Type::LinePattern, "linetypes" },
+    { ON_ModelComponent::Type::Layer, "layers" },
+    { ON_ModelComponent::Type::Group, "groups" },
+    { ON_ModelComponent::Type::TextStyle, "textStyles" },
+    { ON_ModelComponent::Type::DimStyle, "dimStyles" },
+    { ON_ModelComponent::Type::RenderLight, "lights" },
+    { ON_ModelComponent::Type::HatchPattern, "hatchPatterns" },
+    { ON_ModelComponent::Type::InstanceDefinition, "instanceDefinitions" },
+    { ON_ModelComponent::Type::HistoryRecord, "historyRecords" },
+  };
+
+  ON__UINT64 total = 0;
+  int userDataCount = 0;
+  ON__UINT64 userDataBytes = 0;
+
+  BND_DICT tables = CreateDict();
+  for (const auto& tableType : tableTypes)
+  {
+    int count = 0;
+    ON__UINT64 bytes = 0;
+    ONX_ModelComponentIterator iterator(*m_model.get(), tableType.first);
+    for (const ON_ModelComponent* component = iterator.FirstComponent(); component; component = iterator.NextComponent())
+    {
+      ON__UINT64 componentUserData = 0;
+      AddUserDataSize(component, userDataCount, componentUserData);
+      const ON__UINT64 size = component->SizeOf();
+      bytes += size > componentUserData ? size - componentUserData : 0;
+      userDataBytes += componentUserData;
+      count++;
+    }
+    total += bytes;
+    SetDictItem(tables, tableType.second, CountAndBytes(count, bytes));
+  }
+
+  int renderMeshCount = 0;
+  ON__UINT64 renderMeshBytes = 0;
+  ON__UINT64 objectTableBytes = 0;
+  std::vector<ObjectSize> objects;
+  std::map<std::string, std::pair<int, ON__UINT64>> objectTypes;
+  ONX_ModelComponentIterator iterator(*m_model.get(), ON_ModelComponent::Type::ModelGeometry);
+  for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+  {
+    const ON_ModelGeometryComponent* component = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    if (nullptr == component)
+      continue;
+    const ON_Geometry* geometry = component->Geometry(nullptr);
+    const ON_3dmObjectAttributes* attributes = component->Attributes(nullptr);
+
+    ObjectSize item = { compref.ModelComponentId(), geometry ? geometry->ClassId()->ClassName() : "unknown", 0, 0, 0 };
+    AddRenderMeshSize(geometry, renderMeshCount, item.m_render_mesh_bytes);
+    AddUserDataSize(geometry, userDataCount, item.m_user_data_bytes);
+    AddUserDataSize(attributes, userDataCount, item.m_user_data_bytes);
+    const ON__UINT64 size = (ON__UINT64)component->SizeOf()
+      + (geometry ? geometry->SizeOf() : 0)
+      + (attributes ? attributes->SizeOf() : 0);
+    const ON__UINT64 brokenOut = item.m_render_mesh_bytes + item.m_user_data_bytes;
+    item.m_bytes = size > brokenOut ? size - brokenOut : 0;
+
+    renderMeshBytes += item.m_render_mesh_bytes;
+    userDataBytes += item.m_user_data_bytes;
+    objectTableBytes += item.m_bytes;
+    std::pair<int, ON__UINT64>& typeTotal = objectTypes[item.m_class_name];
+    typeTotal.first++;
+    typeTotal.second += item.m_bytes;
+    objects.push_back(item);
+  }
+  total += objectTableBytes + renderMeshBytes + userDataBytes;
+  SetDictItem(tables, "objects", CountAndBytes((int)objects.size(), objectTableBytes));
+
+  BND_DICT types = CreateDict();
+  for (const auto& typeTotal : objectTypes)
+    SetDictItem(types, typeTotal.first.c_str(), CountAndBytes(typeTotal.second.first, typeTotal.second.second));
+
+  int embeddedFileCount = 0;
+  ON__UINT64 embeddedFileBytes = 0;
+  ONX_ModelComponentIterator fileIterator(*m_model.get(), ON_ModelComponent::Type::EmbeddedFile);
+  for (const ON_ModelComponent* component = fileIterator.FirstComponent(); component; component = fileIterator.NextComponent())
+  {
+    const ON_EmbeddedFile* ef = ON_EmbeddedFile::Cast(component);
+    if (ef)
+    {
+      // the component plus the decompressed contents it keeps in a buffer
+      // of its own, which ON_ModelComponent::SizeOf does not see
+      embeddedFileCount++;
+      embeddedFileBytes += (ON__UINT64)ef->SizeOf() + ef->Length();
+    }
+  }
+
+  // RDK embedded files (texture bitmaps and the like) are stored inside the
+  // RDK document user data; they count here and not as user data
+  const BND_EmbeddedFileIndex& rdkFiles = EmbeddedFileIndex();
+  ON__UINT64 rdkFileBytes = 0;
+  for (const BND_EmbeddedFileIndex::Entry& entry : rdkFiles.m_entries)
+  {
+    embeddedFileCount++;
+    rdkFileBytes += entry.m_stored;
+  }
+  embeddedFileBytes += rdkFileBytes;
+  total += embeddedFileBytes;
+
+  // document level plug-in data, including the RDK document XML
+  int documentUserDataCount = 0;
+  ON__UINT64 documentUserDataBytes = 0;
+  for (int i = 0; i < m_model->m_userdata_table.Count(); i++)
+  {
+    const ONX_Model_UserData* ud = m_model->m_userdata_table[i];
+    if (ud)
+    {
+      ON__UINT64 bytes = sizeof(*ud) + (ud->m_goo.m_value > 0 ? ud->m_goo.m_value : 0);
+      if (ud == rdkFiles.UserData())
+        bytes -= rdkFileBytes;
+      documentUserDataCount++;
+      documentUserDataBytes += bytes;
+    }
+  }
+  total += documentUserDataBytes;
+
+  const size_t keep = std::min(objects.size(), (size_t)std::max(largestCount, 0));
+  std::partial_sort(objects.begin(), objects.begin() + keep, objects.end(), [](const ObjectSize& a, const ObjectSize& b)
+  {
+    return a.m_bytes + a.m_render_mesh_bytes + a.m_user_data_bytes > b.m_bytes + b.m_render_mesh_bytes + b.m_user_data_bytes;
+  });
+#if defined(ON_PYTHON_COMPILE)
+  BND_LIST largest;
+#else
+  BND_LIST largest = emscripten::val::array();
+#endif
+  for (size_t i = 0; i < keep; i++)
+  {
+    BND_DICT entry = CreateDict();
+    SetDictItem(entry, "id", ON_UUID_to_Binding(objects[i].m_id));
+    SetDictItem(entry, "type", std::string(objects[i].m_class_name));
+    SetDictItem(entry, "bytes", objects[i].m_bytes);
+    SetDictItem(entry, "renderMeshBytes", objects[i].m_render_mesh_bytes);
+    SetDictItem(entry, "userDataBytes", objects[i].m_user_data_bytes);
+    Append(largest, entry);
+  }
+
+  BND_DICT rc = CreateDict();
+  SetDictItem(rc, "totalBytes", total);
+  SetDictItem(rc, "tables", tables);
+  SetDictItem(rc, "objectTypes", types);
+  SetDictItem(rc, "renderMeshes", CountAndBytes(renderMeshCount, renderMeshBytes));
+  SetDictItem(rc, "userData", CountAndBytes(userDataCount, userDataBytes));
+  SetDictItem(rc, "documentUserData", CountAndBytes(documentUserDataCount, documentUserDataBytes));
+  SetDictItem(rc, "embeddedFiles", CountAndBytes(embeddedFileCount, embeddedFileBytes));
+  SetDictItem(rc, "largestObjects", largest);
+  return rc;
+}
+
+#if defined(ON_PYTHON_COMPILE)
+py::bytes BND_ONXModel::ToGlb() const
+{
+  return ToGlb2(nullptr);
+}
+
+py::bytes BND_ONXModel::ToGlb2(const BND_File3dmGlbOptions* options) const
+{
+  BND_File3dmGlbOptions defaults;
+  std::string glb;
+  BND_WriteGlb(*m_model, options ? *options : defaults, [&glb](const void* data, size_t count) {
+    glb.append((const char*)data, count);
+    return true;
+  });
+  return py::bytes(glb.data(), glb.size());
+}
+#else
+emscripten::val BND_ONXModel::ToGlb() const
+{
+  return ToGlb2(nullptr);
+}
+
+emscripten::val BND_ONXModel::ToGlb2(const BND_File3dmGlbOptions* options) const
+{
+  BND_File3dmGlbOptions defaults;
+  std::string glb;
+  BND_WriteGlb(*m_model, options ? *options : defaults, [&glb](const void* data, size_t count) {
+    glb.append((const char*)data, count);
+    return true;
+  });
+  emscripten::val Uint8Array = emscripten::val::global("Uint8Array");
+  return Uint8Array.new_(emscripten::typed_memory_view(glb.size(), (const unsigned char*)glb.data()));
+}
+#endif
+
+bool BND_ONXModel::WriteGlb(std::wstring path, const BND_File3dmGlbOptions* options) const
+{
+  FILE* fp = ON::OpenFile(path.c_str(), L"wb");
+  if (nullptr == fp)
+    return false;
+  BND_File3dmGlbOptions defaults;
+  const bool rc = BND_WriteGlb(*m_model, options ? *options : defaults, [fp](const void* data, size_t count) {
+    return count == 0 || fwrite(data, 1, count, fp) == count;
+  });
+  ON::CloseFile(fp);
+  return rc;
+}
+
 bool BND_ONXModel::ReadTest(std::wstring path)
 {
   ONX_ModelTest modeltest;
@@ -1871,6 +2493,7 @@ void initExtensionsBindings(rh3dmpymodule& m)
     .def("Add", &BND_File3dmBitmapTable::Add, py::arg("bitmap"))
     .def("Delete", &BND_File3dmBitmapTable::Delete, py::arg("id"))
     .def("FindIndex", &BND_File3dmBitmapTable::FindIndex, py::arg("index"))
+    .def("ToPixels", &BND_File3dmBitmapTable::ToPixels, py::arg("format")=BitmapPixelFormat::Rgba8, py::arg("threadCount")=0)
     .def("FindId", &BND_File3dmBitmapTable::FindId, py::arg("id"))
     ;
 
@@ -1976,6 +2599,8 @@ void initExtensionsBindings(rh3dmpymodule& m)
     .def(py::init<>())
     .def_property("Version", &BND_File3dmWriteOptions::GetVersion, &BND_File3dmWriteOptions::SetVersion)
     .def_property("SaveUserData", &BND_File3dmWriteOptions::SaveUserData, &BND_File3dmWriteOptions::SetSaveUserData)
+    .def_property("CompressBuffers", &BND_File3dmWriteOptions::CompressBuffers, &BND_File3dmWriteOptions::SetCompressBuffers)
+    .def_property("ThreadCount", &BND_File3dmWriteOptions::ThreadCount, &BND_File3dmWriteOptions::SetThreadCount)
     ;
 
   py::class_<PyBNDIterator<BND_File3dmEmbeddedFileTable&, BND_File3dmEmbeddedFile*> >(m, "__EmbeddedFileIterator")
@@ -2082,8 +2707,15 @@ void initExtensionsBindings(rh3dmpymodule& m)
       py::buffer_info info = b.request();
       return BND_ONXModel::FromByteArray(static_cast<int>(info.size), info.ptr);
     })
+    .def_static("FromByteArrayWithProfile", [](py::buffer b, int slowestCount) {
+      py::buffer_info info = b.request();
+      return BND_ONXModel::FromByteArrayWithProfile(static_cast<int>(info.size), info.ptr, slowestCount);
+    }, py::arg("buffer"), py::arg("slowestCount")=10)
  #endif
+    .def_static("ReadWithProfile", &BND_ONXModel::ReadWithProfile, py::arg("path"), py::arg("slowestCount")=10)
     .def("Write", &BND_ONXModel::Write, py::arg("path"), py::arg("version")=0)
+    .def("Write", &BND_ONXModel::Write2, py::arg("path"), py::arg("options"))
+    .def("WriteWithProfile", &BND_ONXModel::WriteWithProfile, py::arg("path"), py::arg("version")=0)
     .def_property("StartSectionComments", &BND_ONXModel::GetStartSectionComments, &BND_ONXModel::SetStartSectionComments)
     .def_property("ApplicationName", &BND_ONXModel::GetApplicationName, &BND_ONXModel::SetApplicationName)
     .def_property("ApplicationUrl", &BND_ONXModel::GetApplicationUrl, &BND_ONXModel::SetApplicationUrl)
@@ -2116,7 +2748,14 @@ void initExtensionsBindings(rh3dmpymodule& m)
     .def("EmbeddedFilePaths2", &BND_ONXModel::GetEmbeddedFilePaths2)
     .def("GetEmbeddedFileAsBase64", &BND_ONXModel::GetEmbeddedFileAsBase64)
     .def("GetEmbeddedFileAsBase64", &BND_ONXModel::GetEmbeddedFileAsBase64Strict)
+    .def("GetEmbeddedFileBytes", &BND_ONXModel::GetEmbeddedFileBytes, py::arg("path"), py::arg("strict")=false)
+    .def("ExtractEmbeddedFile", &BND_ONXModel::ExtractEmbeddedFile, py::arg("path"), py::arg("filename"))
+    .def("ExtractAllEmbeddedFiles", &BND_ONXModel::ExtractAllEmbeddedFiles, py::arg("directory"), py::arg("threadCount")=0)
     .def("RdkXml", &BND_ONXModel::RdkXml)
+    .def("MemoryReport", &BND_ONXModel::MemoryReport, py::arg("largestCount")=10)
+    .def("ToGlb", &BND_ONXModel::ToGlb)
+    .def("ToGlb", &BND_ONXModel::ToGlb2, py::arg("options"))
+    .def("WriteGlb", &BND_ONXModel::WriteGlb, py::arg("path"), py::arg("options"))
     ;
 }
 
@@ -2201,6 +2840,7 @@ void initExtensionsBindings(void*)
     .function("delete", &BND_File3dmBitmapTable::Delete)
     .function("findIndex", &BND_File3dmBitmapTable::FindIndex, allow_raw_pointers())
     .function("findId", &BND_File3dmBitmapTable::FindId, allow_raw_pointers())
+    .function("toPixels", &BND_File3dmBitmapTable::ToPixels)
     ;
 
   class_<BND_File3dmLayerTable>("File3dmLayerTable")
@@ -2264,6 +2904,8 @@ void initExtensionsBindings(void*)
     .constructor<>()
     .property("version", &BND_File3dmWriteOptions::GetVersion, &BND_File3dmWriteOptions::SetVersion)
     .property("saveUserData", &BND_File3dmWriteOptions::SaveUserData, &BND_File3dmWriteOptions::SetSaveUserData)
+    .property("compressBuffers", &BND_File3dmWriteOptions::CompressBuffers, &BND_File3dmWriteOptions::SetCompressBuffers)
+    .property("threadCount", &BND_File3dmWriteOptions::ThreadCount, &BND_File3dmWriteOptions::SetThreadCount)
     ;
 
   class_<BND_File3dmEmbeddedFileTable>("File3dmEmbeddedFileTable")
@@ -2320,6 +2962,7 @@ void initExtensionsBindings(void*)
     .constructor<>()
     .function("destroy", &BND_ONXModel::Destroy)
     .class_function("fromByteArray", &BND_ONXModel::WasmFromByteArray, allow_raw_pointers())
+    .class_function("fromByteArrayWithProfile", &BND_ONXModel::WasmFromByteArrayWithProfile)
     .property("startSectionComments", &BND_ONXModel::GetStartSectionComments, &BND_ONXModel::SetStartSectionComments)
     .property("applicationName", &BND_ONXModel::GetApplicationName, &BND_ONXModel::SetApplicationName)
     .property("applicationUrl", &BND_ONXModel::GetApplicationUrl, &BND_ONXModel::SetApplicationUrl)
@@ -2349,11 +2992,16 @@ void initExtensionsBindings(void*)
     .function("encodeOptions", &BND_ONXModel::Encode2, allow_raw_pointers())
     .function("toByteArray", &BND_ONXModel::ToByteArray)
     .function("toByteArrayOptions", &BND_ONXModel::ToByteArray2, allow_raw_pointers())
+    .function("toByteArrayWithProfile", &BND_ONXModel::ToByteArrayWithProfile, allow_raw_pointers())
     .class_function("decode", &BND_ONXModel::Decode, allow_raw_pointers())
     .function("embeddedFilePaths", &BND_ONXModel::GetEmbeddedFilePaths)
     .function("getEmbeddedFileAsBase64", &BND_ONXModel::GetEmbeddedFileAsBase64)
     .function("getEmbeddedFileAsBase64Strict", &BND_ONXModel::GetEmbeddedFileAsBase64Strict)
+    .function("getEmbeddedFileBytes", &BND_ONXModel::GetEmbeddedFileBytes)
     .function("rdkXml", &BND_ONXModel::RdkXml)
+    .function("memoryReport", &BND_ONXModel::MemoryReport)
+    .function("toGlb", &BND_ONXModel::ToGlb)
+    .function("toGlbOptions", &BND_ONXModel::ToGlb2, allow_raw_pointers())
     ;
 }
 #endif
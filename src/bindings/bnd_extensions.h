@@ -13,21 +13,53 @@ class BND_FileObject
 {
   //std::shared_ptr<ONX_Model> m_model;
 public:
-  //BND_FileObject() = default;
+  BND_FileObject() = default;
+  BND_FileObject(const ON_ModelComponentReference& compref) : m_compref(compref) {}
+#if defined(ON_PYTHON_COMPILE)
+  // python only hands out the wrappers as references into this object
+  ~BND_FileObject();
+  BND_FileObject(const BND_FileObject&) = delete;
+  BND_FileObject& operator=(const BND_FileObject&) = delete;
+#endif
   //BND_FileObject(std::shared_ptr<ONX_Model> m) { m_model = m; }
+  ON_ModelComponentReference m_compref;
+
+  // wrappers are created the first time they are asked for, so walking the
+  // table only costs this object
+  BND_GeometryBase* GetGeometry();
+  BND_3dmObjectAttributes* GetAttributes();
+  //BND_TUPLE GetTextureMapping( const class BND_File3dm* file3dm, int mappingId );
+
+  // nullptr when compref is not a model object with geometry and attributes
+  static BND_FileObject* FromCompRef(const ON_ModelComponentReference& compref);
+
+private:
   class BND_GeometryBase* m_geometry = nullptr;
   class BND_3dmObjectAttributes* m_attributes = nullptr;
+};
 
-  BND_GeometryBase* GetGeometry() { return m_geometry; };
-  BND_3dmObjectAttributes* GetAttributes() { return m_attributes; }
-  //BND_TUPLE GetTextureMapping( const class BND_File3dm* file3dm, int mappingId );
+// Model objects followed by lights in table order. Shared by every object
+// table handed out for a model and only rebuilt after an Add or Delete.
+class BND_ObjectIndexCache
+{
+public:
+  const ON_ModelComponentReference* At(const ONX_Model& model, int index);
+  int Count(const ONX_Model& model);
+  void Invalidate() { m_valid = false; }
+
+private:
+  void Update(const ONX_Model& model);
+  ON_ClassArray<ON_ModelComponentReference> m_comprefs;
+  int m_count = 0;
+  bool m_valid = false;
 };
 
 class BND_ONXModel_ObjectTable
 {
   std::shared_ptr<ONX_Model> m_model;
+  std::shared_ptr<BND_ObjectIndexCache> m_index;
 public:
-  BND_ONXModel_ObjectTable(std::shared_ptr<ONX_Model> m) { m_model = m; }
+  BND_ONXModel_ObjectTable(std::shared_ptr<ONX_Model> m, std::shared_ptr<BND_ObjectIndexCache> index = nullptr);
   BND_UUID AddPoint1(double x, double y, double z);
   BND_UUID AddPoint6(double x, double y, double z, const class BND_3dmObjectAttributes* attributes);
   BND_UUID AddPoint2(const ON_3dPoint& point) { return AddPoint1(point.x, point.y, point.z); }
@@ -99,8 +131,6 @@ public:
   BND_FileObject* IterIndex(int index); // helper function for iterator
   BND_BoundingBox GetBoundingBox() const;
   BND_FileObject* FindId(BND_UUID id) const;
-
-  ON_ClassArray<ON_ModelComponentReference> m_compref_cache;
 };
 
 class BND_File3dmMaterialTable
@@ -150,6 +180,9 @@ public:
   class BND_Bitmap* FindIndex(int index);
   class BND_Bitmap* IterIndex(int index); // helper function for iterator
   class BND_Bitmap* FindId(BND_UUID id);
+  // Every bitmap converted with BND_BitmapToPixels on threadCount threads,
+  // in table order; None/null for bitmaps without uncompressed bits
+  BND_LIST ToPixels(BitmapPixelFormat format, int threadCount) const;
 };
 
 class BND_File3dmLayerTable
@@ -276,6 +309,12 @@ class BND_ONXModel
 {
 public:
   std::shared_ptr<ONX_Model> m_model;
+private:
+  mutable std::shared_ptr<class BND_EmbeddedFileIndex> m_embedded_file_index;
+  const class BND_EmbeddedFileIndex& EmbeddedFileIndex() const;
+  // set by Read(path) so Write can reuse unmodified object records
+  std::shared_ptr<class BND_ArchivePassthrough> m_passthrough;
+  std::shared_ptr<BND_ObjectIndexCache> m_object_index = std::make_shared<BND_ObjectIndexCache>();
 public:
   BND_ONXModel();
   BND_ONXModel(ONX_Model* m);
@@ -284,6 +323,8 @@ public:
   //public static File3dm Read(string path, TableTypeFilter tableTypeFilterFilter, ObjectTypeFilter objectTypeFilter)
   //public static File3dm ReadWithLog(string path, TableTypeFilter tableTypeFilterFilter, ObjectTypeFilter objectTypeFilter, out string errorLog)
   //public static File3dm ReadWithLog(string path, out string errorLog)
+  // Profiled variants return (File3dm or None, report dict); see BND_ArchiveProfile::ToDict
+  static BND_TUPLE ReadWithProfile(std::wstring path, int slowestCount);
   static std::string ReadNotes(std::wstring path);
   static int ReadArchiveVersion(std::wstring path);
   //public static bool ReadRevisionHistory(string path, out string createdBy, out string lastEditedBy, out int revision, out DateTime createdOn, out DateTime lastEditedOn)
@@ -299,11 +340,17 @@ public:
   std::string Encode2(const class BND_File3dmWriteOptions* options);
 
   static BND_ONXModel* FromByteArray(int length, const void* buffer);
+  static BND_TUPLE FromByteArrayWithProfile(int length, const void* buffer, int slowestCount);
+#if defined(ON_WASM_COMPILE)
+  static BND_TUPLE WasmFromByteArrayWithProfile(std::string buffer, int slowestCount);
+  BND_TUPLE ToByteArrayWithProfile(const class BND_File3dmWriteOptions* options) const;
+#endif
   static BND_ONXModel* Decode(std::string buffer);
   bool Write(std::wstring path, int version);
-  //public bool Write(string path, File3dmWriteOptions options)
+  bool Write2(std::wstring path, const class BND_File3dmWriteOptions* options);
   //public bool WriteWithLog(string path, int version, out string errorLog)
   //public bool WriteWithLog(string path, File3dmWriteOptions options, out string errorLog)
+  BND_TUPLE WriteWithProfile(std::wstring path, int version);
 
   std::wstring GetStartSectionComments() const;
   void SetStartSectionComments(std::wstring comments);
@@ -324,7 +371,7 @@ public:
   BND_File3dmSettings Settings() { return BND_File3dmSettings(m_model); }
   //public ManifestTable Manifest | get;
 
-  BND_ONXModel_ObjectTable Objects() { return BND_ONXModel_ObjectTable(m_model); }
+  BND_ONXModel_ObjectTable Objects() { return BND_ONXModel_ObjectTable(m_model, m_object_index); }
   BND_File3dmMaterialTable Materials() { return BND_File3dmMaterialTable(m_model); }
   BND_File3dmLinetypeTable Linetypes() { return BND_File3dmLinetypeTable(m_model); }
   BND_File3dmBitmapTable Bitmaps() { return BND_File3dmBitmapTable(m_model); }
@@ -336,10 +383,10 @@ public:
   BND_File3dmViewTable Views() { return BND_File3dmViewTable(m_model, false); }
   BND_File3dmViewTable NamedViews() { return BND_File3dmViewTable(m_model, true); }
   //public File3dmNamedConstructionPlanes AllNamedConstructionPlanes | get;
-  BND_File3dmPlugInDataTable PlugInData() { return BND_File3dmPlugInDataTable(m_model); }
-  BND_File3dmStringTable Strings() { return BND_File3dmStringTable(m_model); }
-  BND_File3dmEmbeddedFileTable EmbeddedFiles() { return BND_File3dmEmbeddedFileTable(m_model); }
-  BND_File3dmRenderContentTable RenderContent() { return BND_File3dmRenderContentTable(m_model); }
+  BND_File3dmPlugInDataTable PlugInData() { m_passthrough.reset(); return BND_File3dmPlugInDataTable(m_model); }
+  BND_File3dmStringTable Strings() { m_passthrough.reset(); return BND_File3dmStringTable(m_model); }
+  BND_File3dmEmbeddedFileTable EmbeddedFiles() { m_passthrough.reset(); return BND_File3dmEmbeddedFileTable(m_model); }
+  BND_File3dmRenderContentTable RenderContent() { m_passthrough.reset(); return BND_File3dmRenderContentTable(m_model); }
 
   //std::wstring Dump() const;
   //std::wstring DumpSummary() const;
@@ -348,7 +395,25 @@ public:
   std::vector<std::wstring> GetEmbeddedFilePaths2();
   std::string GetEmbeddedFileAsBase64(std::wstring path);
   std::string GetEmbeddedFileAsBase64Strict(std::wstring path, bool strict);
+#if defined(ON_PYTHON_COMPILE)
+  py::bytes GetEmbeddedFileBytes(std::wstring path, bool strict) const;
+#else
+  emscripten::val GetEmbeddedFileBytes(std::wstring path, bool strict) const;
+#endif
+  bool ExtractEmbeddedFile(std::wstring path, std::wstring filename) const;
+  // Writes every embedded file into directory, decompressing on threadCount
+  // threads. Returns the paths of the files written.
+  std::vector<std::wstring> ExtractAllEmbeddedFiles(std::wstring directory, int threadCount) const;
   std::wstring RdkXml() const;
+  BND_DICT MemoryReport(int largestCount) const;
+#if defined(ON_PYTHON_COMPILE)
+  py::bytes ToGlb() const;
+  py::bytes ToGlb2(const class BND_File3dmGlbOptions* options) const;
+#else
+  emscripten::val ToGlb() const;
+  emscripten::val ToGlb2(const class BND_File3dmGlbOptions* options) const;
+#endif
+  bool WriteGlb(std::wstring path, const class BND_File3dmGlbOptions* options) const;
 
 public:
   static bool ReadTest(std::wstring filepath);
@@ -363,7 +428,16 @@ public:
   int VersionForWriting() const;
   bool SaveUserData() const { return m_save_user_data; }
   void SetSaveUserData(bool b) { m_save_user_data = b; }
+  // zlib compression of the archive's compressed buffers; false stores them.
+  // opennurbs has one fixed zlib level, so there is nothing in between.
+  bool CompressBuffers() const { return m_compress_buffers; }
+  void SetCompressBuffers(bool compress) { m_compress_buffers = compress; }
+  // Threads used to serialize object records; <= 0 means all cores
+  int ThreadCount() const { return m_thread_count; }
+  void SetThreadCount(int count) { m_thread_count = count; }
 private:
   int m_version = 0;
   bool m_save_user_data = true;
+  bool m_compress_buffers = true;
+  int m_thread_count = 1;
 };
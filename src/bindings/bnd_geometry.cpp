@@ -1,4 +1,6 @@
 #include "bindings.h"
+#include <algorithm>
+#include <atomic>
 
 BND_GeometryBase::BND_GeometryBase()
 {
@@ -20,6 +22,64 @@ bool BND_GeometryBase::Transform(const BND_Transform& xform)
   return m_geometry->Transform(xform.m_xform);
 }
 
+static int TransformGeometries(const std::vector<ON_Geometry*>& geometries, const std::vector<ON_Xform>& xforms, int threadCount)
+{
+  const int count = (int)geometries.size();
+  if (xforms.empty() || (xforms.size() != 1 && (int)xforms.size() != count))
+    return 0;
+
+  // the same geometry listed twice must not be transformed by two threads
+  std::vector<ON_Geometry*> sorted(geometries);
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+    threadCount = 1;
+
+  std::atomic<int> transformed(0);
+  ParallelFor(count, ParallelThreadCount(threadCount), [&](int i)
+  {
+    ON_Geometry* geometry = geometries[i];
+    const ON_Xform& xform = xforms.size() == 1 ? xforms[0] : xforms[i];
+    if (geometry && geometry->Transform(xform))
+      transformed++;
+  });
+  return transformed;
+}
+
+#if defined(ON_PYTHON_COMPILE)
+int BND_GeometryBase::TransformMany(const std::vector<BND_GeometryBase*>& geometries, const std::vector<BND_Transform>& xforms, int threadCount)
+{
+  if (xforms.size() != 1 && xforms.size() != geometries.size())
+    throw py::value_error("xforms must hold one transform or one per geometry");
+  std::vector<ON_Geometry*> _geometries;
+  _geometries.reserve(geometries.size());
+  for (BND_GeometryBase* geometry : geometries)
+    _geometries.push_back(geometry ? geometry->m_geometry : nullptr);
+  std::vector<ON_Xform> _xforms;
+  _xforms.reserve(xforms.size());
+  for (const BND_Transform& xform : xforms)
+    _xforms.push_back(xform.m_xform);
+  return TransformGeometries(_geometries, _xforms, threadCount);
+}
+#else
+int BND_GeometryBase::TransformMany(emscripten::val geometries, emscripten::val xforms)
+{
+  const int count = geometries["length"].as<int>();
+  std::vector<ON_Geometry*> _geometries;
+  _geometries.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    BND_GeometryBase* geometry = geometries[i].as<BND_GeometryBase*>(emscripten::allow_raw_pointers());
+    _geometries.push_back(geometry ? geometry->m_geometry : nullptr);
+  }
+  const int xform_count = xforms["length"].as<int>();
+  std::vector<ON_Xform> _xforms;
+  _xforms.reserve(xform_count);
+  for (int i = 0; i < xform_count; i++)
+    _xforms.push_back(xforms[i].as<BND_Transform>().m_xform);
+  return TransformGeometries(_geometries, _xforms, 1);
+}
+#endif
+
 BND_BoundingBox BND_GeometryBase::BoundingBox() const
 {
   ON_BoundingBox bbox = m_geometry->BoundingBox();
@@ -39,6 +99,7 @@ void initGeometryBindings(rh3dmpymodule& m)
   py::class_<BND_GeometryBase, BND_CommonObject>(m, "GeometryBase")
     .def_property_readonly("ObjectType", &BND_GeometryBase::ObjectType)
     .def("Transform", &BND_GeometryBase::Transform, py::arg("xform"))
+    .def_static("TransformMany", &BND_GeometryBase::TransformMany, py::arg("geometries"), py::arg("xforms"), py::arg("threadCount")=0)
     .def("Translate", &BND_GeometryBase::Translate, py::arg("translationVector"))
     .def("Scale", &BND_GeometryBase::Scale, py::arg("scaleFactor"))
     .def("Rotate", &BND_GeometryBase::Rotate, py::arg("rotationAngle"), py::arg("rotationAxis"), py::arg("rotationCenter"))
@@ -60,6 +121,7 @@ void initGeometryBindings(void*)
   class_<BND_GeometryBase, base<BND_CommonObject>>("GeometryBase")
     .property("objectType", &BND_GeometryBase::ObjectType)
     .function("transform", &BND_GeometryBase::Transform)
+    .class_function("transformMany", &BND_GeometryBase::TransformMany)
     .function("translate", &BND_GeometryBase::Translate)
     .function("scale", &BND_GeometryBase::Scale)
     .function("rotate", &BND_GeometryBase::Rotate)
@@ -22,6 +22,14 @@ public:
   ON::object_type ObjectType() const { return m_geometry->ObjectType(); }
 
   bool Transform(const class BND_Transform& xform);
+  // Transforms every geometry by the matching transform, or all of them by
+  // xforms[0] when one transform is given. Returns the number of geometries
+  // that were transformed.
+#if defined(ON_PYTHON_COMPILE)
+  static int TransformMany(const std::vector<BND_GeometryBase*>& geometries, const std::vector<class BND_Transform>& xforms, int threadCount);
+#else
+  static int TransformMany(emscripten::val geometries, emscripten::val xforms);
+#endif
   bool Translate(ON_3dVector translationVector) { return m_geometry->Translate(translationVector); }
   //public bool Translate(double x, double y, double z)
   bool Scale(double scaleFactor) { return m_geometry->Scale(scaleFactor); }
@@ -0,0 +1,1027 @@
+#include "bindings.h"
+#include "mesh_optimize.h"
+
+#if defined(ON_INCLUDE_DRACO)
+#undef max
+#undef min
+#undef OK
+#undef ERROR
+#include "../lib/draco/src/draco/core/encoder_buffer.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+
+// glTF constants
+static const int GLB_ARRAY_BUFFER = 34962;
+static const int GLB_ELEMENT_ARRAY_BUFFER = 34963;
+static const int GLB_BYTE = 5120;
+static const int GLB_UNSIGNED_BYTE = 5121;
+static const int GLB_SHORT = 5122;
+static const int GLB_UNSIGNED_SHORT = 5123;
+static const int GLB_UNSIGNED_INT = 5125;
+static const int GLB_FLOAT = 5126;
+
+// Triangulated, flattened copy of one or more ON_Mesh parts
+struct BND_GlbMeshData
+{
+  std::vector<float> m_positions;        // xyz
+  std::vector<float> m_normals;          // xyz, empty when not every part has normals
+  std::vector<float> m_texcoords;        // uv with glTF's top-left origin
+  std::vector<unsigned char> m_colors;   // rgba
+  std::vector<unsigned int> m_indices;   // triangles
+  ON__UINT64 m_hash = 0;
+
+  int VertexCount() const { return (int)(m_positions.size() / 3); }
+  bool operator==(const BND_GlbMeshData& other) const
+  {
+    return m_positions == other.m_positions && m_indices == other.m_indices && m_normals == other.m_normals &&
+      m_texcoords == other.m_texcoords && m_colors == other.m_colors;
+  }
+};
+
+// Accessors written for a unique mesh; shared by every glTF mesh that uses it
+struct BND_GlbPrimitive
+{
+  int m_position = -1;
+  int m_normal = -1;
+  int m_texcoord = -1;
+  int m_color = -1;
+  int m_indices = -1;
+  int m_draco_view = -1;
+  int m_draco_ids[4] = { -1, -1, -1, -1 }; // position, normal, texcoord, color
+  ON_Xform m_dequantize = ON_Xform::IdentityTransformation;
+};
+
+static ON__UINT64 HashBytes(ON__UINT64 hash, const void* data, size_t count)
+{
+  // FNV-1a
+  const unsigned char* bytes = (const unsigned char*)data;
+  for (size_t i = 0; i < count; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+template <typename T>
+static void PermuteVertices(std::vector<T>& values, size_t components, const std::vector<unsigned int>& remap)
+{
+  if (values.size() != components * remap.size())
+    return;
+  std::vector<T> permuted(values.size());
+  for (size_t i = 0; i < remap.size(); i++)
+    std::copy(values.begin() + components * i, values.begin() + components * (i + 1), permuted.begin() + components * remap[i]);
+  values.swap(permuted);
+}
+
+static void BuildMeshData(const std::vector<const ON_Mesh*>& parts, bool optimize, BND_GlbMeshData& data)
+{
+  bool normals = true, texcoords = true, colors = true;
+  for (const ON_Mesh* mesh : parts)
+  {
+    normals = normals && mesh->HasVertexNormals();
+    texcoords = texcoords && mesh->HasTextureCoordinates();
+    colors = colors && mesh->HasVertexColors();
+  }
+
+  for (const ON_Mesh* mesh : parts)
+  {
+    const int vertexCount = mesh->VertexCount();
+    const unsigned int offset = (unsigned int)data.VertexCount();
+    const bool doubles = mesh->HasDoublePrecisionVertices();
+    for (int i = 0; i < vertexCount; i++)
+    {
+      const ON_3dPoint point = doubles ? mesh->m_dV[i] : ON_3dPoint(mesh->m_V[i]);
+      data.m_positions.push_back((float)point.x);
+      data.m_positions.push_back((float)point.y);
+      data.m_positions.push_back((float)point.z);
+      if (normals)
+      {
+        data.m_normals.push_back(mesh->m_N[i].x);
+        data.m_normals.push_back(mesh->m_N[i].y);
+        data.m_normals.push_back(mesh->m_N[i].z);
+      }
+      if (texcoords)
+      {
+        data.m_texcoords.push_back(mesh->m_T[i].x);
+        data.m_texcoords.push_back(1.0f - mesh->m_T[i].y);
+      }
+      if (colors)
+      {
+        const ON_Color& color = mesh->m_C[i];
+        data.m_colors.push_back((unsigned char)color.Red());
+        data.m_colors.push_back((unsigned char)color.Green());
+        data.m_colors.push_back((unsigned char)color.Blue());
+        data.m_colors.push_back((unsigned char)(255 - color.Alpha()));
+      }
+    }
+
+    for (int fi = 0; fi < mesh->m_F.Count(); fi++)
+    {
+      const ON_MeshFace& face = mesh->m_F[fi];
+      if (!face.IsValid(vertexCount))
+        continue;
+      data.m_indices.push_back(offset + face.vi[0]);
+      data.m_indices.push_back(offset + face.vi[1]);
+      data.m_indices.push_back(offset + face.vi[2]);
+      if (face.IsQuad())
+      {
+        data.m_indices.push_back(offset + face.vi[0]);
+        data.m_indices.push_back(offset + face.vi[2]);
+        data.m_indices.push_back(offset + face.vi[3]);
+      }
+    }
+  }
+
+  if (optimize && !data.m_indices.empty())
+  {
+    const size_t vertexCount = (size_t)data.VertexCount();
+    mesh_optimize_triangles(data.m_indices.data(), data.m_indices.size(), vertexCount, data.m_positions.data());
+    const std::vector<unsigned int> remap = mesh_optimize_vertex_fetch(data.m_indices.data(), data.m_indices.size(), vertexCount);
+    PermuteVertices(data.m_positions, 3, remap);
+    PermuteVertices(data.m_normals, 3, remap);
+    PermuteVertices(data.m_texcoords, 2, remap);
+    PermuteVertices(data.m_colors, 4, remap);
+  }
+
+  ON__UINT64 hash = 14695981039346656037ULL;
+  hash = HashBytes(hash, data.m_positions.data(), data.m_positions.size() * sizeof(float));
+  hash = HashBytes(hash, data.m_indices.data(), data.m_indices.size() * sizeof(unsigned int));
+  data.m_hash = hash;
+}
+
+// Brep faces and extrusions contribute the render meshes stored in the file
+static void RenderMeshes(const ON_Geometry* geometry, std::vector<const ON_Mesh*>& parts)
+{
+  const ON_Mesh* mesh = ON_Mesh::Cast(geometry);
+  if (mesh)
+  {
+    parts.push_back(mesh);
+    return;
+  }
+  const ON_Brep* brep = ON_Brep::Cast(geometry);
+  if (brep)
+  {
+    for (int fi = 0; fi < brep->m_F.Count(); fi++)
+    {
+      const ON_Mesh* faceMesh = brep->m_F[fi].Mesh(ON::render_mesh);
+      if (faceMesh)
+        parts.push_back(faceMesh);
+    }
+    return;
+  }
+  const ON_Extrusion* extrusion = ON_Extrusion::Cast(geometry);
+  mesh = extrusion ? extrusion->Mesh(ON::render_mesh) : nullptr;
+  if (mesh)
+    parts.push_back(mesh);
+}
+
+// Splits x into translation, rotation quaternion (x, y, z, w) and scale.
+// Fails for projections and shears, which glTF instances cannot express.
+static bool DecomposeTRS(const ON_Xform& x, double t[3], double r[4], double s[3])
+{
+  if (fabs(x[3][0]) > ON_ZERO_TOLERANCE || fabs(x[3][1]) > ON_ZERO_TOLERANCE || fabs(x[3][2]) > ON_ZERO_TOLERANCE || fabs(x[3][3] - 1.0) > ON_ZERO_TOLERANCE)
+    return false;
+
+  ON_3dVector axes[3];
+  for (int c = 0; c < 3; c++)
+  {
+    axes[c].Set(x[0][c], x[1][c], x[2][c]);
+    s[c] = axes[c].Length();
+    if (s[c] <= ON_ZERO_TOLERANCE)
+      return false;
+  }
+  if (ON_CrossProduct(axes[0], axes[1]) * axes[2] < 0.0)
+    s[0] = -s[0];
+  for (int c = 0; c < 3; c++)
+    axes[c] = axes[c] / s[c];
+
+  const double tol = 1.0e-6;
+  if (fabs(axes[0] * axes[1]) > tol || fabs(axes[1] * axes[2]) > tol || fabs(axes[0] * axes[2]) > tol)
+    return false;
+
+  // m[row][col] of the rotation, columns are the unit axes
+  const double m00 = axes[0].x, m01 = axes[1].x, m02 = axes[2].x;
+  const double m10 = axes[0].y, m11 = axes[1].y, m12 = axes[2].y;
+  const double m20 = axes[0].z, m21 = axes[1].z, m22 = axes[2].z;
+  const double trace = m00 + m11 + m22;
+  if (trace > 0.0)
+  {
+    const double k = 0.5 / sqrt(trace + 1.0);
+    r[3] = 0.25 / k;
+    r[0] = (m21 - m12) * k;
+    r[1] = (m02 - m20) * k;
+    r[2] = (m10 - m01) * k;
+  }
+  else if (m00 > m11 && m00 > m22)
+  {
+    const double k = 2.0 * sqrt(1.0 + m00 - m11 - m22);
+    r[3] = (m21 - m12) / k;
+    r[0] = 0.25 * k;
+    r[1] = (m01 + m10) / k;
+    r[2] = (m02 + m20) / k;
+  }
+  else if (m11 > m22)
+  {
+    const double k = 2.0 * sqrt(1.0 + m11 - m00 - m22);
+    r[3] = (m02 - m20) / k;
+    r[0] = (m01 + m10) / k;
+    r[1] = 0.25 * k;
+    r[2] = (m12 + m21) / k;
+  }
+  else
+  {
+    const double k = 2.0 * sqrt(1.0 + m22 - m00 - m11);
+    r[3] = (m10 - m01) / k;
+    r[0] = (m02 + m20) / k;
+    r[1] = (m12 + m21) / k;
+    r[2] = 0.25 * k;
+  }
+  const double length = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+  for (int i = 0; i < 4; i++)
+    r[i] /= length;
+
+  t[0] = x[0][3];
+  t[1] = x[1][3];
+  t[2] = x[2][3];
+  return true;
+}
+
+static void AppendNumber(std::string& json, double value)
+{
+  if (!std::isfinite(value))
+    value = 0.0;
+  char text[32];
+  snprintf(text, sizeof(text), "%.9g", value);
+  json += text;
+}
+
+static void AppendNumbers(std::string& json, const double* values, int count)
+{
+  json += '[';
+  for (int i = 0; i < count; i++)
+  {
+    if (i > 0)
+      json += ',';
+    AppendNumber(json, values[i]);
+  }
+  json += ']';
+}
+
+static void AppendString(std::string& json, const ON_wString& value)
+{
+  const ON_String utf8(value);
+  json += '"';
+  for (int i = 0; i < utf8.Length(); i++)
+  {
+    const char c = utf8[i];
+    if ('"' == c || '\\' == c)
+    {
+      json += '\\';
+      json += c;
+    }
+    else if ((unsigned char)c < 0x20)
+    {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)(unsigned char)c);
+      json += escaped;
+    }
+    else
+      json += c;
+  }
+  json += '"';
+}
+
+static std::string JoinArray(const std::vector<std::string>& items)
+{
+  std::string rc = "[";
+  for (size_t i = 0; i < items.size(); i++)
+  {
+    if (i > 0)
+      rc += ',';
+    rc += items[i];
+  }
+  rc += ']';
+  return rc;
+}
+
+static double SrgbToLinear(double c)
+{
+  return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+static std::string MaterialJson(const ON_Material& material)
+{
+  double base[4];
+  double emission[3];
+  double metallic = 0.0;
+  double roughness = 1.0;
+  if (material.IsPhysicallyBased())
+  {
+    const auto pbr = material.PhysicallyBased();
+    const ON_4fColor color = pbr->BaseColor();
+    const ON_4fColor emissive = pbr->Emission();
+    base[0] = color.Red();
+    base[1] = color.Green();
+    base[2] = color.Blue();
+    base[3] = pbr->Opacity();
+    emission[0] = emissive.Red();
+    emission[1] = emissive.Green();
+    emission[2] = emissive.Blue();
+    metallic = pbr->Metallic();
+    roughness = pbr->Roughness();
+  }
+  else
+  {
+    const ON_Color diffuse = material.Diffuse();
+    const ON_Color emissive = material.Emission();
+    base[0] = SrgbToLinear(diffuse.FractionRed());
+    base[1] = SrgbToLinear(diffuse.FractionGreen());
+    base[2] = SrgbToLinear(diffuse.FractionBlue());
+    base[3] = 1.0 - material.Transparency();
+    emission[0] = SrgbToLinear(emissive.FractionRed());
+    emission[1] = SrgbToLinear(emissive.FractionGreen());
+    emission[2] = SrgbToLinear(emissive.FractionBlue());
+    roughness = 1.0 - material.Shine() / ON_Material::MaxShine;
+  }
+  base[3] = std::min(std::max(base[3], 0.0), 1.0);
+
+  std::string json = "{\"name\":";
+  AppendString(json, material.Name());
+  json += ",\"pbrMetallicRoughness\":{\"baseColorFactor\":";
+  AppendNumbers(json, base, 4);
+  json += ",\"metallicFactor\":";
+  AppendNumber(json, std::min(std::max(metallic, 0.0), 1.0));
+  json += ",\"roughnessFactor\":";
+  AppendNumber(json, std::min(std::max(roughness, 0.0), 1.0));
+  json += "},\"emissiveFactor\":";
+  AppendNumbers(json, emission, 3);
+  if (base[3] < 1.0)
+    json += ",\"alphaMode\":\"BLEND\"";
+  json += ",\"doubleSided\":true}";
+  return json;
+}
+
+class BND_GlbBuilder
+{
+public:
+  BND_GlbBuilder(const ONX_Model& model, const BND_File3dmGlbOptions& options)
+    : m_model(model), m_options(options) {}
+
+  void Build();
+  std::string m_json;
+  std::vector<unsigned char> m_bin;
+
+private:
+  struct Draw
+  {
+    int m_mesh;
+    int m_material;
+    ON_Xform m_xform;
+  };
+
+  struct UuidLess
+  {
+    bool operator()(const ON_UUID& a, const ON_UUID& b) const { return ON_UuidCompare(a, b) < 0; }
+  };
+
+  bool IsVisible(const ON_3dmObjectAttributes* attributes) const;
+  int MaterialIndex(const ON_3dmObjectAttributes& attributes, int parentMaterial);
+  int MeshIndex(const ON_Geometry* geometry);
+  void AddObject(const ON_ModelComponentReference& compref, int parentMaterial, const ON_Xform& xform, int depth);
+
+  int AddBufferView(const void* data, size_t byteLength, int byteStride, int target);
+  int AddAccessor(int bufferView, int componentType, int count, const char* type, bool normalized, const double* min, const double* max, int components);
+  void WritePrimitive(int meshIndex);
+  bool WriteDracoPrimitive(int meshIndex);
+  int AddMesh(int meshIndex, int material);
+  int AddInstanceNode(int gltfMesh, const std::vector<ON_Xform>& xforms);
+  int AddNode(int gltfMesh, const ON_Xform& xform);
+
+  const ONX_Model& m_model;
+  const BND_File3dmGlbOptions& m_options;
+  bool m_quantize = false;
+  bool m_draco = false;
+  bool m_used_draco = false;
+  bool m_used_quantization = false;
+  bool m_used_instancing = false;
+
+  std::vector<BND_GlbMeshData> m_meshes;
+  std::vector<BND_GlbPrimitive> m_primitives;
+  std::unordered_map<const ON_Geometry*, int> m_geometry_meshes;
+  std::unordered_map<ON__UINT64, std::vector<int>> m_mesh_hashes;
+  std::map<ON_UUID, int, UuidLess> m_material_ids;
+  std::vector<Draw> m_draws;
+
+  std::vector<std::string> m_buffer_views;
+  std::vector<std::string> m_accessors;
+  std::vector<std::string> m_gltf_meshes;
+  std::vector<std::string> m_materials;
+  std::vector<std::string> m_nodes;
+};
+
+bool BND_GlbBuilder::IsVisible(const ON_3dmObjectAttributes* attributes) const
+{
+  if (nullptr == attributes || !attributes->IsVisible())
+    return false;
+  const ON_Layer* layer = ON_Layer::Cast(m_model.ComponentFromIndex(ON_ModelComponent::Type::Layer, attributes->m_layer_index).ModelComponent());
+  return nullptr == layer || layer->IsVisible();
+}
+
+int BND_GlbBuilder::MaterialIndex(const ON_3dmObjectAttributes& attributes, int parentMaterial)
+{
+  if (!m_options.m_export_materials)
+    return -1;
+  if (ON::material_from_parent == attributes.MaterialSource() && parentMaterial >= 0)
+    return parentMaterial;
+
+  ON_ModelComponentReference compref = m_model.MaterialFromAttributes(attributes);
+  const ON_Material* material = ON_Material::Cast(compref.ModelComponent());
+  if (nullptr == material)
+    return -1;
+  const auto found = m_material_ids.find(material->Id());
+  if (found != m_material_ids.end())
+    return found->second;
+  const int index = (int)m_materials.size();
+  m_materials.push_back(MaterialJson(*material));
+  m_material_ids[material->Id()] = index;
+  return index;
+}
+
+// Index into m_meshes; geometry with identical render meshes shares one entry
+int BND_GlbBuilder::MeshIndex(const ON_Geometry* geometry)
+{
+  const auto found = m_geometry_meshes.find(geometry);
+  if (found != m_geometry_meshes.end())
+    return found->second;
+
+  int index = -1;
+  std::vector<const ON_Mesh*> parts;
+  RenderMeshes(geometry, parts);
+  if (!parts.empty())
+  {
+    BND_GlbMeshData data;
+    BuildMeshData(parts, m_options.m_optimize_meshes, data);
+    if (!data.m_indices.empty())
+    {
+      std::vector<int>& candidates = m_mesh_hashes[data.m_hash];
+      for (int candidate : candidates)
+      {
+        if (m_meshes[candidate] == data)
+        {
+          index = candidate;
+          break;
+        }
+      }
+      if (index < 0)
+      {
+        index = (int)m_meshes.size();
+        candidates.push_back(index);
+        m_meshes.push_back(std::move(data));
+      }
+    }
+  }
+  m_geometry_meshes[geometry] = index;
+  return index;
+}
+
+void BND_GlbBuilder::AddObject(const ON_ModelComponentReference& compref, int parentMaterial, const ON_Xform& xform, int depth)
+{
+  const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+  const ON_Geometry* geometry = geometryComponent ? geometryComponent->Geometry(nullptr) : nullptr;
+  const ON_3dmObjectAttributes* attributes = geometryComponent ? geometryComponent->Attributes(nullptr) : nullptr;
+  if (nullptr == geometry || !IsVisible(attributes))
+    return;
+
+  const int material = MaterialIndex(*attributes, parentMaterial);
+  const ON_InstanceRef* iref = ON_InstanceRef::Cast(geometry);
+  if (iref)
+  {
+    // guard against definitions that reference themselves
+    if (depth > 16)
+      return;
+    const ON_ModelComponentReference& idef_compref = m_model.ComponentFromId(ON_ModelComponent::Type::InstanceDefinition, iref->m_instance_definition_uuid);
+    const ON_InstanceDefinition* idef = ON_InstanceDefinition::Cast(idef_compref.ModelComponent());
+    if (nullptr == idef)
+      return;
+    const ON_Xform instance_xform = xform * iref->m_xform;
+    const ON_SimpleArray<ON_UUID>& ids = idef->InstanceGeometryIdList();
+    for (int i = 0; i < ids.Count(); i++)
+    {
+      ON_ModelComponentReference child = m_model.ComponentFromId(ON_ModelComponent::Type::ModelGeometry, ids[i]);
+      AddObject(child, material, instance_xform, depth + 1);
+    }
+    return;
+  }
+
+  const int mesh = MeshIndex(geometry);
+  if (mesh >= 0)
+    m_draws.push_back({ mesh, material, xform });
+}
+
+int BND_GlbBuilder::AddBufferView(const void* data, size_t byteLength, int byteStride, int target)
+{
+  while (m_bin.size() % 4)
+    m_bin.push_back(0);
+  const size_t offset = m_bin.size();
+  const unsigned char* bytes = (const unsigned char*)data;
+  m_bin.insert(m_bin.end(), bytes, bytes + byteLength);
+
+  std::string json = "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) + ",\"byteLength\":" + std::to_string(byteLength);
+  if (byteStride > 0)
+    json += ",\"byteStride\":" + std::to_string(byteStride);
+  if (target > 0)
+    json += ",\"target\":" + std::to_string(target);
+  json += '}';
+  m_buffer_views.push_back(json);
+  return (int)m_buffer_views.size() - 1;
+}
+
+int BND_GlbBuilder::AddAccessor(int bufferView, int componentType, int count, const char* type, bool normalized, const double* min, const double* max, int components)
+{
+  std::string json = "{";
+  if (bufferView >= 0)
+    json += "\"bufferView\":" + std::to_string(bufferView) + ",";
+  json += "\"componentType\":" + std::to_string(componentType) + ",\"count\":" + std::to_string(count) + ",\"type\":\"" + type + "\"";
+  if (normalized)
+    json += ",\"normalized\":true";
+  if (min && max)
+  {
+    json += ",\"min\":";
+    AppendNumbers(json, min, components);
+    json += ",\"max\":";
+    AppendNumbers(json, max, components);
+  }
+  json += '}';
+  m_accessors.push_back(json);
+  return (int)m_accessors.size() - 1;
+}
+
+static void PositionBounds(const BND_GlbMeshData& data, double min[3], double max[3])
+{
+  for (int c = 0; c < 3; c++)
+  {
+    min[c] = ON_UNSET_POSITIVE_VALUE;
+    max[c] = ON_UNSET_VALUE;
+  }
+  for (size_t i = 0; i < data.m_positions.size(); i += 3)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      min[c] = std::min(min[c], (double)data.m_positions[i + c]);
+      max[c] = std::max(max[c], (double)data.m_positions[i + c]);
+    }
+  }
+}
+
+// Copy of data with xform baked into the vertices, for placements a glTF
+// node cannot express. Normals use the cofactor matrix of the linear part
+// and mirrored placements flip the triangle winding.
+static BND_GlbMeshData TransformMeshData(const BND_GlbMeshData& data, const ON_Xform& xform)
+{
+  BND_GlbMeshData rc = data;
+  for (size_t i = 0; i < rc.m_positions.size(); i += 3)
+  {
+    const ON_3dPoint p = xform * ON_3dPoint(rc.m_positions[i], rc.m_positions[i + 1], rc.m_positions[i + 2]);
+    rc.m_positions[i] = (float)p.x;
+    rc.m_positions[i + 1] = (float)p.y;
+    rc.m_positions[i + 2] = (float)p.z;
+  }
+
+  double cofactor[3][3];
+  for (int row = 0; row < 3; row++)
+  {
+    for (int col = 0; col < 3; col++)
+    {
+      const int r0 = (row + 1) % 3, r1 = (row + 2) % 3;
+      const int c0 = (col + 1) % 3, c1 = (col + 2) % 3;
+      cofactor[row][col] = xform[r0][c0] * xform[r1][c1] - xform[r0][c1] * xform[r1][c0];
+    }
+  }
+  for (size_t i = 0; i < rc.m_normals.size(); i += 3)
+  {
+    ON_3dVector n;
+    for (int row = 0; row < 3; row++)
+      n[row] = cofactor[row][0] * rc.m_normals[i] + cofactor[row][1] * rc.m_normals[i + 1] + cofactor[row][2] * rc.m_normals[i + 2];
+    n.Unitize();
+    rc.m_normals[i] = (float)n.x;
+    rc.m_normals[i + 1] = (float)n.y;
+    rc.m_normals[i + 2] = (float)n.z;
+  }
+
+  const double det = xform[0][0] * cofactor[0][0] + xform[0][1] * cofactor[0][1] + xform[0][2] * cofactor[0][2];
+  if (det < 0.0)
+  {
+    for (size_t i = 0; i + 2 < rc.m_indices.size(); i += 3)
+      std::swap(rc.m_indices[i + 1], rc.m_indices[i + 2]);
+  }
+  return rc;
+}
+
+void BND_GlbBuilder::WritePrimitive(int meshIndex)
+{
+  const BND_GlbMeshData& data = m_meshes[meshIndex];
+  BND_GlbPrimitive& primitive = m_primitives[meshIndex];
+  const int vertexCount = data.VertexCount();
+
+  double min[3], max[3];
+  PositionBounds(data, min, max);
+  if (m_quantize)
+  {
+    // positions become int16 offsets from the bounding box center; the
+    // node transform scales them back (KHR_mesh_quantization)
+    const ON_3dPoint center(0.5 * (min[0] + max[0]), 0.5 * (min[1] + max[1]), 0.5 * (min[2] + max[2]));
+    const double extent = std::max(max[0] - min[0], std::max(max[1] - min[1], max[2] - min[2]));
+    const double step = extent > 0.0 ? 0.5 * extent / 32767.0 : 1.0;
+    std::vector<short> positions(4 * (size_t)vertexCount, 0);
+    double qmin[3] = { 32767, 32767, 32767 }, qmax[3] = { -32767, -32767, -32767 };
+    for (int i = 0; i < vertexCount; i++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        const double q = std::min(std::max(floor((data.m_positions[3 * i + c] - center[c]) / step + 0.5), -32767.0), 32767.0);
+        positions[4 * i + c] = (short)q;
+        qmin[c] = std::min(qmin[c], q);
+        qmax[c] = std::max(qmax[c], q);
+      }
+    }
+    const int view = AddBufferView(positions.data(), positions.size() * sizeof(short), 4 * sizeof(short), GLB_ARRAY_BUFFER);
+    primitive.m_position = AddAccessor(view, GLB_SHORT, vertexCount, "VEC3", false, qmin, qmax, 3);
+    primitive.m_dequantize = ON_Xform::TranslationTransformation(center - ON_3dPoint::Origin) * ON_Xform::DiagonalTransformation(step);
+
+    if (!data.m_normals.empty())
+    {
+      std::vector<signed char> normals(4 * (size_t)vertexCount, 0);
+      for (size_t i = 0; i < (size_t)vertexCount; i++)
+        for (int c = 0; c < 3; c++)
+          normals[4 * i + c] = (signed char)std::min(std::max(floor(data.m_normals[3 * i + c] * 127.0f + 0.5f), -127.0f), 127.0f);
+      const int normalView = AddBufferView(normals.data(), normals.size(), 4, GLB_ARRAY_BUFFER);
+      primitive.m_normal = AddAccessor(normalView, GLB_BYTE, vertexCount, "VEC3", true, nullptr, nullptr, 0);
+    }
+    m_used_quantization = true;
+  }
+  else
+  {
+    const int view = AddBufferView(data.m_positions.data(), data.m_positions.size() * sizeof(float), 0, GLB_ARRAY_BUFFER);
+    primitive.m_position = AddAccessor(view, GLB_FLOAT, vertexCount, "VEC3", false, min, max, 3);
+    if (!data.m_normals.empty())
+    {
+      const int normalView = AddBufferView(data.m_normals.data(), data.m_normals.size() * sizeof(float), 0, GLB_ARRAY_BUFFER);
+      primitive.m_normal = AddAccessor(normalView, GLB_FLOAT, vertexCount, "VEC3", false, nullptr, nullptr, 0);
+    }
+  }
+
+  // texture coordinates may tile outside [0,1] so they stay floats
+  if (!data.m_texcoords.empty())
+  {
+    const int view = AddBufferView(data.m_texcoords.data(), data.m_texcoords.size() * sizeof(float), 0, GLB_ARRAY_BUFFER);
+    primitive.m_texcoord = AddAccessor(view, GLB_FLOAT, vertexCount, "VEC2", false, nullptr, nullptr, 0);
+  }
+  if (!data.m_colors.empty())
+  {
+    const int view = AddBufferView(data.m_colors.data(), data.m_colors.size(), 0, GLB_ARRAY_BUFFER);
+    primitive.m_color = AddAccessor(view, GLB_UNSIGNED_BYTE, vertexCount, "VEC4", true, nullptr, nullptr, 0);
+  }
+
+  if (vertexCount <= 0xFFFF)
+  {
+    std::vector<unsigned short> indices(data.m_indices.begin(), data.m_indices.end());
+    const int view = AddBufferView(indices.data(), indices.size() * sizeof(unsigned short), 0, GLB_ELEMENT_ARRAY_BUFFER);
+    primitive.m_indices = AddAccessor(view, GLB_UNSIGNED_SHORT, (int)indices.size(), "SCALAR", false, nullptr, nullptr, 0);
+  }
+  else
+  {
+    const int view = AddBufferView(data.m_indices.data(), data.m_indices.size() * sizeof(unsigned int), 0, GLB_ELEMENT_ARRAY_BUFFER);
+    primitive.m_indices = AddAccessor(view, GLB_UNSIGNED_INT, (int)data.m_indices.size(), "SCALAR", false, nullptr, nullptr, 0);
+  }
+}
+
+// One point per mesh vertex so the decoded attributes line up with the
+// accessor counts written in the JSON chunk
+bool BND_GlbBuilder::WriteDracoPrimitive(int meshIndex)
+{
+#if defined(ON_INCLUDE_DRACO)
+  const BND_GlbMeshData& data = m_meshes[meshIndex];
+  BND_GlbPrimitive& primitive = m_primitives[meshIndex];
+  const int vertexCount = data.VertexCount();
+
+  BND_DracoTriangles triangles;
+  triangles.m_vertex_count = vertexCount;
+  triangles.m_positions = data.m_positions.data();
+  triangles.m_normals = data.m_normals.empty() ? nullptr : data.m_normals.data();
+  triangles.m_texcoords = data.m_texcoords.empty() ? nullptr : data.m_texcoords.data();
+  triangles.m_colors = data.m_colors.empty() ? nullptr : data.m_colors.data();
+  triangles.m_normalized_colors = true;
+  triangles.m_triangle_count = (int)(data.m_indices.size() / 3);
+  triangles.m_indices = data.m_indices.data();
+
+  draco::EncoderBuffer buffer;
+  if (!BND_DracoEncodeTriangles(triangles, m_options.m_draco_options, buffer, primitive.m_draco_ids))
+    return false;
+  primitive.m_draco_view = AddBufferView(buffer.data(), buffer.size(), 0, 0);
+
+  const bool normals = primitive.m_draco_ids[1] >= 0;
+  const bool texcoords = primitive.m_draco_ids[2] >= 0;
+  const bool colors = primitive.m_draco_ids[3] >= 0;
+
+  double min[3], max[3];
+  PositionBounds(data, min, max);
+  primitive.m_position = AddAccessor(-1, GLB_FLOAT, vertexCount, "VEC3", false, min, max, 3);
+  if (normals)
+    primitive.m_normal = AddAccessor(-1, GLB_FLOAT, vertexCount, "VEC3", false, nullptr, nullptr, 0);
+  if (texcoords)
+    primitive.m_texcoord = AddAccessor(-1, GLB_FLOAT, vertexCount, "VEC2", false, nullptr, nullptr, 0);
+  if (colors)
+    primitive.m_color = AddAccessor(-1, GLB_UNSIGNED_BYTE, vertexCount, "VEC4", true, nullptr, nullptr, 0);
+  primitive.m_indices = AddAccessor(-1, vertexCount <= 0xFFFF ? GLB_UNSIGNED_SHORT : GLB_UNSIGNED_INT, (int)data.m_indices.size(), "SCALAR", false, nullptr, nullptr, 0);
+  m_used_draco = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// xform must pass DecomposeTRS; everything else is baked into the mesh
+static void AppendTransform(std::string& json, const ON_Xform& xform)
+{
+  double t[3], r[4], s[3];
+  DecomposeTRS(xform, t, r, s);
+  json += ",\"translation\":";
+  AppendNumbers(json, t, 3);
+  json += ",\"rotation\":";
+  AppendNumbers(json, r, 4);
+  json += ",\"scale\":";
+  AppendNumbers(json, s, 3);
+}
+
+int BND_GlbBuilder::AddNode(int gltfMesh, const ON_Xform& xform)
+{
+  std::string json = "{\"mesh\":" + std::to_string(gltfMesh);
+  if (!xform.IsIdentity())
+    AppendTransform(json, xform);
+  json += '}';
+  m_nodes.push_back(json);
+  return (int)m_nodes.size() - 1;
+}
+
+int BND_GlbBuilder::AddInstanceNode(int gltfMesh, const std::vector<ON_Xform>& xforms)
+{
+  std::vector<float> translations, rotations, scales;
+  translations.reserve(3 * xforms.size());
+  rotations.reserve(4 * xforms.size());
+  scales.reserve(3 * xforms.size());
+  for (const ON_Xform& xform : xforms)
+  {
+    double t[3], r[4], s[3];
+    DecomposeTRS(xform, t, r, s);
+    translations.insert(translations.end(), { (float)t[0], (float)t[1], (float)t[2] });
+    rotations.insert(rotations.end(), { (float)r[0], (float)r[1], (float)r[2], (float)r[3] });
+    scales.insert(scales.end(), { (float)s[0], (float)s[1], (float)s[2] });
+  }
+  const int count = (int)xforms.size();
+  const int t = AddAccessor(AddBufferView(translations.data(), translations.size() * sizeof(float), 0, 0), GLB_FLOAT, count, "VEC3", false, nullptr, nullptr, 0);
+  const int r = AddAccessor(AddBufferView(rotations.data(), rotations.size() * sizeof(float), 0, 0), GLB_FLOAT, count, "VEC4", false, nullptr, nullptr, 0);
+  const int s = AddAccessor(AddBufferView(scales.data(), scales.size() * sizeof(float), 0, 0), GLB_FLOAT, count, "VEC3", false, nullptr, nullptr, 0);
+
+  m_nodes.push_back("{\"mesh\":" + std::to_string(gltfMesh) +
+    ",\"extensions\":{\"EXT_mesh_gpu_instancing\":{\"attributes\":{\"TRANSLATION\":" + std::to_string(t) +
+    ",\"ROTATION\":" + std::to_string(r) + ",\"SCALE\":" + std::to_string(s) + "}}}}");
+  m_used_instancing = true;
+  return (int)m_nodes.size() - 1;
+}
+
+// Writes the accessors of meshIndex on first use and returns a new glTF mesh
+// drawing them with material
+int BND_GlbBuilder::AddMesh(int meshIndex, int material)
+{
+  if (m_primitives.size() < m_meshes.size())
+    m_primitives.resize(m_meshes.size());
+  if (m_primitives[meshIndex].m_position < 0)
+  {
+    if (!m_draco || !WriteDracoPrimitive(meshIndex))
+      WritePrimitive(meshIndex);
+  }
+  const BND_GlbPrimitive& primitive = m_primitives[meshIndex];
+
+  std::string json = "{\"primitives\":[{\"attributes\":{\"POSITION\":" + std::to_string(primitive.m_position);
+  if (primitive.m_normal >= 0)
+    json += ",\"NORMAL\":" + std::to_string(primitive.m_normal);
+  if (primitive.m_texcoord >= 0)
+    json += ",\"TEXCOORD_0\":" + std::to_string(primitive.m_texcoord);
+  if (primitive.m_color >= 0)
+    json += ",\"COLOR_0\":" + std::to_string(primitive.m_color);
+  json += "},\"indices\":" + std::to_string(primitive.m_indices);
+  if (material >= 0)
+    json += ",\"material\":" + std::to_string(material);
+  if (primitive.m_draco_view >= 0)
+  {
+    static const char* names[4] = { "POSITION", "NORMAL", "TEXCOORD_0", "COLOR_0" };
+    json += ",\"extensions\":{\"KHR_draco_mesh_compression\":{\"bufferView\":" + std::to_string(primitive.m_draco_view) + ",\"attributes\":{";
+    bool first = true;
+    for (int i = 0; i < 4; i++)
+    {
+      if (primitive.m_draco_ids[i] < 0)
+        continue;
+      if (!first)
+        json += ',';
+      json += std::string("\"") + names[i] + "\":" + std::to_string(primitive.m_draco_ids[i]);
+      first = false;
+    }
+    json += "}}}";
+  }
+  json += "}]}";
+  m_gltf_meshes.push_back(json);
+  return (int)m_gltf_meshes.size() - 1;
+}
+
+void BND_GlbBuilder::Build()
+{
+  m_draco = m_options.m_use_draco;
+#if !defined(ON_INCLUDE_DRACO)
+  m_draco = false;
+#endif
+  m_quantize = m_options.m_quantize && !m_draco;
+
+  ONX_ModelComponentIterator iterator(m_model, ON_ModelComponent::Type::ModelGeometry);
+  for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+  {
+    const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    const ON_3dmObjectAttributes* attributes = geometryComponent ? geometryComponent->Attributes(nullptr) : nullptr;
+    if (nullptr == attributes || attributes->IsInstanceDefinitionObject())
+      continue;
+    AddObject(compref, -1, ON_Xform::IdentityTransformation, 0);
+  }
+
+  // every (mesh, material) pair becomes one glTF mesh placed by one or more transforms
+  std::map<std::pair<int, int>, std::vector<ON_Xform>> placements;
+  for (const Draw& draw : m_draws)
+    placements[std::make_pair(draw.m_mesh, draw.m_material)].push_back(draw.m_xform);
+
+  std::vector<int> children;
+  for (const auto& placement : placements)
+  {
+    const int meshIndex = placement.first.first;
+    const int material = placement.first.second;
+
+    // glTF nodes only hold translation / rotation / scale; other placements
+    // get a copy of the mesh with the transform applied to its vertices
+    int gltfMesh = -1;
+    std::vector<ON_Xform> instances;
+    for (const ON_Xform& xform : placement.second)
+    {
+      double t[3], r[4], s[3];
+      if (!DecomposeTRS(xform, t, r, s))
+      {
+        m_meshes.push_back(TransformMeshData(m_meshes[meshIndex], xform));
+        const int baked = (int)m_meshes.size() - 1;
+        const int bakedMesh = AddMesh(baked, material);
+        children.push_back(AddNode(bakedMesh, m_primitives[baked].m_dequantize));
+        continue;
+      }
+      if (gltfMesh < 0)
+        gltfMesh = AddMesh(meshIndex, material);
+      const ON_Xform placed = xform * m_primitives[meshIndex].m_dequantize;
+      if (m_options.m_gpu_instancing && placement.second.size() > 1)
+        instances.push_back(placed);
+      else
+        children.push_back(AddNode(gltfMesh, placed));
+    }
+    if (1 == instances.size())
+      children.push_back(AddNode(gltfMesh, instances[0]));
+    else if (instances.size() > 1)
+      children.push_back(AddInstanceNode(gltfMesh, instances));
+  }
+
+  // root node holding the Z-up to Y-up rotation
+  std::string root = "{\"name\":\"rhino3dm\"";
+  if (m_options.m_map_z_to_y)
+    root += ",\"rotation\":[-0.707106781,0,0,0.707106781]";
+  if (!children.empty())
+  {
+    root += ",\"children\":[";
+    for (size_t i = 0; i < children.size(); i++)
+    {
+      if (i > 0)
+        root += ',';
+      root += std::to_string(children[i] + 1);
+    }
+    root += ']';
+  }
+  root += '}';
+  m_nodes.insert(m_nodes.begin(), root);
+
+  std::vector<std::string> used, required;
+  if (m_used_draco)
+  {
+    used.push_back("\"KHR_draco_mesh_compression\"");
+    required.push_back("\"KHR_draco_mesh_compression\"");
+  }
+  if (m_used_quantization)
+  {
+    used.push_back("\"KHR_mesh_quantization\"");
+    required.push_back("\"KHR_mesh_quantization\"");
+  }
+  if (m_used_instancing)
+    used.push_back("\"EXT_mesh_gpu_instancing\"");
+
+  m_json = "{\"asset\":{\"version\":\"2.0\",\"generator\":\"rhino3dm\"}";
+  if (!used.empty())
+    m_json += ",\"extensionsUsed\":" + JoinArray(used);
+  if (!required.empty())
+    m_json += ",\"extensionsRequired\":" + JoinArray(required);
+  m_json += ",\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":" + JoinArray(m_nodes);
+  if (!m_gltf_meshes.empty())
+    m_json += ",\"meshes\":" + JoinArray(m_gltf_meshes);
+  if (!m_materials.empty())
+    m_json += ",\"materials\":" + JoinArray(m_materials);
+  if (!m_accessors.empty())
+    m_json += ",\"accessors\":" + JoinArray(m_accessors);
+  if (!m_buffer_views.empty())
+    m_json += ",\"bufferViews\":" + JoinArray(m_buffer_views);
+  if (!m_bin.empty())
+    m_json += ",\"buffers\":[{\"byteLength\":" + std::to_string(m_bin.size()) + "}]";
+  m_json += '}';
+}
+
+static void SetUInt32(unsigned char* bytes, ON__UINT32 value)
+{
+  // GLB integers are little endian
+  bytes[0] = (unsigned char)(value & 0xFF);
+  bytes[1] = (unsigned char)((value >> 8) & 0xFF);
+  bytes[2] = (unsigned char)((value >> 16) & 0xFF);
+  bytes[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+bool BND_WriteGlb(const ONX_Model& model, const BND_File3dmGlbOptions& options, const std::function<bool(const void*, size_t)>& sink)
+{
+  BND_GlbBuilder builder(model, options);
+  builder.Build();
+
+  const size_t jsonLength = (builder.m_json.size() + 3) & ~(size_t)3;
+  const size_t binLength = (builder.m_bin.size() + 3) & ~(size_t)3;
+  size_t totalLength = 12 + 8 + jsonLength;
+  if (binLength > 0)
+    totalLength += 8 + binLength;
+
+  unsigned char header[20];
+  SetUInt32(header, 0x46546C67); // "glTF"
+  SetUInt32(header + 4, 2);
+  SetUInt32(header + 8, (ON__UINT32)totalLength);
+  SetUInt32(header + 12, (ON__UINT32)jsonLength);
+  SetUInt32(header + 16, 0x4E4F534A); // "JSON"
+  const char spaces[4] = { ' ', ' ', ' ', ' ' };
+  if (!sink(header, sizeof(header)) || !sink(builder.m_json.data(), builder.m_json.size()) || !sink(spaces, jsonLength - builder.m_json.size()))
+    return false;
+
+  if (binLength > 0)
+  {
+    unsigned char chunk[8];
+    SetUInt32(chunk, (ON__UINT32)binLength);
+    SetUInt32(chunk + 4, 0x004E4942); // "BIN\0"
+    const unsigned char zeros[4] = { 0, 0, 0, 0 };
+    if (!sink(chunk, sizeof(chunk)) || !sink(builder.m_bin.data(), builder.m_bin.size()) || !sink(zeros, binLength - builder.m_bin.size()))
+      return false;
+  }
+  return true;
+}
+
+#if defined(ON_PYTHON_COMPILE)
+
+void initGltfBindings(rh3dmpymodule& m)
+{
+  py::class_<BND_File3dmGlbOptions>(m, "File3dmGlbOptions")
+    .def(py::init<>())
+    .def_readwrite("MapZToY", &BND_File3dmGlbOptions::m_map_z_to_y)
+    .def_readwrite("ExportMaterials", &BND_File3dmGlbOptions::m_export_materials)
+    .def_readwrite("UseGpuInstancing", &BND_File3dmGlbOptions::m_gpu_instancing)
+    .def_readwrite("QuantizeAttributes", &BND_File3dmGlbOptions::m_quantize)
+    .def_readwrite("UseDracoCompression", &BND_File3dmGlbOptions::m_use_draco)
+    .def_readwrite("DracoOptions", &BND_File3dmGlbOptions::m_draco_options)
+    .def_readwrite("OptimizeMeshes", &BND_File3dmGlbOptions::m_optimize_meshes)
+    ;
+}
+
+#endif
+
+#if defined(ON_WASM_COMPILE)
+using namespace emscripten;
+
+void initGltfBindings(void*)
+{
+  class_<BND_File3dmGlbOptions>("File3dmGlbOptions")
+    .constructor<>()
+    .property("mapZToY", &BND_File3dmGlbOptions::m_map_z_to_y)
+    .property("exportMaterials", &BND_File3dmGlbOptions::m_export_materials)
+    .property("useGpuInstancing", &BND_File3dmGlbOptions::m_gpu_instancing)
+    .property("quantizeAttributes", &BND_File3dmGlbOptions::m_quantize)
+    .property("useDracoCompression", &BND_File3dmGlbOptions::m_use_draco)
+    .property("dracoOptions", &BND_File3dmGlbOptions::m_draco_options)
+    .property("optimizeMeshes", &BND_File3dmGlbOptions::m_optimize_meshes)
+    ;
+}
+#endif
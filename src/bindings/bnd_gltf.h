@@ -0,0 +1,28 @@
+#include "bindings.h"
+
+#pragma once
+
+#if defined(ON_PYTHON_COMPILE)
+void initGltfBindings(rh3dmpymodule& m);
+#else
+void initGltfBindings(void* m);
+#endif
+
+class BND_File3dmGlbOptions
+{
+public:
+  bool m_map_z_to_y = true;          // wrap the scene in a node that turns Rhino's Z-up into glTF's Y-up
+  bool m_export_materials = true;    // PBR metallic-roughness materials from the model's render materials
+  bool m_gpu_instancing = true;      // EXT_mesh_gpu_instancing for meshes placed more than once
+  bool m_quantize = false;           // KHR_mesh_quantization: 16 bit positions, 8 bit normals
+  bool m_use_draco = false;          // KHR_draco_mesh_compression, takes precedence over m_quantize
+  bool m_optimize_meshes = false;    // vertex cache, overdraw and vertex fetch order, see mesh_optimize.h
+  BND_DracoCompressionOptions m_draco_options;
+};
+
+// Builds a binary glTF 2.0 file from the render meshes, materials and
+// instance references of model. The whole file is built in memory, BIN
+// chunk included, since the JSON chunk in front of it needs every buffer
+// view's offset; it is then handed to sink in file order (header, JSON
+// chunk, BIN chunk). Returns false if sink returns false.
+bool BND_WriteGlb(const ONX_Model& model, const BND_File3dmGlbOptions& options, const std::function<bool(const void*, size_t)>& sink);
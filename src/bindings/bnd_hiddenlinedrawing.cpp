@@ -0,0 +1,1001 @@
+#include "bindings.h"
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
+// ON_HiddenLineDrawing is part of the Rhino SDK and is not available in the
+// opennurbs build used for rhino3dm (see librhino3dm_native/on_hiddenlinedrawing.cpp).
+// This is a self contained make2D: wire curves, brep edges and mesh edges are
+// approximated with polylines, projected with the viewport's camera and tested
+// for occlusion against the render meshes stored in the model.
+
+bool BND_HiddenLineDrawingParameters::SetViewport(const BND_Viewport& viewport)
+{
+  if (nullptr == viewport.m_viewport || !viewport.m_viewport->IsValidCamera())
+    return false;
+  m_viewport = *viewport.m_viewport;
+  return true;
+}
+
+void BND_HiddenLineDrawingParameters::AddClippingPlane(const BND_Plane& plane)
+{
+  ON_Plane _plane = plane.ToOnPlane();
+  if (_plane.IsValid())
+    m_clipping_planes.Append(_plane.plane_equation);
+}
+
+int BND_HiddenLineDrawingParameters::AddGeometry(const BND_GeometryBase& geometry, const BND_Transform& xform, BND_UUID id)
+{
+  const ON_Geometry* g = geometry.GeometryPointer();
+  ON_Geometry* copy = g ? ON_Geometry::Cast(g->Duplicate()) : nullptr;
+  if (nullptr == copy)
+    return -1;
+
+  BND_HiddenLineSource source;
+  source.m_id = Binding_to_ON_UUID(id);
+  source.m_owned.reset(copy);
+  source.m_geometry = copy;
+  source.m_xform = xform.m_xform;
+  m_sources.push_back(source);
+  return (int)m_sources.size() - 1;
+}
+
+static void AddModelGeometry(BND_HiddenLineDrawingParameters& parameters, const ONX_Model& model, const ON_ModelComponentReference& compref, const ON_UUID& id, const ON_Xform& xform, int depth)
+{
+  const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+  const ON_Geometry* geometry = geometryComponent ? geometryComponent->Geometry(nullptr) : nullptr;
+  if (nullptr == geometry)
+    return;
+
+  const ON_InstanceRef* iref = ON_InstanceRef::Cast(geometry);
+  if (iref)
+  {
+    // guard against definitions that reference themselves
+    if (depth > 16)
+      return;
+    const ON_ModelComponentReference& idef_compref = model.ComponentFromId(ON_ModelComponent::Type::InstanceDefinition, iref->m_instance_definition_uuid);
+    const ON_InstanceDefinition* idef = ON_InstanceDefinition::Cast(idef_compref.ModelComponent());
+    if (nullptr == idef)
+      return;
+    const ON_Xform instance_xform = xform * iref->m_xform;
+    const ON_SimpleArray<ON_UUID>& ids = idef->InstanceGeometryIdList();
+    for (int i = 0; i < ids.Count(); i++)
+    {
+      ON_ModelComponentReference child = model.ComponentFromId(ON_ModelComponent::Type::ModelGeometry, ids[i]);
+      AddModelGeometry(parameters, model, child, id, instance_xform, depth + 1);
+    }
+    return;
+  }
+
+  BND_HiddenLineSource source;
+  source.m_id = id;
+  source.m_geometry = geometry;
+  source.m_xform = xform;
+  source.m_compref = compref;
+  parameters.m_sources.push_back(source);
+}
+
+int BND_HiddenLineDrawingParameters::AddObjects(const BND_ONXModel& model)
+{
+  const ONX_Model& onx_model = *model.m_model.get();
+  int count = 0;
+  ONX_ModelComponentIterator iterator(onx_model, ON_ModelComponent::Type::ModelGeometry);
+  for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+  {
+    const ON_ModelGeometryComponent* geometryComponent = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+    const ON_3dmObjectAttributes* attributes = geometryComponent ? geometryComponent->Attributes(nullptr) : nullptr;
+    if (nullptr == attributes || !attributes->IsVisible() || attributes->IsInstanceDefinitionObject())
+      continue;
+    const ON_Layer* layer = ON_Layer::Cast(onx_model.ComponentFromIndex(ON_ModelComponent::Type::Layer, attributes->m_layer_index).ModelComponent());
+    if (layer && !layer->IsVisible())
+      continue;
+
+    const size_t previous_count = m_sources.size();
+    AddModelGeometry(*this, onx_model, compref, geometryComponent->Id(), ON_Xform::IdentityTransformation, 0);
+    if (m_sources.size() > previous_count)
+      count++;
+  }
+  return count;
+}
+
+BND_TUPLE BND_HiddenLineDrawing::SourceIds() const
+{
+#if defined(ON_PYTHON_COMPILE) && defined(NANOBIND)
+  py::list ids;
+  for (const ON_UUID& id : m_source_ids)
+    ids.append(ON_UUID_to_Binding(id));
+  return py::tuple(ids);
+#else
+  BND_TUPLE rc = CreateTuple((int)m_source_ids.size());
+  for (int i = 0; i < (int)m_source_ids.size(); i++)
+    SetTuple(rc, i, ON_UUID_to_Binding(m_source_ids[i]));
+  return rc;
+#endif
+}
+
+BND_BoundingBox BND_HiddenLineDrawing::BoundingBox() const
+{
+  ON_BoundingBox bbox;
+  for (size_t i = 0; i + 1 < m_points.size(); i += 2)
+    bbox.Set(ON_3dPoint(m_points[i], m_points[i + 1], 0.0), bbox.IsValid());
+  return BND_BoundingBox(bbox);
+}
+
+// Camera projection. x and y are view plane coordinates, z is the distance
+// in front of the camera
+struct HLDProjector
+{
+  ON_Xform m_world_to_camera = ON_Xform::IdentityTransformation;
+  ON_3dPoint m_camera_location = ON_3dPoint::Origin;
+  ON_3dVector m_camera_direction = -ON_3dVector::ZAxis;
+  bool m_perspective = false;
+  double m_target_distance = 1.0;
+  double m_near = 0.0;
+
+  bool Create(const ON_Viewport& viewport)
+  {
+    if (!viewport.IsValidCamera())
+      return false;
+    if (!viewport.GetXform(ON::world_cs, ON::camera_cs, m_world_to_camera))
+      return false;
+    m_camera_location = viewport.CameraLocation();
+    m_camera_direction = viewport.CameraDirection();
+    m_camera_direction.Unitize();
+    m_perspective = viewport.IsPerspectiveProjection();
+    if (m_perspective)
+    {
+      m_target_distance = viewport.TargetDistance(true);
+      m_near = viewport.FrustumNear();
+      if (!(m_target_distance > 0.0))
+        m_target_distance = 1.0;
+      if (!(m_near > 0.0))
+        m_near = 1.0e-3 * m_target_distance;
+    }
+    return true;
+  }
+
+  ON_3dPoint Project(const ON_3dPoint& point) const
+  {
+    const ON_3dPoint c = m_world_to_camera * point;
+    const double depth = -c.z;
+    if (m_perspective && depth > 0.0)
+    {
+      const double s = m_target_distance / depth;
+      return ON_3dPoint(c.x * s, c.y * s, depth);
+    }
+    return ON_3dPoint(c.x, c.y, depth);
+  }
+
+  bool CanProject(const ON_3dPoint& view) const
+  {
+    return !m_perspective || view.z > m_near;
+  }
+
+  ON_3dVector ViewDirection(const ON_3dPoint& point) const
+  {
+    return m_perspective ? point - m_camera_location : m_camera_direction;
+  }
+};
+
+struct HLDTriangle
+{
+  ON_3dPoint m_world[3];
+  ON_3dPoint m_view[3];
+};
+
+struct HLDScene
+{
+  HLDProjector m_projector;
+  std::vector<ON_PlaneEquation> m_planes; // clipping planes + near plane
+  std::vector<HLDTriangle> m_triangles;
+  ON_RTree m_tree;
+  double m_tolerance = 0.001;
+  double m_depth_bias = 0.0;
+  double m_sample_step = 0.0;
+
+  bool IsClipped(const ON_3dPoint& point) const
+  {
+    for (const ON_PlaneEquation& plane : m_planes)
+    {
+      if (plane.ValueAt(point) < 0.0)
+        return true;
+    }
+    return false;
+  }
+
+  bool Occludes(const HLDTriangle& triangle, const ON_3dPoint& view) const
+  {
+    const ON_3dPoint* v = triangle.m_view;
+    const double d = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+    if (0.0 == d)
+      return false;
+    double b[3];
+    b[1] = ((view.x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (view.y - v[0].y)) / d;
+    b[2] = ((v[1].x - v[0].x) * (view.y - v[0].y) - (view.x - v[0].x) * (v[1].y - v[0].y)) / d;
+    b[0] = 1.0 - b[1] - b[2];
+    if (b[0] < 0.0 || b[1] < 0.0 || b[2] < 0.0)
+      return false;
+
+    double depth = 0.0;
+    if (m_projector.m_perspective)
+    {
+      // 1/depth is linear in the view plane
+      for (int i = 0; i < 3; i++)
+      {
+        b[i] /= v[i].z;
+        depth += b[i];
+      }
+      depth = 1.0 / depth;
+      for (int i = 0; i < 3; i++)
+        b[i] *= depth;
+    }
+    else
+    {
+      depth = b[0] * v[0].z + b[1] * v[1].z + b[2] * v[2].z;
+    }
+    if (depth >= view.z - m_depth_bias)
+      return false;
+
+    // the part of the occluder in front of the point may itself be clipped away
+    if (!m_planes.empty())
+    {
+      const ON_3dPoint* w = triangle.m_world;
+      const ON_3dPoint hit = b[0] * w[0] + b[1] * w[1] + b[2] * w[2];
+      if (IsClipped(hit))
+        return false;
+    }
+    return true;
+  }
+
+  bool IsVisible(const ON_3dPoint& view) const;
+};
+
+struct HLDOcclusionSearch
+{
+  const HLDScene* m_scene = nullptr;
+  ON_3dPoint m_view;
+  bool m_hidden = false;
+};
+
+static bool OcclusionSearchCallback(void* context, ON__INT_PTR id)
+{
+  HLDOcclusionSearch* search = static_cast<HLDOcclusionSearch*>(context);
+  if (search->m_scene->Occludes(search->m_scene->m_triangles[(size_t)id], search->m_view))
+  {
+    search->m_hidden = true;
+    return false; // stop searching
+  }
+  return true;
+}
+
+bool HLDScene::IsVisible(const ON_3dPoint& view) const
+{
+  if (m_triangles.empty())
+    return true;
+  HLDOcclusionSearch search;
+  search.m_scene = this;
+  search.m_view = view;
+  ON_RTreeBBox box;
+  box.m_min[0] = box.m_max[0] = view.x;
+  box.m_min[1] = box.m_max[1] = view.y;
+  box.m_min[2] = box.m_max[2] = 0.0;
+  m_tree.Search(&box, OcclusionSearchCallback, &search);
+  return !search.m_hidden;
+}
+
+struct HLDCandidate
+{
+  HiddenLineSegmentType m_type = HiddenLineSegmentType::Unset;
+  std::vector<ON_3dPoint> m_points; // world coordinates
+};
+
+struct HLDRun
+{
+  unsigned char m_type = 0;
+  unsigned char m_visibility = 0;
+  std::vector<ON_2dPoint> m_points;
+};
+
+struct HLDSourceData
+{
+  const ON_Curve* m_curve = nullptr;
+  const ON_Mesh* m_mesh = nullptr;
+  const ON_Brep* m_brep = nullptr;
+  std::unique_ptr<ON_Brep> m_brep_form; // brep form of extrusions and surfaces
+  std::vector<const ON_Mesh*> m_render_meshes;
+  ON_Xform m_xform = ON_Xform::IdentityTransformation;
+  std::vector<HLDTriangle> m_triangles;
+  std::vector<HLDRun> m_runs;
+};
+
+static void SubdivideCurve(const ON_Curve& curve, double t0, const ON_3dPoint& p0, double t1, const ON_3dPoint& p1, double tolerance, int depth, std::vector<ON_3dPoint>& points)
+{
+  const double tm = 0.5 * (t0 + t1);
+  const ON_3dPoint pm = curve.PointAt(tm);
+  if (depth < 16 && ON_Line(p0, p1).MinimumDistanceTo(pm) > tolerance)
+  {
+    SubdivideCurve(curve, t0, p0, tm, pm, tolerance, depth + 1, points);
+    SubdivideCurve(curve, tm, pm, t1, p1, tolerance, depth + 1, points);
+    return;
+  }
+  points.push_back(p1);
+}
+
+static void CurveToPolyline(const ON_Curve& curve, double tolerance, std::vector<ON_3dPoint>& points)
+{
+  ON_SimpleArray<ON_3dPoint> polyline;
+  if (curve.IsPolyline(&polyline) >= 2)
+  {
+    points.assign(polyline.Array(), polyline.Array() + polyline.Count());
+    return;
+  }
+
+  const int span_count = curve.SpanCount();
+  if (span_count < 1)
+    return;
+  ON_SimpleArray<double> spans(span_count + 1);
+  spans.SetCount(span_count + 1);
+  if (!curve.GetSpanVector(spans.Array()))
+    return;
+
+  // a few fixed steps per span so s-shaped spans are not mistaken for lines
+  const int steps = 4;
+  ON_3dPoint p0 = curve.PointAt(spans[0]);
+  points.push_back(p0);
+  for (int i = 0; i < span_count; i++)
+  {
+    for (int j = 0; j < steps; j++)
+    {
+      const double t0 = spans[i] + (spans[i + 1] - spans[i]) * j / steps;
+      const double t1 = spans[i] + (spans[i + 1] - spans[i]) * (j + 1) / steps;
+      const ON_3dPoint p1 = curve.PointAt(t1);
+      SubdivideCurve(curve, t0, p0, t1, p1, tolerance, 0, points);
+      p0 = p1;
+    }
+  }
+}
+
+static void AddCurveCandidate(const ON_Curve& curve, const ON_Xform& xform, HiddenLineSegmentType type, double tolerance, std::vector<HLDCandidate>& candidates)
+{
+  HLDCandidate candidate;
+  candidate.m_type = type;
+  CurveToPolyline(curve, tolerance, candidate.m_points);
+  if (candidate.m_points.size() < 2)
+    return;
+  if (!xform.IsIdentity())
+  {
+    for (ON_3dPoint& point : candidate.m_points)
+      point = xform * point;
+  }
+  candidates.push_back(std::move(candidate));
+}
+
+static ON_3dVector TrimFaceNormal(const ON_Brep& brep, int trim_index)
+{
+  const ON_BrepTrim& trim = brep.m_T[trim_index];
+  const ON_BrepFace* face = trim.Face();
+  if (nullptr == face)
+    return ON_3dVector::UnsetVector;
+  const ON_3dPoint uv = trim.PointAt(trim.Domain().Mid());
+  ON_3dVector normal = face->NormalAt(uv.x, uv.y);
+  return face->m_bRev ? -normal : normal;
+}
+
+static HiddenLineSegmentType BrepEdgeType(const ON_Brep& brep, const ON_BrepEdge& edge)
+{
+  const int trim_count = edge.m_ti.Count();
+  if (0 == trim_count)
+    return HiddenLineSegmentType::Curve;
+  if (1 == trim_count)
+    return HiddenLineSegmentType::Boundary;
+  if (trim_count > 2)
+    return HiddenLineSegmentType::Crease;
+
+  const ON_BrepTrim& trim0 = brep.m_T[edge.m_ti[0]];
+  const ON_BrepTrim& trim1 = brep.m_T[edge.m_ti[1]];
+  if (trim0.Face() == trim1.Face())
+    return HiddenLineSegmentType::Tangent; // seam
+
+  const ON_3dVector n0 = TrimFaceNormal(brep, edge.m_ti[0]);
+  const ON_3dVector n1 = TrimFaceNormal(brep, edge.m_ti[1]);
+  if (n0.IsValid() && n1.IsValid() && n0.IsNotZero() && n1.IsNotZero())
+  {
+    const double tangent_cos = cos(ON_PI / 180.0);
+    if (ON_DotProduct(n0.UnitVector(), n1.UnitVector()) > tangent_cos)
+      return HiddenLineSegmentType::Tangent;
+  }
+  return HiddenLineSegmentType::Crease;
+}
+
+static void AddBrepCandidates(const ON_Brep& brep, const ON_Xform& xform, bool includeTangents, double tolerance, std::vector<HLDCandidate>& candidates)
+{
+  for (int i = 0; i < brep.m_E.Count(); i++)
+  {
+    const ON_BrepEdge& edge = brep.m_E[i];
+    const HiddenLineSegmentType type = BrepEdgeType(brep, edge);
+    if (HiddenLineSegmentType::Tangent == type && !includeTangents)
+      continue;
+    AddCurveCandidate(edge, xform, type, tolerance, candidates);
+  }
+}
+
+// Joins edges (pairs of vertex indices) into chains of vertex indices
+// wherever exactly two edges meet
+static void ChainEdges(const std::vector<std::pair<int, int>>& edges, std::vector<std::vector<int>>& chains)
+{
+  std::unordered_map<int, std::vector<int>> vertex_edges;
+  for (int i = 0; i < (int)edges.size(); i++)
+  {
+    vertex_edges[edges[i].first].push_back(i);
+    vertex_edges[edges[i].second].push_back(i);
+  }
+
+  std::vector<bool> used(edges.size(), false);
+  for (int i = 0; i < (int)edges.size(); i++)
+  {
+    if (used[i])
+      continue;
+    used[i] = true;
+    std::deque<int> chain{ edges[i].first, edges[i].second };
+    for (int pass = 0; pass < 2; pass++)
+    {
+      for (;;)
+      {
+        const int v = 0 == pass ? chain.back() : chain.front();
+        const std::vector<int>& adjacent = vertex_edges[v];
+        if (adjacent.size() != 2)
+          break;
+        const int next = used[adjacent[0]] ? adjacent[1] : adjacent[0];
+        if (used[next])
+          break;
+        used[next] = true;
+        const int w = edges[next].first == v ? edges[next].second : edges[next].first;
+        if (0 == pass)
+          chain.push_back(w);
+        else
+          chain.push_front(w);
+      }
+    }
+    chains.emplace_back(chain.begin(), chain.end());
+  }
+}
+
+// Boundary and crease edges are only reported for mesh objects. Render meshes
+// of breps contribute silhouettes; their boundaries are the brep edges.
+static void AddMeshCandidates(const ON_Mesh& mesh, const ON_Xform& xform, bool renderMesh, const HLDProjector& projector, std::vector<HLDCandidate>& candidates)
+{
+  const ON_MeshTopology& top = mesh.Topology();
+  std::vector<ON_3dPoint> top_points(top.m_topv.Count(), ON_3dPoint::UnsetPoint);
+  for (int i = 0; i < top.m_topv.Count(); i++)
+  {
+    const ON_MeshTopologyVertex& v = top.m_topv[i];
+    if (v.m_v_count > 0)
+      top_points[i] = xform * mesh.Vertex(v.m_vi[0]);
+  }
+
+  std::vector<ON_3dVector> normals(mesh.m_F.Count());
+  for (int i = 0; i < mesh.m_F.Count(); i++)
+  {
+    const ON_MeshFace& face = mesh.m_F[i];
+    ON_3dPoint p[4];
+    for (int j = 0; j < 4; j++)
+      p[j] = xform * mesh.Vertex(face.vi[j]);
+    normals[i] = ON_CrossProduct(p[2] - p[0], p[3] - p[1]);
+    normals[i].Unitize();
+  }
+
+  const double crease_cos = cos(30.0 * ON_PI / 180.0);
+  std::vector<std::pair<int, int>> edges[6];
+  for (int i = 0; i < top.m_tope.Count(); i++)
+  {
+    const ON_MeshTopologyEdge& edge = top.m_tope[i];
+    const ON_3dPoint& p0 = top_points[edge.m_topvi[0]];
+    const ON_3dPoint& p1 = top_points[edge.m_topvi[1]];
+    if (!p0.IsValid() || !p1.IsValid())
+      continue;
+
+    HiddenLineSegmentType type = HiddenLineSegmentType::Unset;
+    if (1 == edge.m_topf_count)
+    {
+      if (!renderMesh)
+        type = HiddenLineSegmentType::Boundary;
+    }
+    else if (2 == edge.m_topf_count)
+    {
+      const ON_3dVector& n0 = normals[edge.m_topfi[0]];
+      const ON_3dVector& n1 = normals[edge.m_topfi[1]];
+      if (!renderMesh && ON_DotProduct(n0, n1) < crease_cos)
+        type = HiddenLineSegmentType::Crease;
+      else
+      {
+        const ON_3dVector direction = projector.ViewDirection(0.5 * (p0 + p1));
+        if ((ON_DotProduct(n0, direction) < 0.0) != (ON_DotProduct(n1, direction) < 0.0))
+          type = HiddenLineSegmentType::Silhouette;
+      }
+    }
+    else if (!renderMesh)
+    {
+      type = HiddenLineSegmentType::Crease;
+    }
+
+    if (HiddenLineSegmentType::Unset != type)
+      edges[(int)type].push_back(std::make_pair(edge.m_topvi[0], edge.m_topvi[1]));
+  }
+
+  for (int type = 0; type < 6; type++)
+  {
+    std::vector<std::vector<int>> chains;
+    ChainEdges(edges[type], chains);
+    for (const std::vector<int>& chain : chains)
+    {
+      HLDCandidate candidate;
+      candidate.m_type = (HiddenLineSegmentType)type;
+      candidate.m_points.reserve(chain.size());
+      for (int vi : chain)
+        candidate.m_points.push_back(top_points[vi]);
+      candidates.push_back(std::move(candidate));
+    }
+  }
+}
+
+static void AddMeshTriangles(const ON_Mesh& mesh, const ON_Xform& xform, const HLDScene& scene, std::vector<HLDTriangle>& triangles)
+{
+  auto add_triangle = [&](const ON_3dPoint& a, const ON_3dPoint& b, const ON_3dPoint& c)
+  {
+    HLDTriangle triangle;
+    triangle.m_world[0] = a;
+    triangle.m_world[1] = b;
+    triangle.m_world[2] = c;
+    for (int i = 0; i < 3; i++)
+    {
+      triangle.m_view[i] = scene.m_projector.Project(triangle.m_world[i]);
+      if (!scene.m_projector.CanProject(triangle.m_view[i]))
+        return;
+    }
+    // triangles completely on the clipped side of one plane never occlude
+    for (const ON_PlaneEquation& plane : scene.m_planes)
+    {
+      if (plane.ValueAt(a) < 0.0 && plane.ValueAt(b) < 0.0 && plane.ValueAt(c) < 0.0)
+        return;
+    }
+    triangles.push_back(triangle);
+  };
+
+  triangles.reserve(triangles.size() + 2 * mesh.m_F.Count());
+  for (int i = 0; i < mesh.m_F.Count(); i++)
+  {
+    const ON_MeshFace& face = mesh.m_F[i];
+    ON_3dPoint p[4];
+    for (int j = 0; j < 4; j++)
+      p[j] = xform * mesh.Vertex(face.vi[j]);
+    add_triangle(p[0], p[1], p[2]);
+    if (face.IsQuad())
+      add_triangle(p[0], p[2], p[3]);
+  }
+}
+
+// Collects projected points into runs of equal visibility
+class HLDRunBuilder
+{
+public:
+  HLDRunBuilder(const BND_HiddenLineDrawingParameters& parameters, HiddenLineSegmentType type, std::vector<HLDRun>& runs)
+    : m_parameters(parameters), m_type((unsigned char)type), m_runs(runs) {}
+  ~HLDRunBuilder() { Break(); }
+
+  void Add(const ON_3dPoint& view, HiddenLineSegmentVisibility visibility)
+  {
+    const unsigned char v = (unsigned char)visibility;
+    if (m_current.m_visibility != v)
+    {
+      Break();
+      m_current.m_visibility = v;
+    }
+    const ON_2dPoint point(view.x, view.y);
+    if (m_current.m_points.empty() || m_current.m_points.back() != point)
+      m_current.m_points.push_back(point);
+  }
+
+  void Break()
+  {
+    if (m_current.m_points.size() > 1 && Keep((HiddenLineSegmentVisibility)m_current.m_visibility))
+    {
+      m_current.m_type = m_type;
+      m_runs.push_back(std::move(m_current));
+    }
+    m_current = HLDRun();
+  }
+
+private:
+  bool Keep(HiddenLineSegmentVisibility visibility) const
+  {
+    switch (visibility)
+    {
+    case HiddenLineSegmentVisibility::Visible:
+      return true;
+    case HiddenLineSegmentVisibility::Hidden:
+      return m_parameters.m_include_hidden_curves;
+    case HiddenLineSegmentVisibility::Clipped:
+      return m_parameters.m_include_clipped_curves;
+    default:
+      return false;
+    }
+  }
+
+  const BND_HiddenLineDrawingParameters& m_parameters;
+  unsigned char m_type;
+  std::vector<HLDRun>& m_runs;
+  HLDRun m_current;
+};
+
+// Clips segment a-b to the inside of all planes. Returns false when the
+// whole segment is clipped, otherwise [t0, t1] is the inside portion.
+static bool ClipSegment(const std::vector<ON_PlaneEquation>& planes, const ON_3dPoint& a, const ON_3dPoint& b, double& t0, double& t1)
+{
+  t0 = 0.0;
+  t1 = 1.0;
+  for (const ON_PlaneEquation& plane : planes)
+  {
+    const double va = plane.ValueAt(a);
+    const double vb = plane.ValueAt(b);
+    if (va < 0.0 && vb < 0.0)
+      return false;
+    if (va >= 0.0 && vb >= 0.0)
+      continue;
+    const double t = va / (va - vb);
+    if (va < 0.0)
+      t0 = std::max(t0, t);
+    else
+      t1 = std::min(t1, t);
+    if (t0 >= t1)
+      return false;
+  }
+  return true;
+}
+
+static void AddClippedPiece(const HLDScene& scene, const ON_3dPoint& a, const ON_3dPoint& b, HLDRunBuilder& builder)
+{
+  const ON_3dPoint va = scene.m_projector.Project(a);
+  const ON_3dPoint vb = scene.m_projector.Project(b);
+  if (!scene.m_projector.CanProject(va) || !scene.m_projector.CanProject(vb))
+  {
+    builder.Break();
+    return;
+  }
+  builder.Add(va, HiddenLineSegmentVisibility::Clipped);
+  builder.Add(vb, HiddenLineSegmentVisibility::Clipped);
+}
+
+static void AddVisiblePiece(const HLDScene& scene, const ON_3dPoint& a, const ON_3dPoint& b, HLDRunBuilder& builder)
+{
+  const ON_3dPoint va = scene.m_projector.Project(a);
+  const ON_3dPoint vb = scene.m_projector.Project(b);
+  int samples = 1;
+  if (!scene.m_triangles.empty() && scene.m_sample_step > 0.0)
+  {
+    const double length = ON_2dVector(vb.x - va.x, vb.y - va.y).Length();
+    samples = (int)std::min(4096.0, std::max(1.0, ceil(length / scene.m_sample_step)));
+  }
+
+  auto visibility = [&scene](const ON_3dPoint& view)
+  {
+    return scene.IsVisible(view) ? HiddenLineSegmentVisibility::Visible : HiddenLineSegmentVisibility::Hidden;
+  };
+
+  double t_prev = 0.0;
+  ON_3dPoint v_prev = va;
+  HiddenLineSegmentVisibility vis_prev = visibility(va);
+  builder.Add(va, vis_prev);
+  for (int i = 1; i <= samples; i++)
+  {
+    const double t = (double)i / samples;
+    const ON_3dPoint v = i == samples ? vb : scene.m_projector.Project((1.0 - t) * a + t * b);
+    const HiddenLineSegmentVisibility vis = visibility(v);
+    if (vis != vis_prev)
+    {
+      // bisect to the visibility change
+      double t0 = t_prev, t1 = t;
+      ON_3dPoint v0 = v_prev, v1 = v;
+      for (int j = 0; j < 48 && ON_2dVector(v1.x - v0.x, v1.y - v0.y).Length() > scene.m_tolerance; j++)
+      {
+        const double tm = 0.5 * (t0 + t1);
+        const ON_3dPoint vm = scene.m_projector.Project((1.0 - tm) * a + tm * b);
+        if (visibility(vm) == vis_prev)
+        {
+          t0 = tm;
+          v0 = vm;
+        }
+        else
+        {
+          t1 = tm;
+          v1 = vm;
+        }
+      }
+      builder.Add(v0, vis_prev);
+      builder.Add(v0, vis);
+    }
+    builder.Add(v, vis);
+    t_prev = t;
+    v_prev = v;
+    vis_prev = vis;
+  }
+}
+
+static void ClassifyCandidate(const HLDScene& scene, const BND_HiddenLineDrawingParameters& parameters, const HLDCandidate& candidate, std::vector<HLDRun>& runs)
+{
+  HLDRunBuilder builder(parameters, candidate.m_type, runs);
+  for (size_t i = 0; i + 1 < candidate.m_points.size(); i++)
+  {
+    const ON_3dPoint& a = candidate.m_points[i];
+    const ON_3dPoint& b = candidate.m_points[i + 1];
+    double t0 = 0.0, t1 = 1.0;
+    if (!ClipSegment(scene.m_planes, a, b, t0, t1))
+    {
+      AddClippedPiece(scene, a, b, builder);
+      continue;
+    }
+    const ON_3dPoint p0 = (1.0 - t0) * a + t0 * b;
+    const ON_3dPoint p1 = (1.0 - t1) * a + t1 * b;
+    if (t0 > 0.0)
+      AddClippedPiece(scene, a, p0, builder);
+    AddVisiblePiece(scene, p0, p1, builder);
+    if (t1 < 1.0)
+      AddClippedPiece(scene, p1, b, builder);
+  }
+}
+
+BND_HiddenLineDrawing* BND_HiddenLineDrawing::Compute(const BND_HiddenLineDrawingParameters& parameters, bool multipleThreads)
+{
+  HLDScene scene;
+  if (!scene.m_projector.Create(parameters.m_viewport))
+    return nullptr;
+  scene.m_tolerance = parameters.m_absolute_tolerance > 0.0 ? parameters.m_absolute_tolerance : 0.001;
+  for (int i = 0; i < parameters.m_clipping_planes.Count(); i++)
+    scene.m_planes.push_back(parameters.m_clipping_planes[i]);
+  if (scene.m_projector.m_perspective)
+  {
+    ON_PlaneEquation near_plane;
+    const ON_3dPoint near_point = scene.m_projector.m_camera_location + scene.m_projector.m_near * scene.m_projector.m_camera_direction;
+    if (near_plane.Create(near_point, scene.m_projector.m_camera_direction))
+      scene.m_planes.push_back(near_plane);
+  }
+
+  const int thread_count = multipleThreads ? ParallelThreadCount(0) : 1;
+  const int source_count = (int)parameters.m_sources.size();
+
+  // gather geometry and build mesh topology up front; topology is created
+  // lazily by opennurbs and meshes may be shared between instances
+  std::vector<HLDSourceData> sources(source_count);
+  for (int i = 0; i < source_count; i++)
+  {
+    const BND_HiddenLineSource& source = parameters.m_sources[i];
+    HLDSourceData& data = sources[i];
+    data.m_xform = source.m_xform;
+    const ON_Geometry* geometry = source.m_geometry;
+    if (nullptr == geometry)
+      continue;
+
+    if (const ON_Curve* curve = ON_Curve::Cast(geometry))
+      data.m_curve = curve;
+    else if (const ON_Mesh* mesh = ON_Mesh::Cast(geometry))
+      data.m_mesh = mesh;
+    else if (const ON_Brep* brep = ON_Brep::Cast(geometry))
+    {
+      data.m_brep = brep;
+      for (int fi = 0; fi < brep->m_F.Count(); fi++)
+      {
+        const ON_Mesh* render_mesh = brep->m_F[fi].Mesh(ON::render_mesh);
+        if (render_mesh)
+          data.m_render_meshes.push_back(render_mesh);
+      }
+    }
+    else if (const ON_Extrusion* extrusion = ON_Extrusion::Cast(geometry))
+    {
+      data.m_brep_form.reset(extrusion->BrepForm());
+      data.m_brep = data.m_brep_form.get();
+      const ON_Mesh* render_mesh = extrusion->m_mesh_cache.Mesh(ON::render_mesh);
+      if (render_mesh)
+        data.m_render_meshes.push_back(render_mesh);
+    }
+    else if (ON_Surface::Cast(geometry))
+    {
+      data.m_brep_form.reset(geometry->BrepForm());
+      data.m_brep = data.m_brep_form.get();
+    }
+
+    if (data.m_mesh)
+      data.m_mesh->Topology();
+    for (const ON_Mesh* render_mesh : data.m_render_meshes)
+      render_mesh->Topology();
+  }
+
+  // occluding triangles
+  ParallelFor(source_count, thread_count, [&](int i)
+  {
+    HLDSourceData& data = sources[i];
+    if (data.m_mesh)
+      AddMeshTriangles(*data.m_mesh, data.m_xform, scene, data.m_triangles);
+    for (const ON_Mesh* render_mesh : data.m_render_meshes)
+      AddMeshTriangles(*render_mesh, data.m_xform, scene, data.m_triangles);
+  });
+
+  ON_BoundingBox world_bbox;
+  ON_BoundingBox view_bbox;
+  for (HLDSourceData& data : sources)
+  {
+    for (const HLDTriangle& triangle : data.m_triangles)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        world_bbox.Set(triangle.m_world[i], world_bbox.IsValid());
+        view_bbox.Set(ON_3dPoint(triangle.m_view[i].x, triangle.m_view[i].y, 0.0), view_bbox.IsValid());
+      }
+      scene.m_triangles.push_back(triangle);
+    }
+    std::vector<HLDTriangle>().swap(data.m_triangles);
+  }
+
+  for (int i = 0; i < (int)scene.m_triangles.size(); i++)
+  {
+    const HLDTriangle& triangle = scene.m_triangles[i];
+    double box_min[3] = { triangle.m_view[0].x, triangle.m_view[0].y, 0.0 };
+    double box_max[3] = { triangle.m_view[0].x, triangle.m_view[0].y, 0.0 };
+    for (int j = 1; j < 3; j++)
+    {
+      box_min[0] = std::min(box_min[0], triangle.m_view[j].x);
+      box_min[1] = std::min(box_min[1], triangle.m_view[j].y);
+      box_max[0] = std::max(box_max[0], triangle.m_view[j].x);
+      box_max[1] = std::max(box_max[1], triangle.m_view[j].y);
+    }
+    scene.m_tree.Insert(box_min, box_max, i);
+  }
+
+  // Render meshes only approximate their surfaces, so points are hidden
+  // when they are more than the depth bias behind an occluder. Occluders
+  // narrower than the sample step (1/2000 of the view extents) can be missed.
+  if (world_bbox.IsValid())
+    scene.m_depth_bias = std::max(10.0 * scene.m_tolerance, 1.0e-4 * world_bbox.Diagonal().Length());
+  if (view_bbox.IsValid())
+    scene.m_sample_step = std::max(scene.m_tolerance, view_bbox.Diagonal().Length() / 2000.0);
+
+  // candidate curves, clipped and split by visibility
+  ParallelFor(source_count, thread_count, [&](int i)
+  {
+    HLDSourceData& data = sources[i];
+    std::vector<HLDCandidate> candidates;
+    if (data.m_curve)
+      AddCurveCandidate(*data.m_curve, data.m_xform, HiddenLineSegmentType::Curve, scene.m_tolerance, candidates);
+    if (data.m_mesh)
+      AddMeshCandidates(*data.m_mesh, data.m_xform, false, scene.m_projector, candidates);
+    if (data.m_brep)
+      AddBrepCandidates(*data.m_brep, data.m_xform, parameters.m_include_tangent_edges, scene.m_tolerance, candidates);
+    for (const ON_Mesh* render_mesh : data.m_render_meshes)
+      AddMeshCandidates(*render_mesh, data.m_xform, true, scene.m_projector, candidates);
+
+    for (const HLDCandidate& candidate : candidates)
+      ClassifyCandidate(scene, parameters, candidate, data.m_runs);
+  });
+
+  BND_HiddenLineDrawing* rc = new BND_HiddenLineDrawing();
+  rc->m_offsets.push_back(0);
+  for (int i = 0; i < source_count; i++)
+  {
+    const ON_UUID& id = parameters.m_sources[i].m_id;
+    if (rc->m_source_ids.empty() || rc->m_source_ids.back() != id)
+      rc->m_source_ids.push_back(id);
+    const int source_index = (int)rc->m_source_ids.size() - 1;
+
+    for (const HLDRun& run : sources[i].m_runs)
+    {
+      for (const ON_2dPoint& point : run.m_points)
+      {
+        rc->m_points.push_back(point.x);
+        rc->m_points.push_back(point.y);
+      }
+      rc->m_offsets.push_back((int)(rc->m_points.size() / 2));
+      rc->m_visibility.push_back(run.m_visibility);
+      rc->m_segment_types.push_back(run.m_type);
+      rc->m_source_indices.push_back(source_index);
+    }
+  }
+  return rc;
+}
+
+
+#if defined(ON_PYTHON_COMPILE)
+
+void initHiddenLineDrawingBindings(rh3dmpymodule& m)
+{
+  py::enum_<HiddenLineSegmentVisibility>(m, "HiddenLineSegmentVisibility")
+    .value("Unset", HiddenLineSegmentVisibility::Unset)
+    .value("Visible", HiddenLineSegmentVisibility::Visible)
+    .value("Hidden", HiddenLineSegmentVisibility::Hidden)
+    .value("Clipped", HiddenLineSegmentVisibility::Clipped)
+    ;
+
+  py::enum_<HiddenLineSegmentType>(m, "HiddenLineSegmentType")
+    .value("Unset", HiddenLineSegmentType::Unset)
+    .value("Curve", HiddenLineSegmentType::Curve)
+    .value("Boundary", HiddenLineSegmentType::Boundary)
+    .value("Crease", HiddenLineSegmentType::Crease)
+    .value("Tangent", HiddenLineSegmentType::Tangent)
+    .value("Silhouette", HiddenLineSegmentType::Silhouette)
+    ;
+
+  py::class_<BND_HiddenLineDrawingParameters>(m, "HiddenLineDrawingParameters")
+    .def(py::init<>())
+    .def_property("AbsoluteTolerance", &BND_HiddenLineDrawingParameters::AbsoluteTolerance, &BND_HiddenLineDrawingParameters::SetAbsoluteTolerance)
+    .def_property("IncludeHiddenCurves", &BND_HiddenLineDrawingParameters::IncludeHiddenCurves, &BND_HiddenLineDrawingParameters::SetIncludeHiddenCurves)
+    .def_property("IncludeTangentEdges", &BND_HiddenLineDrawingParameters::IncludeTangentEdges, &BND_HiddenLineDrawingParameters::SetIncludeTangentEdges)
+    .def_property("IncludeClippedCurves", &BND_HiddenLineDrawingParameters::IncludeClippedCurves, &BND_HiddenLineDrawingParameters::SetIncludeClippedCurves)
+    .def_property_readonly("SourceCount", &BND_HiddenLineDrawingParameters::SourceCount)
+    .def("SetViewport", &BND_HiddenLineDrawingParameters::SetViewport, py::arg("viewport"))
+    .def("AddClippingPlane", &BND_HiddenLineDrawingParameters::AddClippingPlane, py::arg("plane"))
+    .def("AddGeometry", &BND_HiddenLineDrawingParameters::AddGeometry, py::arg("geometry"), py::arg("xform"), py::arg("id"))
+    .def("AddObjects", &BND_HiddenLineDrawingParameters::AddObjects, py::arg("file3dm"))
+    ;
+
+  py::class_<BND_HiddenLineDrawing>(m, "HiddenLineDrawing")
+    .def_static("Compute", &BND_HiddenLineDrawing::Compute, py::arg("parameters"), py::arg("multipleThreads")=true)
+    .def_property_readonly("PolylineCount", &BND_HiddenLineDrawing::PolylineCount)
+    .def_property_readonly("PointCount", &BND_HiddenLineDrawing::PointCount)
+    .def_property_readonly("Points", &BND_HiddenLineDrawing::Points)
+    .def_property_readonly("PolylineOffsets", &BND_HiddenLineDrawing::PolylineOffsets)
+    .def_property_readonly("Visibility", &BND_HiddenLineDrawing::Visibility)
+    .def_property_readonly("SegmentTypes", &BND_HiddenLineDrawing::SegmentTypes)
+    .def_property_readonly("SourceIndices", &BND_HiddenLineDrawing::SourceIndices)
+    .def_property_readonly("SourceIds", &BND_HiddenLineDrawing::SourceIds)
+    .def_property_readonly("BoundingBox", &BND_HiddenLineDrawing::BoundingBox)
+    ;
+}
+
+#endif
+
+#if defined(ON_WASM_COMPILE)
+using namespace emscripten;
+
+void initHiddenLineDrawingBindings(void*)
+{
+  enum_<HiddenLineSegmentVisibility>("HiddenLineSegmentVisibility")
+    .value("Unset", HiddenLineSegmentVisibility::Unset)
+    .value("Visible", HiddenLineSegmentVisibility::Visible)
+    .value("Hidden", HiddenLineSegmentVisibility::Hidden)
+    .value("Clipped", HiddenLineSegmentVisibility::Clipped)
+    ;
+
+  enum_<HiddenLineSegmentType>("HiddenLineSegmentType")
+    .value("Unset", HiddenLineSegmentType::Unset)
+    .value("Curve", HiddenLineSegmentType::Curve)
+    .value("Boundary", HiddenLineSegmentType::Boundary)
+    .value("Crease", HiddenLineSegmentType::Crease)
+    .value("Tangent", HiddenLineSegmentType::Tangent)
+    .value("Silhouette", HiddenLineSegmentType::Silhouette)
+    ;
+
+  class_<BND_HiddenLineDrawingParameters>("HiddenLineDrawingParameters")
+    .constructor<>()
+    .property("absoluteTolerance", &BND_HiddenLineDrawingParameters::AbsoluteTolerance, &BND_HiddenLineDrawingParameters::SetAbsoluteTolerance)
+    .property("includeHiddenCurves", &BND_HiddenLineDrawingParameters::IncludeHiddenCurves, &BND_HiddenLineDrawingParameters::SetIncludeHiddenCurves)
+    .property("includeTangentEdges", &BND_HiddenLineDrawingParameters::IncludeTangentEdges, &BND_HiddenLineDrawingParameters::SetIncludeTangentEdges)
+    .property("includeClippedCurves", &BND_HiddenLineDrawingParameters::IncludeClippedCurves, &BND_HiddenLineDrawingParameters::SetIncludeClippedCurves)
+    .property("sourceCount", &BND_HiddenLineDrawingParameters::SourceCount)
+    .function("setViewport", &BND_HiddenLineDrawingParameters::SetViewport)
+    .function("addClippingPlane", &BND_HiddenLineDrawingParameters::AddClippingPlane)
+    .function("addGeometry", &BND_HiddenLineDrawingParameters::AddGeometry)
+    .function("addObjects", &BND_HiddenLineDrawingParameters::AddObjects)
+    ;
+
+  class_<BND_HiddenLineDrawing>("HiddenLineDrawing")
+    .class_function("compute", &BND_HiddenLineDrawing::Compute, allow_raw_pointers())
+    .property("polylineCount", &BND_HiddenLineDrawing::PolylineCount)
+    .property("pointCount", &BND_HiddenLineDrawing::PointCount)
+    .property("points", &BND_HiddenLineDrawing::Points)
+    .property("polylineOffsets", &BND_HiddenLineDrawing::PolylineOffsets)
+    .property("visibility", &BND_HiddenLineDrawing::Visibility)
+    .property("segmentTypes", &BND_HiddenLineDrawing::SegmentTypes)
+    .property("sourceIndices", &BND_HiddenLineDrawing::SourceIndices)
+    .property("sourceIds", &BND_HiddenLineDrawing::SourceIds)
+    .property("boundingBox", &BND_HiddenLineDrawing::BoundingBox)
+    ;
+}
+#endif
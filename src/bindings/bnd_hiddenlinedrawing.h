@@ -0,0 +1,94 @@
+#include "bindings.h"
+
+#pragma once
+
+#if defined(ON_PYTHON_COMPILE)
+void initHiddenLineDrawingBindings(rh3dmpymodule& m);
+#else
+void initHiddenLineDrawingBindings(void* m);
+#endif
+
+// Values match RhinoCommon's HiddenLineDrawingSegment.Visibility
+enum class HiddenLineSegmentVisibility : int
+{
+  Unset = 0,
+  Visible = 1,
+  Hidden = 2,
+  Clipped = 5
+};
+
+enum class HiddenLineSegmentType : int
+{
+  Unset = 0,
+  Curve = 1,      // wire curves
+  Boundary = 2,   // naked brep / mesh edges
+  Crease = 3,     // interior brep edges and sharp mesh edges
+  Tangent = 4,    // smooth interior brep edges and seams
+  Silhouette = 5  // view dependent outlines computed from render meshes
+};
+
+struct BND_HiddenLineSource
+{
+  ON_UUID m_id = ON_nil_uuid;
+  const ON_Geometry* m_geometry = nullptr;
+  ON_Xform m_xform = ON_Xform::IdentityTransformation;
+  ON_ModelComponentReference m_compref; // keeps model geometry alive
+  std::shared_ptr<ON_Geometry> m_owned; // geometry added directly
+};
+
+class BND_HiddenLineDrawingParameters
+{
+public:
+  BND_HiddenLineDrawingParameters() = default;
+
+  double AbsoluteTolerance() const { return m_absolute_tolerance; }
+  void SetAbsoluteTolerance(double tolerance) { m_absolute_tolerance = tolerance; }
+  bool IncludeHiddenCurves() const { return m_include_hidden_curves; }
+  void SetIncludeHiddenCurves(bool b) { m_include_hidden_curves = b; }
+  bool IncludeTangentEdges() const { return m_include_tangent_edges; }
+  void SetIncludeTangentEdges(bool b) { m_include_tangent_edges = b; }
+  bool IncludeClippedCurves() const { return m_include_clipped_curves; }
+  void SetIncludeClippedCurves(bool b) { m_include_clipped_curves = b; }
+
+  bool SetViewport(const class BND_Viewport& viewport);
+  void AddClippingPlane(const class BND_Plane& plane);
+  int AddGeometry(const class BND_GeometryBase& geometry, const class BND_Transform& xform, BND_UUID id);
+  int AddObjects(const class BND_ONXModel& model);
+  int SourceCount() const { return (int)m_sources.size(); }
+
+public:
+  double m_absolute_tolerance = 0.001;
+  bool m_include_hidden_curves = true;
+  bool m_include_tangent_edges = false;
+  bool m_include_clipped_curves = false;
+  ON_Viewport m_viewport;
+  ON_SimpleArray<ON_PlaneEquation> m_clipping_planes;
+  std::vector<BND_HiddenLineSource> m_sources;
+};
+
+// Result of a hidden line computation. Curves are returned as packed
+// 2d polylines in view coordinates (x along CameraX, y along CameraY),
+// one entry per polyline in each of the per-polyline arrays.
+class BND_HiddenLineDrawing
+{
+public:
+  static BND_HiddenLineDrawing* Compute(const BND_HiddenLineDrawingParameters& parameters, bool multipleThreads);
+
+  int PolylineCount() const { return (int)m_visibility.size(); }
+  int PointCount() const { return (int)(m_points.size() / 2); }
+  BND_BUFFER Points() const { return CreateBuffer(m_points); }
+  BND_BUFFER PolylineOffsets() const { return CreateBuffer(m_offsets); }
+  BND_BUFFER Visibility() const { return CreateBuffer(m_visibility); }
+  BND_BUFFER SegmentTypes() const { return CreateBuffer(m_segment_types); }
+  BND_BUFFER SourceIndices() const { return CreateBuffer(m_source_indices); }
+  BND_TUPLE SourceIds() const;
+  BND_BoundingBox BoundingBox() const;
+
+public:
+  std::vector<double> m_points;               // x,y pairs
+  std::vector<int> m_offsets;                 // PolylineCount()+1 point offsets
+  std::vector<unsigned char> m_visibility;    // HiddenLineSegmentVisibility
+  std::vector<unsigned char> m_segment_types; // HiddenLineSegmentType
+  std::vector<int> m_source_indices;          // index into SourceIds()
+  std::vector<ON_UUID> m_source_ids;
+};
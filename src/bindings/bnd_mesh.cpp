@@ -1,5 +1,12 @@
 #include "bindings.h"
 #include "base64.h"
+#include "mesh_optimize.h"
+#include "mesh_simplify.h"
+#include "mesh_weld.h"
+#include "vertex_quantize.h"
+
+#include <algorithm>
+#include <unordered_map>
 
 
 
@@ -252,6 +259,694 @@ int BND_Mesh::PartitionCount() const
   return 0;
 }
 
+// Triangles of the valid faces of mesh with quads split on the 0-2
+// diagonal; faces, when given, receives the face of every triangle
+static std::vector<unsigned int> MeshTriangles(const ON_Mesh& mesh, std::vector<int>* faces = nullptr)
+{
+  const int vertexCount = mesh.VertexCount();
+  std::vector<unsigned int> indices;
+  indices.reserve(6 * (size_t)mesh.FaceCount());
+  for (int i = 0; i < mesh.FaceCount(); i++)
+  {
+    const ON_MeshFace& face = mesh.m_F[i];
+    if (!face.IsValid(vertexCount))
+      continue;
+    indices.insert(indices.end(), { (unsigned int)face.vi[0], (unsigned int)face.vi[1], (unsigned int)face.vi[2] });
+    if (faces)
+      faces->push_back(i);
+    if (face.IsQuad())
+    {
+      indices.insert(indices.end(), { (unsigned int)face.vi[0], (unsigned int)face.vi[2], (unsigned int)face.vi[3] });
+      if (faces)
+        faces->push_back(i);
+    }
+  }
+  return indices;
+}
+
+// Triangles of mesh simplified with options. Vertices that are still used
+// keep their normals, texture coordinates and colors.
+static ON_Mesh* SimplifiedMesh(const ON_Mesh& mesh, const mesh_simplify_options& options, double* error = nullptr)
+{
+  const int vertexCount = mesh.VertexCount();
+  std::vector<double> positions(3 * (size_t)vertexCount);
+  for (int i = 0; i < vertexCount; i++)
+  {
+    const ON_3dPoint p = mesh.Vertex(i);
+    positions[3 * i] = p.x;
+    positions[3 * i + 1] = p.y;
+    positions[3 * i + 2] = p.z;
+  }
+  const std::vector<unsigned int> indices = MeshTriangles(mesh);
+
+  const std::vector<unsigned int> triangles = mesh_simplify(positions.data(), (size_t)vertexCount, indices.data(), indices.size(), options, error);
+
+  const bool normals = mesh.HasVertexNormals();
+  const bool textureCoordinates = mesh.HasTextureCoordinates();
+  const bool colors = mesh.HasVertexColors();
+  ON_Mesh* rc = new ON_Mesh((int)(triangles.size() / 3), vertexCount, normals, textureCoordinates);
+  if (textureCoordinates)
+    rc->m_Ttag = mesh.m_Ttag;
+
+  std::vector<int> remap(vertexCount, -1);
+  for (size_t i = 0; i < triangles.size(); i += 3)
+  {
+    ON_MeshFace& face = rc->m_F.AppendNew();
+    for (int k = 0; k < 3; k++)
+    {
+      const unsigned int v = triangles[i + k];
+      if (remap[v] < 0)
+      {
+        remap[v] = rc->VertexCount();
+        rc->SetVertex(remap[v], mesh.Vertex((int)v));
+        if (normals)
+          rc->m_N.Append(mesh.m_N[v]);
+        if (textureCoordinates)
+          rc->m_T.Append(mesh.m_T[v]);
+        if (colors)
+          rc->m_C.Append(mesh.m_C[v]);
+      }
+      face.vi[k] = remap[v];
+    }
+    face.vi[3] = face.vi[2];
+  }
+  if (mesh.HasFaceNormals())
+    rc->ComputeFaceNormals();
+  return rc;
+}
+
+BND_Mesh* BND_Mesh::Simplify(double targetRatio, double targetError, bool preserveBorders, bool preserveUVSeams) const
+{
+  mesh_simplify_options options;
+  options.target_ratio = targetRatio;
+  options.target_error = targetError;
+  options.preserve_borders = preserveBorders;
+  options.preserve_seams = preserveUVSeams;
+  return new BND_Mesh(SimplifiedMesh(*m_mesh, options), nullptr);
+}
+
+BND_TUPLE BND_Mesh::BuildLods(int levels, double ratio, bool preserveBorders, bool preserveUVSeams) const
+{
+  mesh_simplify_options options;
+  options.target_ratio = ratio;
+  options.preserve_borders = preserveBorders;
+  options.preserve_seams = preserveUVSeams;
+
+  // every level is simplified from the one before it
+  std::vector<ON_Mesh*> lods;
+  const ON_Mesh* previous = m_mesh;
+  for (int i = 0; i < levels; i++)
+  {
+    ON_Mesh* lod = SimplifiedMesh(*previous, options);
+    lods.push_back(lod);
+    previous = lod;
+  }
+
+  BND_TUPLE rc = CreateTuple((int)lods.size());
+  for (int i = 0; i < (int)lods.size(); i++)
+    SetTuple(rc, i, new BND_Mesh(lods[i], nullptr));
+  return rc;
+}
+
+bool BND_Mesh::Weld(double tolerance, double angleTolerance, int threadCount)
+{
+  ON_Mesh& mesh = *m_mesh;
+  const int vertexCount = mesh.VertexCount();
+  const int faceCount = mesh.FaceCount();
+  if (vertexCount < 1)
+    return false;
+
+  std::vector<double> positions(3 * (size_t)vertexCount);
+  for (int i = 0; i < vertexCount; i++)
+  {
+    const ON_3dPoint p = mesh.Vertex(i);
+    positions[3 * i] = p.x;
+    positions[3 * i + 1] = p.y;
+    positions[3 * i + 2] = p.z;
+  }
+
+  // Meshes without vertex normals (STL and other triangle soups) are
+  // compared by the area weighted normals of the faces around each vertex
+  std::vector<float> vertexNormals;
+  const float* normals = nullptr;
+  if (angleTolerance < ON_PI)
+  {
+    if (mesh.HasVertexNormals())
+      normals = &mesh.m_N[0].x;
+    else
+    {
+      std::vector<ON_3dVector> sums(vertexCount, ON_3dVector::ZeroVector);
+      for (int i = 0; i < faceCount; i++)
+      {
+        const ON_MeshFace& face = mesh.m_F[i];
+        if (!face.IsValid(vertexCount))
+          continue;
+        const ON_3dPoint a = mesh.Vertex(face.vi[0]);
+        const ON_3dVector n = ON_CrossProduct(mesh.Vertex(face.vi[2]) - a, mesh.Vertex(face.vi[3]) - mesh.Vertex(face.vi[1]));
+        for (int k = 0; k < (face.IsQuad() ? 4 : 3); k++)
+          sums[face.vi[k]] += n;
+      }
+      vertexNormals.resize(3 * (size_t)vertexCount);
+      for (int i = 0; i < vertexCount; i++)
+      {
+        vertexNormals[3 * i] = (float)sums[i].x;
+        vertexNormals[3 * i + 1] = (float)sums[i].y;
+        vertexNormals[3 * i + 2] = (float)sums[i].z;
+      }
+      normals = vertexNormals.data();
+    }
+  }
+  const float* textureCoordinates = mesh.HasTextureCoordinates() ? &mesh.m_T[0].x : nullptr;
+
+  mesh_weld_options options;
+  options.tolerance = tolerance;
+  options.angle_tolerance = angleTolerance;
+  const int threads = ParallelThreadCount(threadCount);
+  options.parallel_for = [threads](int count, const std::function<void(int)>& func) { ParallelFor(count, threads, func); };
+  const std::vector<unsigned int> weld = mesh_weld(positions.data(), (size_t)vertexCount, normals, textureCoordinates, options);
+
+  // faces onto the kept vertices; faces that lose a corner become
+  // triangles, ones left with fewer than three corners go
+  bool changed = false;
+  std::vector<int> faces(4 * (size_t)faceCount);
+  std::vector<char> keep(faceCount, 1);
+  for (int i = 0; i < faceCount; i++)
+  {
+    int* vi = &faces[4 * (size_t)i];
+    const ON_MeshFace& face = mesh.m_F[i];
+    if (!face.IsValid(vertexCount))
+    {
+      keep[i] = 0;
+      vi[0] = -1;
+      continue;
+    }
+    int corners[4];
+    int cornerCount = 0;
+    for (int k = 0; k < (face.IsQuad() ? 4 : 3); k++)
+    {
+      const int v = (int)weld[face.vi[k]];
+      if (v != face.vi[k])
+        changed = true;
+      if (0 == cornerCount || v != corners[cornerCount - 1])
+        corners[cornerCount++] = v;
+    }
+    if (cornerCount > 1 && corners[0] == corners[cornerCount - 1])
+      cornerCount--;
+    const bool distinct = cornerCount < 4 || (corners[0] != corners[2] && corners[1] != corners[3]);
+    if (cornerCount < 3 || !distinct)
+    {
+      keep[i] = 0;
+      vi[0] = -1;
+      continue;
+    }
+    for (int k = 0; k < 4; k++)
+      vi[k] = corners[k < cornerCount ? k : 2];
+  }
+
+  const std::vector<char> duplicate = mesh_duplicate_faces(faces.data(), (size_t)faceCount, (size_t)vertexCount, options.parallel_for);
+  for (int i = 0; i < faceCount; i++)
+  {
+    if (duplicate[i])
+      keep[i] = 0;
+    if (!keep[i])
+      changed = true;
+  }
+  if (!changed)
+    return false;
+
+  // face and ngon indices change; ngons can not be carried over
+  if (mesh.NgonCount() > 0)
+    mesh.RemoveAllNgons();
+  const bool hasFaceNormals = mesh.HasFaceNormals();
+  int count = 0;
+  for (int i = 0; i < faceCount; i++)
+  {
+    if (!keep[i])
+      continue;
+    ON_MeshFace& face = mesh.m_F[count];
+    for (int k = 0; k < 4; k++)
+      face.vi[k] = faces[4 * (size_t)i + k];
+    if (hasFaceNormals)
+      mesh.m_FN[count] = mesh.m_FN[i];
+    count++;
+  }
+  mesh.m_F.SetCount(count);
+  if (hasFaceNormals)
+    mesh.m_FN.SetCount(count);
+
+  mesh.DestroyRuntimeCache(true);
+  mesh.SetClosed(-1);
+  // drops the merged vertices along with their normals, texture
+  // coordinates, colors, surface parameters and curvatures
+  mesh.CullUnusedVertices();
+  return true;
+}
+
+template <typename T>
+static void PermuteVertexArray(ON_SimpleArray<T>& values, const std::vector<unsigned int>& remap)
+{
+  if (values.UnsignedCount() != remap.size())
+    return;
+  ON_SimpleArray<T> permuted(values.Count());
+  permuted.SetCount(values.Count());
+  for (size_t i = 0; i < remap.size(); i++)
+    permuted[(int)remap[i]] = values[(int)i];
+  values = permuted;
+}
+
+double BND_Mesh::ComputeAcmr(int cacheSize) const
+{
+  const std::vector<unsigned int> indices = MeshTriangles(*m_mesh);
+  return mesh_acmr(indices.data(), indices.size(), (size_t)m_mesh->VertexCount(), (unsigned int)std::max(cacheSize, 1));
+}
+
+BND_TUPLE BND_Mesh::OptimizeForGpu(bool optimizeOverdraw, int cacheSize)
+{
+  ON_Mesh& mesh = *m_mesh;
+  const unsigned int cache = (unsigned int)std::max(cacheSize, 1);
+  const int vertexCount = mesh.VertexCount();
+  const int faceCount = mesh.FaceCount();
+
+  std::vector<int> triangleFaces;
+  std::vector<unsigned int> indices = MeshTriangles(mesh, &triangleFaces);
+  const double before = mesh_acmr(indices.data(), indices.size(), (size_t)vertexCount, cache);
+
+  std::vector<float> positions;
+  if (optimizeOverdraw)
+  {
+    positions.resize(3 * (size_t)vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+    {
+      const ON_3dPoint p = mesh.Vertex(i);
+      positions[3 * i] = (float)p.x;
+      positions[3 * i + 1] = (float)p.y;
+      positions[3 * i + 2] = (float)p.z;
+    }
+  }
+  std::vector<unsigned int> order;
+  mesh_optimize_triangles(indices.data(), indices.size(), (size_t)vertexCount, optimizeOverdraw ? positions.data() : nullptr, cache, &order);
+
+  // faces in the order their first triangle is drawn; invalid faces last
+  std::vector<int> faceIndex(faceCount, -1);
+  std::vector<int> faceOrder;
+  faceOrder.reserve(faceCount);
+  for (unsigned int t : order)
+  {
+    const int f = triangleFaces[t];
+    if (faceIndex[f] < 0)
+    {
+      faceIndex[f] = (int)faceOrder.size();
+      faceOrder.push_back(f);
+    }
+  }
+  for (int f = 0; f < faceCount; f++)
+  {
+    if (faceIndex[f] < 0)
+    {
+      faceIndex[f] = (int)faceOrder.size();
+      faceOrder.push_back(f);
+    }
+  }
+  const ON_SimpleArray<ON_MeshFace> faces(mesh.m_F);
+  const ON_3fVectorArray faceNormals(mesh.m_FN);
+  const bool hasFaceNormals = faceNormals.Count() == faceCount;
+  for (int i = 0; i < faceCount; i++)
+  {
+    mesh.m_F[i] = faces[faceOrder[i]];
+    if (hasFaceNormals)
+      mesh.m_FN[i] = faceNormals[faceOrder[i]];
+  }
+
+  // vertices in order of first use by the reordered faces
+  indices = MeshTriangles(mesh);
+  const std::vector<unsigned int> remap = mesh_optimize_vertex_fetch(indices.data(), indices.size(), (size_t)vertexCount);
+  for (int i = 0; i < faceCount; i++)
+  {
+    ON_MeshFace& face = mesh.m_F[i];
+    for (int k = 0; k < 4; k++)
+    {
+      if (face.vi[k] >= 0 && face.vi[k] < vertexCount)
+        face.vi[k] = (int)remap[face.vi[k]];
+    }
+  }
+  PermuteVertexArray(mesh.m_V, remap);
+  PermuteVertexArray(mesh.m_dV, remap);
+  PermuteVertexArray(mesh.m_N, remap);
+  PermuteVertexArray(mesh.m_T, remap);
+  PermuteVertexArray(mesh.m_S, remap);
+  PermuteVertexArray(mesh.m_K, remap);
+  PermuteVertexArray(mesh.m_C, remap);
+  PermuteVertexArray(mesh.m_H, remap);
+  for (int i = 0; i < mesh.m_TC.Count(); i++)
+    PermuteVertexArray(mesh.m_TC[i].m_T, remap);
+
+  for (unsigned int i = 0; i < mesh.m_Ngon.UnsignedCount(); i++)
+  {
+    ON_MeshNgon* ngon = mesh.m_Ngon[i];
+    if (nullptr == ngon)
+      continue;
+    for (unsigned int k = 0; k < ngon->m_Vcount; k++)
+      ngon->m_vi[k] = remap[ngon->m_vi[k]];
+    for (unsigned int k = 0; k < ngon->m_Fcount; k++)
+      ngon->m_fi[k] = (unsigned int)faceIndex[ngon->m_fi[k]];
+  }
+  mesh.RemoveNgonMap();
+  mesh.DestroyRuntimeCache(true);
+
+  const double after = mesh_acmr(indices.data(), indices.size(), (size_t)vertexCount, cache);
+  BND_TUPLE rc = CreateTuple(2);
+  SetTuple(rc, 0, before);
+  SetTuple(rc, 1, after);
+  return rc;
+}
+
+BND_MeshQuantizedBuffers* BND_Mesh::ToQuantizedBuffers(const BND_MeshQuantizationOptions* options) const
+{
+  const BND_MeshQuantizationOptions defaults;
+  if (nullptr == options)
+    options = &defaults;
+  const ON_Mesh& mesh = *m_mesh;
+  const int vertexCount = mesh.VertexCount();
+
+  BND_MeshQuantizedBuffers* rc = new BND_MeshQuantizedBuffers();
+  rc->m_vertex_count = vertexCount;
+  rc->m_normal_bits = std::min(std::max(options->m_normal_bits, 2), 16);
+  rc->m_unsigned_positions = options->m_unsigned_positions;
+  rc->m_half_float_texture_coordinates = options->m_half_float_texture_coordinates;
+  rc->m_indices = MeshTriangles(mesh);
+
+  ON_BoundingBox bbox;
+  for (int i = 0; i < vertexCount; i++)
+    bbox.Set(mesh.Vertex(i), i > 0);
+  const double extent = vertexCount > 0 ? std::max(bbox.m_max.x - bbox.m_min.x, std::max(bbox.m_max.y - bbox.m_min.y, bbox.m_max.z - bbox.m_min.z)) : 0.0;
+  if (options->m_unsigned_positions)
+  {
+    const double step = extent > 0.0 ? extent / 65535.0 : 1.0;
+    rc->m_positions_unsigned.resize(3 * (size_t)vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+    {
+      const ON_3dVector offset = mesh.Vertex(i) - bbox.m_min;
+      for (int c = 0; c < 3; c++)
+        rc->m_positions_unsigned[3 * i + c] = (unsigned short)std::min(std::max(floor(offset[c] / step + 0.5), 0.0), 65535.0);
+    }
+    rc->m_dequantize = ON_Xform::TranslationTransformation(bbox.m_min - ON_3dPoint::Origin) * ON_Xform::DiagonalTransformation(step);
+  }
+  else
+  {
+    const ON_3dPoint center = bbox.Center();
+    const double step = extent > 0.0 ? 0.5 * extent / 32767.0 : 1.0;
+    rc->m_positions.resize(3 * (size_t)vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+    {
+      const ON_3dVector offset = mesh.Vertex(i) - center;
+      for (int c = 0; c < 3; c++)
+        rc->m_positions[3 * i + c] = (short)std::min(std::max(floor(offset[c] / step + 0.5), -32767.0), 32767.0);
+    }
+    rc->m_dequantize = ON_Xform::TranslationTransformation(center - ON_3dPoint::Origin) * ON_Xform::DiagonalTransformation(step);
+  }
+
+  if (mesh.HasVertexNormals())
+  {
+    if (rc->m_normal_bits > 8)
+      rc->m_normals16.resize(2 * (size_t)vertexCount);
+    else
+      rc->m_normals8.resize(2 * (size_t)vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+    {
+      const ON_3fVector& n = mesh.m_N[i];
+      int e[2];
+      octahedral_encode(n.x, n.y, n.z, rc->m_normal_bits, e);
+      for (int c = 0; c < 2; c++)
+      {
+        if (rc->m_normal_bits > 8)
+          rc->m_normals16[2 * i + c] = (short)e[c];
+        else
+          rc->m_normals8[2 * i + c] = (signed char)e[c];
+      }
+    }
+  }
+
+  if (mesh.HasTextureCoordinates())
+  {
+    if (options->m_half_float_texture_coordinates)
+    {
+      rc->m_texcoords_half.resize(2 * (size_t)vertexCount);
+      for (int i = 0; i < vertexCount; i++)
+      {
+        rc->m_texcoords_half[2 * i] = float_to_half(mesh.m_T[i].x);
+        rc->m_texcoords_half[2 * i + 1] = float_to_half(mesh.m_T[i].y);
+      }
+    }
+    else
+      rc->m_texcoords.assign(&mesh.m_T[0].x, &mesh.m_T[0].x + 2 * (size_t)vertexCount);
+  }
+
+  if (mesh.HasVertexColors())
+  {
+    rc->m_colors.resize(4 * (size_t)vertexCount);
+    for (int i = 0; i < vertexCount; i++)
+    {
+      const ON_Color& color = mesh.m_C[i];
+      rc->m_colors[4 * i] = (unsigned char)color.Red();
+      rc->m_colors[4 * i + 1] = (unsigned char)color.Green();
+      rc->m_colors[4 * i + 2] = (unsigned char)color.Blue();
+      rc->m_colors[4 * i + 3] = (unsigned char)(255 - color.Alpha());
+    }
+  }
+  return rc;
+}
+
+BND_TileSet* BND_Mesh::SplitIntoTiles(int maxTriangles, double gridSize, int threadCount, bool levelOfDetail) const
+{
+  const ON_Mesh& mesh = *m_mesh;
+  const int vertexCount = mesh.VertexCount();
+
+  // faces with out of range or repeated vertices are left out of every tile
+  std::vector<int> validFaces;
+  validFaces.reserve(mesh.FaceCount());
+  for (int fi = 0; fi < mesh.FaceCount(); fi++)
+  {
+    if (mesh.m_F[fi].IsValid(vertexCount))
+      validFaces.push_back(fi);
+  }
+  const size_t faceCount = validFaces.size();
+
+  std::vector<double> centers(3 * faceCount);
+  std::vector<double> bounds(6 * faceCount);
+  std::vector<double> weights(faceCount);
+  for (size_t fi = 0; fi < faceCount; fi++)
+  {
+    const ON_MeshFace& face = mesh.m_F[validFaces[fi]];
+    const int corners = face.IsQuad() ? 4 : 3;
+    ON_BoundingBox bbox;
+    ON_3dVector sum = ON_3dVector::ZeroVector;
+    for (int k = 0; k < corners; k++)
+    {
+      const ON_3dPoint p = mesh.Vertex(face.vi[k]);
+      bbox.Set(p, k > 0);
+      sum += p - ON_3dPoint::Origin;
+    }
+    for (int c = 0; c < 3; c++)
+    {
+      centers[3 * fi + c] = sum[c] / corners;
+      bounds[6 * fi + c] = bbox.m_min[c];
+      bounds[6 * fi + 3 + c] = bbox.m_max[c];
+    }
+    weights[fi] = corners - 2;
+  }
+
+  spatial_tiles_options options;
+  options.max_weight = maxTriangles > 0 ? (double)maxTriangles : 0.0;
+  options.max_extent = gridSize > 0.0 ? gridSize : 0.0;
+
+  BND_TileSet* rc = new BND_TileSet();
+  rc->m_tiles = spatial_tiles_build(centers.data(), bounds.data(), weights.data(), faceCount, options, rc->m_order);
+  for (unsigned int& item : rc->m_order)
+    item = (unsigned int)validFaces[item];
+  rc->m_content.resize(rc->m_tiles.size());
+
+  const bool normals = mesh.HasVertexNormals();
+  const bool textureCoordinates = mesh.HasTextureCoordinates();
+  const bool colors = mesh.HasVertexColors();
+  const bool faceNormals = mesh.HasFaceNormals();
+  ParallelFor((int)rc->m_tiles.size(), threadCount, [&](int t)
+  {
+    const spatial_tile& tile = rc->m_tiles[t];
+    if (tile.end == tile.begin)
+      return;
+    ON_Mesh* piece = new ON_Mesh((int)(tile.end - tile.begin), 0, normals, textureCoordinates);
+    if (textureCoordinates)
+      piece->m_Ttag = mesh.m_Ttag;
+    std::unordered_map<int, int> remap;
+    for (size_t i = tile.begin; i < tile.end; i++)
+    {
+      const ON_MeshFace& face = mesh.m_F[(int)rc->m_order[i]];
+      ON_MeshFace& copy = piece->m_F.AppendNew();
+      for (int k = 0; k < 4; k++)
+      {
+        const int v = face.vi[k];
+        auto found = remap.find(v);
+        if (found == remap.end())
+        {
+          found = remap.emplace(v, piece->VertexCount()).first;
+          piece->SetVertex(found->second, mesh.Vertex(v));
+          if (normals)
+            piece->m_N.Append(mesh.m_N[v]);
+          if (textureCoordinates)
+            piece->m_T.Append(mesh.m_T[v]);
+          if (colors)
+            piece->m_C.Append(mesh.m_C[v]);
+        }
+        copy.vi[k] = found->second;
+      }
+    }
+    if (faceNormals)
+      piece->ComputeFaceNormals();
+    rc->m_content[t].reset(piece);
+  });
+
+  if (!levelOfDetail)
+    return rc;
+
+  // Levels are built from the deepest up; tiles of one level only read
+  // their children. Borders stay put so neighbouring tiles drawn at
+  // different levels do not open cracks.
+  mesh_simplify_options simplify;
+  simplify.target_ratio = 0.5;
+  simplify.preserve_borders = true;
+  simplify.preserve_seams = true;
+  int levelEnd = (int)rc->m_tiles.size();
+  while (levelEnd > 0)
+  {
+    const int depth = rc->m_tiles[levelEnd - 1].depth;
+    int levelBegin = levelEnd - 1;
+    while (levelBegin > 0 && rc->m_tiles[levelBegin - 1].depth == depth)
+      levelBegin--;
+    ParallelFor(levelEnd - levelBegin, threadCount, [&](int i)
+    {
+      const int t = levelBegin + i;
+      spatial_tile& tile = rc->m_tiles[t];
+      if (tile.child_count < 1)
+        return;
+      ON_Mesh merged;
+      double childError = 0.0;
+      for (int c = tile.first_child; c < tile.first_child + tile.child_count; c++)
+      {
+        const ON_Mesh* child = ON_Mesh::Cast(rc->m_content[c].get());
+        if (child)
+          merged.Append(*child);
+        childError = std::max(childError, rc->m_tiles[c].geometric_error);
+      }
+      double error = 0.0;
+      rc->m_content[t].reset(SimplifiedMesh(merged, simplify, &error));
+      // a tile drawn instead of its children misses their detail too
+      tile.geometric_error = childError + error;
+      tile.lod_content = true;
+    });
+    levelEnd = levelBegin;
+  }
+  return rc;
+}
+
+// Fills offsets and entries with count rows, row(i, entries) appending the
+// entries of row i. Rows are produced twice, once to size them and once
+// to write them, so every chunk of rows writes straight into its range.
+template <typename RowFunc>
+static void BuildRows(int count, int threadCount, std::vector<unsigned int>& offsets, std::vector<unsigned int>& entries, RowFunc row)
+{
+  const int chunkSize = 4096;
+  const int chunkCount = (count + chunkSize - 1) / chunkSize;
+  offsets.assign((size_t)count + 1, 0);
+  ParallelFor(chunkCount, threadCount, [&](int chunk)
+  {
+    std::vector<unsigned int> scratch;
+    const int last = std::min(count, (chunk + 1) * chunkSize);
+    for (int i = chunk * chunkSize; i < last; i++)
+    {
+      scratch.clear();
+      row(i, scratch);
+      offsets[(size_t)i + 1] = (unsigned int)scratch.size();
+    }
+  });
+  for (int i = 0; i < count; i++)
+    offsets[(size_t)i + 1] += offsets[i];
+
+  entries.resize(offsets[count]);
+  ParallelFor(chunkCount, threadCount, [&](int chunk)
+  {
+    std::vector<unsigned int> scratch;
+    const int last = std::min(count, (chunk + 1) * chunkSize);
+    for (int i = chunk * chunkSize; i < last; i++)
+    {
+      scratch.clear();
+      row(i, scratch);
+      std::copy(scratch.begin(), scratch.end(), entries.begin() + offsets[i]);
+    }
+  });
+}
+
+BND_MeshAdjacency* BND_Mesh::GetAdjacency(int threadCount) const
+{
+  // ON_Mesh::Topology builds on first use and is only read after that
+  const ON_MeshTopology& topology = m_mesh->Topology();
+  const int threads = ParallelThreadCount(threadCount);
+  const int vertexCount = topology.m_topv.Count();
+  const int edgeCount = topology.m_tope.Count();
+  const int faceCount = topology.m_topf.Count();
+
+  BND_MeshAdjacency* rc = new BND_MeshAdjacency();
+  rc->m_vertex_map.assign(topology.m_topv_map.Array(), topology.m_topv_map.Array() + topology.m_topv_map.Count());
+  rc->m_edge_vertices.resize(2 * (size_t)edgeCount);
+  for (int i = 0; i < edgeCount; i++)
+  {
+    rc->m_edge_vertices[2 * i] = (unsigned int)topology.m_tope[i].m_topvi[0];
+    rc->m_edge_vertices[2 * i + 1] = (unsigned int)topology.m_tope[i].m_topvi[1];
+  }
+
+  BuildRows(vertexCount, threads, rc->m_vertex_faces_offsets, rc->m_vertex_faces, [&topology](int i, std::vector<unsigned int>& row)
+  {
+    // every face reaches a vertex through two of its edges
+    const ON_MeshTopologyVertex& v = topology.m_topv[i];
+    for (int j = 0; j < v.m_tope_count; j++)
+    {
+      const ON_MeshTopologyEdge& e = topology.m_tope[v.m_topei[j]];
+      for (int k = 0; k < e.m_topf_count; k++)
+        row.push_back((unsigned int)e.m_topfi[k]);
+    }
+    std::sort(row.begin(), row.end());
+    row.erase(std::unique(row.begin(), row.end()), row.end());
+  });
+
+  BuildRows(vertexCount, threads, rc->m_vertex_vertices_offsets, rc->m_vertex_vertices, [&topology](int i, std::vector<unsigned int>& row)
+  {
+    const ON_MeshTopologyVertex& v = topology.m_topv[i];
+    for (int j = 0; j < v.m_tope_count; j++)
+    {
+      const ON_MeshTopologyEdge& e = topology.m_tope[v.m_topei[j]];
+      row.push_back((unsigned int)(e.m_topvi[0] == i ? e.m_topvi[1] : e.m_topvi[0]));
+    }
+  });
+
+  BuildRows(edgeCount, threads, rc->m_edge_faces_offsets, rc->m_edge_faces, [&topology](int i, std::vector<unsigned int>& row)
+  {
+    const ON_MeshTopologyEdge& e = topology.m_tope[i];
+    for (int k = 0; k < e.m_topf_count; k++)
+      row.push_back((unsigned int)e.m_topfi[k]);
+  });
+
+  BuildRows(faceCount, threads, rc->m_face_edges_offsets, rc->m_face_edges, [&topology](int i, std::vector<unsigned int>& row)
+  {
+    const ON_MeshTopologyFace& f = topology.m_topf[i];
+    if (!f.IsValid())
+      return;
+    const int sides = f.IsTriangle() ? 3 : 4;
+    for (int k = 0; k < sides; k++)
+      row.push_back((unsigned int)f.m_topei[k]);
+  });
+
+  return rc;
+}
+
 #if defined(ON_WASM_COMPILE)
 BND_DICT BND_Mesh::ToThreejsJSON() const
 {
@@ -1050,6 +1745,41 @@ void initMeshBindings(rh3dmpymodule& m)
     .def("CombineIdentical", &BND_MeshVertexList::CombineIdentical)
     ;
 
+  py::class_<BND_MeshQuantizationOptions>(m, "MeshQuantizationOptions")
+    .def(py::init<>())
+    .def_readwrite("UnsignedPositions", &BND_MeshQuantizationOptions::m_unsigned_positions)
+    .def_readwrite("NormalBits", &BND_MeshQuantizationOptions::m_normal_bits)
+    .def_readwrite("HalfFloatTextureCoordinates", &BND_MeshQuantizationOptions::m_half_float_texture_coordinates)
+    ;
+
+  py::class_<BND_MeshQuantizedBuffers>(m, "MeshQuantizedBuffers")
+    .def_property_readonly("VertexCount", &BND_MeshQuantizedBuffers::VertexCount)
+    .def_property_readonly("TriangleCount", &BND_MeshQuantizedBuffers::TriangleCount)
+    .def_property_readonly("NormalBits", &BND_MeshQuantizedBuffers::NormalBits)
+    .def_property_readonly("Positions", &BND_MeshQuantizedBuffers::Positions)
+    .def_property_readonly("Normals", &BND_MeshQuantizedBuffers::Normals)
+    .def_property_readonly("TextureCoordinates", &BND_MeshQuantizedBuffers::TextureCoordinates)
+    .def_property_readonly("Colors", &BND_MeshQuantizedBuffers::Colors)
+    .def_property_readonly("Indices", &BND_MeshQuantizedBuffers::Indices)
+    .def_property_readonly("DequantizationTransform", &BND_MeshQuantizedBuffers::DequantizationTransform)
+    ;
+
+  py::class_<BND_MeshAdjacency>(m, "MeshAdjacency")
+    .def_property_readonly("TopologyVertexCount", &BND_MeshAdjacency::TopologyVertexCount)
+    .def_property_readonly("EdgeCount", &BND_MeshAdjacency::EdgeCount)
+    .def_property_readonly("FaceCount", &BND_MeshAdjacency::FaceCount)
+    .def_property_readonly("VertexMap", &BND_MeshAdjacency::VertexMap)
+    .def_property_readonly("EdgeVertices", &BND_MeshAdjacency::EdgeVertices)
+    .def_property_readonly("VertexFacesOffsets", &BND_MeshAdjacency::VertexFacesOffsets)
+    .def_property_readonly("VertexFaces", &BND_MeshAdjacency::VertexFaces)
+    .def_property_readonly("VertexVerticesOffsets", &BND_MeshAdjacency::VertexVerticesOffsets)
+    .def_property_readonly("VertexVertices", &BND_MeshAdjacency::VertexVertices)
+    .def_property_readonly("EdgeFacesOffsets", &BND_MeshAdjacency::EdgeFacesOffsets)
+    .def_property_readonly("EdgeFaces", &BND_MeshAdjacency::EdgeFaces)
+    .def_property_readonly("FaceEdgesOffsets", &BND_MeshAdjacency::FaceEdgesOffsets)
+    .def_property_readonly("FaceEdges", &BND_MeshAdjacency::FaceEdges)
+    ;
+
   py::class_<BND_MeshTopologyEdgeList>(m, "MeshTopologyEdgeList")
     .def("__len__", &BND_MeshTopologyEdgeList::Count)
     .def("EdgeLine", &BND_MeshTopologyEdgeList::EdgeLine, py::arg("topologyEdgeIndex"))
@@ -1141,6 +1871,14 @@ void initMeshBindings(rh3dmpymodule& m)
     .def("Append", &BND_Mesh::Append, py::arg("other"))
     .def("CreatePartitions", &BND_Mesh::CreatePartitions, py::arg("maximumVertexCount"), py::arg("maximumTriangleCount"))
     .def_property_readonly("PartitionCount", &BND_Mesh::PartitionCount)
+    .def("Simplify", &BND_Mesh::Simplify, py::arg("targetRatio")=0.5, py::arg("targetError")=0.0, py::arg("preserveBorders")=true, py::arg("preserveUVSeams")=true)
+    .def("BuildLods", &BND_Mesh::BuildLods, py::arg("levels"), py::arg("ratio")=0.5, py::arg("preserveBorders")=true, py::arg("preserveUVSeams")=true)
+    .def("Weld", &BND_Mesh::Weld, py::arg("tolerance"), py::arg("angleTolerance")=ON_PI, py::arg("threadCount")=0)
+    .def("GetAdjacency", &BND_Mesh::GetAdjacency, py::arg("threadCount")=0)
+    .def("ComputeAcmr", &BND_Mesh::ComputeAcmr, py::arg("cacheSize")=16)
+    .def("OptimizeForGpu", &BND_Mesh::OptimizeForGpu, py::arg("optimizeOverdraw")=true, py::arg("cacheSize")=16)
+    .def("ToQuantizedBuffers", &BND_Mesh::ToQuantizedBuffers, py::arg("options")=nullptr)
+    .def("SplitIntoTiles", &BND_Mesh::SplitIntoTiles, py::arg("maxTriangles")=65535, py::arg("gridSize")=0.0, py::arg("threadCount")=0, py::arg("levelOfDetail")=false)
     ;
 }
 
@@ -1201,6 +1939,41 @@ void initMeshBindings(void*)
     .function("combineIdentical", &BND_MeshVertexList::CombineIdentical)
     ;
 
+  class_<BND_MeshQuantizationOptions>("MeshQuantizationOptions")
+    .constructor<>()
+    .property("unsignedPositions", &BND_MeshQuantizationOptions::m_unsigned_positions)
+    .property("normalBits", &BND_MeshQuantizationOptions::m_normal_bits)
+    .property("halfFloatTextureCoordinates", &BND_MeshQuantizationOptions::m_half_float_texture_coordinates)
+    ;
+
+  class_<BND_MeshQuantizedBuffers>("MeshQuantizedBuffers")
+    .property("vertexCount", &BND_MeshQuantizedBuffers::VertexCount)
+    .property("triangleCount", &BND_MeshQuantizedBuffers::TriangleCount)
+    .property("normalBits", &BND_MeshQuantizedBuffers::NormalBits)
+    .property("positions", &BND_MeshQuantizedBuffers::Positions)
+    .property("normals", &BND_MeshQuantizedBuffers::Normals)
+    .property("textureCoordinates", &BND_MeshQuantizedBuffers::TextureCoordinates)
+    .property("colors", &BND_MeshQuantizedBuffers::Colors)
+    .property("indices", &BND_MeshQuantizedBuffers::Indices)
+    .property("dequantizationTransform", &BND_MeshQuantizedBuffers::DequantizationTransform)
+    ;
+
+  class_<BND_MeshAdjacency>("MeshAdjacency")
+    .property("topologyVertexCount", &BND_MeshAdjacency::TopologyVertexCount)
+    .property("edgeCount", &BND_MeshAdjacency::EdgeCount)
+    .property("faceCount", &BND_MeshAdjacency::FaceCount)
+    .property("vertexMap", &BND_MeshAdjacency::VertexMap)
+    .property("edgeVertices", &BND_MeshAdjacency::EdgeVertices)
+    .property("vertexFacesOffsets", &BND_MeshAdjacency::VertexFacesOffsets)
+    .property("vertexFaces", &BND_MeshAdjacency::VertexFaces)
+    .property("vertexVerticesOffsets", &BND_MeshAdjacency::VertexVerticesOffsets)
+    .property("vertexVertices", &BND_MeshAdjacency::VertexVertices)
+    .property("edgeFacesOffsets", &BND_MeshAdjacency::EdgeFacesOffsets)
+    .property("edgeFaces", &BND_MeshAdjacency::EdgeFaces)
+    .property("faceEdgesOffsets", &BND_MeshAdjacency::FaceEdgesOffsets)
+    .property("faceEdges", &BND_MeshAdjacency::FaceEdges)
+    ;
+
   class_<BND_MeshTopologyEdgeList>("MeshTopologyEdgeList")
     .property("count", &BND_MeshTopologyEdgeList::Count)
     .function("edgeLine", &BND_MeshTopologyEdgeList::EdgeLine)
@@ -1292,6 +2065,14 @@ void initMeshBindings(void*)
     .function("append", &BND_Mesh::Append)
     .function("createPartitions", &BND_Mesh::CreatePartitions)
     .property("partitionCount", &BND_Mesh::PartitionCount)
+    .function("simplify", &BND_Mesh::Simplify, allow_raw_pointers())
+    .function("buildLods", &BND_Mesh::BuildLods)
+    .function("weld", &BND_Mesh::Weld)
+    .function("getAdjacency", &BND_Mesh::GetAdjacency, allow_raw_pointers())
+    .function("computeAcmr", &BND_Mesh::ComputeAcmr)
+    .function("optimizeForGpu", &BND_Mesh::OptimizeForGpu)
+    .function("toQuantizedBuffers", &BND_Mesh::ToQuantizedBuffers, allow_raw_pointers())
+    .function("splitIntoTiles", &BND_Mesh::SplitIntoTiles, allow_raw_pointers())
     .function("toThreejsJSON", &BND_Mesh::ToThreejsJSON)
     .function("toThreejsJSONRotate", &BND_Mesh::ToThreejsJSONRotate)
     .class_function("createFromThreejsJSON", &BND_Mesh::CreateFromThreejsJSON, allow_raw_pointers())
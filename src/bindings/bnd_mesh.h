@@ -285,6 +285,82 @@ public:
 
 };
 
+// Mesh topology as compressed sparse rows: the entries of row i are
+// X[XOffsets[i]] up to X[XOffsets[i + 1]]. Vertices are topology vertices
+// (coincident mesh vertices joined), edges are topology edges and faces
+// are mesh faces.
+class BND_MeshAdjacency
+{
+public:
+  int TopologyVertexCount() const { return (int)m_vertex_faces_offsets.size() - 1; }
+  int EdgeCount() const { return (int)(m_edge_vertices.size() / 2); }
+  int FaceCount() const { return (int)m_face_edges_offsets.size() - 1; }
+  BND_BUFFER VertexMap() const { return CreateBuffer(m_vertex_map); }
+  BND_BUFFER EdgeVertices() const { return CreateBuffer(m_edge_vertices); }
+  BND_BUFFER VertexFacesOffsets() const { return CreateBuffer(m_vertex_faces_offsets); }
+  BND_BUFFER VertexFaces() const { return CreateBuffer(m_vertex_faces); }
+  BND_BUFFER VertexVerticesOffsets() const { return CreateBuffer(m_vertex_vertices_offsets); }
+  BND_BUFFER VertexVertices() const { return CreateBuffer(m_vertex_vertices); }
+  BND_BUFFER EdgeFacesOffsets() const { return CreateBuffer(m_edge_faces_offsets); }
+  BND_BUFFER EdgeFaces() const { return CreateBuffer(m_edge_faces); }
+  BND_BUFFER FaceEdgesOffsets() const { return CreateBuffer(m_face_edges_offsets); }
+  BND_BUFFER FaceEdges() const { return CreateBuffer(m_face_edges); }
+
+public:
+  std::vector<unsigned int> m_vertex_map;              // topology vertex per mesh vertex
+  std::vector<unsigned int> m_edge_vertices;           // 2 topology vertices per edge
+  std::vector<unsigned int> m_vertex_faces_offsets;    // faces around a vertex, sorted
+  std::vector<unsigned int> m_vertex_faces;
+  std::vector<unsigned int> m_vertex_vertices_offsets; // vertices sharing an edge with a vertex
+  std::vector<unsigned int> m_vertex_vertices;
+  std::vector<unsigned int> m_edge_faces_offsets;      // faces on an edge
+  std::vector<unsigned int> m_edge_faces;
+  std::vector<unsigned int> m_face_edges_offsets;      // 3 or 4 edges per face in face order
+  std::vector<unsigned int> m_face_edges;
+};
+
+class BND_MeshQuantizationOptions
+{
+public:
+  bool m_unsigned_positions = false;             // uint16 from the bounding box minimum instead of int16 around its center
+  int m_normal_bits = 8;                         // octahedral normal precision, 2 to 16; int8 pairs up to 8 bits, int16 above
+  bool m_half_float_texture_coordinates = true;  // float32 when false
+};
+
+// Mesh vertex attributes in compact encodings, see vertex_quantize.h.
+// Positions are integers on a uniform grid over the bounding box; the
+// dequantization transform maps them back to model coordinates and, being
+// a uniform scale, leaves normals valid.
+class BND_MeshQuantizedBuffers
+{
+public:
+  int VertexCount() const { return m_vertex_count; }
+  int TriangleCount() const { return (int)(m_indices.size() / 3); }
+  int NormalBits() const { return m_normal_bits; }
+  // array types follow the options even when a buffer is empty
+  BND_BUFFER Positions() const { return m_unsigned_positions ? CreateBuffer(m_positions_unsigned) : CreateBuffer(m_positions); }
+  BND_BUFFER Normals() const { return m_normal_bits > 8 ? CreateBuffer(m_normals16) : CreateBuffer(m_normals8); }
+  BND_BUFFER TextureCoordinates() const { return m_half_float_texture_coordinates ? CreateBuffer(m_texcoords_half) : CreateBuffer(m_texcoords); }
+  BND_BUFFER Colors() const { return CreateBuffer(m_colors); }
+  BND_BUFFER Indices() const { return m_vertex_count <= 0xFFFF ? CreateBuffer(std::vector<unsigned short>(m_indices.begin(), m_indices.end())) : CreateBuffer(m_indices); }
+  BND_Transform DequantizationTransform() const { return BND_Transform(m_dequantize); }
+
+public:
+  int m_vertex_count = 0;
+  int m_normal_bits = 8;
+  bool m_unsigned_positions = false;
+  bool m_half_float_texture_coordinates = true;
+  std::vector<short> m_positions;                   // x,y,z per vertex
+  std::vector<unsigned short> m_positions_unsigned; // x,y,z per vertex
+  std::vector<signed char> m_normals8;              // octahedral u,v per vertex
+  std::vector<short> m_normals16;
+  std::vector<float> m_texcoords;                   // u,v per vertex
+  std::vector<unsigned short> m_texcoords_half;
+  std::vector<unsigned char> m_colors;              // r,g,b,a per vertex
+  std::vector<unsigned int> m_indices;              // 3 per triangle
+  ON_Xform m_dequantize = ON_Xform::IdentityTransformation;
+};
+
 class BND_Mesh : public BND_GeometryBase
 {
 public:
@@ -328,6 +404,31 @@ public:
   //public bool[] GetNakedEdgePointStatus()
   bool CreatePartitions(int maximumVertexCount, int maximumTriangleCount) { return m_mesh->CreatePartition(maximumVertexCount, maximumTriangleCount); }
   int PartitionCount() const;
+  // Quadric error simplification into a new triangle mesh; see mesh_simplify.h
+  BND_Mesh* Simplify(double targetRatio, double targetError, bool preserveBorders, bool preserveUVSeams) const;
+  // levels meshes, each simplified to ratio of the triangles of the one before
+  BND_TUPLE BuildLods(int levels, double ratio, bool preserveBorders, bool preserveUVSeams) const;
+  // Merges vertices within tolerance whose normals differ by at most
+  // angleTolerance (radians) and removes the faces that collapse or repeat
+  // another face. Returns true when the mesh changed.
+  bool Weld(double tolerance, double angleTolerance, int threadCount);
+  // Topology adjacency for the whole mesh in one call; the topology is
+  // built once and the rows are filled on threadCount threads
+  BND_MeshAdjacency* GetAdjacency(int threadCount) const;
+  // Average vertex cache miss ratio of the triangles in face order
+  double ComputeAcmr(int cacheSize) const;
+  // Reorders faces for the vertex cache (and overdraw) and vertices in
+  // order of first use; returns the ACMR before and after
+  BND_TUPLE OptimizeForGpu(bool optimizeOverdraw, int cacheSize);
+  // Quantized positions, octahedral normals and half float texture
+  // coordinates for GPU upload
+  BND_MeshQuantizedBuffers* ToQuantizedBuffers(const BND_MeshQuantizationOptions* options) const;
+  // Splits faces into a k-d hierarchy of tiles with at most maxTriangles
+  // triangles and no side longer than gridSize (either one 0 for no
+  // limit). Leaf tiles hold the faces as meshes, built on threadCount threads.
+  // With levelOfDetail, inner tiles hold their children's content
+  // simplified to half and the tileset refines by replacement.
+  class BND_TileSet* SplitIntoTiles(int maxTriangles, double gridSize, int threadCount, bool levelOfDetail) const;
   //public MeshPart GetPartition(int which)
   //public IEnumerable<MeshNgon> GetNgonAndFacesEnumerable()
   //public int GetNgonAndFacesCount()
@@ -1,5 +1,6 @@
 #include "bindings.h"
 #include "base64.h"
+#include "bnd_archive_passthrough.h"
 
 
 std::string StringFromDict(BND_DICT& d, const char* key)
@@ -65,6 +66,11 @@ void BND_CommonObject::SetTrackedPointer(ON_Object* obj, const ON_ModelComponent
   if( compref )
   {
     m_component_ref = *compref;
+    // wrapping a table component (layer, material, ...) itself lets script
+    // code edit it in place
+    const ON_ModelComponent* model_component = compref->ModelComponent();
+    if (model_component && model_component == ON_ModelComponent::Cast(obj))
+      BND_ArchivePassthrough::MarkExposed(model_component);
   }
   else
   {
@@ -1489,6 +1495,216 @@ BND_CommonObject* BND_CommonObject::Decode(BND_DICT jsonObject)
   return CreateWrapper(obj, nullptr);
 }
 
+// Layout written by EncodeBinary and EncodeMany, integers little endian:
+//   "RH3B" | u32 format version | u32 3dm version | u32 opennurbs version |
+//   u32 object count | u64 offsets[count + 1] | archive bytes
+// Offsets are relative to the first archive byte; the last one is the
+// archive length. A null entry passed to EncodeMany has an empty range.
+static const char BINARY_MAGIC[4] = { 'R', 'H', '3', 'B' };
+static const ON__UINT32 BINARY_FORMAT_VERSION = 1;
+static const size_t BINARY_HEADER_SIZE = 20;
+
+static void AppendUInt(std::string& s, ON__UINT64 value, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    s += (char)((value >> (8 * i)) & 0xFF);
+}
+
+static ON__UINT64 ReadUInt(const unsigned char* p, int bytes)
+{
+  ON__UINT64 value = 0;
+  for (int i = bytes - 1; i >= 0; i--)
+    value = (value << 8) | p[i];
+  return value;
+}
+
+static std::string EncodeObjects(const std::vector<const ON_Object*>& objects)
+{
+  const int rhinoversion = 60;
+  const unsigned int on_version__to_write = ON_BinaryArchive::ArchiveOpenNURBSVersionToWrite(rhinoversion, ON::Version());
+
+  size_t sz = 0;
+  for (const ON_Object* object : objects)
+    sz += object ? object->SizeOf() + 512 : 0;
+  ON_Write3dmBufferArchive archive(sz, 0, rhinoversion, on_version__to_write);
+
+  std::vector<ON__UINT64> offsets;
+  offsets.reserve(objects.size() + 1);
+  for (const ON_Object* object : objects)
+  {
+    offsets.push_back(archive.SizeOfArchive());
+    if (object && !archive.WriteObject(object))
+      return std::string();
+  }
+  offsets.push_back(archive.SizeOfArchive());
+
+  std::string rc;
+  rc.reserve(BINARY_HEADER_SIZE + 8 * offsets.size() + (size_t)offsets.back());
+  rc.append(BINARY_MAGIC, 4);
+  AppendUInt(rc, BINARY_FORMAT_VERSION, 4);
+  AppendUInt(rc, (ON__UINT64)rhinoversion, 4);
+  AppendUInt(rc, on_version__to_write, 4);
+  AppendUInt(rc, objects.size(), 4);
+  for (ON__UINT64 offset : offsets)
+    AppendUInt(rc, offset, 8);
+  rc.append((const char*)archive.Buffer(), (size_t)offsets.back());
+  return rc;
+}
+
+struct BND_EncodedObjects
+{
+  int m_3dm_version = 0;
+  unsigned int m_on_version = 0;
+  int m_count = 0;
+  const unsigned char* m_offsets = nullptr;
+  const unsigned char* m_archive = nullptr;
+  ON__UINT64 m_archive_length = 0;
+
+  bool Read(size_t length, const void* buffer)
+  {
+    const unsigned char* p = (const unsigned char*)buffer;
+    if (nullptr == p || length < BINARY_HEADER_SIZE + 8 || 0 != memcmp(p, BINARY_MAGIC, 4))
+      return false;
+    if (ReadUInt(p + 4, 4) != BINARY_FORMAT_VERSION)
+      return false;
+    m_3dm_version = (int)ReadUInt(p + 8, 4);
+    m_on_version = (unsigned int)ReadUInt(p + 12, 4);
+    const ON__UINT64 count = ReadUInt(p + 16, 4);
+    if (count > (length - BINARY_HEADER_SIZE) / 8 - 1)
+      return false;
+    m_count = (int)count;
+    m_offsets = p + BINARY_HEADER_SIZE;
+    m_archive = m_offsets + 8 * (count + 1);
+    m_archive_length = length - (m_archive - p);
+    if (Offset(m_count) > m_archive_length)
+      return false;
+    for (int i = 0; i < m_count; i++)
+    {
+      if (Offset(i) > Offset(i + 1))
+        return false;
+    }
+    return true;
+  }
+
+  ON__UINT64 Offset(int i) const { return ReadUInt(m_offsets + 8 * i, 8); }
+
+  ON_Object* ReadObject(int i) const
+  {
+    if (i < 0 || i >= m_count)
+      return nullptr;
+    const ON__UINT64 start = Offset(i);
+    const ON__UINT64 end = Offset(i + 1);
+    if (end <= start)
+      return nullptr;
+    return ON_ReadBufferArchive(m_3dm_version, m_on_version, (int)(end - start), m_archive + start);
+  }
+};
+
+BND_CommonObject* BND_CommonObject::DecodeBinary(size_t length, const void* buffer)
+{
+  return DecodeAt(length, buffer, 0);
+}
+
+BND_CommonObject* BND_CommonObject::DecodeAt(size_t length, const void* buffer, int index)
+{
+  BND_EncodedObjects encoded;
+  if (!encoded.Read(length, buffer))
+    return nullptr;
+  return CreateWrapper(encoded.ReadObject(index), nullptr);
+}
+
+int BND_CommonObject::EncodedCount(size_t length, const void* buffer)
+{
+  BND_EncodedObjects encoded;
+  return encoded.Read(length, buffer) ? encoded.m_count : -1;
+}
+
+BND_TUPLE BND_CommonObject::DecodeMany(size_t length, const void* buffer)
+{
+  BND_EncodedObjects encoded;
+  if (!encoded.Read(length, buffer))
+    return NullTuple();
+#if defined(ON_PYTHON_COMPILE) && defined(NANOBIND)
+  py::list rc;
+  for (int i = 0; i < encoded.m_count; i++)
+  {
+    BND_CommonObject* object = CreateWrapper(encoded.ReadObject(i), nullptr);
+    if (object)
+      rc.append(py::cast(object, py::rv_policy::take_ownership));
+    else
+      rc.append(py::none());
+  }
+  return py::tuple(rc);
+#else
+  BND_TUPLE rc = CreateTuple(encoded.m_count);
+  for (int i = 0; i < encoded.m_count; i++)
+    SetTuple(rc, i, CreateWrapper(encoded.ReadObject(i), nullptr));
+  return rc;
+#endif
+}
+
+#if defined(ON_PYTHON_COMPILE)
+py::bytes BND_CommonObject::EncodeBinary() const
+{
+  const std::string encoded = EncodeObjects({ m_object });
+  return py::bytes(encoded.data(), encoded.size());
+}
+
+py::bytes BND_CommonObject::EncodeMany(const std::vector<BND_CommonObject*>& objects)
+{
+  std::vector<const ON_Object*> _objects;
+  _objects.reserve(objects.size());
+  for (const BND_CommonObject* object : objects)
+    _objects.push_back(object ? object->m_object : nullptr);
+  const std::string encoded = EncodeObjects(_objects);
+  return py::bytes(encoded.data(), encoded.size());
+}
+#else
+static emscripten::val EncodedToUint8Array(const std::string& encoded)
+{
+  emscripten::val Uint8Array = emscripten::val::global("Uint8Array");
+  return Uint8Array.new_(emscripten::typed_memory_view(encoded.size(), (const unsigned char*)encoded.data()));
+}
+
+emscripten::val BND_CommonObject::EncodeBinary() const
+{
+  return EncodedToUint8Array(EncodeObjects({ m_object }));
+}
+
+emscripten::val BND_CommonObject::EncodeMany(emscripten::val objects)
+{
+  const int count = objects["length"].as<int>();
+  std::vector<const ON_Object*> _objects;
+  _objects.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    BND_CommonObject* object = objects[i].as<BND_CommonObject*>(emscripten::allow_raw_pointers());
+    _objects.push_back(object ? object->m_object : nullptr);
+  }
+  return EncodedToUint8Array(EncodeObjects(_objects));
+}
+
+BND_CommonObject* BND_CommonObject::WasmDecodeBinary(std::string buffer)
+{
+  return DecodeBinary(buffer.length(), buffer.c_str());
+}
+
+BND_TUPLE BND_CommonObject::WasmDecodeMany(std::string buffer)
+{
+  return DecodeMany(buffer.length(), buffer.c_str());
+}
+
+BND_CommonObject* BND_CommonObject::WasmDecodeAt(std::string buffer, int index)
+{
+  return DecodeAt(buffer.length(), buffer.c_str(), index);
+}
+
+int BND_CommonObject::WasmEncodedCount(std::string buffer)
+{
+  return EncodedCount(buffer.length(), buffer.c_str());
+}
+#endif
+
 
 bool BND_CommonObject::SetUserString(std::wstring key, std::wstring value)
 {
@@ -1579,6 +1795,31 @@ void initObjectBindings(rh3dmpymodule& m)
     .def_property_readonly("IsValidWithLog", &BND_CommonObject::IsValidWithLog)
     .def("Encode", &BND_CommonObject::Encode)
     .def_static("Decode", &BND_CommonObject::Decode, py::arg("jsonObject"))
+    .def("EncodeBinary", &BND_CommonObject::EncodeBinary)
+    .def_static("EncodeMany", &BND_CommonObject::EncodeMany, py::arg("objects"))
+#if defined(NANOBIND)
+    .def_static("DecodeBinary", [](py::bytes b) { return BND_CommonObject::DecodeBinary(b.size(), b.c_str()); }, py::arg("buffer"))
+    .def_static("DecodeMany", [](py::bytes b) { return BND_CommonObject::DecodeMany(b.size(), b.c_str()); }, py::arg("buffer"))
+    .def_static("DecodeAt", [](py::bytes b, int index) { return BND_CommonObject::DecodeAt(b.size(), b.c_str(), index); }, py::arg("buffer"), py::arg("index"))
+    .def_static("EncodedCount", [](py::bytes b) { return BND_CommonObject::EncodedCount(b.size(), b.c_str()); }, py::arg("buffer"))
+#else
+    .def_static("DecodeBinary", [](py::buffer b) {
+      py::buffer_info info = b.request();
+      return BND_CommonObject::DecodeBinary(static_cast<size_t>(info.size * info.itemsize), info.ptr);
+    }, py::arg("buffer"))
+    .def_static("DecodeMany", [](py::buffer b) {
+      py::buffer_info info = b.request();
+      return BND_CommonObject::DecodeMany(static_cast<size_t>(info.size * info.itemsize), info.ptr);
+    }, py::arg("buffer"))
+    .def_static("DecodeAt", [](py::buffer b, int index) {
+      py::buffer_info info = b.request();
+      return BND_CommonObject::DecodeAt(static_cast<size_t>(info.size * info.itemsize), info.ptr, index);
+    }, py::arg("buffer"), py::arg("index"))
+    .def_static("EncodedCount", [](py::buffer b) {
+      py::buffer_info info = b.request();
+      return BND_CommonObject::EncodedCount(static_cast<size_t>(info.size * info.itemsize), info.ptr);
+    }, py::arg("buffer"))
+#endif
     .def("SetUserString", &BND_CommonObject::SetUserString, py::arg("key"), py::arg("value"))
     .def("GetUserString", &BND_CommonObject::GetUserString, py::arg("key"))
     .def_property_readonly("UserStringCount", &BND_CommonObject::UserStringCount)
@@ -1607,6 +1848,12 @@ void initObjectBindings(void*)
     .function("encode", &BND_CommonObject::Encode)
     .function("toJSON", &BND_CommonObject::toJSON)
     .class_function("decode", &BND_CommonObject::Decode, allow_raw_pointers())
+    .function("encodeBinary", &BND_CommonObject::EncodeBinary)
+    .class_function("encodeMany", &BND_CommonObject::EncodeMany)
+    .class_function("decodeBinary", &BND_CommonObject::WasmDecodeBinary, allow_raw_pointers())
+    .class_function("decodeMany", &BND_CommonObject::WasmDecodeMany)
+    .class_function("decodeAt", &BND_CommonObject::WasmDecodeAt, allow_raw_pointers())
+    .class_function("encodedCount", &BND_CommonObject::WasmEncodedCount)
     .function("setUserString", &BND_CommonObject::SetUserString)
     .function("getUserString", &BND_CommonObject::GetUserString)
     .property("userStringCount", &BND_CommonObject::UserStringCount)
@@ -22,6 +22,26 @@ public:
   BND_DICT Encode() const;
   static BND_CommonObject* Decode(BND_DICT jsonObject);
 
+  // Compact binary alternative to Encode/Decode: raw bytes instead of a
+  // base64 string in a dictionary. EncodeMany writes every object into a
+  // single archive preceded by an offset index so DecodeAt can pull out
+  // one object without reading the others.
+#if defined(ON_PYTHON_COMPILE)
+  py::bytes EncodeBinary() const;
+  static py::bytes EncodeMany(const std::vector<BND_CommonObject*>& objects);
+#else
+  emscripten::val EncodeBinary() const;
+  static emscripten::val EncodeMany(emscripten::val objects);
+  static BND_CommonObject* WasmDecodeBinary(std::string buffer);
+  static BND_TUPLE WasmDecodeMany(std::string buffer);
+  static BND_CommonObject* WasmDecodeAt(std::string buffer, int index);
+  static int WasmEncodedCount(std::string buffer);
+#endif
+  static BND_CommonObject* DecodeBinary(size_t length, const void* buffer);
+  static BND_TUPLE DecodeMany(size_t length, const void* buffer);
+  static BND_CommonObject* DecodeAt(size_t length, const void* buffer, int index);
+  static int EncodedCount(size_t length, const void* buffer);
+
 #if defined(__EMSCRIPTEN__)
   BND_DICT toJSON(BND_DICT key);
 #endif
@@ -1,4 +1,8 @@
 #include "bindings.h"
+#include "point_cloud_lod.h"
+#include "point_cloud_normals.h"
+
+#include <algorithm>
 
 #if defined(ON_WASM_COMPILE)
 template<typename T>
@@ -793,6 +797,209 @@ int BND_PointCloud::ClosestPoint(const ON_3dPoint& testPoint)
   return -1;
 }
 
+// Copy of the points at indices with every per point array the source has
+static ON_PointCloud* PointCloudSubset(const ON_PointCloud& pointcloud, const unsigned int* indices, size_t count)
+{
+  const int pointCount = pointcloud.m_P.Count();
+  const bool normals = pointcloud.m_N.Count() == pointCount;
+  const bool colors = pointcloud.m_C.Count() == pointCount;
+  const bool values = pointcloud.m_V.Count() == pointCount;
+  const bool hidden = pointcloud.m_H.Count() == pointCount;
+
+  ON_PointCloud* rc = new ON_PointCloud((int)count);
+  for (size_t i = 0; i < count; i++)
+  {
+    const int index = (int)indices[i];
+    rc->m_P.Append(pointcloud.m_P[index]);
+    if (normals)
+      rc->m_N.Append(pointcloud.m_N[index]);
+    if (colors)
+      rc->m_C.Append(pointcloud.m_C[index]);
+    if (values)
+      rc->m_V.Append(pointcloud.m_V[index]);
+    if (hidden)
+      rc->m_H.Append(pointcloud.m_H[index]);
+  }
+  if (hidden)
+  {
+    rc->m_hidden_count = 0;
+    for (int i = 0; i < rc->m_H.Count(); i++)
+      rc->m_hidden_count += rc->m_H[i] ? 1 : 0;
+  }
+  return rc;
+}
+
+BND_TileSet* BND_PointCloud::BuildTiles(int maxPoints, int threadCount) const
+{
+  const ON_PointCloud& pointcloud = *m_pointcloud;
+  const int pointCount = pointcloud.m_P.Count();
+  const double* centers = pointCount > 0 ? &pointcloud.m_P[0].x : nullptr;
+
+  spatial_tiles_options options;
+  options.max_weight = maxPoints > 0 ? (double)maxPoints : 0.0;
+
+  BND_TileSet* rc = new BND_TileSet();
+  rc->m_tiles = spatial_tiles_build(centers, nullptr, nullptr, (size_t)pointCount, options, rc->m_order);
+  rc->m_content.resize(rc->m_tiles.size());
+  ParallelFor((int)rc->m_tiles.size(), threadCount, [&](int t)
+  {
+    const spatial_tile& tile = rc->m_tiles[t];
+    if (tile.end > tile.begin)
+      rc->m_content[t].reset(PointCloudSubset(pointcloud, rc->m_order.data() + tile.begin, tile.end - tile.begin));
+  });
+  return rc;
+}
+
+BND_PointCloud* BND_PointCloud::VoxelDownsample(double cellSize, int threadCount) const
+{
+  const ON_PointCloud& pointcloud = *m_pointcloud;
+  const int pointCount = pointcloud.m_P.Count();
+  const int threads = ParallelThreadCount(threadCount);
+  const bool* hidden = (pointcloud.m_H.Count() == pointCount && pointcloud.HiddenPointCount() > 0) ? pointcloud.m_H.Array() : nullptr;
+
+  std::vector<unsigned int> offsets;
+  std::vector<unsigned int> points;
+  point_voxel_group(pointCount > 0 ? &pointcloud.m_P[0].x : nullptr, (size_t)pointCount, hidden, cellSize,
+    [threads](int count, const std::function<void(int)>& func) { ParallelFor(count, threads, func); },
+    offsets, points);
+
+  const int cellCount = (int)offsets.size() - 1;
+  const bool normals = pointcloud.m_N.Count() == pointCount;
+  const bool colors = pointcloud.m_C.Count() == pointCount;
+  const bool values = pointcloud.m_V.Count() == pointCount;
+  ON_PointCloud* rc = new ON_PointCloud(cellCount);
+  rc->m_P.SetCount(cellCount);
+  if (normals)
+    rc->m_N.SetCount(cellCount);
+  if (colors)
+    rc->m_C.SetCount(cellCount);
+  if (values)
+    rc->m_V.SetCount(cellCount);
+
+  const int chunkSize = 4096;
+  ParallelFor((cellCount + chunkSize - 1) / chunkSize, threads, [&](int chunk)
+  {
+    const int last = std::min(cellCount, (chunk + 1) * chunkSize);
+    for (int cell = chunk * chunkSize; cell < last; cell++)
+    {
+      const unsigned int begin = offsets[cell];
+      const unsigned int end = offsets[cell + 1];
+      const double weight = 1.0 / (double)(end - begin);
+      ON_3dVector position = ON_3dVector::ZeroVector;
+      ON_3dVector normal = ON_3dVector::ZeroVector;
+      double rgba[4] = { 0, 0, 0, 0 };
+      double value = 0.0;
+      for (unsigned int i = begin; i < end; i++)
+      {
+        const int index = (int)points[i];
+        position += pointcloud.m_P[index] - ON_3dPoint::Origin;
+        if (normals)
+          normal += pointcloud.m_N[index];
+        if (colors)
+        {
+          const ON_Color& color = pointcloud.m_C[index];
+          rgba[0] += color.Red();
+          rgba[1] += color.Green();
+          rgba[2] += color.Blue();
+          rgba[3] += color.Alpha();
+        }
+        if (values)
+          value += pointcloud.m_V[index];
+      }
+      rc->m_P[cell] = ON_3dPoint::Origin + weight * position;
+      if (normals)
+      {
+        normal.Unitize();
+        rc->m_N[cell] = normal;
+      }
+      if (colors)
+        rc->m_C[cell] = ON_Color((int)(weight * rgba[0] + 0.5), (int)(weight * rgba[1] + 0.5), (int)(weight * rgba[2] + 0.5), (int)(weight * rgba[3] + 0.5));
+      if (values)
+        rc->m_V[cell] = weight * value;
+    }
+  });
+  return new BND_PointCloud(rc, nullptr);
+}
+
+BND_TileSet* BND_PointCloud::BuildLodOctree(int maxPointsPerNode, int threadCount) const
+{
+  const ON_PointCloud& pointcloud = *m_pointcloud;
+  const int pointCount = pointcloud.m_P.Count();
+  const int threads = ParallelThreadCount(threadCount);
+
+  BND_TileSet* rc = new BND_TileSet();
+  rc->m_tiles = point_lod_octree(pointCount > 0 ? &pointcloud.m_P[0].x : nullptr, (size_t)pointCount, maxPointsPerNode,
+    [threads](int count, const std::function<void(int)>& func) { ParallelFor(count, threads, func); },
+    rc->m_order);
+  rc->m_content.resize(rc->m_tiles.size());
+  ParallelFor((int)rc->m_tiles.size(), threads, [&](int t)
+  {
+    const spatial_tile& tile = rc->m_tiles[t];
+    if (tile.end > tile.begin)
+      rc->m_content[t].reset(PointCloudSubset(pointcloud, rc->m_order.data() + tile.begin, tile.end - tile.begin));
+  });
+  return rc;
+}
+
+bool BND_PointCloud::EstimateNormals(int k, double radius, ON_3dPoint orientTowards, int threadCount)
+{
+  ON_PointCloud& pointcloud = *m_pointcloud;
+  const int pointCount = pointcloud.m_P.Count();
+  if (pointCount < 1)
+    return false;
+  const int threads = ParallelThreadCount(threadCount);
+
+  point_normals_options options;
+  options.k = k;
+  options.radius = radius;
+  options.parallel_for = [threads](int count, const std::function<void(int)>& func) { ParallelFor(count, threads, func); };
+  ON_3dPoint viewpoint = orientTowards;
+  if (orientTowards.IsValid())
+    options.viewpoint = &viewpoint.x;
+  else if (pointcloud.m_N.Count() == pointCount)
+    options.previous = &pointcloud.m_N[0].x;
+  else
+  {
+    viewpoint = pointcloud.BoundingBox().Center();
+    options.viewpoint = &viewpoint.x;
+    options.away = true;
+  }
+
+  ON_PointCloud_FixPointCloud(m_pointcloud, true, false, false, false);
+  point_estimate_normals(&pointcloud.m_P[0].x, (size_t)pointCount, options, &pointcloud.m_N[0].x);
+  return true;
+}
+
+int BND_PointCloud::RemoveStatisticalOutliers(int k, double stdRatio, int threadCount)
+{
+  ON_PointCloud& pointcloud = *m_pointcloud;
+  const int pointCount = pointcloud.m_P.Count();
+  const int threads = ParallelThreadCount(threadCount);
+
+  std::vector<char> outliers;
+  const size_t count = point_statistical_outliers(pointCount > 0 ? &pointcloud.m_P[0].x : nullptr, (size_t)pointCount, k, stdRatio,
+    [threads](int n, const std::function<void(int)>& func) { ParallelFor(n, threads, func); },
+    outliers);
+  if (0 == count)
+    return 0;
+
+  if (pointcloud.m_H.Count() != pointCount)
+  {
+    pointcloud.m_H.Reserve(pointCount);
+    pointcloud.m_H.SetCount(pointCount);
+    pointcloud.m_H.Zero();
+  }
+  pointcloud.m_hidden_count = 0;
+  for (int i = 0; i < pointCount; i++)
+  {
+    if (outliers[i])
+      pointcloud.m_H[i] = true;
+    if (pointcloud.m_H[i])
+      pointcloud.m_hidden_count++;
+  }
+  return (int)count;
+}
+
 #if defined(ON_WASM_COMPILE)
 
 
@@ -991,6 +1198,11 @@ void initPointCloudBindings(rh3dmpymodule& m)
     .def("GetValues", &BND_PointCloud::GetValues)
     .def("GetValues2", &BND_PointCloud::GetValues2)
     .def("ClosestPoint", &BND_PointCloud::ClosestPoint, py::arg("testPoint"))
+    .def("BuildTiles", &BND_PointCloud::BuildTiles, py::arg("maxPoints")=100000, py::arg("threadCount")=0)
+    .def("VoxelDownsample", &BND_PointCloud::VoxelDownsample, py::arg("cellSize"), py::arg("threadCount")=0)
+    .def("BuildLodOctree", &BND_PointCloud::BuildLodOctree, py::arg("maxPointsPerNode")=20000, py::arg("threadCount")=0)
+    .def("EstimateNormals", &BND_PointCloud::EstimateNormals, py::arg("k")=16, py::arg("radius")=0.0, py::arg("orientTowards")=ON_3dPoint::UnsetPoint, py::arg("threadCount")=0)
+    .def("RemoveStatisticalOutliers", &BND_PointCloud::RemoveStatisticalOutliers, py::arg("k")=16, py::arg("stdRatio")=2.0, py::arg("threadCount")=0)
     ;
 }
 
@@ -1059,6 +1271,11 @@ void initPointCloudBindings(void*)
     .function("getColors", &BND_PointCloud::GetColors)
     .function("getValues", &BND_PointCloud::GetValues)
     .function("closestPoint", &BND_PointCloud::ClosestPoint)
+    .function("buildTiles", &BND_PointCloud::BuildTiles, allow_raw_pointers())
+    .function("voxelDownsample", &BND_PointCloud::VoxelDownsample, allow_raw_pointers())
+    .function("buildLodOctree", &BND_PointCloud::BuildLodOctree, allow_raw_pointers())
+    .function("estimateNormals", &BND_PointCloud::EstimateNormals)
+    .function("removeStatisticalOutliers", &BND_PointCloud::RemoveStatisticalOutliers)
     .function("toThreejsJSON", &BND_PointCloud::ToThreejsJSON)
     .class_function("createFromThreejsJSON", &BND_PointCloud::CreateFromThreejsJSON, allow_raw_pointers())
     ;
@@ -127,6 +127,23 @@ public:
   BND_TUPLE GetValues() const;
   std::vector<double> GetValues2() const;
   int ClosestPoint(const ON_3dPoint& testPoint);
+  // Splits points into a k-d hierarchy of tiles with at most maxPoints
+  // points each. Leaf tiles hold the points as point clouds, built on
+  // threadCount threads.
+  class BND_TileSet* BuildTiles(int maxPoints, int threadCount) const;
+  // New point cloud with one point per occupied cube of cellSize: the
+  // average position, normal, color and value of its visible points
+  BND_PointCloud* VoxelDownsample(double cellSize, int threadCount) const;
+  // Octree of tiles with at most maxPointsPerNode points each, every tile
+  // an evenly spread subset that its children add detail to
+  class BND_TileSet* BuildLodOctree(int maxPointsPerNode, int threadCount) const;
+  // Writes unit normals fitted to the k nearest points (all points within
+  // radius when radius > 0) to the normals, facing orientTowards when it
+  // is valid, else the side of the current normals, else outwards
+  bool EstimateNormals(int k, double radius, ON_3dPoint orientTowards, int threadCount);
+  // Hides points whose mean distance to their k nearest neighbours is more
+  // than stdRatio standard deviations above average; returns their count
+  int RemoveStatisticalOutliers(int k, double stdRatio, int threadCount);
 
 #if defined(ON_WASM_COMPILE)
   BND_DICT ToThreejsJSON() const;
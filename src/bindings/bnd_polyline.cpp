@@ -48,7 +48,9 @@ ON_3dPoint BND_Point3dList::GetPoint(int index) const
 
 void BND_Point3dList::Transform(const BND_Transform& xform)
 {
-  m_polyline.Transform(xform.m_xform);
+  const int count = m_polyline.Count();
+  if (count > 0)
+    BND_TransformPoints(xform.m_xform, &m_polyline[0].x, &m_polyline[0].x, (size_t)count, 1);
 }
 
 void BND_Point3dList::SetAllX(double xValue)
@@ -1,5 +1,9 @@
 #include "bindings.h"
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
 BND_SubD::BND_SubD(ON_SubD* subd, const ON_ModelComponentReference* compref)
 {
   SetTrackedPointer(subd, compref);
@@ -16,17 +20,272 @@ BND_SubD::BND_SubD()
   SetTrackedPointer(new ON_SubD(), nullptr);
 }
 
+BND_SubD* BND_SubD::CreateFromMesh(const BND_Mesh& mesh)
+{
+  ON_SubD* subd = ON_SubD::CreateFromMesh(mesh.m_mesh, nullptr, nullptr);
+  if (nullptr == subd)
+    return nullptr;
+  return new BND_SubD(subd, nullptr);
+}
+
+// Single precision copy of an ON_SubDMeshFragment, which only lives for
+// the duration of the GetMeshFragments callback
+struct BND_SubDFragment
+{
+  unsigned int m_face_id = 0;
+  std::vector<float> m_points;
+  std::vector<float> m_normals;
+  std::vector<unsigned int> m_quads; // 4 grid point indices per quad
+};
+
+static bool CopySubDMeshFragment(ON__UINT_PTR context, const ON_SubDMeshFragment* fragment)
+{
+  std::vector<BND_SubDFragment>* fragments = (std::vector<BND_SubDFragment>*)context;
+  const unsigned int point_count = fragment ? fragment->PointArrayCount(ON_SubDComponentLocation::Surface) : 0;
+  if (0 == point_count || nullptr == fragment->m_grid.m_F)
+    return true;
+
+  BND_SubDFragment copy;
+  copy.m_face_id = fragment->m_face ? fragment->m_face->m_id : 0;
+
+  const double* points = fragment->PointArray(ON_SubDComponentLocation::Surface);
+  const size_t point_stride = fragment->PointArrayStride(ON_SubDComponentLocation::Surface);
+  const double* normals = fragment->NormalArray(ON_SubDComponentLocation::Surface);
+  const size_t normal_stride = fragment->NormalArrayStride(ON_SubDComponentLocation::Surface);
+  const bool has_normals = nullptr != normals && fragment->NormalArrayCount(ON_SubDComponentLocation::Surface) == point_count;
+  copy.m_points.resize(3 * point_count);
+  copy.m_normals.resize(3 * point_count, 0.0f);
+  for (unsigned int i = 0; i < point_count; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      copy.m_points[3 * i + j] = (float)points[i * point_stride + j];
+      if (has_normals)
+        copy.m_normals[3 * i + j] = (float)normals[i * normal_stride + j];
+    }
+  }
+
+  const ON_SubDMeshFragmentGrid& grid = fragment->m_grid;
+  copy.m_quads.reserve(4 * grid.m_F_count);
+  for (unsigned int i = 0; i < grid.m_F_count; i++)
+  {
+    const unsigned int* quad = grid.m_F + i * grid.m_F_stride;
+    if (quad[0] < point_count && quad[1] < point_count && quad[2] < point_count && quad[3] < point_count)
+      copy.m_quads.insert(copy.m_quads.end(), quad, quad + 4);
+  }
+
+  fragments->push_back(std::move(copy));
+  return true;
+}
+
+BND_SubDSurfaceMeshBuffers* BND_SubD::GetSurfaceMeshBuffers(int density, bool multipleThreads)
+{
+  // display densities above 6 produce more than 4096 quads per SubD face
+  const unsigned int _density = (unsigned int)std::max(1, std::min(density, 6));
+
+  // ON_SubD::GetMeshFragments has no per face entry point, so evaluation
+  // is one pass over all faces; only packing the copies runs in parallel
+  std::vector<BND_SubDFragment> fragments;
+  ON_SubDDisplayParameters display_parameters = ON_SubDDisplayParameters::CreateFromDisplayDensity(_density);
+  m_subd->GetMeshFragments(display_parameters, (ON__UINT_PTR)&fragments, CopySubDMeshFragment);
+
+  const int fragment_count = (int)fragments.size();
+  std::vector<size_t> point_offsets(fragment_count + 1, 0);
+  std::vector<size_t> quad_offsets(fragment_count + 1, 0);
+  for (int i = 0; i < fragment_count; i++)
+  {
+    point_offsets[i + 1] = point_offsets[i] + fragments[i].m_points.size() / 3;
+    quad_offsets[i + 1] = quad_offsets[i] + fragments[i].m_quads.size() / 4;
+  }
+
+  BND_SubDSurfaceMeshBuffers* rc = new BND_SubDSurfaceMeshBuffers();
+  rc->m_positions.resize(3 * point_offsets[fragment_count]);
+  rc->m_normals.resize(3 * point_offsets[fragment_count]);
+  rc->m_indices.resize(6 * quad_offsets[fragment_count]);
+  rc->m_face_ids.resize(2 * quad_offsets[fragment_count]);
+
+  // every fragment writes to its own range of the output buffers
+  ParallelFor(fragment_count, multipleThreads ? ParallelThreadCount(0) : 1, [&](int i)
+  {
+    const BND_SubDFragment& fragment = fragments[i];
+    const unsigned int base = (unsigned int)point_offsets[i];
+    float* positions = rc->m_positions.data() + 3 * point_offsets[i];
+    float* normals = rc->m_normals.data() + 3 * point_offsets[i];
+    std::copy(fragment.m_points.begin(), fragment.m_points.end(), positions);
+    std::copy(fragment.m_normals.begin(), fragment.m_normals.end(), normals);
+
+    unsigned int* indices = rc->m_indices.data() + 6 * quad_offsets[i];
+    unsigned int* face_ids = rc->m_face_ids.data() + 2 * quad_offsets[i];
+    for (size_t j = 0; j + 3 < fragment.m_quads.size(); j += 4)
+    {
+      const unsigned int* quad = fragment.m_quads.data() + j;
+      *indices++ = base + quad[0];
+      *indices++ = base + quad[1];
+      *indices++ = base + quad[2];
+      *indices++ = base + quad[0];
+      *indices++ = base + quad[2];
+      *indices++ = base + quad[3];
+      *face_ids++ = fragment.m_face_id;
+      *face_ids++ = fragment.m_face_id;
+    }
+  });
+  return rc;
+}
+
+BND_SubDToBrepResults::~BND_SubDToBrepResults()
+{
+  for (ON_Brep* brep : m_breps)
+    delete brep;
+}
+
+BND_TUPLE BND_SubDToBrepResults::Breps() const
+{
+#if defined(ON_PYTHON_COMPILE) && defined(NANOBIND)
+  py::list rc;
+  for (const ON_Brep* brep : m_breps)
+  {
+    if (brep)
+      rc.append(py::cast(new BND_Brep(new ON_Brep(*brep), nullptr), py::rv_policy::take_ownership));
+    else
+      rc.append(py::none());
+  }
+  return py::tuple(rc);
+#else
+  BND_TUPLE rc = CreateTuple((int)m_breps.size());
+  for (int i = 0; i < (int)m_breps.size(); i++)
+  {
+    if (m_breps[i])
+      SetTuple(rc, i, new BND_Brep(new ON_Brep(*m_breps[i]), nullptr));
+    else
+      SetTuple(rc, i, (BND_Brep*)nullptr);
+  }
+  return rc;
+#endif
+}
+
+BND_Brep* BND_SubD::ToBrep(const BND_SubDToBrepParameters* parameters) const
+{
+  ON_Brep* brep = m_subd->GetSurfaceBrep(parameters ? parameters->m_parameters : ON_SubDToBrepParameters::Default, nullptr);
+  if (nullptr == brep)
+    return nullptr;
+  return new BND_Brep(brep, nullptr);
+}
+
+BND_SubDToBrepResults* BND_SubD::ToBrepMany(const std::vector<const ON_SubD*>& subds, const BND_SubDToBrepParameters* parameters, int threadCount)
+{
+  typedef std::chrono::steady_clock clock;
+  const clock::time_point start = clock::now();
+  const ON_SubDToBrepParameters& brep_parameters = parameters ? parameters->m_parameters : ON_SubDToBrepParameters::Default;
+  const int count = (int)subds.size();
+
+  BND_SubDToBrepResults* rc = new BND_SubDToBrepResults();
+  rc->m_breps.resize(count, nullptr);
+  rc->m_seconds.resize(count, 0.0);
+
+  // SubD evaluation caches are not thread safe, so a SubD that is listed
+  // more than once is converted once and copied
+  std::unordered_map<const ON_SubD*, int> first_index;
+  std::vector<int> unique_indices;
+  std::vector<int> source_index(count);
+  for (int i = 0; i < count; i++)
+  {
+    auto inserted = first_index.insert(std::make_pair(subds[i], i));
+    source_index[i] = inserted.first->second;
+    if (inserted.second && subds[i])
+      unique_indices.push_back(i);
+  }
+
+  ParallelFor((int)unique_indices.size(), ParallelThreadCount(threadCount), [&](int k)
+  {
+    const int i = unique_indices[k];
+    const clock::time_point t0 = clock::now();
+    rc->m_breps[i] = subds[i]->GetSurfaceBrep(brep_parameters, nullptr);
+    rc->m_seconds[i] = std::chrono::duration<double>(clock::now() - t0).count();
+  });
+
+  for (int i = 0; i < count; i++)
+  {
+    const int j = source_index[i];
+    if (j != i && rc->m_breps[j])
+    {
+      rc->m_breps[i] = new ON_Brep(*rc->m_breps[j]);
+      rc->m_seconds[i] = rc->m_seconds[j];
+    }
+  }
+
+  rc->m_total_seconds = std::chrono::duration<double>(clock::now() - start).count();
+  return rc;
+}
+
+#if defined(ON_PYTHON_COMPILE)
+BND_SubDToBrepResults* BND_SubD::ToBrepMany2(const std::vector<BND_SubD*>& subds, const BND_SubDToBrepParameters* parameters, int threadCount)
+{
+  std::vector<const ON_SubD*> _subds;
+  _subds.reserve(subds.size());
+  for (BND_SubD* subd : subds)
+    _subds.push_back(subd ? subd->m_subd : nullptr);
+  return ToBrepMany(_subds, parameters, threadCount);
+}
+#else
+BND_SubDToBrepResults* BND_SubD::ToBrepMany2(emscripten::val subds, const BND_SubDToBrepParameters* parameters, int threadCount)
+{
+  const int count = subds["length"].as<int>();
+  std::vector<const ON_SubD*> _subds;
+  _subds.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    BND_SubD* subd = subds[i].as<BND_SubD*>(emscripten::allow_raw_pointers());
+    _subds.push_back(subd ? subd->m_subd : nullptr);
+  }
+  return ToBrepMany(_subds, parameters, threadCount);
+}
+#endif
+
 
 #if defined(ON_PYTHON_COMPILE)
 
 void initSubDBindings(rh3dmpymodule& m)
 {
+  py::enum_<ON_SubDToBrepParameters::VertexProcess>(m, "SubDToBrepVertexProcess")
+    .value("None", ON_SubDToBrepParameters::VertexProcess::None)
+    .value("LocalG1", ON_SubDToBrepParameters::VertexProcess::LocalG1)
+    .value("LocalG2", ON_SubDToBrepParameters::VertexProcess::LocalG2)
+    .value("LocalG1x", ON_SubDToBrepParameters::VertexProcess::LocalG1x)
+    .value("LocalG1xx", ON_SubDToBrepParameters::VertexProcess::LocalG1xx)
+    ;
+
+  py::class_<BND_SubDToBrepParameters>(m, "SubDToBrepParameters")
+    .def(py::init<>())
+    .def_property("PackFaces", &BND_SubDToBrepParameters::PackFaces, &BND_SubDToBrepParameters::SetPackFaces)
+    .def_property("ExtraordinaryVertexProcess", &BND_SubDToBrepParameters::ExtraordinaryVertexProcess, &BND_SubDToBrepParameters::SetExtraordinaryVertexProcess)
+    ;
+
+  py::class_<BND_SubDToBrepResults>(m, "SubDToBrepResults")
+    .def_property_readonly("Count", &BND_SubDToBrepResults::Count)
+    .def_property_readonly("Breps", &BND_SubDToBrepResults::Breps)
+    .def_property_readonly("Seconds", &BND_SubDToBrepResults::Seconds)
+    .def_property_readonly("TotalSeconds", &BND_SubDToBrepResults::TotalSeconds)
+    ;
+
+  py::class_<BND_SubDSurfaceMeshBuffers>(m, "SubDSurfaceMeshBuffers")
+    .def_property_readonly("VertexCount", &BND_SubDSurfaceMeshBuffers::VertexCount)
+    .def_property_readonly("TriangleCount", &BND_SubDSurfaceMeshBuffers::TriangleCount)
+    .def_property_readonly("Positions", &BND_SubDSurfaceMeshBuffers::Positions)
+    .def_property_readonly("Normals", &BND_SubDSurfaceMeshBuffers::Normals)
+    .def_property_readonly("Indices", &BND_SubDSurfaceMeshBuffers::Indices)
+    .def_property_readonly("FaceIds", &BND_SubDSurfaceMeshBuffers::FaceIds)
+    ;
+
   py::class_<BND_SubD, BND_GeometryBase>(m, "SubD")
     .def(py::init<>())
     .def_property_readonly("IsSolid", &BND_SubD::IsSolid)
     .def("ClearEvaluationCache", &BND_SubD::ClearEvaluationCache)
     .def("UpdateAllTagsAndSectorCoefficients", &BND_SubD::UpdateAllTagsAndSectorCoefficients)
     .def("Subdivide", &BND_SubD::Subdivide, py::arg("count"))
+    .def_static("CreateFromMesh", &BND_SubD::CreateFromMesh, py::arg("mesh"))
+    .def("GetSurfaceMeshBuffers", &BND_SubD::GetSurfaceMeshBuffers, py::arg("density")=4, py::arg("multipleThreads")=true)
+    .def("ToBrep", &BND_SubD::ToBrep, py::arg("parameters")=nullptr)
+    .def_static("ToBrepMany", &BND_SubD::ToBrepMany2, py::arg("subds"), py::arg("parameters")=nullptr, py::arg("threadCount")=0)
     ;
 }
 
@@ -37,12 +296,46 @@ using namespace emscripten;
 
 void initSubDBindings(void*)
 {
+  enum_<ON_SubDToBrepParameters::VertexProcess>("SubDToBrepVertexProcess")
+    .value("None", ON_SubDToBrepParameters::VertexProcess::None)
+    .value("LocalG1", ON_SubDToBrepParameters::VertexProcess::LocalG1)
+    .value("LocalG2", ON_SubDToBrepParameters::VertexProcess::LocalG2)
+    .value("LocalG1x", ON_SubDToBrepParameters::VertexProcess::LocalG1x)
+    .value("LocalG1xx", ON_SubDToBrepParameters::VertexProcess::LocalG1xx)
+    ;
+
+  class_<BND_SubDToBrepParameters>("SubDToBrepParameters")
+    .constructor<>()
+    .property("packFaces", &BND_SubDToBrepParameters::PackFaces, &BND_SubDToBrepParameters::SetPackFaces)
+    .property("extraordinaryVertexProcess", &BND_SubDToBrepParameters::ExtraordinaryVertexProcess, &BND_SubDToBrepParameters::SetExtraordinaryVertexProcess)
+    ;
+
+  class_<BND_SubDToBrepResults>("SubDToBrepResults")
+    .property("count", &BND_SubDToBrepResults::Count)
+    .property("breps", &BND_SubDToBrepResults::Breps)
+    .property("seconds", &BND_SubDToBrepResults::Seconds)
+    .property("totalSeconds", &BND_SubDToBrepResults::TotalSeconds)
+    ;
+
+  class_<BND_SubDSurfaceMeshBuffers>("SubDSurfaceMeshBuffers")
+    .property("vertexCount", &BND_SubDSurfaceMeshBuffers::VertexCount)
+    .property("triangleCount", &BND_SubDSurfaceMeshBuffers::TriangleCount)
+    .property("positions", &BND_SubDSurfaceMeshBuffers::Positions)
+    .property("normals", &BND_SubDSurfaceMeshBuffers::Normals)
+    .property("indices", &BND_SubDSurfaceMeshBuffers::Indices)
+    .property("faceIds", &BND_SubDSurfaceMeshBuffers::FaceIds)
+    ;
+
   class_<BND_SubD, base<BND_GeometryBase>>("SubD")
     .constructor<>()
     .property("isSolid", &BND_SubD::IsSolid)
     .function("clearEvaluationCache", &BND_SubD::ClearEvaluationCache)
     .function("updateAllTagsAndSectorCoefficients", &BND_SubD::UpdateAllTagsAndSectorCoefficients)
     .function("subdivide", &BND_SubD::Subdivide)
+    .class_function("createFromMesh", &BND_SubD::CreateFromMesh, allow_raw_pointers())
+    .function("getSurfaceMeshBuffers", &BND_SubD::GetSurfaceMeshBuffers, allow_raw_pointers())
+    .function("toBrep", &BND_SubD::ToBrep, allow_raw_pointers())
+    .class_function("toBrepMany", &BND_SubD::ToBrepMany2, allow_raw_pointers())
     ;
 }
 #endif
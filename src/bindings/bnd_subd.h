@@ -8,6 +8,56 @@ void initSubDBindings(rh3dmpymodule& m);
 void initSubDBindings(void* m);
 #endif
 
+// Limit surface mesh of a SubD packed for display. Fragments do not share
+// vertices, so points along fragment boundaries are repeated.
+class BND_SubDSurfaceMeshBuffers
+{
+public:
+  int VertexCount() const { return (int)(m_positions.size() / 3); }
+  int TriangleCount() const { return (int)(m_indices.size() / 3); }
+  BND_BUFFER Positions() const { return CreateBuffer(m_positions); }
+  BND_BUFFER Normals() const { return CreateBuffer(m_normals); }
+  BND_BUFFER Indices() const { return CreateBuffer(m_indices); }
+  BND_BUFFER FaceIds() const { return CreateBuffer(m_face_ids); }
+
+public:
+  std::vector<float> m_positions;       // x,y,z per vertex
+  std::vector<float> m_normals;         // x,y,z per vertex
+  std::vector<unsigned int> m_indices;  // 3 per triangle
+  std::vector<unsigned int> m_face_ids; // ON_SubDFace id per triangle
+};
+
+class BND_SubDToBrepParameters
+{
+public:
+  ON_SubDToBrepParameters m_parameters = ON_SubDToBrepParameters::Default;
+
+  bool PackFaces() const { return m_parameters.PackFaces(); }
+  void SetPackFaces(bool packFaces) { m_parameters.SetPackFaces(packFaces); }
+  ON_SubDToBrepParameters::VertexProcess ExtraordinaryVertexProcess() const { return m_parameters.ExtraordinaryVertexProcess(); }
+  void SetExtraordinaryVertexProcess(ON_SubDToBrepParameters::VertexProcess vertexProcess) { m_parameters.SetExtraordinaryVertexProcess(vertexProcess); }
+};
+
+// Breps and per object conversion times of SubD.ToBrepMany
+class BND_SubDToBrepResults
+{
+public:
+  BND_SubDToBrepResults() = default;
+  BND_SubDToBrepResults(const BND_SubDToBrepResults&) = delete;
+  BND_SubDToBrepResults& operator=(const BND_SubDToBrepResults&) = delete;
+  ~BND_SubDToBrepResults();
+
+  int Count() const { return (int)m_breps.size(); }
+  BND_TUPLE Breps() const;
+  BND_BUFFER Seconds() const { return CreateBuffer(m_seconds); }
+  double TotalSeconds() const { return m_total_seconds; }
+
+public:
+  std::vector<ON_Brep*> m_breps; // nullptr where conversion failed
+  std::vector<double> m_seconds;
+  double m_total_seconds = 0.0;
+};
+
 class BND_SubD : public BND_GeometryBase
 {
   ON_SubD* m_subd = nullptr;
@@ -21,6 +71,16 @@ public:
   void ClearEvaluationCache() const { m_subd->ClearEvaluationCache(); }
   unsigned int UpdateAllTagsAndSectorCoefficients() { return m_subd->UpdateAllTagsAndSectorCoefficients(false); }
   bool Subdivide(int count) { return m_subd->GlobalSubdivide(count); }
+  // SubD with the mesh as its control net, default ON_ToSubDParameters
+  static BND_SubD* CreateFromMesh(const class BND_Mesh& mesh);
+  BND_SubDSurfaceMeshBuffers* GetSurfaceMeshBuffers(int density, bool multipleThreads);
+  class BND_Brep* ToBrep(const BND_SubDToBrepParameters* parameters) const;
+  static BND_SubDToBrepResults* ToBrepMany(const std::vector<const ON_SubD*>& subds, const BND_SubDToBrepParameters* parameters, int threadCount);
+#if defined(ON_PYTHON_COMPILE)
+  static BND_SubDToBrepResults* ToBrepMany2(const std::vector<BND_SubD*>& subds, const BND_SubDToBrepParameters* parameters, int threadCount);
+#else
+  static BND_SubDToBrepResults* ToBrepMany2(emscripten::val subds, const BND_SubDToBrepParameters* parameters, int threadCount);
+#endif
 
 protected:
   void SetTrackedPointer(ON_SubD* subd, const ON_ModelComponentReference* compref);
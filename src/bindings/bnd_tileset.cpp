@@ -0,0 +1,99 @@
+#include "bindings.h"
+
+BND_BoundingBox BND_TileSet::GetBoundingBox(int index) const
+{
+  if (index < 0 || index >= TileCount())
+    return BND_BoundingBox(ON_BoundingBox::EmptyBoundingBox);
+  const spatial_tile& tile = m_tiles[index];
+  return BND_BoundingBox(tile.min[0], tile.min[1], tile.min[2], tile.max[0], tile.max[1], tile.max[2]);
+}
+
+int BND_TileSet::GetParent(int index) const
+{
+  if (index < 0 || index >= TileCount())
+    return -1;
+  return m_tiles[index].parent;
+}
+
+BND_TUPLE BND_TileSet::GetChildren(int index) const
+{
+  const int count = (index < 0 || index >= TileCount()) ? 0 : m_tiles[index].child_count;
+  BND_TUPLE rc = CreateTuple(count);
+  for (int i = 0; i < count; i++)
+    SetTuple(rc, i, m_tiles[index].first_child + i);
+  return rc;
+}
+
+int BND_TileSet::GetDepth(int index) const
+{
+  if (index < 0 || index >= TileCount())
+    return -1;
+  return m_tiles[index].depth;
+}
+
+double BND_TileSet::GetGeometricError(int index) const
+{
+  if (index < 0 || index >= TileCount())
+    return 0.0;
+  return m_tiles[index].geometric_error;
+}
+
+BND_BUFFER BND_TileSet::GetItemIndices(int index) const
+{
+  if (index < 0 || index >= TileCount())
+    return CreateBuffer(std::vector<unsigned int>());
+  const spatial_tile& tile = m_tiles[index];
+  return CreateBuffer(m_order.data() + tile.begin, tile.end - tile.begin);
+}
+
+BND_GeometryBase* BND_TileSet::GetContent(int index) const
+{
+  if (index < 0 || index >= (int)m_content.size() || !m_content[index])
+    return nullptr;
+  ON_Object* copy = m_content[index]->Duplicate();
+  return dynamic_cast<BND_GeometryBase*>(BND_CommonObject::CreateWrapper(copy, nullptr));
+}
+
+std::string BND_TileSet::ToTilesetJson(std::string contentUri) const
+{
+  return spatial_tiles_json(m_tiles, contentUri);
+}
+
+
+#if defined(ON_PYTHON_COMPILE)
+
+void initTileSetBindings(rh3dmpymodule& m)
+{
+  py::class_<BND_TileSet>(m, "TileSet")
+    .def_property_readonly("TileCount", &BND_TileSet::TileCount)
+    .def("GetBoundingBox", &BND_TileSet::GetBoundingBox, py::arg("index"))
+    .def("GetParent", &BND_TileSet::GetParent, py::arg("index"))
+    .def("GetChildren", &BND_TileSet::GetChildren, py::arg("index"))
+    .def("GetDepth", &BND_TileSet::GetDepth, py::arg("index"))
+    .def("GetGeometricError", &BND_TileSet::GetGeometricError, py::arg("index"))
+    .def("GetItemIndices", &BND_TileSet::GetItemIndices, py::arg("index"))
+    .def("GetContent", &BND_TileSet::GetContent, py::arg("index"))
+    .def("ToTilesetJson", &BND_TileSet::ToTilesetJson, py::arg("contentUri")="{index}.glb")
+    ;
+}
+
+#endif
+
+#if defined(ON_WASM_COMPILE)
+using namespace emscripten;
+
+void initTileSetBindings(void*)
+{
+  class_<BND_TileSet>("TileSet")
+    .property("tileCount", &BND_TileSet::TileCount)
+    .function("getBoundingBox", &BND_TileSet::GetBoundingBox)
+    .function("getParent", &BND_TileSet::GetParent)
+    .function("getChildren", &BND_TileSet::GetChildren)
+    .function("getDepth", &BND_TileSet::GetDepth)
+    .function("getGeometricError", &BND_TileSet::GetGeometricError)
+    .function("getItemIndices", &BND_TileSet::GetItemIndices)
+    .function("getContent", &BND_TileSet::GetContent, allow_raw_pointers())
+    .function("toTilesetJson", &BND_TileSet::ToTilesetJson)
+    ;
+}
+#endif
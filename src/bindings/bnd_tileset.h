@@ -0,0 +1,34 @@
+#include "bindings.h"
+
+#pragma once
+
+#include "spatial_tiles.h"
+
+#if defined(ON_PYTHON_COMPILE)
+void initTileSetBindings(rh3dmpymodule& m);
+#else
+void initTileSetBindings(void* m);
+#endif
+
+// Spatial hierarchy of a mesh or point cloud split for streaming, see
+// spatial_tiles.h. Tiles with content hold a piece of the source geometry;
+// write each one out (Draco, glb, quantized buffers) under the uri given
+// to ToTilesetJson.
+class BND_TileSet
+{
+public:
+  int TileCount() const { return (int)m_tiles.size(); }
+  BND_BoundingBox GetBoundingBox(int index) const;
+  int GetParent(int index) const;
+  BND_TUPLE GetChildren(int index) const;
+  int GetDepth(int index) const;
+  double GetGeometricError(int index) const;
+  BND_BUFFER GetItemIndices(int index) const;
+  class BND_GeometryBase* GetContent(int index) const;
+  std::string ToTilesetJson(std::string contentUri) const;
+
+public:
+  std::vector<spatial_tile> m_tiles;
+  std::vector<unsigned int> m_order;                    // source faces or points, tile ranges index into this
+  std::vector<std::shared_ptr<ON_Geometry>> m_content;  // per tile, null for tiles without items
+};
@@ -1,4 +1,5 @@
 #include "bindings.h"
+#include "point_transform.h"
 
 BND_Transform BND_Transform::Identity()
 {
@@ -131,6 +132,109 @@ std::vector<float> BND_Transform::ToFloatArray2(bool rowDominant) const
   return rc;
 }
 
+template<typename T>
+static void TransformPoints(const ON_Xform& xform, const T* in, T* out, size_t count, int threadCount)
+{
+  // large enough that starting a thread is noise, small enough to balance
+  const size_t chunk = 1 << 16;
+  const int chunk_count = (int)((count + chunk - 1) / chunk);
+  ParallelFor(chunk_count, ParallelThreadCount(threadCount), [&](int i)
+  {
+    const size_t start = (size_t)i * chunk;
+    const size_t n = (count - start) < chunk ? (count - start) : chunk;
+    point_transform(xform.m_xform, in + 3 * start, out + 3 * start, n);
+  });
+}
+
+void BND_TransformPoints(const ON_Xform& xform, const double* in, double* out, size_t count, int threadCount)
+{
+  TransformPoints(xform, in, out, count, threadCount);
+}
+
+void BND_TransformPoints(const ON_Xform& xform, const float* in, float* out, size_t count, int threadCount)
+{
+  TransformPoints(xform, in, out, count, threadCount);
+}
+
+#if defined(ON_PYTHON_COMPILE) && !defined(NANOBIND)
+// element size of a float32 / float64 buffer format, 0 for anything else
+static int PointBufferItemSize(std::string format)
+{
+  if (!format.empty() && (format[0] == '@' || format[0] == '=' || format[0] == '<'))
+    format = format.substr(1);
+  if (format == "d")
+    return 8;
+  if (format == "f")
+    return 4;
+  return 0;
+}
+
+py::object BND_Transform::ApplyToPoints(py::buffer points, bool inPlace, int threadCount) const
+{
+  py::buffer_info info = points.request(inPlace);
+  const int itemsize = PointBufferItemSize(info.format);
+  if (0 == itemsize || itemsize != info.itemsize || info.size % 3 != 0)
+    throw py::value_error("points must be a float32 or float64 buffer of x,y,z values");
+  ssize_t stride = info.itemsize;
+  for (ssize_t i = info.ndim - 1; i >= 0; i--)
+  {
+    if (info.shape[i] > 1 && info.strides[i] != stride)
+      throw py::value_error("points must be a contiguous buffer");
+    stride *= info.shape[i];
+  }
+
+  const size_t count = (size_t)info.size / 3;
+  py::object rc = points;
+  void* out = info.ptr;
+  if (!inPlace)
+  {
+    rc = py::reinterpret_steal<py::object>(PyByteArray_FromStringAndSize(nullptr, (Py_ssize_t)(info.size * info.itemsize)));
+    out = PyByteArray_AsString(rc.ptr());
+  }
+
+  if (8 == itemsize)
+    BND_TransformPoints(m_xform, (const double*)info.ptr, (double*)out, count, threadCount);
+  else
+    BND_TransformPoints(m_xform, (const float*)info.ptr, (float*)out, count, threadCount);
+
+  if (inPlace)
+    return rc;
+  py::object memoryview = py::module_::import("builtins").attr("memoryview");
+  if (2 == info.ndim)
+    return memoryview(rc).attr("cast")(info.format, py::make_tuple(count, 3));
+  return memoryview(rc).attr("cast")(info.format);
+}
+#endif
+
+#if defined(ON_WASM_COMPILE)
+template<typename T>
+static emscripten::val ApplyToJSPoints(const ON_Xform& xform, emscripten::val points, bool inPlace, bool typed)
+{
+  std::vector<T> values = emscripten::convertJSArrayToNumberVector<T>(points);
+  BND_TransformPoints(xform, values.data(), values.data(), values.size() / 3, 1);
+  if (!inPlace)
+    return CreateBuffer(values);
+  if (typed)
+  {
+    points.call<void>("set", emscripten::val(emscripten::typed_memory_view(values.size(), values.data())));
+  }
+  else
+  {
+    for (size_t i = 0; i < values.size(); i++)
+      points.set(i, values[i]);
+  }
+  return points;
+}
+
+emscripten::val BND_Transform::ApplyToPoints(emscripten::val points, bool inPlace) const
+{
+  if (points.instanceof(emscripten::val::global("Float32Array")))
+    return ApplyToJSPoints<float>(m_xform, points, inPlace, true);
+  const bool typed = points.instanceof(emscripten::val::global("Float64Array"));
+  return ApplyToJSPoints<double>(m_xform, points, inPlace, typed);
+}
+#endif
+
 #if defined(ON_PYTHON_COMPILE)
 
 void initXformBindings(rh3dmpymodule& m)
@@ -168,6 +272,9 @@ void initXformBindings(rh3dmpymodule& m)
     .def("Transpose", &BND_Transform::Transpose)
     .def("ToFloatArray", &BND_Transform::ToFloatArray)
     .def("ToFloatArray2", &BND_Transform::ToFloatArray2)
+#if !defined(NANOBIND)
+    .def("ApplyToPoints", &BND_Transform::ApplyToPoints, py::arg("points"), py::arg("inPlace")=true, py::arg("threadCount")=0)
+#endif
     .def_property("M00", &BND_Transform::GetM00, &BND_Transform::SetM00)
     .def_property("M01", &BND_Transform::GetM01, &BND_Transform::SetM01)
     .def_property("M02", &BND_Transform::GetM02, &BND_Transform::SetM02)
@@ -250,6 +357,7 @@ void initXformBindings(void*)
     .function("transformBoundingBox", &BND_Transform::TransformBoundingBox, allow_raw_pointers())
     .function("transpose", &BND_Transform::Transpose)
     .function("toFloatArray", &BND_Transform::ToFloatArray)
+    .function("applyToPoints", &BND_Transform::ApplyToPoints)
     .property("m00", &BND_Transform::GetM00, &BND_Transform::SetM00)
     .property("m01", &BND_Transform::GetM01, &BND_Transform::SetM01)
     .property("m02", &BND_Transform::GetM02, &BND_Transform::SetM02)
@@ -23,6 +23,11 @@ enum class TransformRigidType : int
   Rigid = 1
 };
 
+// Transforms count packed x,y,z points from in to out, spread over
+// threadCount threads. in and out may be the same buffer.
+void BND_TransformPoints(const ON_Xform& xform, const double* in, double* out, size_t count, int threadCount);
+void BND_TransformPoints(const ON_Xform& xform, const float* in, float* out, size_t count, int threadCount);
+
 class BND_Transform
 {
 public:
@@ -81,6 +86,16 @@ public:
   BND_TUPLE ToFloatArray(bool rowDominant) const;
   std::vector<float> ToFloatArray2(bool rowDominant) const;
 
+  // Transforms a packed buffer of x,y,z triples (float32 or float64). The
+  // buffer is modified when inPlace is true, otherwise a new buffer of the
+  // same type is returned.
+#if defined(ON_PYTHON_COMPILE) && !defined(NANOBIND)
+  py::object ApplyToPoints(py::buffer points, bool inPlace, int threadCount) const;
+#endif
+#if defined(ON_WASM_COMPILE)
+  emscripten::val ApplyToPoints(emscripten::val points, bool inPlace) const;
+#endif
+
   double GetM00() const { return m_xform.m_xform[0][0]; }
   double GetM01() const { return m_xform.m_xform[0][1]; }
   double GetM02() const { return m_xform.m_xform[0][2]; }
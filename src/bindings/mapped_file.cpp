@@ -0,0 +1,141 @@
+/*
+   mapped_file.cpp and mapped_file.h
+
+   Read only memory mapping of a whole file.
+*/
+
+#include "mapped_file.h"
+
+#include <filesystem>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__EMSCRIPTEN__)
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mapped_file::~mapped_file()
+{
+  close();
+}
+
+#if defined(_WIN32)
+bool mapped_file::open(const wchar_t* path)
+{
+  close();
+  HANDLE file = ::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (INVALID_HANDLE_VALUE == file)
+    return false;
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file, &size) || 0 == size.QuadPart || (unsigned long long)size.QuadPart > (size_t)-1)
+  {
+    ::CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void* view = mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (nullptr == view)
+  {
+    if (mapping)
+      ::CloseHandle(mapping);
+    ::CloseHandle(file);
+    return false;
+  }
+  m_file = file;
+  m_mapping = mapping;
+  m_data = (const unsigned char*)view;
+  m_size = (size_t)size.QuadPart;
+  return true;
+}
+
+void mapped_file::close()
+{
+  if (m_data)
+    ::UnmapViewOfFile(m_data);
+  if (m_mapping)
+    ::CloseHandle((HANDLE)m_mapping);
+  if (m_file)
+    ::CloseHandle((HANDLE)m_file);
+  m_data = nullptr;
+  m_size = 0;
+  m_mapping = nullptr;
+  m_file = nullptr;
+}
+
+#elif defined(__EMSCRIPTEN__)
+bool mapped_file::open(const wchar_t* path)
+{
+  close();
+  FILE* fp = fopen(std::filesystem::path(path).c_str(), "rb");
+  if (nullptr == fp)
+    return false;
+  bool rc = false;
+  if (0 == fseek(fp, 0, SEEK_END))
+  {
+    const long size = ftell(fp);
+    if (size > 0 && 0 == fseek(fp, 0, SEEK_SET))
+    {
+      m_copy.resize((size_t)size);
+      rc = fread(m_copy.data(), 1, m_copy.size(), fp) == m_copy.size();
+    }
+  }
+  fclose(fp);
+  if (!rc)
+  {
+    close();
+    return false;
+  }
+  m_data = m_copy.data();
+  m_size = m_copy.size();
+  return true;
+}
+
+void mapped_file::close()
+{
+  m_copy.clear();
+  m_copy.shrink_to_fit();
+  m_data = nullptr;
+  m_size = 0;
+}
+
+#else
+bool mapped_file::open(const wchar_t* path)
+{
+  close();
+  const int fd = ::open(std::filesystem::path(path).c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (0 != ::fstat(fd, &st) || st.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  void* view = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping keeps its own reference to the file
+  ::close(fd);
+  if (MAP_FAILED == view)
+    return false;
+  // archives are parsed front to back
+  ::madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+  m_data = (const unsigned char*)view;
+  m_size = (size_t)st.st_size;
+  return true;
+}
+
+void mapped_file::close()
+{
+  if (m_data)
+    ::munmap((void*)m_data, m_size);
+  m_data = nullptr;
+  m_size = 0;
+}
+#endif
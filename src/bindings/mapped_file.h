@@ -0,0 +1,43 @@
+//
+//  Read only memory mapping of a whole file.
+//
+//  The pages come straight from the OS file cache, so reading a mapped
+//  archive does not copy the file into a private buffer first and every
+//  process that maps the same file shares the same physical pages. Uses
+//  mmap on POSIX and CreateFileMapping on Windows; web assembly has no real
+//  mapping and reads the file into memory instead.
+//
+
+#ifndef MAPPED_FILE_H_8E4C2B71_6A3D_4F0E_B5D9_2C7A1E963F04
+#define MAPPED_FILE_H_8E4C2B71_6A3D_4F0E_B5D9_2C7A1E963F04
+
+#include <cstddef>
+#include <vector>
+
+class mapped_file
+{
+public:
+  mapped_file() = default;
+  ~mapped_file();
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  // Maps the whole file. Fails for missing and empty files.
+  bool open(const wchar_t* path);
+  void close();
+
+  bool is_open() const { return nullptr != m_data; }
+  const unsigned char* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  const unsigned char* m_data = nullptr;
+  size_t m_size = 0;
+#if defined(_WIN32)
+  void* m_file = nullptr;
+  void* m_mapping = nullptr;
+#endif
+  std::vector<unsigned char> m_copy; // only used where mapping is not available
+};
+
+#endif /* MAPPED_FILE_H_8E4C2B71_6A3D_4F0E_B5D9_2C7A1E963F04 */
@@ -0,0 +1,313 @@
+/*
+   mesh_optimize.cpp and mesh_optimize.h
+
+   Vertex cache, overdraw and vertex fetch ordering.
+
+   The vertex cache is modelled as a FIFO of timestamps: a vertex is in the
+   cache while fewer than cache_size other vertices were added after it.
+   Overdraw ordering follows the same paper: the Tipsify order is cut into
+   clusters wherever the cache starts over anyway, and again wherever a
+   cluster has reached close to its average miss ratio, so reordering the
+   clusters costs little cache efficiency. Clusters facing away from the
+   middle of the mesh are drawn first.
+*/
+
+#include "mesh_optimize.h"
+
+#include <algorithm>
+#include <cmath>
+
+typedef unsigned int index_t;
+
+// clusters may end once their miss ratio is within this factor of the
+// ratio of the hard cluster they are cut from
+static const double OVERDRAW_THRESHOLD = 1.05;
+
+namespace
+{
+  struct fifo_cache
+  {
+    std::vector<index_t> time;
+    index_t now;
+    index_t size;
+
+    fifo_cache(size_t vertex_count, index_t cache_size)
+      : time(vertex_count, 0), now(cache_size + 1), size(cache_size)
+    {
+    }
+
+    // misses drawing one triangle
+    int draw(const index_t* triangle)
+    {
+      int misses = 0;
+      for (int k = 0; k < 3; k++)
+      {
+        if (now - time[triangle[k]] > size)
+        {
+          time[triangle[k]] = now++;
+          misses++;
+        }
+      }
+      return misses;
+    }
+
+    void flush()
+    {
+      now += size + 1;
+    }
+  };
+}
+
+double mesh_acmr(const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size)
+{
+  const size_t triangle_count = index_count / 3;
+  if (0 == triangle_count)
+    return 0.0;
+  fifo_cache cache(vertex_count, cache_size);
+  size_t misses = 0;
+  for (size_t t = 0; t < triangle_count; t++)
+    misses += cache.draw(indices + 3 * t);
+  return (double)misses / (double)triangle_count;
+}
+
+// Tipsify: fans out from the current vertex, then moves to the neighbour
+// that will still be in the cache once its remaining triangles are drawn
+static std::vector<index_t> tipsify(const index_t* indices, size_t triangle_count, size_t vertex_count, index_t cache_size)
+{
+  std::vector<index_t> offsets(vertex_count + 1, 0);
+  for (size_t i = 0; i < 3 * triangle_count; i++)
+    offsets[indices[i] + 1]++;
+  for (size_t v = 0; v < vertex_count; v++)
+    offsets[v + 1] += offsets[v];
+  std::vector<index_t> live(vertex_count);
+  for (size_t v = 0; v < vertex_count; v++)
+    live[v] = offsets[v + 1] - offsets[v];
+  std::vector<index_t> triangles(offsets[vertex_count]);
+  {
+    std::vector<index_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < 3 * triangle_count; i++)
+      triangles[cursor[indices[i]]++] = (index_t)(i / 3);
+  }
+
+  std::vector<index_t> order;
+  order.reserve(triangle_count);
+  std::vector<char> emitted(triangle_count, 0);
+  std::vector<index_t> cache_time(vertex_count, 0);
+  index_t now = cache_size + 1;
+  std::vector<index_t> dead_end;
+  std::vector<index_t> candidates;
+  size_t cursor = 0;
+
+  long long fan = triangle_count > 0 ? (long long)indices[0] : -1;
+  while (fan >= 0)
+  {
+    candidates.clear();
+    for (index_t i = offsets[fan]; i < offsets[fan + 1]; i++)
+    {
+      const index_t t = triangles[i];
+      if (emitted[t])
+        continue;
+      emitted[t] = 1;
+      order.push_back(t);
+      for (int k = 0; k < 3; k++)
+      {
+        const index_t v = indices[3 * (size_t)t + k];
+        dead_end.push_back(v);
+        candidates.push_back(v);
+        live[v]--;
+        if (now - cache_time[v] > cache_size)
+          cache_time[v] = now++;
+      }
+    }
+
+    // neighbour that stays cached the longest after its fan
+    fan = -1;
+    long long best_priority = -1;
+    for (index_t v : candidates)
+    {
+      if (0 == live[v])
+        continue;
+      long long priority = 0;
+      if (now - cache_time[v] + 2 * live[v] <= cache_size)
+        priority = now - cache_time[v];
+      if (priority > best_priority)
+      {
+        best_priority = priority;
+        fan = v;
+      }
+    }
+
+    // dead end: the most recently used vertex with triangles left, then
+    // the first such vertex in input order
+    while (fan < 0 && !dead_end.empty())
+    {
+      const index_t v = dead_end.back();
+      dead_end.pop_back();
+      if (live[v] > 0)
+        fan = v;
+    }
+    while (fan < 0 && cursor < vertex_count)
+    {
+      if (live[cursor] > 0)
+        fan = (long long)cursor;
+      cursor++;
+    }
+  }
+  return order;
+}
+
+static void sort_clusters(const index_t* indices, const float* positions, size_t vertex_count, index_t cache_size, std::vector<index_t>& order)
+{
+  const size_t triangle_count = order.size();
+  auto corner = [&](size_t position, int k) { return indices[3 * (size_t)order[position] + k]; };
+
+  // hard boundaries: triangles that miss on all three vertices
+  std::vector<size_t> hard;
+  {
+    fifo_cache cache(vertex_count, cache_size);
+    for (size_t i = 0; i < triangle_count; i++)
+    {
+      const index_t triangle[3] = { corner(i, 0), corner(i, 1), corner(i, 2) };
+      if (3 == cache.draw(triangle) || 0 == i)
+        hard.push_back(i);
+    }
+  }
+  hard.push_back(triangle_count);
+
+  // soft boundaries inside every hard cluster
+  std::vector<size_t> clusters;
+  fifo_cache cache(vertex_count, cache_size);
+  for (size_t h = 0; h + 1 < hard.size(); h++)
+  {
+    const size_t begin = hard[h];
+    const size_t end = hard[h + 1];
+    cache.flush();
+    size_t misses = 0;
+    for (size_t i = begin; i < end; i++)
+    {
+      const index_t triangle[3] = { corner(i, 0), corner(i, 1), corner(i, 2) };
+      misses += cache.draw(triangle);
+    }
+    const double limit = OVERDRAW_THRESHOLD * (double)misses / (double)(end - begin);
+
+    cache.flush();
+    size_t start = begin;
+    misses = 0;
+    clusters.push_back(begin);
+    for (size_t i = begin; i < end; i++)
+    {
+      const index_t triangle[3] = { corner(i, 0), corner(i, 1), corner(i, 2) };
+      misses += cache.draw(triangle);
+      if (i + 1 < end && (double)misses <= limit * (double)(i + 1 - start))
+      {
+        clusters.push_back(i + 1);
+        start = i + 1;
+        misses = 0;
+        cache.flush();
+      }
+    }
+  }
+  clusters.push_back(triangle_count);
+
+  // area weighted centroid and normal of every cluster and the mesh
+  const size_t cluster_count = clusters.size() - 1;
+  std::vector<double> centroids(3 * cluster_count, 0.0);
+  std::vector<double> normals(3 * cluster_count, 0.0);
+  double mesh_centroid[3] = { 0, 0, 0 };
+  double mesh_area = 0.0;
+  for (size_t c = 0; c < cluster_count; c++)
+  {
+    double* centroid = &centroids[3 * c];
+    double* normal = &normals[3 * c];
+    double area = 0.0;
+    for (size_t i = clusters[c]; i < clusters[c + 1]; i++)
+    {
+      const float* a = positions + 3 * (size_t)corner(i, 0);
+      const float* b = positions + 3 * (size_t)corner(i, 1);
+      const float* d = positions + 3 * (size_t)corner(i, 2);
+      const double u[3] = { (double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2] };
+      const double w[3] = { (double)d[0] - a[0], (double)d[1] - a[1], (double)d[2] - a[2] };
+      const double n[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+      const double twice_area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (int k = 0; k < 3; k++)
+      {
+        centroid[k] += twice_area * ((double)a[k] + b[k] + d[k]) / 3.0;
+        normal[k] += n[k];
+      }
+      area += twice_area;
+    }
+    for (int k = 0; k < 3; k++)
+      mesh_centroid[k] += centroid[k];
+    mesh_area += area;
+    if (area > 0.0)
+    {
+      for (int k = 0; k < 3; k++)
+        centroid[k] /= area;
+    }
+  }
+  if (mesh_area > 0.0)
+  {
+    for (int k = 0; k < 3; k++)
+      mesh_centroid[k] /= mesh_area;
+  }
+
+  std::vector<double> keys(cluster_count, 0.0);
+  for (size_t c = 0; c < cluster_count; c++)
+  {
+    const double* centroid = &centroids[3 * c];
+    const double* normal = &normals[3 * c];
+    const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    if (length > 0.0)
+    {
+      for (int k = 0; k < 3; k++)
+        keys[c] += (centroid[k] - mesh_centroid[k]) * normal[k] / length;
+    }
+  }
+
+  std::vector<size_t> sorted(cluster_count);
+  for (size_t c = 0; c < cluster_count; c++)
+    sorted[c] = c;
+  std::stable_sort(sorted.begin(), sorted.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+  std::vector<index_t> result;
+  result.reserve(triangle_count);
+  for (size_t c : sorted)
+    result.insert(result.end(), order.begin() + clusters[c], order.begin() + clusters[c + 1]);
+  order.swap(result);
+}
+
+void mesh_optimize_triangles(unsigned int* indices, size_t index_count, size_t vertex_count,
+  const float* positions, unsigned int cache_size, std::vector<unsigned int>* triangle_order)
+{
+  const size_t triangle_count = index_count / 3;
+  std::vector<index_t> order = tipsify(indices, triangle_count, vertex_count, cache_size);
+  if (positions && triangle_count > 0)
+    sort_clusters(indices, positions, vertex_count, cache_size, order);
+
+  std::vector<index_t> reordered(3 * triangle_count);
+  for (size_t i = 0; i < triangle_count; i++)
+    std::copy(indices + 3 * (size_t)order[i], indices + 3 * (size_t)order[i] + 3, reordered.begin() + 3 * i);
+  std::copy(reordered.begin(), reordered.end(), indices);
+  if (triangle_order)
+    triangle_order->swap(order);
+}
+
+std::vector<unsigned int> mesh_optimize_vertex_fetch(unsigned int* indices, size_t index_count, size_t vertex_count)
+{
+  const index_t unused = ~index_t(0);
+  std::vector<index_t> remap(vertex_count, unused);
+  index_t next = 0;
+  for (size_t i = 0; i < index_count; i++)
+  {
+    index_t& v = remap[indices[i]];
+    if (unused == v)
+      v = next++;
+    indices[i] = v;
+  }
+  for (size_t v = 0; v < vertex_count; v++)
+  {
+    if (unused == remap[v])
+      remap[v] = next++;
+  }
+  return remap;
+}
@@ -0,0 +1,35 @@
+//
+//  Triangle and vertex order for GPU rendering.
+//
+//  Triangles are put in an order that reuses the post transform vertex
+//  cache (Tipsify, Sander, Nehab and Barczak 2007), then clusters of that
+//  order are sorted so outward facing parts are drawn first and hide what
+//  is behind them. Vertices are finally renumbered in order of first use
+//  so vertex fetches walk memory forwards.
+//
+
+#ifndef MESH_OPTIMIZE_H_52A9C4E1_7F3B_4D86_B0E2_9C1D68A35F07
+#define MESH_OPTIMIZE_H_52A9C4E1_7F3B_4D86_B0E2_9C1D68A35F07
+
+#include <cstddef>
+#include <vector>
+
+// Average cache miss ratio: vertices transformed per triangle when
+// indices (3 per triangle) are drawn through a FIFO cache of cache_size
+// vertices. 3 is the worst, 0.5 about the best a large regular mesh allows.
+double mesh_acmr(const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size = 16);
+
+// Reorders the triangles of indices for cache_size vertex caches. With
+// positions (x,y,z per vertex) the result is also ordered to reduce
+// overdraw, giving up at most a few percent of the cache hit rate.
+// triangle_order, when given, receives the original index of every output
+// triangle.
+void mesh_optimize_triangles(unsigned int* indices, size_t index_count, size_t vertex_count,
+  const float* positions, unsigned int cache_size = 16, std::vector<unsigned int>* triangle_order = nullptr);
+
+// Renumbers vertices in order of first use by indices, rewriting indices.
+// Returns the new index of every vertex; vertices no triangle uses go to
+// the end in their original order.
+std::vector<unsigned int> mesh_optimize_vertex_fetch(unsigned int* indices, size_t index_count, size_t vertex_count);
+
+#endif /* MESH_OPTIMIZE_H_52A9C4E1_7F3B_4D86_B0E2_9C1D68A35F07 */
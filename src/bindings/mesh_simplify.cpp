@@ -0,0 +1,533 @@
+/*
+   mesh_simplify.cpp and mesh_simplify.h
+
+   Quadric error mesh simplification.
+
+   Every vertex carries the sum of the plane quadrics of the triangles
+   around it, weighted by triangle area, plus steep planes along open
+   boundaries so collapses do not pull borders inwards. The error of
+   merging u into v is the quadric of both evaluated at v, divided by the
+   accumulated area and square rooted into a distance.
+*/
+
+#include "mesh_simplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+typedef unsigned int index_t;
+
+// fraction of the ranked candidates a pass may apply; lower values keep
+// the order closer to a true priority queue at the cost of more passes
+static const size_t PASS_CANDIDATE_DIVISOR = 3;
+// border planes count this many times the squared edge length
+static const double BORDER_WEIGHT = 10.0;
+
+struct quadric
+{
+  double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+  double b0 = 0, b1 = 0, b2 = 0, c = 0;
+  double area = 0;
+
+  void add_plane(const double n[3], double d, double weight)
+  {
+    a00 += weight * n[0] * n[0]; a01 += weight * n[0] * n[1]; a02 += weight * n[0] * n[2];
+    a11 += weight * n[1] * n[1]; a12 += weight * n[1] * n[2]; a22 += weight * n[2] * n[2];
+    b0 += weight * n[0] * d; b1 += weight * n[1] * d; b2 += weight * n[2] * d;
+    c += weight * d * d;
+  }
+
+  void add(const quadric& q)
+  {
+    a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+    b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c;
+    area += q.area;
+  }
+
+  // sum of weighted squared plane distances at p
+  double eval(const double p[3]) const
+  {
+    const double x = p[0], y = p[1], z = p[2];
+    return a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + a11 * y * y + 2 * a12 * y * z + a22 * z * z +
+      2 * (b0 * x + b1 * y + b2 * z) + c;
+  }
+};
+
+static double collapse_error(const quadric& qu, const quadric& qv, const double p[3])
+{
+  quadric q = qu;
+  q.add(qv);
+  const double e = std::max(0.0, q.eval(p));
+  return std::sqrt(q.area > 0 ? e / q.area : e);
+}
+
+static void cross(const double a[3], const double b[3], const double c[3], double n[3])
+{
+  const double e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+  const double e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+  n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+  n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+  n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+static double length(const double v[3])
+{
+  return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+namespace
+{
+  // A neighbouring point of the surface and the number of triangles that
+  // share the edge to it
+  struct neighbour
+  {
+    index_t m_point;
+    int m_count;
+  };
+
+  struct candidate
+  {
+    double m_error;
+    index_t m_from;
+    index_t m_to;
+  };
+
+  class simplifier
+  {
+  public:
+    simplifier(const double* positions, size_t vertex_count, const mesh_simplify_options& options)
+      : m_options(options)
+    {
+      weld(positions, vertex_count);
+      m_wedge_remap.resize(vertex_count);
+      std::iota(m_wedge_remap.begin(), m_wedge_remap.end(), 0);
+    }
+
+    void set_triangles(const unsigned int* indices, size_t index_count, size_t vertex_count)
+    {
+      m_triangles.reserve(index_count - index_count % 3);
+      for (size_t i = 0; i + 2 < index_count; i += 3)
+      {
+        if (indices[i] >= vertex_count || indices[i + 1] >= vertex_count || indices[i + 2] >= vertex_count)
+          continue;
+        m_triangles.insert(m_triangles.end(), indices + i, indices + i + 3);
+      }
+      compact();
+      build_adjacency();
+      build_quadrics();
+    }
+
+    size_t triangle_count() const { return m_triangles.size() / 3; }
+
+    // one pass of independent collapses; returns the number applied
+    size_t pass(size_t target, double& max_error)
+    {
+      build_adjacency();
+      classify();
+
+      std::vector<candidate> candidates;
+      std::vector<neighbour> around;
+      for (index_t u = 0; u < (index_t)point_count(); u++)
+      {
+        if (m_locked[u] || m_offsets[u] == m_offsets[u + 1])
+          continue;
+        neighbours(u, around);
+        candidate best = { 0, u, u };
+        for (const neighbour& n : around)
+        {
+          // a border vertex only slides along its border
+          if (m_border[u] && 1 != n.m_count)
+            continue;
+          if (m_options.preserve_seams && m_seam[u] && !m_seam[n.m_point])
+            continue;
+          const double e = collapse_error(m_quadrics[u], m_quadrics[n.m_point], point(n.m_point));
+          if (best.m_to == u || e < best.m_error)
+            best = { e, u, n.m_point };
+        }
+        if (best.m_to != u)
+          candidates.push_back(best);
+      }
+      const size_t considered = std::min(candidates.size(), std::max<size_t>(1, candidates.size() / PASS_CANDIDATE_DIVISOR));
+      auto cheaper = [](const candidate& a, const candidate& b) { return a.m_error < b.m_error; };
+      std::nth_element(candidates.begin(), candidates.begin() + (considered ? considered - 1 : 0), candidates.end(), cheaper);
+      candidates.resize(considered);
+      std::sort(candidates.begin(), candidates.end(), cheaper);
+
+      const size_t current = triangle_count();
+      const size_t budget = current > target ? current - target : 0;
+      std::vector<char> touched(point_count(), 0);
+      size_t removed = 0;
+      size_t applied = 0;
+      for (const candidate& c : candidates)
+      {
+        if (removed >= budget)
+          break;
+        if (m_options.target_error > 0 && c.m_error > m_options.target_error)
+          break;
+        if (touched[c.m_from] || touched[c.m_to])
+          continue;
+        const int shared = collapse(c.m_from, c.m_to);
+        if (0 == shared)
+          continue;
+        touched[c.m_from] = touched[c.m_to] = 1;
+        m_quadrics[c.m_to].add(m_quadrics[c.m_from]);
+        max_error = std::max(max_error, c.m_error);
+        removed += shared;
+        applied++;
+      }
+      compact();
+      return applied;
+    }
+
+    std::vector<unsigned int> take_triangles()
+    {
+      compact();
+      return std::move(m_triangles);
+    }
+
+  private:
+    size_t point_count() const { return m_points.size() / 3; }
+    const double* point(index_t p) const { return &m_points[p * 3]; }
+
+    index_t resolve(index_t wedge)
+    {
+      index_t w = wedge;
+      while (m_wedge_remap[w] != w)
+        w = m_wedge_remap[w];
+      // shorten the chain for the next lookup
+      while (m_wedge_remap[wedge] != w)
+      {
+        const index_t next = m_wedge_remap[wedge];
+        m_wedge_remap[wedge] = w;
+        wedge = next;
+      }
+      return w;
+    }
+
+    // vertices with identical positions become one point of the surface
+    void weld(const double* positions, size_t vertex_count)
+    {
+      std::vector<index_t> order(vertex_count);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [positions](index_t a, index_t b)
+      {
+        return std::lexicographical_compare(positions + a * 3, positions + a * 3 + 3, positions + b * 3, positions + b * 3 + 3);
+      });
+      m_point_of.resize(vertex_count);
+      for (size_t i = 0; i < vertex_count; i++)
+      {
+        const double* p = positions + order[i] * 3;
+        if (0 == i || !std::equal(p, p + 3, positions + order[i - 1] * 3))
+          m_points.insert(m_points.end(), p, p + 3);
+        m_point_of[order[i]] = (index_t)(m_points.size() / 3 - 1);
+      }
+    }
+
+    // resolves remapped vertices and drops triangles that collapsed
+    void compact()
+    {
+      size_t live = 0;
+      for (size_t t = 0; t + 2 < m_triangles.size(); t += 3)
+      {
+        const index_t a = resolve(m_triangles[t]), b = resolve(m_triangles[t + 1]), c = resolve(m_triangles[t + 2]);
+        const index_t pa = m_point_of[a], pb = m_point_of[b], pc = m_point_of[c];
+        if (pa == pb || pb == pc || pa == pc)
+          continue;
+        m_triangles[live++] = a;
+        m_triangles[live++] = b;
+        m_triangles[live++] = c;
+      }
+      m_triangles.resize(live);
+    }
+
+    void build_adjacency()
+    {
+      const size_t count = point_count();
+      m_offsets.assign(count + 1, 0);
+      for (index_t w : m_triangles)
+        m_offsets[m_point_of[w] + 1]++;
+      for (size_t i = 0; i < count; i++)
+        m_offsets[i + 1] += m_offsets[i];
+      m_adjacent.resize(m_triangles.size());
+      std::vector<index_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+      for (size_t i = 0; i < m_triangles.size(); i++)
+        m_adjacent[fill[m_point_of[m_triangles[i]]]++] = (index_t)(i / 3);
+    }
+
+    // current points of triangle t
+    void triangle_points(index_t t, index_t p[3])
+    {
+      for (int k = 0; k < 3; k++)
+        p[k] = m_point_of[resolve(m_triangles[t * 3 + k])];
+    }
+
+    void neighbours(index_t u, std::vector<neighbour>& around)
+    {
+      around.clear();
+      for (index_t i = m_offsets[u]; i < m_offsets[u + 1]; i++)
+      {
+        index_t p[3];
+        triangle_points(m_adjacent[i], p);
+        if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2])
+          continue;
+        for (int k = 0; k < 3; k++)
+        {
+          if (p[k] == u)
+            continue;
+          auto found = std::find_if(around.begin(), around.end(), [&](const neighbour& n) { return n.m_point == p[k]; });
+          if (found == around.end())
+            around.push_back({ p[k], 1 });
+          else
+            found->m_count++;
+        }
+      }
+    }
+
+    void build_quadrics()
+    {
+      const size_t count = point_count();
+      m_quadrics.assign(count, quadric());
+      for (size_t t = 0; t < triangle_count(); t++)
+      {
+        index_t p[3];
+        triangle_points((index_t)t, p);
+        double n[3];
+        cross(point(p[0]), point(p[1]), point(p[2]), n);
+        const double len = length(n);
+        if (len <= 0)
+          continue;
+        for (double& x : n)
+          x /= len;
+        const double d = -(n[0] * point(p[0])[0] + n[1] * point(p[0])[1] + n[2] * point(p[0])[2]);
+        for (int k = 0; k < 3; k++)
+        {
+          m_quadrics[p[k]].add_plane(n, d, 0.5 * len);
+          m_quadrics[p[k]].area += 0.5 * len;
+        }
+      }
+
+      // planes through border edges, perpendicular to their triangle
+      std::vector<neighbour> around;
+      for (index_t u = 0; u < (index_t)count; u++)
+      {
+        neighbours(u, around);
+        for (const neighbour& nb : around)
+        {
+          if (1 != nb.m_count || nb.m_point < u)
+            continue;
+          for (index_t i = m_offsets[u]; i < m_offsets[u + 1]; i++)
+          {
+            index_t p[3];
+            triangle_points(m_adjacent[i], p);
+            if (p[0] != nb.m_point && p[1] != nb.m_point && p[2] != nb.m_point)
+              continue;
+            double n[3];
+            cross(point(p[0]), point(p[1]), point(p[2]), n);
+            const double* a = point(u);
+            const double* b = point(nb.m_point);
+            const double e[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            double m[3] = { e[1] * n[2] - e[2] * n[1], e[2] * n[0] - e[0] * n[2], e[0] * n[1] - e[1] * n[0] };
+            const double len = length(m);
+            if (len > 0)
+            {
+              for (double& x : m)
+                x /= len;
+              const double d = -(m[0] * a[0] + m[1] * a[1] + m[2] * a[2]);
+              const double weight = BORDER_WEIGHT * (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+              m_quadrics[u].add_plane(m, d, weight);
+              m_quadrics[nb.m_point].add_plane(m, d, weight);
+            }
+            break;
+          }
+        }
+      }
+    }
+
+    void classify()
+    {
+      const size_t count = point_count();
+      m_border.assign(count, 0);
+      m_seam.assign(count, 0);
+      m_locked.assign(count, 0);
+      std::vector<neighbour> around;
+      for (index_t u = 0; u < (index_t)count; u++)
+      {
+        neighbours(u, around);
+        for (const neighbour& n : around)
+        {
+          if (1 == n.m_count)
+            m_border[u] = 1;
+          else if (n.m_count > 2)
+            m_locked[u] = 1;  // non manifold
+        }
+        if (m_border[u] && m_options.preserve_borders)
+          m_locked[u] = 1;
+
+        index_t first = (index_t)-1;
+        for (index_t i = m_offsets[u]; i < m_offsets[u + 1] && !m_seam[u]; i++)
+        {
+          const index_t t = m_adjacent[i];
+          for (int k = 0; k < 3; k++)
+          {
+            const index_t w = resolve(m_triangles[t * 3 + k]);
+            if (m_point_of[w] != u)
+              continue;
+            if (first == (index_t)-1)
+              first = w;
+            else if (first != w)
+              m_seam[u] = 1;
+          }
+        }
+      }
+    }
+
+    // Merges point u into point v. Returns the number of triangles that
+    // collapse, 0 when the collapse is rejected.
+    int collapse(index_t u, index_t v)
+    {
+      std::vector<std::pair<index_t, index_t>>& wedges = m_scratch_wedges;
+      wedges.clear();
+      std::vector<index_t>& around_u = m_scratch_points;
+      around_u.clear();
+      int shared = 0;
+      bool consistent = true;
+
+      for (index_t i = m_offsets[u]; i < m_offsets[u + 1]; i++)
+      {
+        const index_t t = m_adjacent[i];
+        index_t w[3], p[3];
+        for (int k = 0; k < 3; k++)
+        {
+          w[k] = resolve(m_triangles[t * 3 + k]);
+          p[k] = m_point_of[w[k]];
+        }
+        if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2])
+          continue;
+        const int ku = p[0] == u ? 0 : (p[1] == u ? 1 : 2);
+        for (int k = 0; k < 3; k++)
+        {
+          if (k != ku && std::find(around_u.begin(), around_u.end(), p[k]) == around_u.end())
+            around_u.push_back(p[k]);
+        }
+        const int kv = p[0] == v ? 0 : (p[1] == v ? 1 : (p[2] == v ? 2 : -1));
+        if (kv < 0)
+          continue;
+
+        // the wedge of u in a collapsing triangle maps onto the wedge of v
+        // on the same side of any seam
+        shared++;
+        auto found = std::find_if(wedges.begin(), wedges.end(), [&](const std::pair<index_t, index_t>& m) { return m.first == w[ku]; });
+        if (found == wedges.end())
+          wedges.emplace_back(w[ku], w[kv]);
+        else if (found->second != w[kv])
+          consistent = false;
+      }
+      if (0 == shared || (!consistent && m_options.preserve_seams))
+        return 0;
+
+      // link condition: u and v may only share the points opposite the
+      // collapsing edge, anything more pinches the surface
+      int common = 0;
+      for (index_t i = m_offsets[v]; i < m_offsets[v + 1]; i++)
+      {
+        index_t p[3];
+        triangle_points(m_adjacent[i], p);
+        if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2])
+          continue;
+        for (int k = 0; k < 3; k++)
+        {
+          if (p[k] == v || p[k] == u)
+            continue;
+          auto found = std::find(around_u.begin(), around_u.end(), p[k]);
+          if (found != around_u.end())
+          {
+            common++;
+            // count each point once
+            *found = u;
+          }
+        }
+      }
+      if (common > shared)
+        return 0;
+
+      // triangles that stay must not flip or degenerate, and every wedge of
+      // u has to have somewhere to go
+      const double* pv = point(v);
+      for (index_t i = m_offsets[u]; i < m_offsets[u + 1]; i++)
+      {
+        const index_t t = m_adjacent[i];
+        index_t w[3], p[3];
+        for (int k = 0; k < 3; k++)
+        {
+          w[k] = resolve(m_triangles[t * 3 + k]);
+          p[k] = m_point_of[w[k]];
+        }
+        if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2] || p[0] == v || p[1] == v || p[2] == v)
+          continue;
+        const int ku = p[0] == u ? 0 : (p[1] == u ? 1 : 2);
+
+        auto found = std::find_if(wedges.begin(), wedges.end(), [&](const std::pair<index_t, index_t>& m) { return m.first == w[ku]; });
+        if (found == wedges.end())
+        {
+          if (m_options.preserve_seams)
+            return 0;
+          wedges.emplace_back(w[ku], wedges.front().second);
+        }
+
+        const double* before[3] = { point(p[0]), point(p[1]), point(p[2]) };
+        const double* after[3] = { before[0], before[1], before[2] };
+        after[ku] = pv;
+        double n0[3], n1[3];
+        cross(before[0], before[1], before[2], n0);
+        cross(after[0], after[1], after[2], n1);
+        const double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+        if (dot <= 0 || length(n1) <= 1e-12 * length(n0))
+          return 0;
+      }
+
+      for (const auto& m : wedges)
+        m_wedge_remap[m.first] = m.second;
+      return shared;
+    }
+
+    const mesh_simplify_options m_options;
+    std::vector<double> m_points;        // x,y,z per welded point
+    std::vector<index_t> m_point_of;     // welded point of every input vertex
+    std::vector<index_t> m_wedge_remap;  // vertex each input vertex was merged into
+    std::vector<index_t> m_triangles;    // input vertex triples
+    std::vector<quadric> m_quadrics;
+    std::vector<index_t> m_offsets;      // triangles around each point
+    std::vector<index_t> m_adjacent;
+    std::vector<char> m_border;
+    std::vector<char> m_seam;
+    std::vector<char> m_locked;
+    std::vector<std::pair<index_t, index_t>> m_scratch_wedges;
+    std::vector<index_t> m_scratch_points;
+  };
+}
+
+std::vector<unsigned int> mesh_simplify(const double* positions, size_t vertex_count,
+  const unsigned int* indices, size_t index_count,
+  const mesh_simplify_options& options, double* error)
+{
+  if (error)
+    *error = 0.0;
+  if (nullptr == positions || nullptr == indices || 0 == vertex_count)
+    return std::vector<unsigned int>();
+
+  simplifier s(positions, vertex_count, options);
+  s.set_triangles(indices, index_count, vertex_count);
+
+  const double ratio = std::min(1.0, std::max(0.0, options.target_ratio));
+  const size_t target = (size_t)std::ceil(ratio * (double)s.triangle_count());
+  double max_error = 0.0;
+  while (s.triangle_count() > target)
+  {
+    if (0 == s.pass(target, max_error))
+      break;
+  }
+  if (error)
+    *error = max_error;
+  return s.take_triangles();
+}
@@ -0,0 +1,46 @@
+//
+//  Quadric error mesh simplification.
+//
+//  Garland and Heckbert edge collapses restricted to half edge collapses: a
+//  vertex is always merged into one of its neighbours, so no new vertices
+//  (and no interpolated normals, texture coordinates or colors) are made.
+//  Vertices that share a position but differ in their other attributes
+//  (texture seams, hard edges) are treated as one point of the surface;
+//  collapses keep the attribute split intact by mapping each of those
+//  vertices onto the vertex on the same side of the seam.
+//
+//  Collapses are applied in passes. Every pass ranks one candidate per
+//  vertex by error and applies the cheapest ones that do not touch a vertex
+//  already changed in the same pass, so large meshes never need a mutable
+//  priority queue.
+//
+
+#ifndef MESH_SIMPLIFY_H_3F1C7A52_9B64_4E0D_A8C3_51D7E20B6F94
+#define MESH_SIMPLIFY_H_3F1C7A52_9B64_4E0D_A8C3_51D7E20B6F94
+
+#include <cstddef>
+#include <vector>
+
+struct mesh_simplify_options
+{
+  // stop once this fraction of the triangles is left
+  double target_ratio = 0.5;
+  // stop before a collapse moves the surface further than this (model
+  // units, measured as area weighted RMS distance to the original planes);
+  // 0 means no limit
+  double target_error = 0.0;
+  // open boundaries never move
+  bool preserve_borders = false;
+  // vertices on an attribute seam only collapse along the seam
+  bool preserve_seams = false;
+};
+
+// positions holds x,y,z for vertex_count vertices and indices holds
+// triangles as index triples. Returns the remaining triangles, still
+// indexing the input vertices. error, when given, receives the largest
+// error of any collapse that was applied.
+std::vector<unsigned int> mesh_simplify(const double* positions, size_t vertex_count,
+  const unsigned int* indices, size_t index_count,
+  const mesh_simplify_options& options, double* error = nullptr);
+
+#endif /* MESH_SIMPLIFY_H_3F1C7A52_9B64_4E0D_A8C3_51D7E20B6F94 */
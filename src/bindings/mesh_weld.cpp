@@ -0,0 +1,424 @@
+/*
+   mesh_weld.cpp and mesh_weld.h
+
+   Tolerance based vertex welding.
+
+   Every vertex is linked to the lowest indexed earlier vertex it can merge
+   with (within tolerance, compatible normal and texture coordinates); that
+   search runs on all threads. A single ordered pass then resolves links
+   into groups: since a link always points to a lower index, the target's
+   group is already known when a vertex is reached.
+*/
+
+#include "mesh_weld.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+typedef unsigned int index_t;
+typedef std::function<void(int, const std::function<void(int)>&)> parallel_for_t;
+
+static const size_t BLOCK_SIZE = 1 << 16;
+static const int SHARD_BITS = 8;
+static const size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+static const index_t EMPTY = ~index_t(0);
+// grid cells are this many times the tolerance wide
+static const double CELL_SIZE_FACTOR = 8.0;
+
+static void run(const parallel_for_t& parallel_for, size_t count, const std::function<void(int)>& func)
+{
+  if (parallel_for && count > 1)
+    parallel_for((int)count, func);
+  else
+  {
+    for (size_t i = 0; i < count; i++)
+      func((int)i);
+  }
+}
+
+static size_t block_count(size_t count)
+{
+  return (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+static uint64_t mix(uint64_t h)
+{
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  h ^= h >> 31;
+  return h;
+}
+
+static uint64_t hash3(uint64_t x, uint64_t y, uint64_t z)
+{
+  return mix(mix(mix(x) ^ y) ^ z);
+}
+
+static int64_t cell_coordinate(double v, double inverse_cell_size)
+{
+  // also catches NaN and infinities
+  const double limit = 4.0e18;
+  double c = std::floor(v * inverse_cell_size);
+  if (!(c > -limit))
+    c = -limit;
+  if (!(c < limit))
+    c = limit;
+  return (int64_t)c;
+}
+
+static uint64_t position_bits(double v)
+{
+  // -0 and 0 are the same position
+  if (0.0 == v)
+    v = 0.0;
+  uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+namespace
+{
+  // Cells whose hash starts with the same SHARD_BITS bits, in an open
+  // addressing table. A cell lists its vertices by increasing index as a
+  // range of the grouped vertex array. Cells that collide on the full hash
+  // share an entry; the distance test sorts them out.
+  struct cell_range
+  {
+    uint64_t key;
+    index_t begin;
+    index_t end;
+  };
+
+  struct shard
+  {
+    std::vector<index_t> slots;
+    std::vector<cell_range> cells;
+
+    const cell_range* find(uint64_t key) const
+    {
+      if (slots.empty())
+        return nullptr;
+      const size_t mask = slots.size() - 1;
+      for (size_t slot = (size_t)key & mask; ; slot = (slot + 1) & mask)
+      {
+        const index_t cell = slots[slot];
+        if (EMPTY == cell)
+          return nullptr;
+        if (cells[cell].key == key)
+          return &cells[cell];
+      }
+    }
+
+    index_t insert(uint64_t key)
+    {
+      const size_t mask = slots.size() - 1;
+      for (size_t slot = (size_t)key & mask; ; slot = (slot + 1) & mask)
+      {
+        index_t& cell = slots[slot];
+        if (EMPTY == cell)
+        {
+          cell = (index_t)cells.size();
+          cells.push_back({ key, 0, 0 });
+          return cell;
+        }
+        if (cells[cell].key == key)
+          return cell;
+      }
+    }
+  };
+
+  struct grid
+  {
+    std::vector<shard> shards;
+    std::vector<index_t> grouped;
+
+    void build(const std::vector<uint64_t>& hashes, const parallel_for_t& parallel_for)
+    {
+      const size_t count = hashes.size();
+      const size_t blocks = block_count(count);
+
+      // counting sort into shards, stable so every shard lists its
+      // vertices by increasing index
+      std::vector<std::array<index_t, SHARD_COUNT>> offsets(blocks);
+      run(parallel_for, blocks, [&](int b)
+      {
+        std::array<index_t, SHARD_COUNT>& counts = offsets[b];
+        counts.fill(0);
+        const size_t last = std::min(count, (b + 1) * BLOCK_SIZE);
+        for (size_t i = b * BLOCK_SIZE; i < last; i++)
+          counts[hashes[i] >> (64 - SHARD_BITS)]++;
+      });
+      std::vector<index_t> shard_begin(SHARD_COUNT + 1, 0);
+      index_t running = 0;
+      for (size_t s = 0; s < SHARD_COUNT; s++)
+      {
+        shard_begin[s] = running;
+        for (size_t b = 0; b < blocks; b++)
+        {
+          const index_t c = offsets[b][s];
+          offsets[b][s] = running;
+          running += c;
+        }
+      }
+      shard_begin[SHARD_COUNT] = running;
+
+      std::vector<index_t> by_shard(count);
+      run(parallel_for, blocks, [&](int b)
+      {
+        std::array<index_t, SHARD_COUNT>& cursor = offsets[b];
+        const size_t last = std::min(count, (b + 1) * BLOCK_SIZE);
+        for (size_t i = b * BLOCK_SIZE; i < last; i++)
+          by_shard[cursor[hashes[i] >> (64 - SHARD_BITS)]++] = (index_t)i;
+      });
+
+      shards.assign(SHARD_COUNT, shard());
+      grouped.resize(count);
+      run(parallel_for, SHARD_COUNT, [&](int s)
+      {
+        const index_t first = shard_begin[s];
+        const index_t last = shard_begin[s + 1];
+        if (first == last)
+          return;
+        shard& sh = shards[s];
+        size_t table_size = 2;
+        while (table_size < 2 * (size_t)(last - first))
+          table_size *= 2;
+        sh.slots.assign(table_size, EMPTY);
+
+        std::vector<index_t> cell_of(last - first);
+        for (index_t i = first; i < last; i++)
+          cell_of[i - first] = sh.insert(hashes[by_shard[i]]);
+
+        for (index_t cell : cell_of)
+          sh.cells[cell].end++;
+        index_t offset = first;
+        for (cell_range& cell : sh.cells)
+        {
+          cell.begin = offset;
+          offset += cell.end;
+          cell.end = cell.begin;
+        }
+        for (index_t i = first; i < last; i++)
+          grouped[sh.cells[cell_of[i - first]].end++] = by_shard[i];
+      });
+    }
+
+    // range of grouped holding the vertices of the cell with this hash;
+    // an empty range when there is no such cell
+    void cell(uint64_t key, index_t& begin, index_t& end) const
+    {
+      const cell_range* c = shards[key >> (64 - SHARD_BITS)].find(key);
+      begin = c ? c->begin : 0;
+      end = c ? c->end : 0;
+    }
+  };
+}
+
+std::vector<unsigned int> mesh_weld(const double* positions, size_t vertex_count,
+  const float* normals, const float* texture_coordinates,
+  const mesh_weld_options& options)
+{
+  std::vector<index_t> parent(vertex_count);
+  if (0 == vertex_count)
+    return parent;
+
+  const parallel_for_t& parallel_for = options.parallel_for;
+  const bool exact = !(options.tolerance > 0.0);
+  const double tolerance = exact ? 0.0 : options.tolerance;
+  const double tolerance2 = tolerance * tolerance;
+  // the tolerance box around a vertex crosses into a second cell along an
+  // axis with probability 2 / CELL_SIZE_FACTOR; welding tolerances are far
+  // below edge lengths, so larger cells barely add vertices per cell
+  const double inverse_cell_size = exact ? 0.0 : 1.0 / (CELL_SIZE_FACTOR * tolerance);
+  const bool use_normals = nullptr != normals && options.angle_tolerance < 3.14159265358979323846;
+  const double cos_limit = std::cos(std::max(0.0, options.angle_tolerance));
+
+  const size_t blocks = block_count(vertex_count);
+  std::vector<uint64_t> hashes(vertex_count);
+  run(parallel_for, blocks, [&](int b)
+  {
+    const size_t last = std::min(vertex_count, (b + 1) * BLOCK_SIZE);
+    for (size_t i = b * BLOCK_SIZE; i < last; i++)
+    {
+      const double* p = positions + 3 * i;
+      hashes[i] = exact
+        ? hash3(position_bits(p[0]), position_bits(p[1]), position_bits(p[2]))
+        : hash3((uint64_t)cell_coordinate(p[0], inverse_cell_size), (uint64_t)cell_coordinate(p[1], inverse_cell_size), (uint64_t)cell_coordinate(p[2], inverse_cell_size));
+    }
+  });
+
+  grid g;
+  g.build(hashes, parallel_for);
+
+  auto compatible = [&](index_t u, index_t v)
+  {
+    const double* a = positions + 3 * (size_t)u;
+    const double* b = positions + 3 * (size_t)v;
+    if (exact)
+    {
+      if (a[0] != b[0] || a[1] != b[1] || a[2] != b[2])
+        return false;
+    }
+    else
+    {
+      const double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+      if (!(dx * dx + dy * dy + dz * dz <= tolerance2))
+        return false;
+    }
+    if (texture_coordinates)
+    {
+      const float* ta = texture_coordinates + 2 * (size_t)u;
+      const float* tb = texture_coordinates + 2 * (size_t)v;
+      if (ta[0] != tb[0] || ta[1] != tb[1])
+        return false;
+    }
+    if (use_normals)
+    {
+      const float* na = normals + 3 * (size_t)u;
+      const float* nb = normals + 3 * (size_t)v;
+      const double la = (double)na[0] * na[0] + (double)na[1] * na[1] + (double)na[2] * na[2];
+      const double lb = (double)nb[0] * nb[0] + (double)nb[1] * nb[1] + (double)nb[2] * nb[2];
+      const double dot = (double)na[0] * nb[0] + (double)na[1] * nb[1] + (double)na[2] * nb[2];
+      // zero length normals match anything
+      if (la > 0.0 && lb > 0.0 && dot < cos_limit * std::sqrt(la * lb))
+        return false;
+    }
+    return true;
+  };
+
+  // lowest earlier vertex in grouped[begin, end) that v can merge with,
+  // looking no further than best
+  auto search = [&](index_t begin, index_t end, index_t v, index_t best)
+  {
+    for (index_t k = begin; k < end; k++)
+    {
+      const index_t u = g.grouped[k];
+      if (u >= best)
+        break;
+      if (compatible(u, v))
+        return u;
+    }
+    return best;
+  };
+
+  // walk vertices cell by cell so neighbouring lookups stay in cache
+  run(parallel_for, blocks, [&](int b)
+  {
+    // vertices of a cell mostly look at the same block of cells; their
+    // ranges are only looked up again when the block changes
+    int64_t block_lo[3] = { 0, 0, 0 }, block_hi[3] = { -1, -1, -1 };
+    index_t ranges[8][2];
+    int range_count = 0;
+
+    const size_t last = std::min(vertex_count, (b + 1) * BLOCK_SIZE);
+    for (size_t k = b * BLOCK_SIZE; k < last; k++)
+    {
+      const index_t v = g.grouped[k];
+      if (exact)
+      {
+        index_t begin, end;
+        g.cell(hashes[v], begin, end);
+        parent[v] = search(begin, end, v, v);
+        continue;
+      }
+
+      const double* p = positions + 3 * (size_t)v;
+      int64_t lo[3], hi[3];
+      for (int axis = 0; axis < 3; axis++)
+      {
+        lo[axis] = cell_coordinate(p[axis] - tolerance, inverse_cell_size);
+        hi[axis] = cell_coordinate(p[axis] + tolerance, inverse_cell_size);
+      }
+      if (!std::equal(lo, lo + 3, block_lo) || !std::equal(hi, hi + 3, block_hi))
+      {
+        std::copy(lo, lo + 3, block_lo);
+        std::copy(hi, hi + 3, block_hi);
+        range_count = 0;
+        for (int64_t x = lo[0]; x <= hi[0]; x++)
+        {
+          for (int64_t y = lo[1]; y <= hi[1]; y++)
+          {
+            for (int64_t z = lo[2]; z <= hi[2]; z++)
+            {
+              index_t* range = ranges[range_count];
+              g.cell(hash3((uint64_t)x, (uint64_t)y, (uint64_t)z), range[0], range[1]);
+              if (range[0] < range[1])
+                range_count++;
+            }
+          }
+        }
+      }
+
+      index_t best = v;
+      for (int i = 0; i < range_count; i++)
+        best = search(ranges[i][0], ranges[i][1], v, best);
+      parent[v] = best;
+    }
+  });
+
+  for (size_t v = 0; v < vertex_count; v++)
+    parent[v] = parent[parent[v]];
+  return parent;
+}
+
+std::vector<char> mesh_duplicate_faces(const int* faces, size_t face_count, size_t vertex_count,
+  const parallel_for_t& parallel_for)
+{
+  std::vector<char> duplicate(face_count, 0);
+
+  // distinct vertices of every face sorted, padded with -1
+  std::vector<std::array<int, 4>> keys(face_count);
+  std::vector<index_t> bucket_begin(vertex_count + 1, 0);
+  for (size_t f = 0; f < face_count; f++)
+  {
+    std::array<int, 4>& key = keys[f];
+    std::copy(faces + 4 * f, faces + 4 * f + 4, key.begin());
+    std::sort(key.begin(), key.end());
+    const auto unique_end = std::unique(key.begin(), key.end());
+    std::fill(unique_end, key.end(), -1);
+    if (key[0] < 0 || (size_t)*std::max_element(key.begin(), key.end()) >= vertex_count)
+    {
+      // out of range faces are left to the caller
+      key[0] = -1;
+      continue;
+    }
+    bucket_begin[key[0] + 1]++;
+  }
+
+  // faces bucketed by their lowest vertex; duplicates share a bucket
+  for (size_t v = 0; v < vertex_count; v++)
+    bucket_begin[v + 1] += bucket_begin[v];
+  std::vector<index_t> cursor(bucket_begin.begin(), bucket_begin.end() - 1);
+  std::vector<index_t> bucketed(bucket_begin[vertex_count]);
+  for (size_t f = 0; f < face_count; f++)
+  {
+    if (keys[f][0] >= 0)
+      bucketed[cursor[keys[f][0]]++] = (index_t)f;
+  }
+
+  const size_t blocks = block_count(vertex_count);
+  run(parallel_for, blocks, [&](int b)
+  {
+    const size_t last = std::min(vertex_count, (b + 1) * BLOCK_SIZE);
+    for (size_t v = b * BLOCK_SIZE; v < last; v++)
+    {
+      index_t* first = bucketed.data() + bucket_begin[v];
+      index_t* end = bucketed.data() + bucket_begin[v + 1];
+      if (end - first < 2)
+        continue;
+      // the lowest face index of every key sorts first and is kept
+      std::sort(first, end, [&keys](index_t a, index_t c) { return keys[a] != keys[c] ? keys[a] < keys[c] : a < c; });
+      for (index_t* f = first + 1; f < end; f++)
+      {
+        if (keys[*f] == keys[*(f - 1)])
+          duplicate[*f] = 1;
+      }
+    }
+  });
+  return duplicate;
+}
@@ -0,0 +1,47 @@
+//
+//  Tolerance based vertex welding and duplicate face detection.
+//
+//  Vertices are hashed into a grid of cells wider than twice the tolerance,
+//  so everything within tolerance of a vertex lies in at most 8 cells. Cells
+//  are grouped into shards by hash and every shard's lookup table is built
+//  independently, which keeps both building the grid and searching it
+//  parallel.
+//
+
+#ifndef MESH_WELD_H_8D2E4B17_C05A_4F39_9E61_7A3B0C94D2E5
+#define MESH_WELD_H_8D2E4B17_C05A_4F39_9E61_7A3B0C94D2E5
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+struct mesh_weld_options
+{
+  // vertices at most this far apart are merged; 0 merges identical
+  // positions only
+  double tolerance = 0.0;
+  // vertices whose normals differ by more than this (radians) stay split;
+  // pi or more ignores normals
+  double angle_tolerance = 3.14159265358979323846;
+  // calls func(i) for every i in [0, count), possibly concurrently; runs
+  // serially when empty
+  std::function<void(int count, const std::function<void(int)>& func)> parallel_for;
+};
+
+// positions holds x,y,z for vertex_count vertices. normals (x,y,z) and
+// texture_coordinates (u,v) are optional; vertices with different texture
+// coordinates are never merged. Returns for every vertex the vertex it
+// merges into: the lowest index of its group, itself when it is kept.
+// Groups chain through neighbours, so two merged vertices can be further
+// apart than the tolerance.
+std::vector<unsigned int> mesh_weld(const double* positions, size_t vertex_count,
+  const float* normals, const float* texture_coordinates,
+  const mesh_weld_options& options);
+
+// faces holds 4 vertex indices per face, triangles repeating the third
+// one. Returns a flag for every face that uses the same set of vertices
+// as a face before it, in either orientation.
+std::vector<char> mesh_duplicate_faces(const int* faces, size_t face_count, size_t vertex_count,
+  const std::function<void(int count, const std::function<void(int)>& func)>& parallel_for);
+
+#endif /* MESH_WELD_H_8D2E4B17_C05A_4F39_9E61_7A3B0C94D2E5 */
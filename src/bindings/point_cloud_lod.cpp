@@ -0,0 +1,484 @@
+/*
+   point_cloud_lod.cpp and point_cloud_lod.h
+
+   Voxel grouping and level of detail octrees for point clouds.
+
+   Voxel grouping is a counting sort: every block of points counts how
+   many of its points fall in each bucket (a hash of the cell), the counts
+   give every block its own write position in every bucket, and a second
+   pass scatters point indices there. Buckets are then sorted by cell on
+   their own.
+
+   The octree is built top down, a level at a time. A node keeps the point
+   closest to the center of every occupied cell of a grid over its cube,
+   halving the grid until the sample fits, and hands the remaining points
+   to its eight octants. Levels with few (large) nodes split every node
+   over all threads; deeper levels run one node per thread.
+*/
+
+#include "point_cloud_lod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+typedef unsigned int index_t;
+typedef std::function<void(int, const std::function<void(int)>&)> parallel_for_t;
+
+static const size_t BLOCK_SIZE = 1 << 18;
+static const int BUCKET_BITS = 10;
+static const size_t BUCKET_COUNT = size_t(1) << BUCKET_BITS;
+static const int CELL_BITS = 21;
+static const int MAX_DEPTH = 24;
+// levels with fewer nodes than this split each node on all threads
+static const size_t PARALLEL_NODE_LEVEL = 8;
+static const size_t MAX_NODE_CHUNKS = 64;
+
+static void run(const parallel_for_t& parallel_for, size_t count, const std::function<void(int)>& func)
+{
+  if (parallel_for && count > 1)
+    parallel_for((int)count, func);
+  else
+  {
+    for (size_t i = 0; i < count; i++)
+      func((int)i);
+  }
+}
+
+static size_t block_count(size_t count)
+{
+  return (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+static uint64_t mix(uint64_t h)
+{
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  h ^= h >> 31;
+  return h;
+}
+
+void point_voxel_group(const double* positions, size_t point_count, const bool* skip, double cell_size,
+  const parallel_for_t& parallel_for, std::vector<unsigned int>& offsets, std::vector<unsigned int>& points)
+{
+  const size_t blocks = block_count(point_count);
+  auto block_end = [point_count](size_t b) { return std::min(point_count, (b + 1) * BLOCK_SIZE); };
+
+  std::vector<double> block_bounds(6 * blocks);
+  run(parallel_for, blocks, [&](int b)
+  {
+    double* lo = &block_bounds[6 * (size_t)b];
+    double* hi = lo + 3;
+    for (int k = 0; k < 3; k++)
+    {
+      lo[k] = HUGE_VAL;
+      hi[k] = -HUGE_VAL;
+    }
+    for (size_t i = b * BLOCK_SIZE; i < block_end(b); i++)
+    {
+      if (skip && skip[i])
+        continue;
+      for (int k = 0; k < 3; k++)
+      {
+        lo[k] = std::min(lo[k], positions[3 * i + k]);
+        hi[k] = std::max(hi[k], positions[3 * i + k]);
+      }
+    }
+  });
+  double lo[3] = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+  double hi[3] = { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL };
+  for (size_t b = 0; b < blocks; b++)
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      lo[k] = std::min(lo[k], block_bounds[6 * b + k]);
+      hi[k] = std::max(hi[k], block_bounds[6 * b + 3 + k]);
+    }
+  }
+  offsets.assign(1, 0);
+  points.clear();
+  if (!(hi[0] >= lo[0]))
+    return;
+
+  const double max_cell = (double)((1u << CELL_BITS) - 1);
+  const double extent = std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+  double cell = std::max(cell_size, extent / max_cell);
+  if (!(cell > 0.0))
+    cell = 1.0;
+  auto key = [&](size_t i)
+  {
+    uint64_t rc = 0;
+    for (int k = 0; k < 3; k++)
+    {
+      const double c = std::min(std::max(std::floor((positions[3 * i + k] - lo[k]) / cell), 0.0), max_cell);
+      rc |= (uint64_t)c << (CELL_BITS * k);
+    }
+    return rc;
+  };
+  auto bucket = [](uint64_t k) { return (size_t)(mix(k) >> (64 - BUCKET_BITS)); };
+
+  // write position of every block in every bucket
+  std::vector<index_t> cursors(blocks * BUCKET_COUNT, 0);
+  run(parallel_for, blocks, [&](int b)
+  {
+    index_t* counts = &cursors[(size_t)b * BUCKET_COUNT];
+    for (size_t i = b * BLOCK_SIZE; i < block_end(b); i++)
+    {
+      if (!(skip && skip[i]))
+        counts[bucket(key(i))]++;
+    }
+  });
+  std::vector<size_t> bucket_begin(BUCKET_COUNT + 1, 0);
+  size_t total = 0;
+  for (size_t k = 0; k < BUCKET_COUNT; k++)
+  {
+    bucket_begin[k] = total;
+    for (size_t b = 0; b < blocks; b++)
+    {
+      const index_t count = cursors[b * BUCKET_COUNT + k];
+      cursors[b * BUCKET_COUNT + k] = (index_t)total;
+      total += count;
+    }
+  }
+  bucket_begin[BUCKET_COUNT] = total;
+
+  points.resize(total);
+  run(parallel_for, blocks, [&](int b)
+  {
+    index_t* cursor = &cursors[(size_t)b * BUCKET_COUNT];
+    for (size_t i = b * BLOCK_SIZE; i < block_end(b); i++)
+    {
+      if (!(skip && skip[i]))
+        points[cursor[bucket(key(i))]++] = (index_t)i;
+    }
+  });
+  std::vector<index_t>().swap(cursors);
+
+  std::vector<std::vector<index_t>> cell_begin(BUCKET_COUNT);
+  run(parallel_for, BUCKET_COUNT, [&](int k)
+  {
+    const size_t begin = bucket_begin[k];
+    const size_t end = bucket_begin[k + 1];
+    std::vector<std::pair<uint64_t, index_t>> cells(end - begin);
+    for (size_t i = begin; i < end; i++)
+      cells[i - begin] = std::make_pair(key(points[i]), points[i]);
+    std::sort(cells.begin(), cells.end());
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+      points[begin + i] = cells[i].second;
+      if (0 == i || cells[i].first != cells[i - 1].first)
+        cell_begin[k].push_back((index_t)(begin + i));
+    }
+  });
+  for (size_t k = 0; k < BUCKET_COUNT; k++)
+    offsets.insert(offsets.end() - 1, cell_begin[k].begin(), cell_begin[k].end());
+  offsets.back() = (index_t)total;
+}
+
+namespace
+{
+  struct octree_node
+  {
+    int tile;
+    int depth;
+    size_t begin;
+    size_t end;
+    double origin[3];
+    double size;
+  };
+
+  struct octree_split
+  {
+    double lo[3];
+    double hi[3];
+    size_t sample_count = 0;
+    size_t child_count[8] = { 0 };
+    double spacing = 0.0;
+  };
+
+  struct octree_builder
+  {
+    const double* positions;
+    size_t max_points;
+    std::vector<index_t>& order;
+    std::vector<index_t> scratch;
+    std::vector<char> sampled;
+
+    octree_builder(const double* p, size_t point_count, size_t max, std::vector<index_t>& o)
+      : positions(p), max_points(max), order(o), scratch(point_count), sampled(point_count, 0)
+    {
+    }
+
+    // keeps the point closest to the center of every occupied cell of a
+    // grid x grid x grid grid over node; false when there are more cells
+    // than max_points
+    bool sample(const octree_node& node, size_t grid, const parallel_for_t& parallel_for, size_t chunks, std::vector<index_t>& samples) const
+    {
+      typedef std::unordered_map<uint64_t, std::pair<double, index_t>> cell_map;
+      const size_t n = node.end - node.begin;
+      const double cell = node.size / (double)grid;
+      auto closer = [](const std::pair<double, index_t>& a, const std::pair<double, index_t>& b)
+      {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+      };
+
+      std::vector<cell_map> maps(chunks);
+      std::vector<char> overflow(chunks, 0);
+      run(parallel_for, chunks, [&](int c)
+      {
+        cell_map& map = maps[c];
+        const size_t last = node.begin + n * (c + 1) / chunks;
+        for (size_t i = node.begin + n * c / chunks; i < last; i++)
+        {
+          const index_t p = order[i];
+          uint64_t key = 0;
+          double d2 = 0.0;
+          for (int k = 0; k < 3; k++)
+          {
+            const double x = positions[3 * (size_t)p + k] - node.origin[k];
+            const double g = std::min(std::max(std::floor(x / cell), 0.0), (double)(grid - 1));
+            const double d = x - (g + 0.5) * cell;
+            key |= (uint64_t)g << (20 * k);
+            d2 += d * d;
+          }
+          const std::pair<double, index_t> candidate(d2, p);
+          auto found = map.emplace(key, candidate);
+          if (!found.second && closer(candidate, found.first->second))
+            found.first->second = candidate;
+          if (map.size() > max_points)
+          {
+            overflow[c] = 1;
+            return;
+          }
+        }
+      });
+      for (size_t c = 0; c < chunks; c++)
+      {
+        if (overflow[c])
+          return false;
+      }
+
+      cell_map& merged = maps[0];
+      for (size_t c = 1; c < chunks; c++)
+      {
+        for (const auto& entry : maps[c])
+        {
+          auto found = merged.emplace(entry);
+          if (!found.second && closer(entry.second, found.first->second))
+            found.first->second = entry.second;
+        }
+        cell_map().swap(maps[c]);
+        if (merged.size() > max_points)
+          return false;
+      }
+      samples.clear();
+      for (const auto& entry : merged)
+        samples.push_back(entry.second.second);
+      return true;
+    }
+
+    static size_t chunk_count(const octree_node& node, const parallel_for_t& parallel_for)
+    {
+      return parallel_for ? std::max<size_t>(1, std::min(MAX_NODE_CHUNKS, block_count(node.end - node.begin))) : 1;
+    }
+
+    void bounds(const octree_node& node, const parallel_for_t& parallel_for, double lo[3], double hi[3]) const
+    {
+      const size_t n = node.end - node.begin;
+      const size_t chunks = chunk_count(node, parallel_for);
+      std::vector<double> chunk_bounds(6 * chunks);
+      run(parallel_for, chunks, [&](int c)
+      {
+        double* chunk_lo = &chunk_bounds[6 * (size_t)c];
+        double* chunk_hi = chunk_lo + 3;
+        for (int k = 0; k < 3; k++)
+        {
+          chunk_lo[k] = HUGE_VAL;
+          chunk_hi[k] = -HUGE_VAL;
+        }
+        const size_t last = node.begin + n * (c + 1) / chunks;
+        for (size_t i = node.begin + n * c / chunks; i < last; i++)
+        {
+          const double* p = positions + 3 * (size_t)order[i];
+          for (int k = 0; k < 3; k++)
+          {
+            chunk_lo[k] = std::min(chunk_lo[k], p[k]);
+            chunk_hi[k] = std::max(chunk_hi[k], p[k]);
+          }
+        }
+      });
+      for (int k = 0; k < 3; k++)
+      {
+        lo[k] = HUGE_VAL;
+        hi[k] = -HUGE_VAL;
+        for (size_t c = 0; c < chunks; c++)
+        {
+          lo[k] = std::min(lo[k], chunk_bounds[6 * c + k]);
+          hi[k] = std::max(hi[k], chunk_bounds[6 * c + 3 + k]);
+        }
+      }
+    }
+
+    octree_split split(const octree_node& node, const parallel_for_t& parallel_for)
+    {
+      octree_split rc;
+      const size_t n = node.end - node.begin;
+      const size_t chunks = chunk_count(node, parallel_for);
+      auto chunk_begin = [&](size_t c) { return node.begin + n * c / chunks; };
+
+      bounds(node, parallel_for, rc.lo, rc.hi);
+
+      if (n <= max_points || node.depth >= MAX_DEPTH)
+      {
+        rc.sample_count = n;
+        return rc;
+      }
+
+      // about max_points cells on a surface crossing the node
+      size_t grid = 1;
+      while (grid < (size_t(1) << 20) && 4 * grid * grid <= max_points)
+        grid *= 2;
+      std::vector<index_t> samples;
+      while (!sample(node, grid, parallel_for, chunks, samples))
+        grid /= 2;
+      rc.spacing = node.size / (double)grid;
+      for (index_t p : samples)
+        sampled[p] = 1;
+
+      // samples first, then the points of every octant
+      const double middle[3] = { node.origin[0] + 0.5 * node.size, node.origin[1] + 0.5 * node.size, node.origin[2] + 0.5 * node.size };
+      auto group = [&](index_t p)
+      {
+        if (sampled[p])
+          return 0;
+        const double* x = positions + 3 * (size_t)p;
+        return 1 + (x[0] >= middle[0] ? 1 : 0) + (x[1] >= middle[1] ? 2 : 0) + (x[2] >= middle[2] ? 4 : 0);
+      };
+      std::vector<size_t> cursors(9 * chunks, 0);
+      run(parallel_for, chunks, [&](int c)
+      {
+        for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); i++)
+          cursors[9 * (size_t)c + group(order[i])]++;
+      });
+      size_t total = node.begin;
+      for (int g = 0; g < 9; g++)
+      {
+        const size_t start = total;
+        for (size_t c = 0; c < chunks; c++)
+        {
+          const size_t count = cursors[9 * c + g];
+          cursors[9 * c + g] = total;
+          total += count;
+        }
+        if (0 == g)
+          rc.sample_count = total - start;
+        else
+          rc.child_count[g - 1] = total - start;
+      }
+      run(parallel_for, chunks, [&](int c)
+      {
+        size_t* cursor = &cursors[9 * (size_t)c];
+        for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); i++)
+          scratch[cursor[group(order[i])]++] = order[i];
+      });
+      run(parallel_for, chunks, [&](int c)
+      {
+        std::copy(scratch.begin() + chunk_begin(c), scratch.begin() + chunk_begin(c + 1), order.begin() + chunk_begin(c));
+      });
+      return rc;
+    }
+  };
+}
+
+std::vector<spatial_tile> point_lod_octree(const double* positions, size_t point_count, int max_points_per_node,
+  const parallel_for_t& parallel_for, std::vector<unsigned int>& order)
+{
+  order.resize(point_count);
+  run(parallel_for, block_count(point_count), [&](int b)
+  {
+    const size_t last = std::min(point_count, (b + 1) * BLOCK_SIZE);
+    for (size_t i = b * BLOCK_SIZE; i < last; i++)
+      order[i] = (index_t)i;
+  });
+
+  octree_builder builder(positions, point_count, (size_t)std::max(max_points_per_node, 1), order);
+  std::vector<spatial_tile> tiles(1);
+
+  octree_node root = { 0, 0, 0, point_count, { 0.0, 0.0, 0.0 }, 0.0 };
+  if (point_count > 0)
+  {
+    double lo[3], hi[3];
+    builder.bounds(root, parallel_for, lo, hi);
+    for (int k = 0; k < 3; k++)
+    {
+      root.origin[k] = lo[k];
+      root.size = std::max(root.size, hi[k] - lo[k]);
+    }
+    // keep the largest coordinates inside the last cell
+    root.size = root.size > 0.0 ? root.size * (1.0 + 1e-9) : 1.0;
+  }
+
+  std::vector<octree_node> level(1, root);
+  while (!level.empty())
+  {
+    std::vector<octree_split> splits(level.size());
+    if (level.size() < PARALLEL_NODE_LEVEL)
+    {
+      for (size_t i = 0; i < level.size(); i++)
+        splits[i] = builder.split(level[i], parallel_for);
+    }
+    else
+    {
+      const parallel_for_t serial;
+      run(parallel_for, level.size(), [&](int i) { splits[i] = builder.split(level[i], serial); });
+    }
+
+    std::vector<octree_node> next;
+    for (size_t i = 0; i < level.size(); i++)
+    {
+      const octree_node& node = level[i];
+      const octree_split& split = splits[i];
+      spatial_tile& tile = tiles[node.tile];
+      for (int k = 0; k < 3; k++)
+      {
+        tile.min[k] = node.end > node.begin ? split.lo[k] : 0.0;
+        tile.max[k] = node.end > node.begin ? split.hi[k] : 0.0;
+      }
+      tile.begin = node.begin;
+      tile.end = node.begin + split.sample_count;
+      tile.geometric_error = split.spacing;
+
+      size_t begin = tile.end;
+      const int parent = node.tile;
+      for (int octant = 0; octant < 8; octant++)
+      {
+        const size_t count = split.child_count[octant];
+        if (0 == count)
+          continue;
+        octree_node child;
+        child.tile = (int)tiles.size();
+        child.depth = node.depth + 1;
+        child.begin = begin;
+        child.end = begin + count;
+        child.size = 0.5 * node.size;
+        for (int k = 0; k < 3; k++)
+          child.origin[k] = node.origin[k] + ((octant >> k) & 1 ? child.size : 0.0);
+        begin += count;
+        next.push_back(child);
+
+        spatial_tile child_tile;
+        child_tile.parent = parent;
+        child_tile.depth = child.depth;
+        if (tiles[parent].first_child < 0)
+          tiles[parent].first_child = child.tile;
+        tiles[parent].child_count++;
+        tiles.push_back(child_tile);
+      }
+    }
+    level.swap(next);
+  }
+  return tiles;
+}
@@ -0,0 +1,40 @@
+//
+//  Point cloud reduction: voxel grouping and level of detail octrees.
+//
+//  Both work on arrays of point indices and never copy point data, so
+//  besides the cloud itself they need at most two 32 bit indices and a
+//  byte per point, and scratch space for one bucket or node per thread.
+//  Work is spread over spatial buckets that share no cells, so buckets run
+//  in parallel without locks.
+//
+
+#ifndef POINT_CLOUD_LOD_H_6E19B2D4_0A7C_4B35_8F61_C3D5E90A27B8
+#define POINT_CLOUD_LOD_H_6E19B2D4_0A7C_4B35_8F61_C3D5E90A27B8
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "spatial_tiles.h"
+
+// Groups the points (x,y,z per point) by cubic cells of cell_size. skip is
+// optional; points flagged in it belong to no cell. Writes the points of
+// every occupied cell to points, cell i being points[offsets[i],
+// offsets[i+1]). Cells are made larger when needed to keep them under
+// 2^21 per axis. parallel_for calls func(i) for every i in [0, count),
+// possibly concurrently; it runs serially when empty.
+void point_voxel_group(const double* positions, size_t point_count, const bool* skip, double cell_size,
+  const std::function<void(int count, const std::function<void(int)>& func)>& parallel_for,
+  std::vector<unsigned int>& offsets, std::vector<unsigned int>& points);
+
+// Potree style octree: every node holds at most max_points_per_node
+// points, spread evenly by keeping one point per cell of a grid over the
+// node, and the rest move down to its children. Drawing a node adds to
+// what its ancestors drew. order receives point indices; tile ranges
+// index into it and every point is in exactly one tile. Tiles come level
+// by level, children next to each other.
+std::vector<spatial_tile> point_lod_octree(const double* positions, size_t point_count, int max_points_per_node,
+  const std::function<void(int count, const std::function<void(int)>& func)>& parallel_for,
+  std::vector<unsigned int>& order);
+
+#endif /* POINT_CLOUD_LOD_H_6E19B2D4_0A7C_4B35_8F61_C3D5E90A27B8 */
@@ -0,0 +1,233 @@
+/*
+   point_cloud_normals.cpp and point_cloud_normals.h
+
+   Normal estimation and statistical outlier detection.
+
+   The covariance of a neighbourhood is diagonalised with cyclic Jacobi
+   rotations, which is exact to rounding for symmetric 3x3 matrices in a
+   handful of sweeps and has no trouble with repeated eigenvalues. Every
+   block of points keeps its own neighbour buffers, so the only state the
+   threads share is the tree, which they only read.
+*/
+
+#include "point_cloud_normals.h"
+#include "point_kd_tree.h"
+
+#include <algorithm>
+#include <cmath>
+
+typedef std::function<void(int, const std::function<void(int)>&)> parallel_for_t;
+
+static const size_t BLOCK_SIZE = 4096;
+static const int JACOBI_SWEEPS = 16;
+
+static void run(const parallel_for_t& parallel_for, size_t count, const std::function<void(int)>& func)
+{
+  if (parallel_for && count > 1)
+    parallel_for((int)count, func);
+  else
+  {
+    for (size_t i = 0; i < count; i++)
+      func((int)i);
+  }
+}
+
+static size_t block_count(size_t count)
+{
+  return (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+// Eigenvalues of the symmetric matrix a (overwritten) in values and the
+// matching eigenvectors in the columns of vectors
+static void jacobi_eigen(double a[3][3], double values[3], double vectors[3][3])
+{
+  for (int i = 0; i < 3; i++)
+  {
+    for (int j = 0; j < 3; j++)
+      vectors[i][j] = i == j ? 1.0 : 0.0;
+  }
+  for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++)
+  {
+    const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+    const double diagonal = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+    if (off <= 1e-30 * diagonal || 0.0 == off)
+      break;
+    for (int p = 0; p < 2; p++)
+    {
+      for (int q = p + 1; q < 3; q++)
+      {
+        if (0.0 == a[p][q])
+          continue;
+        const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+        const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+        const double c = 1.0 / std::sqrt(t * t + 1.0);
+        const double s = t * c;
+        for (int k = 0; k < 3; k++)
+        {
+          const double akp = a[k][p];
+          const double akq = a[k][q];
+          a[k][p] = c * akp - s * akq;
+          a[k][q] = s * akp + c * akq;
+        }
+        for (int k = 0; k < 3; k++)
+        {
+          const double apk = a[p][k];
+          const double aqk = a[q][k];
+          a[p][k] = c * apk - s * aqk;
+          a[q][k] = s * apk + c * aqk;
+        }
+        for (int k = 0; k < 3; k++)
+        {
+          const double vkp = vectors[k][p];
+          const double vkq = vectors[k][q];
+          vectors[k][p] = c * vkp - s * vkq;
+          vectors[k][q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < 3; i++)
+    values[i] = a[i][i];
+}
+
+// Direction of least variance of the points at indices, or zero when they
+// do not span a plane
+static void plane_normal(const double* positions, const unsigned int* indices, size_t count, double normal[3])
+{
+  normal[0] = normal[1] = normal[2] = 0.0;
+  if (count < 3)
+    return;
+
+  double center[3] = { 0, 0, 0 };
+  for (size_t i = 0; i < count; i++)
+  {
+    for (int k = 0; k < 3; k++)
+      center[k] += positions[3 * (size_t)indices[i] + k];
+  }
+  for (int k = 0; k < 3; k++)
+    center[k] /= (double)count;
+
+  double covariance[3][3] = { { 0 } };
+  for (size_t i = 0; i < count; i++)
+  {
+    const double* p = positions + 3 * (size_t)indices[i];
+    const double d[3] = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+    for (int r = 0; r < 3; r++)
+    {
+      for (int c = r; c < 3; c++)
+        covariance[r][c] += d[r] * d[c];
+    }
+  }
+  for (int r = 0; r < 3; r++)
+  {
+    for (int c = 0; c < r; c++)
+      covariance[r][c] = covariance[c][r];
+  }
+
+  double values[3];
+  double vectors[3][3];
+  jacobi_eigen(covariance, values, vectors);
+  int order[3] = { 0, 1, 2 };
+  std::sort(order, order + 3, [&values](int a, int b) { return values[a] < values[b]; });
+  // a line has two vanishing eigenvalues
+  if (!(values[order[1]] > 1e-12 * values[order[2]]))
+    return;
+  for (int k = 0; k < 3; k++)
+    normal[k] = vectors[k][order[0]];
+}
+
+void point_estimate_normals(const double* positions, size_t point_count, const point_normals_options& options, double* normals)
+{
+  const point_kd_tree tree(positions, point_count, options.parallel_for);
+  const size_t k = (size_t)std::max(options.k, 3);
+
+  run(options.parallel_for, block_count(point_count), [&](int block)
+  {
+    std::vector<std::pair<double, unsigned int>> nearest;
+    std::vector<unsigned int> neighbours;
+    const size_t last = std::min(point_count, (block + 1) * BLOCK_SIZE);
+    for (size_t i = block * BLOCK_SIZE; i < last; i++)
+    {
+      const double* p = positions + 3 * i;
+      if (options.radius > 0.0)
+        tree.within(p, options.radius, neighbours);
+      if (!(options.radius > 0.0) || neighbours.size() < 3)
+      {
+        tree.nearest(p, k, point_count, nearest);
+        neighbours.clear();
+        for (const auto& n : nearest)
+          neighbours.push_back(n.second);
+      }
+
+      double normal[3];
+      plane_normal(positions, neighbours.data(), neighbours.size(), normal);
+
+      double side = 0.0;
+      if (options.viewpoint)
+      {
+        for (int c = 0; c < 3; c++)
+          side += normal[c] * (options.viewpoint[c] - p[c]);
+        if (options.away)
+          side = -side;
+      }
+      else if (options.previous)
+      {
+        for (int c = 0; c < 3; c++)
+          side += normal[c] * options.previous[3 * i + c];
+      }
+      const double sign = side < 0.0 ? -1.0 : 1.0;
+      for (int c = 0; c < 3; c++)
+        normals[3 * i + c] = sign * normal[c];
+    }
+  });
+}
+
+size_t point_statistical_outliers(const double* positions, size_t point_count, int k, double std_ratio,
+  const parallel_for_t& parallel_for, std::vector<char>& outliers)
+{
+  outliers.assign(point_count, 0);
+  if (point_count < 2 || k < 1)
+    return 0;
+
+  const point_kd_tree tree(positions, point_count, parallel_for);
+  std::vector<double> distances(point_count);
+  const size_t blocks = block_count(point_count);
+  std::vector<double> block_sums(2 * blocks, 0.0);
+  run(parallel_for, blocks, [&](int block)
+  {
+    std::vector<std::pair<double, unsigned int>> nearest;
+    const size_t last = std::min(point_count, (block + 1) * BLOCK_SIZE);
+    for (size_t i = block * BLOCK_SIZE; i < last; i++)
+    {
+      tree.nearest(positions + 3 * i, (size_t)k, i, nearest);
+      double sum = 0.0;
+      for (const auto& n : nearest)
+        sum += std::sqrt(n.first);
+      distances[i] = sum / (double)nearest.size();
+      block_sums[2 * (size_t)block] += distances[i];
+      block_sums[2 * (size_t)block + 1] += distances[i] * distances[i];
+    }
+  });
+
+  double sum = 0.0;
+  double sum2 = 0.0;
+  for (size_t b = 0; b < blocks; b++)
+  {
+    sum += block_sums[2 * b];
+    sum2 += block_sums[2 * b + 1];
+  }
+  const double mean = sum / (double)point_count;
+  const double deviation = std::sqrt(std::max(0.0, sum2 / (double)point_count - mean * mean));
+  const double limit = mean + std_ratio * deviation;
+
+  size_t count = 0;
+  for (size_t i = 0; i < point_count; i++)
+  {
+    if (distances[i] > limit)
+    {
+      outliers[i] = 1;
+      count++;
+    }
+  }
+  return count;
+}
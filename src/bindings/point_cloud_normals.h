@@ -0,0 +1,47 @@
+//
+//  Normal estimation and statistical outlier detection for point clouds.
+//
+//  Both query a point_kd_tree built once per call and run over blocks of
+//  points on all threads. A normal is the direction of least variance of
+//  a point's neighbourhood (principal component analysis of the 3x3
+//  covariance); its sign is chosen afterwards, see point_estimate_normals.
+//
+
+#ifndef POINT_CLOUD_NORMALS_H_F2B85E07_3C94_4A1D_8D70_6A9E4C13B5D2
+#define POINT_CLOUD_NORMALS_H_F2B85E07_3C94_4A1D_8D70_6A9E4C13B5D2
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+struct point_normals_options
+{
+  // neighbours used for every point, the point included
+  int k = 16;
+  // when larger than 0, all points within radius are used instead; points
+  // with fewer than 3 of those fall back to the k nearest
+  double radius = 0.0;
+  // normals face this point (x,y,z), or away from it when away is set
+  const double* viewpoint = nullptr;
+  bool away = false;
+  // without a viewpoint, normals keep the side of these (x,y,z per point;
+  // may be the output buffer)
+  const double* previous = nullptr;
+  // calls func(i) for every i in [0, count), possibly concurrently; runs
+  // serially when empty
+  std::function<void(int count, const std::function<void(int)>& func)> parallel_for;
+};
+
+// Writes a unit normal (x,y,z) for each of point_count points to normals.
+// Points without a plane through their neighbours (fewer than 3, or all on
+// one line) get a zero normal.
+void point_estimate_normals(const double* positions, size_t point_count, const point_normals_options& options, double* normals);
+
+// Flags points whose mean distance to their k nearest neighbours is more
+// than std_ratio standard deviations above the mean of that distance over
+// all points. Returns the number of flagged points.
+size_t point_statistical_outliers(const double* positions, size_t point_count, int k, double std_ratio,
+  const std::function<void(int count, const std::function<void(int)>& func)>& parallel_for,
+  std::vector<char>& outliers);
+
+#endif /* POINT_CLOUD_NORMALS_H_F2B85E07_3C94_4A1D_8D70_6A9E4C13B5D2 */
@@ -0,0 +1,164 @@
+/*
+   point_kd_tree.cpp and point_kd_tree.h
+
+   Implicit k-d tree. Node p of depth d covers order[n*p/2^d, n*(p+1)/2^d),
+   which makes its two children the halves split at n*(2p+1)/2^(d+1). A
+   level is built by partitioning every node of the level at that middle
+   along the node's longest axis; nodes of a level are independent and
+   built on all threads.
+*/
+
+#include "point_kd_tree.h"
+
+#include <algorithm>
+#include <cmath>
+
+typedef std::function<void(int, const std::function<void(int)>&)> parallel_for_t;
+
+static const size_t LEAF_SIZE = 16;
+
+static void run(const parallel_for_t& parallel_for, size_t count, const std::function<void(int)>& func)
+{
+  if (parallel_for && count > 1)
+    parallel_for((int)count, func);
+  else
+  {
+    for (size_t i = 0; i < count; i++)
+      func((int)i);
+  }
+}
+
+point_kd_tree::point_kd_tree(const double* positions, size_t point_count, const parallel_for_t& parallel_for)
+  : m_positions(positions), m_count(point_count), m_depth(0)
+{
+  while ((point_count >> m_depth) > LEAF_SIZE)
+    m_depth++;
+  m_order.resize(point_count);
+  for (size_t i = 0; i < point_count; i++)
+    m_order[i] = (unsigned int)i;
+  m_split.resize(size_t(1) << m_depth, 0.0);
+  m_axis.resize(size_t(1) << m_depth, 0);
+
+  for (int depth = 0; depth < m_depth; depth++)
+  {
+    const size_t nodes = size_t(1) << depth;
+    run(parallel_for, nodes, [&](int position)
+    {
+      const size_t begin = range_begin(depth, position);
+      const size_t middle = range_begin(depth + 1, 2 * (size_t)position + 1);
+      const size_t end = range_begin(depth, position + 1);
+
+      double lo[3] = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+      double hi[3] = { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL };
+      for (size_t i = begin; i < end; i++)
+      {
+        const double* p = m_positions + 3 * (size_t)m_order[i];
+        for (int k = 0; k < 3; k++)
+        {
+          lo[k] = std::min(lo[k], p[k]);
+          hi[k] = std::max(hi[k], p[k]);
+        }
+      }
+      int axis = 0;
+      for (int k = 1; k < 3; k++)
+      {
+        if (hi[k] - lo[k] > hi[axis] - lo[axis])
+          axis = k;
+      }
+
+      const double* coordinates = m_positions;
+      std::nth_element(m_order.begin() + begin, m_order.begin() + middle, m_order.begin() + end,
+        [coordinates, axis](unsigned int a, unsigned int b) { return coordinates[3 * (size_t)a + axis] < coordinates[3 * (size_t)b + axis]; });
+
+      const size_t node = nodes + position;
+      m_axis[node] = (unsigned char)axis;
+      m_split[node] = middle < end ? m_positions[3 * (size_t)m_order[middle] + axis] : 0.0;
+    });
+  }
+}
+
+size_t point_kd_tree::range_begin(int depth, size_t position) const
+{
+  // n * position / 2^depth without overflowing for any realistic n
+  const size_t whole = (m_count >> depth) * position;
+  const size_t rest = ((m_count & ((size_t(1) << depth) - 1)) * position) >> depth;
+  return whole + rest;
+}
+
+void point_kd_tree::nearest(const double point[3], size_t k, size_t skip, std::vector<std::pair<double, unsigned int>>& result) const
+{
+  result.clear();
+  if (k > 0 && m_count > 0)
+    nearest(1, 0, point, k, skip, result);
+  std::sort_heap(result.begin(), result.end());
+}
+
+void point_kd_tree::nearest(size_t node, int depth, const double point[3], size_t k, size_t skip, std::vector<std::pair<double, unsigned int>>& heap) const
+{
+  if (depth == m_depth)
+  {
+    const size_t position = node - (size_t(1) << depth);
+    const size_t end = range_begin(depth, position + 1);
+    for (size_t i = range_begin(depth, position); i < end; i++)
+    {
+      const unsigned int index = m_order[i];
+      if (index == skip)
+        continue;
+      const double* p = m_positions + 3 * (size_t)index;
+      const double dx = p[0] - point[0];
+      const double dy = p[1] - point[1];
+      const double dz = p[2] - point[2];
+      const std::pair<double, unsigned int> candidate(dx * dx + dy * dy + dz * dz, index);
+      if (heap.size() < k)
+      {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end());
+      }
+      else if (candidate < heap.front())
+      {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end());
+      }
+    }
+    return;
+  }
+
+  const double diff = point[m_axis[node]] - m_split[node];
+  const size_t near_child = 2 * node + (diff < 0.0 ? 0 : 1);
+  nearest(near_child, depth + 1, point, k, skip, heap);
+  if (heap.size() < k || diff * diff < heap.front().first)
+    nearest(near_child ^ 1, depth + 1, point, k, skip, heap);
+}
+
+void point_kd_tree::within(const double point[3], double radius, std::vector<unsigned int>& result) const
+{
+  result.clear();
+  if (radius >= 0.0 && m_count > 0)
+    within(1, 0, point, radius * radius, result);
+}
+
+void point_kd_tree::within(size_t node, int depth, const double point[3], double radius2, std::vector<unsigned int>& result) const
+{
+  if (depth == m_depth)
+  {
+    const size_t position = node - (size_t(1) << depth);
+    const size_t end = range_begin(depth, position + 1);
+    for (size_t i = range_begin(depth, position); i < end; i++)
+    {
+      const double* p = m_positions + 3 * (size_t)m_order[i];
+      const double dx = p[0] - point[0];
+      const double dy = p[1] - point[1];
+      const double dz = p[2] - point[2];
+      if (dx * dx + dy * dy + dz * dz <= radius2)
+        result.push_back(m_order[i]);
+    }
+    return;
+  }
+
+  const double diff = point[m_axis[node]] - m_split[node];
+  const size_t near_child = 2 * node + (diff < 0.0 ? 0 : 1);
+  within(near_child, depth + 1, point, radius2, result);
+  if (diff * diff <= radius2)
+    within(near_child ^ 1, depth + 1, point, radius2, result);
+}
@@ -0,0 +1,48 @@
+//
+//  Static k-d tree over packed x,y,z points for neighbour queries.
+//
+//  The tree is implicit: every level halves the index ranges of the level
+//  above, so a node's range follows from its position and only the split
+//  axis and value are stored. Leaves hold at most 16 points. Queries do not
+//  change the tree and can run on any number of threads at once.
+//
+
+#ifndef POINT_KD_TREE_H_A47D0C93_5E1B_4F28_9B6A_2D8E31F7C05B
+#define POINT_KD_TREE_H_A47D0C93_5E1B_4F28_9B6A_2D8E31F7C05B
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+class point_kd_tree
+{
+public:
+  // positions must outlive the tree. parallel_for calls func(i) for every
+  // i in [0, count), possibly concurrently; it runs serially when empty.
+  point_kd_tree(const double* positions, size_t point_count,
+    const std::function<void(int count, const std::function<void(int)>& func)>& parallel_for);
+
+  // The k points nearest to point as (squared distance, index) pairs,
+  // closest first. The point with index skip is left out; pass the query
+  // point's own index, or any value past the last point to keep all.
+  void nearest(const double point[3], size_t k, size_t skip, std::vector<std::pair<double, unsigned int>>& result) const;
+
+  // Indices of all points within radius of point, in no particular order
+  void within(const double point[3], double radius, std::vector<unsigned int>& result) const;
+
+private:
+  const double* m_positions;
+  size_t m_count;
+  int m_depth;
+  std::vector<unsigned int> m_order;
+  // per internal node in heap order, the root being node 1
+  std::vector<double> m_split;
+  std::vector<unsigned char> m_axis;
+
+  size_t range_begin(int depth, size_t position) const;
+  void nearest(size_t node, int depth, const double point[3], size_t k, size_t skip, std::vector<std::pair<double, unsigned int>>& heap) const;
+  void within(size_t node, int depth, const double point[3], double radius2, std::vector<unsigned int>& result) const;
+};
+
+#endif /* POINT_KD_TREE_H_A47D0C93_5E1B_4F28_9B6A_2D8E31F7C05B */
@@ -0,0 +1,242 @@
+/*
+   point_transform.cpp and point_transform.h
+
+   Batch transformation of packed xyz point buffers.
+
+   Every SIMD path computes one point per step: the columns of the matrix
+   are kept in registers, each coordinate is broadcast and accumulated, and
+   only the x,y,z lanes are stored so in place transformation never writes
+   into the next point before it has been read.
+*/
+
+#include "point_transform.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define POINT_TRANSFORM_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define POINT_TRANSFORM_AVX2_TARGET
+#else
+#define POINT_TRANSFORM_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define POINT_TRANSFORM_NEON
+#include <arm_neon.h>
+#elif defined(__wasm_simd128__)
+#define POINT_TRANSFORM_WASM_SIMD
+#include <wasm_simd128.h>
+#endif
+
+bool point_transform_is_affine(const double m[4][4])
+{
+  return m[3][0] == 0.0 && m[3][1] == 0.0 && m[3][2] == 0.0 && m[3][3] == 1.0;
+}
+
+template<typename T>
+static void transform_affine_scalar(const double m[4][4], const T* in, T* out, size_t count)
+{
+  for (size_t i = 0; i < count; i++, in += 3, out += 3)
+  {
+    const double x = in[0], y = in[1], z = in[2];
+    out[0] = (T)(m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3]);
+    out[1] = (T)(m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3]);
+    out[2] = (T)(m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3]);
+  }
+}
+
+template<typename T>
+static void transform_projective_scalar(const double m[4][4], const T* in, T* out, size_t count)
+{
+  for (size_t i = 0; i < count; i++, in += 3, out += 3)
+  {
+    const double x = in[0], y = in[1], z = in[2];
+    double w = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+    w = (w != 0.0) ? 1.0 / w : 1.0;
+    out[0] = (T)(w * (m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3]));
+    out[1] = (T)(w * (m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3]));
+    out[2] = (T)(w * (m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3]));
+  }
+}
+
+#if defined(POINT_TRANSFORM_AVX2)
+static bool has_avx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 1);
+  const bool fma = 0 != (info[2] & (1 << 12));
+  const bool osxsave = 0 != (info[2] & (1 << 27));
+  if (!fma || !osxsave || (_xgetbv(0) & 6) != 6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return 0 != (info[1] & (1 << 5));
+#else
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+static const bool use_avx2 = has_avx2();
+
+POINT_TRANSFORM_AVX2_TARGET static inline void store_xyz(double* out, __m256d r)
+{
+  _mm256_maskstore_pd(out, _mm256_setr_epi64x(-1, -1, -1, 0), r);
+}
+
+POINT_TRANSFORM_AVX2_TARGET static inline void store_xyz(float* out, __m256d r)
+{
+  _mm_maskstore_ps(out, _mm_setr_epi32(-1, -1, -1, 0), _mm256_cvtpd_ps(r));
+}
+
+// lane j of column c holds m[j][c]; lane 3 is the homogeneous row
+template<typename T>
+POINT_TRANSFORM_AVX2_TARGET static void transform_avx2(const double m[4][4], bool affine, const T* in, T* out, size_t count)
+{
+  const __m256d c0 = _mm256_setr_pd(m[0][0], m[1][0], m[2][0], m[3][0]);
+  const __m256d c1 = _mm256_setr_pd(m[0][1], m[1][1], m[2][1], m[3][1]);
+  const __m256d c2 = _mm256_setr_pd(m[0][2], m[1][2], m[2][2], m[3][2]);
+  const __m256d c3 = _mm256_setr_pd(m[0][3], m[1][3], m[2][3], m[3][3]);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+
+  if (affine)
+  {
+    for (size_t i = 0; i < count; i++, in += 3, out += 3)
+    {
+      __m256d r = _mm256_fmadd_pd(c0, _mm256_set1_pd((double)in[0]), c3);
+      r = _mm256_fmadd_pd(c1, _mm256_set1_pd((double)in[1]), r);
+      r = _mm256_fmadd_pd(c2, _mm256_set1_pd((double)in[2]), r);
+      store_xyz(out, r);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++, in += 3, out += 3)
+  {
+    __m256d r = _mm256_fmadd_pd(c0, _mm256_set1_pd((double)in[0]), c3);
+    r = _mm256_fmadd_pd(c1, _mm256_set1_pd((double)in[1]), r);
+    r = _mm256_fmadd_pd(c2, _mm256_set1_pd((double)in[2]), r);
+    __m256d w = _mm256_permute4x64_pd(r, 0xFF);
+    w = _mm256_blendv_pd(w, one, _mm256_cmp_pd(w, zero, _CMP_EQ_OQ));
+    store_xyz(out, _mm256_mul_pd(r, _mm256_div_pd(one, w)));
+  }
+}
+#endif
+
+#if defined(POINT_TRANSFORM_NEON)
+static inline void store_xyz(double* out, float64x2_t xy, double z)
+{
+  vst1q_f64(out, xy);
+  out[2] = z;
+}
+
+static inline void store_xyz(float* out, float64x2_t xy, double z)
+{
+  vst1_f32(out, vcvt_f32_f64(xy));
+  out[2] = (float)z;
+}
+
+// xy holds rows 0 and 1, zw rows 2 and 3
+template<typename T>
+static void transform_neon(const double m[4][4], bool affine, const T* in, T* out, size_t count)
+{
+  const double col0xy[2] = { m[0][0], m[1][0] }, col0zw[2] = { m[2][0], m[3][0] };
+  const double col1xy[2] = { m[0][1], m[1][1] }, col1zw[2] = { m[2][1], m[3][1] };
+  const double col2xy[2] = { m[0][2], m[1][2] }, col2zw[2] = { m[2][2], m[3][2] };
+  const double col3xy[2] = { m[0][3], m[1][3] }, col3zw[2] = { m[2][3], m[3][3] };
+  const float64x2_t c0xy = vld1q_f64(col0xy), c0zw = vld1q_f64(col0zw);
+  const float64x2_t c1xy = vld1q_f64(col1xy), c1zw = vld1q_f64(col1zw);
+  const float64x2_t c2xy = vld1q_f64(col2xy), c2zw = vld1q_f64(col2zw);
+  const float64x2_t c3xy = vld1q_f64(col3xy), c3zw = vld1q_f64(col3zw);
+
+  for (size_t i = 0; i < count; i++, in += 3, out += 3)
+  {
+    const float64x2_t x = vdupq_n_f64((double)in[0]);
+    const float64x2_t y = vdupq_n_f64((double)in[1]);
+    const float64x2_t z = vdupq_n_f64((double)in[2]);
+    float64x2_t xy = vfmaq_f64(vfmaq_f64(vfmaq_f64(c3xy, c0xy, x), c1xy, y), c2xy, z);
+    float64x2_t zw = vfmaq_f64(vfmaq_f64(vfmaq_f64(c3zw, c0zw, x), c1zw, y), c2zw, z);
+    if (!affine)
+    {
+      double w = vgetq_lane_f64(zw, 1);
+      w = (w != 0.0) ? 1.0 / w : 1.0;
+      xy = vmulq_n_f64(xy, w);
+      zw = vmulq_n_f64(zw, w);
+    }
+    store_xyz(out, xy, vgetq_lane_f64(zw, 0));
+  }
+}
+#endif
+
+#if defined(POINT_TRANSFORM_WASM_SIMD)
+static inline void store_xyz(double* out, v128_t xy, double z)
+{
+  wasm_v128_store(out, xy);
+  out[2] = z;
+}
+
+static inline void store_xyz(float* out, v128_t xy, double z)
+{
+  wasm_v128_store64_lane(out, wasm_f32x4_demote_f64x2_zero(xy), 0);
+  out[2] = (float)z;
+}
+
+// xy holds rows 0 and 1, zw rows 2 and 3
+template<typename T>
+static void transform_wasm_simd(const double m[4][4], bool affine, const T* in, T* out, size_t count)
+{
+  const v128_t c0xy = wasm_f64x2_make(m[0][0], m[1][0]), c0zw = wasm_f64x2_make(m[2][0], m[3][0]);
+  const v128_t c1xy = wasm_f64x2_make(m[0][1], m[1][1]), c1zw = wasm_f64x2_make(m[2][1], m[3][1]);
+  const v128_t c2xy = wasm_f64x2_make(m[0][2], m[1][2]), c2zw = wasm_f64x2_make(m[2][2], m[3][2]);
+  const v128_t c3xy = wasm_f64x2_make(m[0][3], m[1][3]), c3zw = wasm_f64x2_make(m[2][3], m[3][3]);
+
+  for (size_t i = 0; i < count; i++, in += 3, out += 3)
+  {
+    const v128_t x = wasm_f64x2_splat((double)in[0]);
+    const v128_t y = wasm_f64x2_splat((double)in[1]);
+    const v128_t z = wasm_f64x2_splat((double)in[2]);
+    v128_t xy = wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(c0xy, x), c3xy), wasm_f64x2_add(wasm_f64x2_mul(c1xy, y), wasm_f64x2_mul(c2xy, z)));
+    v128_t zw = wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(c0zw, x), c3zw), wasm_f64x2_add(wasm_f64x2_mul(c1zw, y), wasm_f64x2_mul(c2zw, z)));
+    if (!affine)
+    {
+      double w = wasm_f64x2_extract_lane(zw, 1);
+      const v128_t s = wasm_f64x2_splat((w != 0.0) ? 1.0 / w : 1.0);
+      xy = wasm_f64x2_mul(xy, s);
+      zw = wasm_f64x2_mul(zw, s);
+    }
+    store_xyz(out, xy, wasm_f64x2_extract_lane(zw, 0));
+  }
+}
+#endif
+
+template<typename T>
+static void transform(const double m[4][4], const T* in, T* out, size_t count)
+{
+  const bool affine = point_transform_is_affine(m);
+#if defined(POINT_TRANSFORM_AVX2)
+  if (use_avx2)
+  {
+    transform_avx2(m, affine, in, out, count);
+    return;
+  }
+#elif defined(POINT_TRANSFORM_NEON)
+  transform_neon(m, affine, in, out, count);
+  return;
+#elif defined(POINT_TRANSFORM_WASM_SIMD)
+  transform_wasm_simd(m, affine, in, out, count);
+  return;
+#endif
+  if (affine)
+    transform_affine_scalar(m, in, out, count);
+  else
+    transform_projective_scalar(m, in, out, count);
+}
+
+void point_transform(const double m[4][4], const double* in, double* out, size_t count)
+{
+  transform(m, in, out, count);
+}
+
+void point_transform(const double m[4][4], const float* in, float* out, size_t count)
+{
+  transform(m, in, out, count);
+}
@@ -0,0 +1,26 @@
+//
+//  Batch transformation of packed xyz point buffers.
+//
+//  Points are stored as x,y,z triples in float or double. The matrix is a
+//  row major 4x4 (the layout of ON_Xform::m_xform) and math is always done
+//  in double, so float buffers only lose precision when the result is
+//  stored. Affine matrices skip the homogeneous divide. Points are
+//  processed with AVX2 (x64, when the CPU has it), NEON (arm64) or wasm
+//  SIMD (web assembly built with -msimd128) and plain C++ everywhere else.
+//
+
+#ifndef POINT_TRANSFORM_H_5B0A3E9C_2F4D_4C71_9E36_7C1D0A84B2F1
+#define POINT_TRANSFORM_H_5B0A3E9C_2F4D_4C71_9E36_7C1D0A84B2F1
+
+#include <cstddef>
+
+// true when the bottom row of m is 0,0,0,1
+bool point_transform_is_affine(const double m[4][4]);
+
+// Writes count transformed points to out. in and out may be the same
+// buffer but must not otherwise overlap. A point whose homogeneous w is
+// zero is left undivided, as ON_3dPoint::Transform does.
+void point_transform(const double m[4][4], const double* in, double* out, size_t count);
+void point_transform(const double m[4][4], const float* in, float* out, size_t count);
+
+#endif /* POINT_TRANSFORM_H_5B0A3E9C_2F4D_4C71_9E36_7C1D0A84B2F1 */
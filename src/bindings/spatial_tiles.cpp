@@ -0,0 +1,184 @@
+/*
+   spatial_tiles.cpp and spatial_tiles.h
+
+   k-d tile hierarchy and its 3D Tiles tileset JSON.
+
+   Tiles are split breadth first, so the tile array lists every level
+   before the next one and a tile's children are always next to each
+   other. A split tile hands all its items to its two children. Drawing a
+   tile that only groups others shows nothing, so those get a geometric
+   error far beyond any screen space error limit and viewers refine them
+   at every distance. The error is finite because JSON has no infinity.
+   Callers that fill split tiles with coarse content (lod_content) replace
+   that error with their own.
+*/
+
+#include "spatial_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static const double GROUP_GEOMETRIC_ERROR = 1.0e30;
+
+std::vector<spatial_tile> spatial_tiles_build(const double* centers, const double* bounds, const double* weights,
+  size_t item_count, const spatial_tiles_options& options, std::vector<unsigned int>& order)
+{
+  order.resize(item_count);
+  for (size_t i = 0; i < item_count; i++)
+    order[i] = (unsigned int)i;
+
+  std::vector<spatial_tile> tiles(1);
+  tiles[0].end = item_count;
+
+  for (size_t t = 0; t < tiles.size(); t++)
+  {
+    const size_t begin = tiles[t].begin;
+    const size_t end = tiles[t].end;
+
+    double lo[3] = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+    double hi[3] = { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL };
+    double center_lo[3] = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+    double center_hi[3] = { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL };
+    double weight = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      const size_t item = order[i];
+      const double* c = centers + 3 * item;
+      const double* item_lo = bounds ? bounds + 6 * item : c;
+      const double* item_hi = bounds ? bounds + 6 * item + 3 : c;
+      for (int k = 0; k < 3; k++)
+      {
+        lo[k] = std::min(lo[k], item_lo[k]);
+        hi[k] = std::max(hi[k], item_hi[k]);
+        center_lo[k] = std::min(center_lo[k], c[k]);
+        center_hi[k] = std::max(center_hi[k], c[k]);
+      }
+      weight += weights ? weights[item] : 1.0;
+    }
+    if (end == begin)
+    {
+      for (int k = 0; k < 3; k++)
+        lo[k] = hi[k] = center_lo[k] = center_hi[k] = 0.0;
+    }
+
+    spatial_tile& tile = tiles[t];
+    double extent = 0.0;
+    for (int k = 0; k < 3; k++)
+    {
+      tile.min[k] = lo[k];
+      tile.max[k] = hi[k];
+      extent = std::max(extent, hi[k] - lo[k]);
+    }
+
+    int axis = 0;
+    for (int k = 1; k < 3; k++)
+    {
+      if (center_hi[k] - center_lo[k] > center_hi[axis] - center_lo[axis])
+        axis = k;
+    }
+
+    const bool too_heavy = options.max_weight > 0.0 && weight > options.max_weight;
+    const bool too_large = options.max_extent > 0.0 && extent > options.max_extent;
+    // items with one center can not be told apart
+    if (!(too_heavy || too_large) || tile.depth >= options.max_depth || end - begin < 2 || !(center_hi[axis] > center_lo[axis]))
+      continue;
+
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+      [centers, axis](unsigned int a, unsigned int b) { return centers[3 * (size_t)a + axis] < centers[3 * (size_t)b + axis]; });
+
+    tile.first_child = (int)tiles.size();
+    tile.child_count = 2;
+    tile.end = tile.begin;
+    tile.geometric_error = GROUP_GEOMETRIC_ERROR;
+
+    spatial_tile child;
+    child.parent = (int)t;
+    child.depth = tile.depth + 1;
+    child.begin = begin;
+    child.end = middle;
+    tiles.push_back(child);
+    child.begin = middle;
+    child.end = end;
+    tiles.push_back(child);
+  }
+  return tiles;
+}
+
+static void append_number(std::string& json, double value)
+{
+  if (!std::isfinite(value))
+    value = 0.0;
+  char text[32];
+  snprintf(text, sizeof(text), "%.15g", value);
+  json += text;
+}
+
+static void append_tile(std::string& json, const std::vector<spatial_tile>& tiles, int index, const std::string& content_uri)
+{
+  const spatial_tile& tile = tiles[index];
+
+  // oriented box: center, then the three half axes
+  double box[12] = { 0 };
+  for (int k = 0; k < 3; k++)
+  {
+    box[k] = 0.5 * (tile.min[k] + tile.max[k]);
+    box[3 + 4 * k] = 0.5 * (tile.max[k] - tile.min[k]);
+  }
+  json += "{\"boundingVolume\":{\"box\":[";
+  for (int i = 0; i < 12; i++)
+  {
+    if (i > 0)
+      json += ',';
+    append_number(json, box[i]);
+  }
+  json += "]},\"geometricError\":";
+  append_number(json, tile.geometric_error);
+  if (0 == index)
+    json += tile.lod_content ? ",\"refine\":\"REPLACE\"" : ",\"refine\":\"ADD\"";
+
+  if (tile.end > tile.begin || tile.lod_content)
+  {
+    std::string uri = content_uri;
+    const std::string key = "{index}";
+    const std::string value = std::to_string(index);
+    for (size_t at = uri.find(key); at != std::string::npos; at = uri.find(key, at + value.size()))
+      uri.replace(at, key.size(), value);
+
+    json += ",\"content\":{\"uri\":\"";
+    for (char c : uri)
+    {
+      if ('"' == c || '\\' == c)
+        json += '\\';
+      json += c;
+    }
+    json += "\"}";
+  }
+
+  if (tile.child_count > 0)
+  {
+    json += ",\"children\":[";
+    for (int i = 0; i < tile.child_count; i++)
+    {
+      if (i > 0)
+        json += ',';
+      append_tile(json, tiles, tile.first_child + i, content_uri);
+    }
+    json += ']';
+  }
+  json += '}';
+}
+
+std::string spatial_tiles_json(const std::vector<spatial_tile>& tiles, const std::string& content_uri)
+{
+  std::string json = "{\"asset\":{\"version\":\"1.1\"},\"geometricError\":";
+  append_number(json, tiles.empty() ? 0.0 : tiles[0].geometric_error);
+  json += ",\"root\":";
+  if (tiles.empty())
+    json += "null";
+  else
+    append_tile(json, tiles, 0, content_uri);
+  json += '}';
+  return json;
+}
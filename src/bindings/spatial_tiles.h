@@ -0,0 +1,72 @@
+//
+//  Spatial tile hierarchies for streaming large meshes and point clouds.
+//
+//  Items (faces, points) are split at the median of their centers along
+//  the longest axis until every tile is small enough, which gives a k-d
+//  tree of tiles with balanced item counts. The hierarchy is written as a
+//  3D Tiles 1.1 tileset; payloads are left to the caller.
+//
+//  Split tiles hand all their items to their children, so on its own the
+//  hierarchy streams by location only: tiles without content get a
+//  geometric error that makes viewers refine them at any distance, and
+//  there is no level of detail. Callers that want one give split tiles a
+//  coarse version of their descendants (see BND_Mesh::SplitIntoTiles with
+//  levelOfDetail, or point_lod_octree for point clouds), set lod_content
+//  and replace geometric_error with the error of that version.
+//
+
+#ifndef SPATIAL_TILES_H_3C71E0A8_94B2_4F5D_A6E3_1B8D27C9F046
+#define SPATIAL_TILES_H_3C71E0A8_94B2_4F5D_A6E3_1B8D27C9F046
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct spatial_tile
+{
+  // bounds of all items in the tile and its descendants
+  double min[3];
+  double max[3];
+  int parent = -1;
+  // children are consecutive tiles; -1 when there are none
+  int first_child = -1;
+  int child_count = 0;
+  int depth = 0;
+  // content of the tile itself, a range of the item order
+  size_t begin = 0;
+  size_t end = 0;
+  // size of the largest detail missing when the tile is drawn without its
+  // descendants, in model units; very large for tiles without content
+  double geometric_error = 0.0;
+  // the tile has content besides its item range: a coarse version of its
+  // descendants that they replace when refined
+  bool lod_content = false;
+};
+
+struct spatial_tiles_options
+{
+  // tiles are split while the summed weight of their items is larger; 0
+  // puts no limit on weight
+  double max_weight = 0.0;
+  // tiles are split while their largest extent is larger; 0 puts no limit
+  // on size
+  double max_extent = 0.0;
+  int max_depth = 32;
+};
+
+// centers holds x,y,z for item_count items. bounds (min x,y,z then max
+// x,y,z per item) and weights are optional; items default to their center
+// and a weight of 1. Items end up in the leaves only. order receives the
+// item indices tile ranges refer to. Tile 0 is the root and every tile
+// comes after its parent.
+std::vector<spatial_tile> spatial_tiles_build(const double* centers, const double* bounds, const double* weights,
+  size_t item_count, const spatial_tiles_options& options, std::vector<unsigned int>& order);
+
+// 3D Tiles 1.1 tileset JSON for tiles. Every tile with content gets
+// content_uri with "{index}" replaced by its tile index. Tiles refine by
+// adding to their parent, or by replacing it when the root has
+// lod_content. Coordinates are written as they are, z up, without a root
+// transform.
+std::string spatial_tiles_json(const std::vector<spatial_tile>& tiles, const std::string& content_uri);
+
+#endif /* SPATIAL_TILES_H_3C71E0A8_94B2_4F5D_A6E3_1B8D27C9F046 */
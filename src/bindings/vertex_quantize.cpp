@@ -0,0 +1,72 @@
+/*
+   vertex_quantize.cpp and vertex_quantize.h
+
+   Half float conversion and octahedral normal encoding.
+*/
+
+#include "vertex_quantize.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+unsigned short float_to_half(float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000;
+  const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+  // NaN keeps a quiet payload bit, infinity stays infinity
+  if (magnitude >= 0x7F800000)
+    return (unsigned short)(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0));
+  // 65520 and above round to infinity
+  if (magnitude >= 0x477FF000)
+    return (unsigned short)(sign | 0x7C00);
+  // below half the smallest subnormal half
+  if (magnitude < 0x33000001)
+    return (unsigned short)sign;
+
+  const uint32_t exponent = magnitude >> 23;
+  uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+  uint32_t shift;
+  uint32_t half;
+  if (exponent < 113)
+  {
+    // subnormal half: the implicit bit moves into the mantissa
+    shift = 126 - exponent;
+    half = mantissa >> shift;
+  }
+  else
+  {
+    shift = 13;
+    half = ((exponent - 112) << 10) | ((mantissa >> 13) & 0x3FF);
+  }
+  // round to nearest, ties to even; a carry into the exponent is correct
+  const uint32_t remainder = mantissa & ((1u << shift) - 1);
+  const uint32_t halfway = 1u << (shift - 1);
+  if (remainder > halfway || (remainder == halfway && (half & 1)))
+    half++;
+  return (unsigned short)(sign | half);
+}
+
+void octahedral_encode(float x, float y, float z, int bits, int e[2])
+{
+  const double scale = (double)((1 << (bits - 1)) - 1);
+  const double l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+  double u = 0.0, v = 0.0;
+  if (l1 > 0.0)
+  {
+    u = x / l1;
+    v = y / l1;
+    if (z < 0.0f)
+    {
+      const double fu = (1.0 - std::fabs(v)) * (u >= 0.0 ? 1.0 : -1.0);
+      const double fv = (1.0 - std::fabs(u)) * (v >= 0.0 ? 1.0 : -1.0);
+      u = fu;
+      v = fv;
+    }
+  }
+  e[0] = (int)std::floor(u * scale + 0.5);
+  e[1] = (int)std::floor(v * scale + 0.5);
+}
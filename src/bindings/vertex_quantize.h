@@ -0,0 +1,27 @@
+//
+//  Compact vertex attribute encodings for GPU upload.
+//
+//  Half floats are IEEE 754 binary16 (WebGL HALF_FLOAT, numpy float16).
+//  Octahedral normals fold the unit sphere onto the [-1,1] square (Meyer
+//  et al. 2010), so two signed normalized integers hold a direction with
+//  nearly uniform error. A shader decodes them as
+//
+//    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+//    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+//    n = normalize(n);
+//
+//  where e is the snorm pair scaled back to [-1,1].
+//
+
+#ifndef VERTEX_QUANTIZE_H_0E6B93D4_21C8_4A7F_BD53_F84A1C2E79B6
+#define VERTEX_QUANTIZE_H_0E6B93D4_21C8_4A7F_BD53_F84A1C2E79B6
+
+// round to nearest even; out of range values become infinity
+unsigned short float_to_half(float value);
+
+// e receives the octahedral encoding of (x, y, z) as signed integers in
+// [-(2^(bits-1) - 1), 2^(bits-1) - 1]; bits is 2 to 16. A zero vector
+// encodes as +Z.
+void octahedral_encode(float x, float y, float z, int bits, int e[2]);
+
+#endif /* VERTEX_QUANTIZE_H_0E6B93D4_21C8_4A7F_BD53_F84A1C2E79B6 */
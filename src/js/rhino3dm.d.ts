@@ -42,6 +42,13 @@ declare module 'rhino3dm' {
 		CenterOfEarth
 	}
 
+	enum BitmapPixelFormat {
+		Rgba8,
+		Bgra8,
+		Rgb8,
+		Gray8
+	}
+
 	enum BlendContinuity {
 		Position,
 		Tangency,
@@ -168,6 +175,22 @@ declare module 'rhino3dm' {
 		Hemispherical
 	}
 
+	enum HiddenLineSegmentType {
+		Unset,
+		Curve,
+		Boundary,
+		Crease,
+		Tangent,
+		Silhouette
+	}
+
+	enum HiddenLineSegmentVisibility {
+		Unset,
+		Visible,
+		Hidden,
+		Clipped
+	}
+
 	enum InstanceDefinitionUpdateType {
 		Static,
 		Embedded,
@@ -346,6 +369,14 @@ declare module 'rhino3dm' {
 		Overlap
 	}
 
+	enum SubDToBrepVertexProcess {
+		None,
+		LocalG1,
+		LocalG2,
+		LocalG1x,
+		LocalG1xx
+	}
+
 	enum TextureType {
 		None,
 		Bitmap,
@@ -428,6 +459,7 @@ declare module 'rhino3dm' {
 		AnnotationType: typeof AnnotationType
 		ArrowheadTypes: typeof ArrowheadTypes
 		BasepointZero: typeof BasepointZero
+		BitmapPixelFormat: typeof BitmapPixelFormat
 		BlendContinuity: typeof BlendContinuity
 		ComponentIndexType: typeof ComponentIndexType
 		CoordinateSystem: typeof CoordinateSystem
@@ -442,6 +474,8 @@ declare module 'rhino3dm' {
 		DisplacementSweepResolutionFormulas: typeof DisplacementSweepResolutionFormulas
 		DitheringMethods: typeof DitheringMethods
 		EnvironmentBackgroundProjections: typeof EnvironmentBackgroundProjections
+		HiddenLineSegmentType: typeof HiddenLineSegmentType
+		HiddenLineSegmentVisibility: typeof HiddenLineSegmentVisibility
 		InstanceDefinitionUpdateType: typeof InstanceDefinitionUpdateType
 		LightStyle: typeof LightStyle
 		LineCircleIntersection: typeof LineCircleIntersection
@@ -464,12 +498,14 @@ declare module 'rhino3dm' {
 		RegionContainment: typeof RegionContainment
 		RenderChannelsModes: typeof RenderChannelsModes
 		SphereSphereIntersection: typeof SphereSphereIntersection
+		SubDToBrepVertexProcess: typeof SubDToBrepVertexProcess
 		TextureType: typeof TextureType
 		TextureUvwWrapping: typeof TextureUvwWrapping
 		TransformRigidType: typeof TransformRigidType
 		TransformSimilarityType: typeof TransformSimilarityType
 		UnitSystem: typeof UnitSystem
 		AnnotationBase: typeof AnnotationBase;
+		AnnotationTessellation: typeof AnnotationTessellation;
 		Arc: typeof Arc;
 		ArcCurve: typeof ArcCurve;
 		ArchivableDictionary: typeof ArchivableDictionary;
@@ -519,6 +555,7 @@ declare module 'rhino3dm' {
 		File3dmDecalTable: typeof File3dmDecalTable;
 		File3dmDimStyleTable: typeof File3dmDimStyleTable;
 		File3dmEmbeddedFileTable: typeof File3dmEmbeddedFileTable;
+		File3dmGlbOptions: typeof File3dmGlbOptions;
 		File3dmGroupTable: typeof File3dmGroupTable;
 		File3dmInstanceDefinitionTable: typeof File3dmInstanceDefinitionTable;
 		File3dmLayerTable: typeof File3dmLayerTable;
@@ -543,6 +580,8 @@ declare module 'rhino3dm' {
 		GroundPlane: typeof GroundPlane;
 		Group: typeof Group;
 		Hatch: typeof Hatch;
+		HiddenLineDrawing: typeof HiddenLineDrawing;
+		HiddenLineDrawingParameters: typeof HiddenLineDrawingParameters;
 		InstanceDefinition: typeof InstanceDefinition;
 		InstanceReference: typeof InstanceReference;
 		Intersection: typeof Intersection;
@@ -597,6 +636,9 @@ declare module 'rhino3dm' {
 		Skylight: typeof Skylight;
 		Sphere: typeof Sphere;
 		SubD: typeof SubD;
+		SubDSurfaceMeshBuffers: typeof SubDSurfaceMeshBuffers;
+		SubDToBrepParameters: typeof SubDToBrepParameters;
+		SubDToBrepResults: typeof SubDToBrepResults;
 		Sun: typeof Sun;
 		Surface: typeof Surface;
 		SurfaceProxy: typeof SurfaceProxy;
@@ -649,6 +691,98 @@ declare module 'rhino3dm' {
 		wrapText(): void;
 	}
 
+	class AnnotationTessellation {
+		/**
+		 * Number of vertices in the filled glyph triangles.
+		 */
+		vertexCount: number;
+		/**
+		 * Number of filled glyph triangles.
+		 */
+		triangleCount: number;
+		/**
+		 * Packed x,y,z world coordinates of the triangle vertices.
+		 */
+		vertices: Float32Array;
+		/**
+		 * Three vertex indices per triangle.
+		 */
+		indices: Uint32Array;
+		/**
+		 * Index into sourceIds for each triangle.
+		 */
+		triangleSourceIndices: Uint32Array;
+		/**
+		 * Number of outline polylines (fill is false or the font is a single stroke font).
+		 */
+		polylineCount: number;
+		/**
+		 * Number of points in all polylines.
+		 */
+		pointCount: number;
+		/**
+		 * Packed x,y,z world coordinates of all polyline points.
+		 * Closed outlines repeat their first point at the end.
+		 */
+		points: Float32Array;
+		/**
+		 * Point offsets into points (in x,y,z triples), polylineCount + 1 entries.
+		 */
+		polylineOffsets: Int32Array;
+		/**
+		 * Index into sourceIds for each polyline.
+		 */
+		polylineSourceIndices: Uint32Array;
+		/**
+		 * Ids of the annotation objects that produced geometry.
+		 */
+		sourceIds: string[];
+		/**
+		 * Number of glyphs placed.
+		 */
+		glyphCount: number;
+		/**
+		 * Number of distinct glyph shapes used; each was tessellated once.
+		 */
+		uniqueGlyphCount: number;
+		/**
+		 * Bounding box of all triangles and polylines.
+		 */
+		boundingBox: BoundingBox;
+		/**
+		 * @description Tessellates the text of every visible text, leader and
+		 * dimension object in the model, including those inside blocks.
+		 * @param {File3dm} file3dm
+		 * @param {boolean} fill Triangles when true, outline polylines when false.
+		 * @param {number} tolerance Chordal tolerance as a fraction of the capital letter height.
+		 * @returns {AnnotationTessellation}
+		 */
+		static fromFile3dm(file3dm: File3dm, fill: boolean, tolerance: number): AnnotationTessellation;
+		/**
+		 * @description Tessellates the text of one annotation.
+		 * @param {AnnotationBase} annotation
+		 * @param {DimensionStyle} dimstyle Parent dimension style, may be null.
+		 * @param {boolean} fill Triangles when true, outline polylines when false.
+		 * @param {number} tolerance Chordal tolerance as a fraction of the capital letter height.
+		 * @returns {AnnotationTessellation}
+		 */
+		static fromAnnotation(annotation: AnnotationBase, dimstyle: DimensionStyle, fill: boolean, tolerance: number): AnnotationTessellation;
+		/**
+		 * @description Frees all cached glyph tessellations.
+		 */
+		static clearGlyphCache(): void;
+		/**
+		 * @description Number of glyph tessellations in the shared cache.
+		 */
+		static glyphCacheCount(): number;
+		/**
+		 * @description True when this build has a font engine for glyph outlines.
+		 * Without one (no FreeType on Linux and web assembly) glyphs are counted
+		 * but produce no triangles or polylines.
+		 */
+		static glyphOutlinesAvailable(): boolean;
+	}
+
 	class Arc {
 		/**
 		 * Gets a value indicating whether or not this arc is valid.
@@ -935,6 +1069,14 @@ declare module 'rhino3dm' {
 	}
 
 	class Bitmap extends CommonObject {
+		constructor();
+		/**
+		 * @description Uncompressed Windows DIB, scan lines stored bottom row first.
+		 * @param {number} width
+		 * @param {number} height
+		 * @param {number} bitsPerPixel 1, 4, 8, 24 or 32.
+		 */
+		constructor(width: number, height: number, bitsPerPixel: number);
 		/**
 		 */
 		width: number;
@@ -953,6 +1095,19 @@ declare module 'rhino3dm' {
 		/**
 		 */
 		id: string;
+		/**
+		 * @description Pixels converted to 8 bit channels, top row first.
+		 * Empty for bitmaps that are file references or compressed images.
+		 * @param {BitmapPixelFormat} format
+		 * @returns {Uint8Array}
+		 */
+		toPixels(format: BitmapPixelFormat): Uint8Array;
+		/**
+		 * @description View over the uncompressed DIB scan lines without a copy.
+		 * Only valid until the bitmap is deleted or wasm memory grows.
+		 * @returns {Uint8Array}
+		 */
+		bits(): Uint8Array;
 	}
 
 	class BoundingBox {
@@ -1558,6 +1713,42 @@ declare module 'rhino3dm' {
 		 * @returns {CommonObject}
 		*/
 		static decode(json:object): CommonObject;
+		/**
+		 * @description Binary form of encode(): the object as one 3dm buffer archive behind a small header, no base64.
+		 * @returns {Uint8Array}
+		 */
+		encodeBinary(): Uint8Array;
+		/**
+		 * @description Pack many objects into one buffer with an offset index so single objects can be decoded with decodeAt.
+		 * @param {CommonObject[]} objects
+		 * @returns {Uint8Array}
+		 */
+		static encodeMany(objects: CommonObject[]): Uint8Array;
+		/**
+		 * @description Decodes the output of encodeBinary (or the first object of encodeMany).
+		 * @param {Uint8Array} buffer
+		 * @returns {CommonObject} null if the buffer is not valid.
+		 */
+		static decodeBinary(buffer: Uint8Array): CommonObject;
+		/**
+		 * @description Decodes every object written by encodeMany.
+		 * @param {Uint8Array} buffer
+		 * @returns {CommonObject[]}
+		 */
+		static decodeMany(buffer: Uint8Array): CommonObject[];
+		/**
+		 * @description Decodes a single object from an encodeMany buffer without reading the others.
+		 * @param {Uint8Array} buffer
+		 * @param {number} index
+		 * @returns {CommonObject}
+		 */
+		static decodeAt(buffer: Uint8Array, index: number): CommonObject;
+		/**
+		 * @description Number of objects in an encodeBinary / encodeMany buffer, -1 if the buffer is not valid.
+		 * @param {Uint8Array} buffer
+		 * @returns {number}
+		 */
+		static encodedCount(buffer: Uint8Array): number;
 		/**
 		 * @description Attach a user string (key,value combination) to this geometry.
 		 * @param {string} key id used to retrieve this string.
@@ -2224,6 +2415,10 @@ declare module 'rhino3dm' {
 		/**
 		 */
 		baselineSpacing: number;
+		/**
+		 * Model space scale applied to text and other annotation sizes.
+		 */
+		dimensionScale: number;
 		/**
 		 */
 		textRotation: number;
@@ -2813,6 +3008,15 @@ declare module 'rhino3dm' {
 		 * @returns {File3dm} New File3dm on success, null on error.
 		 */
 		static fromByteArray(buffer: Uint8Array): File3dm;
+		/**
+		 * @description Read a 3dm file from a byte array and report where the time went.
+		The report holds totalSeconds, totalBytes, per table seconds/bytes/count,
+		per object class totals, the slowest objects by id and the error log.
+		 * @param {Uint8Array} buffer
+		 * @param {number} slowestCount Number of slowest objects to list in the report.
+		 * @returns {[File3dm, object]} New File3dm (null on error) and the report.
+		 */
+		static fromByteArrayWithProfile(buffer: Uint8Array, slowestCount: number): [File3dm, object];
 		/** ... */
 		settings(): File3dmSettings;
 		/** ... */
@@ -2854,6 +3058,32 @@ declare module 'rhino3dm' {
 		toByteArray(): Uint8Array;
 		/** ... */
 		toByteArrayOptions(options:File3dmWriteOptions): Uint8Array;
+		/**
+		 * @description Write to an in-memory byte[] and report per table seconds and bytes.
+		 * @param {File3dmWriteOptions} options Pass null for defaults.
+		 * @returns {[Uint8Array, object]} The 3dm bytes and the report.
+		 */
+		toByteArrayWithProfile(options:File3dmWriteOptions): [Uint8Array, object];
+		/**
+		 * @description Report the memory held by this model: bytes per table and per
+		object class, render meshes, user data and embedded files (including RDK
+		embedded textures) listed separately, plus the largest objects by id.
+		 * @param {number} largestCount Number of largest objects to list.
+		 * @returns {object}
+		 */
+		memoryReport(largestCount: number): object;
+		/**
+		 * @description Export render meshes, materials and instance references as binary glTF (GLB).
+		Meshes placed more than once share one glTF mesh.
+		 * @returns {Uint8Array} The .glb file contents.
+		 */
+		toGlb(): Uint8Array;
+		/**
+		 * @description Export render meshes, materials and instance references as binary glTF (GLB).
+		 * @param {File3dmGlbOptions} options Instancing, quantization and Draco settings.
+		 * @returns {Uint8Array} The .glb file contents.
+		 */
+		toGlbOptions(options: File3dmGlbOptions): Uint8Array;
 		/**
 		 * @description Creates a File3dm object from a string encoded File3dm
 		 * @param {string} buffer
@@ -2866,6 +3096,14 @@ declare module 'rhino3dm' {
 		getEmbeddedFileAsBase64(path: string): void;
 		/** ... */
 		getEmbeddedFileAsBase64Strict(path:string, string:boolean): void;
+		/**
+		 * @description Uncompressed bytes of an embedded file, without base64 encoding.
+		 * Files are looked up in an index built the first time one is requested.
+		 * @param {string} path Full path or, when strict is false, just the file name
+		 * @param {boolean} strict Require an exact, case sensitive path match
+		 * @returns {Uint8Array} Empty when no file matches
+		 */
+		getEmbeddedFileBytes(path: string, strict: boolean): Uint8Array;
 		/** ... */
 		rdkXml(): string;
 	}
@@ -2882,6 +3120,14 @@ declare module 'rhino3dm' {
 		delete(id:string): boolean;
 		/** ... */
 		findIndex(index:number): Bitmap;
+		/**
+		 * @description Converts every bitmap in the table, in table order.
+		 * Entries are null for bitmaps without uncompressed pixels.
+		 * @param {BitmapPixelFormat} format
+		 * @param {number} threadCount Ignored in web assembly builds
+		 * @returns {Uint8Array[]}
+		 */
+		toPixels(format: BitmapPixelFormat, threadCount: number): Uint8Array[];
 		/** ... */
 		findId(id:string): Bitmap;
 	}
@@ -2929,6 +3175,37 @@ declare module 'rhino3dm' {
 		findIndex(index:number): EmbeddedFile;
 	}
 
+	class File3dmGlbOptions {
+		/**
+		 * @description Rotate the scene so Rhino's Z-up becomes glTF's Y-up. Default true.
+		 */
+		mapZToY: boolean;
+		/**
+		 * @description Write PBR metallic-roughness materials. Default true.
+		 */
+		exportMaterials: boolean;
+		/**
+		 * @description Use EXT_mesh_gpu_instancing for meshes placed more than once. Default true.
+		 */
+		useGpuInstancing: boolean;
+		/**
+		 * @description Store positions and normals as 16 and 8 bit integers (KHR_mesh_quantization). Default false.
+		 */
+		quantizeAttributes: boolean;
+		/**
+		 * @description Compress meshes with KHR_draco_mesh_compression. Takes precedence over quantizeAttributes. Default false.
+		 */
+		useDracoCompression: boolean;
+		/**
+		 * @description Settings used when useDracoCompression is true.
+		 */
+		dracoOptions: DracoCompressionOptions;
+		/**
+		 * @description Reorder triangles for the vertex cache and overdraw, and vertices in order of first use. Default false.
+		 */
+		optimizeMeshes: boolean;
+	}
+
 	class File3dmGroupTable {
 		/**
 		 */
@@ -3414,6 +3691,15 @@ declare module 'rhino3dm' {
 		 * Include custom user data in the file. Default is true
 		 */
 		saveUserData: boolean;
+		/**
+		 * zlib compression of the file's compressed buffers. true (the default)
+		 * uses the opennurbs level, false stores the buffers uncompressed.
+		 */
+		compressBuffers: boolean;
+		/**
+		 * Number of threads used to serialize objects. Always 1 in web assembly builds.
+		 */
+		threadCount: number;
 	}
 
 	class FileReference {
@@ -3513,6 +3799,14 @@ declare module 'rhino3dm' {
 		 * @returns {boolean} true if geometry successfully transformed.
 		 */
 		transform(xform:Transform): boolean;
+		/**
+		 * @description Transforms many geometries in one call.
+		 * @param {GeometryBase[]} geometries Geometry to transform.
+		 * @param {Transform[]} xforms One transform per geometry, or a single transform
+		applied to all of them.
+		 * @returns {number} The number of geometries that were transformed.
+		 */
+		static transformMany(geometries:GeometryBase[], xforms:Transform[]): number;
 		/**
 		 * @description Translates the object along the specified vector.
 		 * @param {number[]} translationVector A moving vector.
@@ -3646,6 +3940,106 @@ declare module 'rhino3dm' {
 		scalePattern(): void;
 	}
 
+	class HiddenLineDrawing {
+		/**
+		 * Number of polylines in the drawing.
+		 */
+		polylineCount: number;
+		/**
+		 * Number of points in all polylines.
+		 */
+		pointCount: number;
+		/**
+		 * Packed x,y pairs of all polylines in view plane coordinates
+		 * (x along the camera x axis, y along the camera y axis).
+		 */
+		points: Float64Array;
+		/**
+		 * Point offsets into points (in x,y pairs), polylineCount + 1 entries.
+		 * Polyline i uses points polylineOffsets[i] to polylineOffsets[i+1]-1.
+		 */
+		polylineOffsets: Int32Array;
+		/**
+		 * HiddenLineSegmentVisibility value for each polyline.
+		 */
+		visibility: Uint8Array;
+		/**
+		 * HiddenLineSegmentType value for each polyline.
+		 */
+		segmentTypes: Uint8Array;
+		/**
+		 * Index into sourceIds for each polyline.
+		 */
+		sourceIndices: Int32Array;
+		/**
+		 * Ids of the objects the polylines were computed from.
+		 */
+		sourceIds: string[];
+		/**
+		 * Bounding box of all polylines in view plane coordinates.
+		 */
+		boundingBox: BoundingBox;
+		/**
+		 * @description Computes a hidden line drawing. Occlusion is computed
+		 * against the render meshes of breps and extrusions and against meshes.
+		 * @param {HiddenLineDrawingParameters} parameters Objects, viewport and clipping planes.
+		 * @param {boolean} multipleThreads Ignored in web assembly builds.
+		 * @returns {HiddenLineDrawing} The drawing or null if the viewport is not valid.
+		 */
+		static compute(parameters: HiddenLineDrawingParameters, multipleThreads: boolean): HiddenLineDrawing;
+	}
+
+	class HiddenLineDrawingParameters {
+		/**
+		 * Tolerance used to approximate curves and locate visibility changes.
+		 */
+		absoluteTolerance: number;
+		/**
+		 * Include hidden segments in the output. Default is true.
+		 */
+		includeHiddenCurves: boolean;
+		/**
+		 * Include smooth brep edges and seams in the output. Default is false.
+		 */
+		includeTangentEdges: boolean;
+		/**
+		 * Include segments removed by clipping planes in the output. Default is false.
+		 */
+		includeClippedCurves: boolean;
+		/**
+		 * Number of geometry sources added so far.
+		 */
+		sourceCount: number;
+		/**
+		 * @description Sets the viewport that defines the projection.
+		 * @param {ViewportInfo} viewport
+		 * @returns {boolean} false if the viewport does not have a valid camera.
+		 */
+		setViewport(viewport: ViewportInfo): boolean;
+		/**
+		 * @description Adds a clipping plane. Geometry on the side opposite
+		 * the plane normal is clipped.
+		 * @param {Plane} plane
+		 * @returns {void}
+		 */
+		addClippingPlane(plane: Plane): void;
+		/**
+		 * @description Adds a copy of geometry to the drawing.
+		 * @param {GeometryBase} geometry
+		 * @param {Transform} xform Transformation applied to the geometry.
+		 * @param {string} id Source id reported for the resulting polylines.
+		 * @returns {number} Index of the added source or -1 on failure.
+		 */
+		addGeometry(geometry: GeometryBase, xform: Transform, id: string): number;
+		/**
+		 * @description Adds all visible objects on visible layers in a model.
+		 * Instance references are expanded.
+		 * @param {File3dm} file3dm
+		 * @returns {number} Number of objects added.
+		 */
+		addObjects(file3dm: File3dm): number;
+	}
+
 	class InstanceDefinition extends CommonObject {
 		/**
 		 */
@@ -4500,6 +4894,78 @@ declare module 'rhino3dm' {
 		 * @returns {boolean} true on success
 		 */
 		createPartitions(): boolean;
+		/**
+		 * @description Quadric error simplification. Every collapse merges a vertex into one of
+		its neighbours, so the result keeps the normals, texture coordinates and colors of the
+		vertices it uses. Quads are split into triangles.
+		 * @param {number} targetRatio Fraction of the triangles to keep.
+		 * @param {number} targetError Stop before the surface moves further than this; 0 for no limit.
+		 * @param {boolean} preserveBorders Keep open boundaries in place.
+		 * @param {boolean} preserveUVSeams Only collapse vertices on texture or normal seams along the seam.
+		 * @returns {Mesh} A new simplified mesh.
+		 */
+		simplify(targetRatio: number, targetError: number, preserveBorders: boolean, preserveUVSeams: boolean): Mesh;
+		/**
+		 * @description Level of detail chain; every level is simplified from the one before it.
+		 * @param {number} levels Number of meshes to create.
+		 * @param {number} ratio Fraction of the triangles of the previous level to keep.
+		 * @param {boolean} preserveBorders Keep open boundaries in place.
+		 * @param {boolean} preserveUVSeams Only collapse vertices on texture or normal seams along the seam.
+		 * @returns {Mesh[]} levels meshes, most detailed first.
+		 */
+		buildLods(levels: number, ratio: number, preserveBorders: boolean, preserveUVSeams: boolean): Mesh[];
+		/**
+		 * @description Merges vertices closer than tolerance whose normals differ by at most angleTolerance
+		and removes faces that collapse or repeat another face. Vertices with different texture
+		coordinates are never merged. Ngons are removed when the mesh changes.
+		 * @param {number} tolerance Largest distance between merged vertices; 0 merges identical positions only.
+		 * @param {number} angleTolerance Largest angle in radians between merged vertex normals; Math.PI ignores normals.
+		 * @param {number} threadCount Number of threads; ignored in web assembly.
+		 * @returns {boolean} true when the mesh changed.
+		 */
+		weld(tolerance: number, angleTolerance: number, threadCount: number): boolean;
+		/**
+		 * @description Builds the mesh topology once and returns vertex to faces, vertex to vertices,
+		edge to faces and face to edges adjacency as compressed sparse rows.
+		 * @param {number} threadCount Number of threads; ignored in web assembly.
+		 * @returns {MeshAdjacency}
+		 */
+		getAdjacency(threadCount: number): MeshAdjacency;
+		/**
+		 * @description Average cache miss ratio: vertices transformed per triangle when the faces are
+		drawn in order through a FIFO vertex cache.
+		 * @param {number} cacheSize Number of vertices the cache holds.
+		 * @returns {number}
+		 */
+		computeAcmr(cacheSize: number): number;
+		/**
+		 * @description Reorders faces for the post transform vertex cache (Tipsify), optionally
+		sorts clusters of them to reduce overdraw, and renumbers vertices in order of first use.
+		The order is kept by toThreejsJSON and the other exports.
+		 * @param {boolean} optimizeOverdraw Also order for overdraw at a small cost in cache hits.
+		 * @param {number} cacheSize Number of vertices the cache holds.
+		 * @returns {number[]} ACMR before and after.
+		 */
+		optimizeForGpu(optimizeOverdraw: boolean, cacheSize: number): number[];
+		/**
+		 * @description Vertex attributes in compact encodings for GPU upload: positions as 16 bit
+		integers on a uniform grid over the bounding box, octahedral normals and half float
+		texture coordinates.
+		 * @param {MeshQuantizationOptions} options Encodings to use; null for the defaults.
+		 * @returns {MeshQuantizedBuffers}
+		 */
+		toQuantizedBuffers(options: MeshQuantizationOptions): MeshQuantizedBuffers;
+		/**
+		 * @description Splits the faces into a k-d hierarchy of tiles for streaming. Tiles are
+		split at the median face until neither limit is exceeded; leaf tiles hold their faces as meshes.
+		 * @param {number} maxTriangles Most triangles in a tile, quads counting as two; 0 for no limit.
+		 * @param {number} gridSize Longest side of a tile; 0 for no limit.
+		 * @param {number} threadCount Ignored, tiles are built on the calling thread.
+		 * @param {boolean} levelOfDetail Give inner tiles their children's content simplified to half, refined by replacement.
+		 Without it the tileset streams by location only and has no level of detail.
+		 * @returns {TileSet}
+		 */
+		splitIntoTiles(maxTriangles: number, gridSize: number, threadCount: number, levelOfDetail: boolean): TileSet;
 		/**
 		 * @description Creates a Three.js bufferGeometry from a Rhino mesh.
 		 * @returns {object} A Three.js bufferGeometry.
@@ -4519,6 +4985,61 @@ declare module 'rhino3dm' {
 		static createFromThreejsJSON( object: object ): Mesh;
 	}
 
+	class MeshAdjacency {
+		/**
+		 * Number of topology vertices (coincident mesh vertices joined)
+		 */
+		topologyVertexCount: number;
+		/**
+		 * Number of topology edges
+		 */
+		edgeCount: number;
+		/**
+		 * Number of mesh faces
+		 */
+		faceCount: number;
+		/**
+		 * Topology vertex of each mesh vertex
+		 */
+		vertexMap: Uint32Array;
+		/**
+		 * Two topology vertices per edge
+		 */
+		edgeVertices: Uint32Array;
+		/**
+		 * topologyVertexCount + 1 offsets into vertexFaces
+		 */
+		vertexFacesOffsets: Uint32Array;
+		/**
+		 * Faces around each topology vertex, sorted
+		 */
+		vertexFaces: Uint32Array;
+		/**
+		 * topologyVertexCount + 1 offsets into vertexVertices
+		 */
+		vertexVerticesOffsets: Uint32Array;
+		/**
+		 * Topology vertices sharing an edge with each topology vertex
+		 */
+		vertexVertices: Uint32Array;
+		/**
+		 * edgeCount + 1 offsets into edgeFaces
+		 */
+		edgeFacesOffsets: Uint32Array;
+		/**
+		 * Faces on each edge
+		 */
+		edgeFaces: Uint32Array;
+		/**
+		 * faceCount + 1 offsets into faceEdges
+		 */
+		faceEdgesOffsets: Uint32Array;
+		/**
+		 * Three or four edges per face in face order
+		 */
+		faceEdges: Uint32Array;
+	}
+
 	class MeshFaceList {
 		/**
 		 * Gets or sets the number of mesh faces. When getting this can includes invalid faces.
@@ -4769,6 +5290,59 @@ declare module 'rhino3dm' {
 		static decode(json:object): MeshingParameters;
 	}
 
+	class MeshQuantizationOptions {
+		constructor();
+		/**
+		 * @description Uint16 positions from the bounding box minimum instead of Int16 around its center. Default false.
+		 */
+		unsignedPositions: boolean;
+		/**
+		 * @description Octahedral normal precision, 2 to 16. Int8Array pairs up to 8 bits, Int16Array above. Default 8.
+		 */
+		normalBits: number;
+		/**
+		 * @description Texture coordinates as half floats (Uint16Array bits) instead of Float32Array. Default true.
+		 */
+		halfFloatTextureCoordinates: boolean;
+	}
+
+	class MeshQuantizedBuffers {
+		/**
+		 */
+		vertexCount: number;
+		/**
+		 */
+		triangleCount: number;
+		/**
+		 * Bits per octahedral normal component
+		 */
+		normalBits: number;
+		/**
+		 * x,y,z of each vertex as Int16Array or Uint16Array grid coordinates
+		 */
+		positions: Int16Array | Uint16Array;
+		/**
+		 * Octahedral u,v of each vertex normal as signed normalized integers; empty without normals
+		 */
+		normals: Int8Array | Int16Array;
+		/**
+		 * u,v of each vertex as half float bits or floats; empty without texture coordinates
+		 */
+		textureCoordinates: Uint16Array | Float32Array;
+		/**
+		 * r,g,b,a of each vertex; empty without vertex colors
+		 */
+		colors: Uint8Array;
+		/**
+		 * Three vertex indices per triangle, Uint16Array up to 65535 vertices
+		 */
+		indices: Uint16Array | Uint32Array;
+		/**
+		 * Maps the integer positions back to model coordinates
+		 */
+		dequantizationTransform: Transform;
+	}
+
 	class MeshNormalList {
 		/**
 		 */
@@ -5816,6 +6390,50 @@ declare module 'rhino3dm' {
 		 * @returns {number} Index of point in the point cloud on success. -1 on failure.
 		 */
 		closestPoint(testPoint:number[]): number;
+		/**
+		 * @description Splits the points into a k-d hierarchy of tiles for streaming; leaf tiles
+		hold their points as point clouds.
+		 * @param {number} maxPoints Most points in a tile.
+		 * @param {number} threadCount Ignored, tiles are built on the calling thread.
+		 * @returns {TileSet}
+		 */
+		buildTiles(maxPoints: number, threadCount: number): TileSet;
+		/**
+		 * @description New point cloud with one point per occupied cube of cellSize, averaging the
+		position, normal, color and value of the visible points in it.
+		 * @param {number} cellSize Edge length of the cubes.
+		 * @param {number} threadCount Ignored, runs on the calling thread.
+		 * @returns {PointCloud}
+		 */
+		voxelDownsample(cellSize: number, threadCount: number): PointCloud;
+		/**
+		 * @description Potree style level of detail octree. Every tile holds an evenly spread subset
+		of at most maxPointsPerNode points and its children add the rest (3D Tiles refine ADD).
+		 * @param {number} maxPointsPerNode Most points in a tile.
+		 * @param {number} threadCount Ignored, runs on the calling thread.
+		 * @returns {TileSet}
+		 */
+		buildLodOctree(maxPointsPerNode: number, threadCount: number): TileSet;
+		/**
+		 * @description Fits a plane to the neighbourhood of every point (PCA) and writes its unit normal
+		to the point normals. Normals face orientTowards when it is valid, else keep the side of the
+		current normals, else point away from the bounding box center.
+		 * @param {number} k Number of nearest points to fit.
+		 * @param {number} radius When larger than 0, fit all points within this distance instead.
+		 * @param {number[]} orientTowards Viewpoint, such as the scanner position; an unset point for none.
+		 * @param {number} threadCount Ignored, runs on the calling thread.
+		 * @returns {boolean} false when the point cloud is empty.
+		 */
+		estimateNormals(k: number, radius: number, orientTowards: number[], threadCount: number): boolean;
+		/**
+		 * @description Hides points whose mean distance to their k nearest neighbours is more than
+		stdRatio standard deviations above the average over all points.
+		 * @param {number} k Number of neighbours to measure.
+		 * @param {number} stdRatio Standard deviations above the mean that still count as inliers.
+		 * @param {number} threadCount Ignored, runs on the calling thread.
+		 * @returns {number} Number of outliers found.
+		 */
+		removeStatisticalOutliers(k: number, stdRatio: number, threadCount: number): number;
 		/**
 		 * @description Converts a Rhino point cloud to a Three.js bufferGeometry
 		 * @returns {object} A Three.js bufferGeometry.
@@ -6656,6 +7274,89 @@ declare module 'rhino3dm' {
 		 * @returns {boolean} true on success
 		 */
 		subdivide(): boolean;
+		/**
+		 * @description Creates a SubD with the mesh as its control net.
+		 * @param {Mesh} mesh Control net.
+		 * @returns {SubD} A new SubD or null on failure.
+		 */
+		static createFromMesh(mesh: Mesh): SubD;
+		/**
+		 * @description Gets the limit surface mesh as packed buffers.
+		 * @param {number} density Display density from 1 (coarse) to 6 (fine). Each SubD quad
+		is divided into 2^density x 2^density mesh quads.
+		 * @param {boolean} multipleThreads Ignored in web assembly builds.
+		 * @returns {SubDSurfaceMeshBuffers}
+		 */
+		getSurfaceMeshBuffers(density: number, multipleThreads: boolean): SubDSurfaceMeshBuffers;
+		/**
+		 * @description Converts the limit surface of this SubD to a brep.
+		 * @param {SubDToBrepParameters} parameters Conversion options. Pass null for defaults.
+		 * @returns {Brep} A new brep or null on failure.
+		 */
+		toBrep(parameters: SubDToBrepParameters): Brep;
+		/**
+		 * @description Converts many SubDs to breps in one call and times each conversion.
+		 * @param {SubD[]} subds SubDs to convert.
+		 * @param {SubDToBrepParameters} parameters Conversion options. Pass null for defaults.
+		 * @param {number} threadCount Ignored in web assembly builds.
+		 * @returns {SubDToBrepResults}
+		 */
+		static toBrepMany(subds: SubD[], parameters: SubDToBrepParameters, threadCount: number): SubDToBrepResults;
+	}
+
+	class SubDSurfaceMeshBuffers {
+		/**
+		 */
+		vertexCount: number;
+		/**
+		 */
+		triangleCount: number;
+		/**
+		 * x,y,z of each vertex
+		 */
+		positions: Float32Array;
+		/**
+		 * x,y,z of each vertex normal
+		 */
+		normals: Float32Array;
+		/**
+		 * Three vertex indices per triangle
+		 */
+		indices: Uint32Array;
+		/**
+		 * Id of the SubD face each triangle belongs to
+		 */
+		faceIds: Uint32Array;
+	}
+
+	class SubDToBrepParameters {
+		constructor();
+		/**
+		 * Pack adjacent SubD faces into a single brep face where possible.
+		 */
+		packFaces: boolean;
+		/**
+		 * Treatment of the surface around extraordinary vertices.
+		 */
+		extraordinaryVertexProcess: SubDToBrepVertexProcess;
+	}
+
+	class SubDToBrepResults {
+		/**
+		 */
+		count: number;
+		/**
+		 * One brep per input SubD, null where the conversion failed.
+		 */
+		breps: Brep[];
+		/**
+		 * Seconds spent converting each SubD.
+		 */
+		seconds: Float64Array;
+		/**
+		 * Wall clock seconds for the whole batch.
+		 */
+		totalSeconds: number;
 	}
 
 	class Sun {
@@ -7115,6 +7816,58 @@ declare module 'rhino3dm' {
 		bothSides: boolean;
 	}
 
+	class TileSet {
+		/**
+		 * Number of tiles; tile 0 is the root
+		 */
+		tileCount: number;
+		/**
+		 * @description Bounds of a tile and all its descendants.
+		 * @param {number} index Tile index.
+		 * @returns {BoundingBox}
+		 */
+		getBoundingBox(index: number): BoundingBox;
+		/**
+		 * @param {number} index Tile index.
+		 * @returns {number} Parent tile index, -1 for the root.
+		 */
+		getParent(index: number): number;
+		/**
+		 * @param {number} index Tile index.
+		 * @returns {number[]} Child tile indices.
+		 */
+		getChildren(index: number): number[];
+		/**
+		 * @param {number} index Tile index.
+		 * @returns {number} Levels below the root.
+		 */
+		getDepth(index: number): number;
+		/**
+		 * @description Size of the detail missing when the tile is drawn without its children.
+		 * @param {number} index Tile index.
+		 * @returns {number}
+		 */
+		getGeometricError(index: number): number;
+		/**
+		 * @description Source face or point indices in the content of a tile.
+		 * @param {number} index Tile index.
+		 * @returns {Uint32Array}
+		 */
+		getItemIndices(index: number): Uint32Array;
+		/**
+		 * @description Copy of the content of a tile: a Mesh or PointCloud, null for tiles that only group others. Inner tiles of a levelOfDetail split hold a simplified mesh.
+		 * @param {number} index Tile index.
+		 * @returns {GeometryBase}
+		 */
+		getContent(index: number): GeometryBase;
+		/**
+		 * @description 3D Tiles 1.1 tileset JSON for the hierarchy, z up in model units.
+		 * @param {string} contentUri Content uri of every tile with content, "{index}" replaced by the tile index.
+		 * @returns {string}
+		 */
+		toTilesetJson(contentUri: string): string;
+	}
+
 	class Transform {
 		/**
 		 * Tests for an affine transformation.
@@ -7329,6 +8082,16 @@ declare module 'rhino3dm' {
 		 * @returns {number[]} An array of 16 floats.
 		 */
 		toFloatArray(rowDominant:boolean): number[];
+		/**
+		 * @description Transforms a packed array of x,y,z values. Float32Array input stays
+		Float32Array; anything else is treated as 64 bit values. The math is done
+		in double precision and affine transforms skip the homogeneous divide.
+		 * @param {Float32Array | Float64Array | number[]} points x,y,z triples.
+		 * @param {boolean} inPlace If true, points is modified and returned. If false,
+		a new typed array holding the transformed points is returned.
+		 * @returns {Float32Array | Float64Array | number[]} The transformed points.
+		 */
+		applyToPoints(points:Float32Array | Float64Array | number[], inPlace:boolean): Float32Array | Float64Array | number[];
 	}
 
 	class ViewInfo {
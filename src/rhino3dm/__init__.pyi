@@ -75,7 +75,30 @@ class BezierCurve:
     def IncreaseDegree(self, desiredDegree: int) -> bool: ...
     def ChangeDimension(self, desiredDimension: int) -> bool: ...
 
-class Bitmap: ...
+class Bitmap:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, width: int, height: int, bitsPerPixel: int = 32) -> None: ...
+    @property
+    def Width(self) -> int: ...
+    @property
+    def Height(self) -> int: ...
+    @property
+    def BitsPerPixel(self) -> int: ...
+    @property
+    def SizeOfScan(self) -> int: ...
+    @property
+    def SizeOfImage(self) -> int: ...
+    @property
+    def Id(self) -> UUID: ...
+    def ToPixels(self, format: BitmapPixelFormat = BitmapPixelFormat.Rgba8) -> memoryview: ...
+
+class BitmapPixelFormat(Enum):
+    Rgba8 = 0
+    Bgra8 = 1
+    Rgb8 = 2
+    Gray8 = 3
 
 class BoundingBox:
     @overload
@@ -155,6 +178,23 @@ class Circle:
 class CommonObject:
     def Encode(self) -> dict[str, Any]: ...
 
+    def EncodeBinary(self) -> bytes: ...
+
+    @staticmethod
+    def EncodeMany(objects: list[CommonObject]) -> bytes: ...
+
+    @staticmethod
+    def DecodeBinary(buffer: bytes) -> CommonObject: ...
+
+    @staticmethod
+    def DecodeMany(buffer: bytes) -> tuple[CommonObject, ...]: ...
+
+    @staticmethod
+    def DecodeAt(buffer: bytes, index: int) -> CommonObject: ...
+
+    @staticmethod
+    def EncodedCount(buffer: bytes) -> int: ...
+
     def GetUserString(self, key: str) -> str: ...
 
     def GetUserStrings(self) -> tuple[tuple[str, str]]: ...
@@ -352,13 +392,58 @@ class File3dm:
     def ReadArchiveVersion(path: str) -> int: ...
     @staticmethod
     def FromByteArray(bytes: List[byte]) -> File3dm: ...
-    def Write(self, path: str, version: int) -> bool: ...
+    @staticmethod
+    def ReadWithProfile(path: str, slowestCount: int = 10) -> tuple[File3dm, dict]: ...
+    @staticmethod
+    def FromByteArrayWithProfile(buffer: bytes, slowestCount: int = 10) -> tuple[File3dm, dict]: ...
+    @overload
+    def Write(self, path: str, version: int = 0) -> bool: ...
+    @overload
+    def Write(self, path: str, options: File3dmWriteOptions) -> bool: ...
+    def WriteWithProfile(self, path: str, version: int = 0) -> tuple[bool, dict]: ...
+    def MemoryReport(self, largestCount: int = 10) -> dict: ...
+    def ToGlb(self, options: File3dmGlbOptions = None) -> bytes: ...
+    def WriteGlb(self, path: str, options: File3dmGlbOptions) -> bool: ...
+    def GetEmbeddedFileBytes(self, path: str, strict: bool = False) -> bytes: ...
+    def ExtractEmbeddedFile(self, path: str, filename: str) -> bool: ...
+    def ExtractAllEmbeddedFiles(self, directory: str, threadCount: int = 0) -> List[str]: ...
 
-class File3dmBitmapTable: ...
+class File3dmBitmapTable:
+    def ToPixels(self, format: BitmapPixelFormat = BitmapPixelFormat.Rgba8, threadCount: int = 0) -> List[memoryview]: ...
 
 class File3dmDimStyleTable:
     def FindIndex(self, index: int) -> DimensionStyle: ...
 
+class File3dmGlbOptions:
+    @property
+    def MapZToY(self) -> bool: ...
+    @MapZToY.setter
+    def MapZToY(self, value: bool) -> None: ...
+    @property
+    def ExportMaterials(self) -> bool: ...
+    @ExportMaterials.setter
+    def ExportMaterials(self, value: bool) -> None: ...
+    @property
+    def UseGpuInstancing(self) -> bool: ...
+    @UseGpuInstancing.setter
+    def UseGpuInstancing(self, value: bool) -> None: ...
+    @property
+    def QuantizeAttributes(self) -> bool: ...
+    @QuantizeAttributes.setter
+    def QuantizeAttributes(self, value: bool) -> None: ...
+    @property
+    def UseDracoCompression(self) -> bool: ...
+    @UseDracoCompression.setter
+    def UseDracoCompression(self, value: bool) -> None: ...
+    @property
+    def DracoOptions(self) -> DracoCompressionOptions: ...
+    @DracoOptions.setter
+    def DracoOptions(self, value: DracoCompressionOptions) -> None: ...
+    @property
+    def OptimizeMeshes(self) -> bool: ...
+    @OptimizeMeshes.setter
+    def OptimizeMeshes(self, value: bool) -> None: ...
+
 class File3dmGroupTable:
     def FindIndex(self, groupIndex: int) -> Group: ...
     def FindName(self, name: str) -> Group: ...
@@ -459,6 +544,10 @@ class File3dmWriteOptions:
     def Version(self) -> int: ...
     @property
     def SaveUserData(self) -> bool: ...
+    @property
+    def CompressBuffers(self) -> bool: ...
+    @property
+    def ThreadCount(self) -> int: ...
 
 class FileReference:
     @property
@@ -500,6 +589,66 @@ class Font:
     @property
     def FamilyName(self) -> str: ...
 
+class HiddenLineDrawing:
+    @property
+    def PolylineCount(self) -> int: ...
+    @property
+    def PointCount(self) -> int: ...
+    @property
+    def Points(self) -> memoryview: ...
+    @property
+    def PolylineOffsets(self) -> memoryview: ...
+    @property
+    def Visibility(self) -> memoryview: ...
+    @property
+    def SegmentTypes(self) -> memoryview: ...
+    @property
+    def SourceIndices(self) -> memoryview: ...
+    @property
+    def SourceIds(self) -> tuple[UUID, ...]: ...
+    @property
+    def BoundingBox(self) -> BoundingBox: ...
+    @staticmethod
+    def Compute(parameters: HiddenLineDrawingParameters, multipleThreads: bool = True) -> HiddenLineDrawing: ...
+
+class HiddenLineDrawingParameters:
+    @property
+    def AbsoluteTolerance(self) -> float: ...
+    @AbsoluteTolerance.setter
+    def AbsoluteTolerance(self, value: float) -> None: ...
+    @property
+    def IncludeHiddenCurves(self) -> bool: ...
+    @IncludeHiddenCurves.setter
+    def IncludeHiddenCurves(self, value: bool) -> None: ...
+    @property
+    def IncludeTangentEdges(self) -> bool: ...
+    @IncludeTangentEdges.setter
+    def IncludeTangentEdges(self, value: bool) -> None: ...
+    @property
+    def IncludeClippedCurves(self) -> bool: ...
+    @IncludeClippedCurves.setter
+    def IncludeClippedCurves(self, value: bool) -> None: ...
+    @property
+    def SourceCount(self) -> int: ...
+    def SetViewport(self, viewport: ViewportInfo) -> bool: ...
+    def AddClippingPlane(self, plane: Plane) -> None: ...
+    def AddGeometry(self, geometry: GeometryBase, xform: Transform, id: UUID) -> int: ...
+    def AddObjects(self, file3dm: File3dm) -> int: ...
+
+class HiddenLineSegmentType(Enum):
+    Unset = 0
+    Curve = 1
+    Boundary = 2
+    Crease = 3
+    Tangent = 4
+    Silhouette = 5
+
+class HiddenLineSegmentVisibility(Enum):
+    Unset = 0
+    Visible = 1
+    Hidden = 2
+    Clipped = 5
+
 class Intersection:
     @staticmethod
     def LinePlane(line: Line, plane: Plane, lineParameter: float) -> bool: ...
@@ -537,6 +686,34 @@ class Line:
     def UnitTangent(self) -> Vector3d: ...
     def PointAt(self, t: float) -> Point3d: ...
 
+class MeshAdjacency:
+    @property
+    def TopologyVertexCount(self) -> int: ...
+    @property
+    def EdgeCount(self) -> int: ...
+    @property
+    def FaceCount(self) -> int: ...
+    @property
+    def VertexMap(self) -> memoryview: ...
+    @property
+    def EdgeVertices(self) -> memoryview: ...
+    @property
+    def VertexFacesOffsets(self) -> memoryview: ...
+    @property
+    def VertexFaces(self) -> memoryview: ...
+    @property
+    def VertexVerticesOffsets(self) -> memoryview: ...
+    @property
+    def VertexVertices(self) -> memoryview: ...
+    @property
+    def EdgeFacesOffsets(self) -> memoryview: ...
+    @property
+    def EdgeFaces(self) -> memoryview: ...
+    @property
+    def FaceEdgesOffsets(self) -> memoryview: ...
+    @property
+    def FaceEdges(self) -> memoryview: ...
+
 class MeshFaceList:
     @property
     def Count(self) -> int: ...
@@ -615,6 +792,41 @@ class MeshingParameters:
 
 class MeshNormalList: ...
 
+class MeshQuantizationOptions:
+    def __init__(self) -> None: ...
+    @property
+    def UnsignedPositions(self) -> bool: ...
+    @UnsignedPositions.setter
+    def UnsignedPositions(self, value: bool) -> None: ...
+    @property
+    def NormalBits(self) -> int: ...
+    @NormalBits.setter
+    def NormalBits(self, value: int) -> None: ...
+    @property
+    def HalfFloatTextureCoordinates(self) -> bool: ...
+    @HalfFloatTextureCoordinates.setter
+    def HalfFloatTextureCoordinates(self, value: bool) -> None: ...
+
+class MeshQuantizedBuffers:
+    @property
+    def VertexCount(self) -> int: ...
+    @property
+    def TriangleCount(self) -> int: ...
+    @property
+    def NormalBits(self) -> int: ...
+    @property
+    def Positions(self) -> memoryview: ...
+    @property
+    def Normals(self) -> memoryview: ...
+    @property
+    def TextureCoordinates(self) -> memoryview: ...
+    @property
+    def Colors(self) -> memoryview: ...
+    @property
+    def Indices(self) -> memoryview: ...
+    @property
+    def DequantizationTransform(self) -> Transform: ...
+
 class MeshTextureCoordinateList: ...
 
 class MeshType(Enum):
@@ -990,6 +1202,18 @@ class TextureType(Enum):
     PBR_Displacement = 28
     PBR_ClearcoatBump = 29
 
+class TileSet:
+    @property
+    def TileCount(self) -> int: ...
+    def GetBoundingBox(self, index: int) -> BoundingBox: ...
+    def GetParent(self, index: int) -> int: ...
+    def GetChildren(self, index: int) -> tuple[int, ...]: ...
+    def GetDepth(self, index: int) -> int: ...
+    def GetGeometricError(self, index: int) -> float: ...
+    def GetItemIndices(self, index: int) -> memoryview: ...
+    def GetContent(self, index: int) -> GeometryBase: ...
+    def ToTilesetJson(self, contentUri: str = "{index}.glb") -> str: ...
+
 class Transform:
     def __init__(self, diagonalValue: float) -> None: ...
     @property
@@ -1026,6 +1250,7 @@ class Transform:
     def TransformBoundingBox(self, bbox: BoundingBox) -> BoundingBox: ...
     def Transpose(self) -> Transform: ...
     def ToFloatArray(self, rowDominant: bool) -> List[float]: ...
+    def ApplyToPoints(self, points: memoryview, inPlace: bool = True, threadCount: int = 0) -> memoryview: ...
 
 class UnitSystem(Enum):
     NoUnits = 0
@@ -1149,6 +1374,8 @@ class DimensionStyle(CommonObject):
     @property
     def BaselineSpacing(self) -> float: ...
     @property
+    def DimensionScale(self) -> float: ...
+    @property
     def TextRotation(self) -> float: ...
     @property
     def StackHeightScale(self) -> float: ...
@@ -1174,6 +1401,8 @@ class GeometryBase(CommonObject):
     @property
     def HasBrepForm(self) -> bool: ...
     def Transform(self, xform: Transform) -> bool: ...
+    @staticmethod
+    def TransformMany(geometries: List[GeometryBase], xforms: List[Transform], threadCount: int = 0) -> int: ...
     def Translate(self, translationVector: Vector3d) -> bool: ...
     def Scale(self, scaleFactor: float) -> bool: ...
     def Rotate(self, angleRadians: float, rotationAxis: Vector3d, rotationCenter: Point3d) -> bool: ...
@@ -1411,6 +1640,45 @@ class AnnotationBase(GeometryBase):
     @property
     def PlainText(self) -> str: ...
 
+class AnnotationTessellation:
+    @property
+    def VertexCount(self) -> int: ...
+    @property
+    def TriangleCount(self) -> int: ...
+    @property
+    def Vertices(self) -> memoryview: ...
+    @property
+    def Indices(self) -> memoryview: ...
+    @property
+    def TriangleSourceIndices(self) -> memoryview: ...
+    @property
+    def PolylineCount(self) -> int: ...
+    @property
+    def PointCount(self) -> int: ...
+    @property
+    def Points(self) -> memoryview: ...
+    @property
+    def PolylineOffsets(self) -> memoryview: ...
+    @property
+    def PolylineSourceIndices(self) -> memoryview: ...
+    @property
+    def SourceIds(self) -> tuple[UUID, ...]: ...
+    @property
+    def GlyphCount(self) -> int: ...
+    @property
+    def UniqueGlyphCount(self) -> int: ...
+    @property
+    def BoundingBox(self) -> BoundingBox: ...
+    @staticmethod
+    def FromFile3dm(file3dm: File3dm, fill: bool = True, tolerance: float = 0.01) -> AnnotationTessellation: ...
+    @staticmethod
+    def FromAnnotation(annotation: AnnotationBase, dimstyle: DimensionStyle = None, fill: bool = True, tolerance: float = 0.01) -> AnnotationTessellation: ...
+    @staticmethod
+    def ClearGlyphCache() -> None: ...
+    @staticmethod
+    def GlyphCacheCount() -> int: ...
+    GlyphOutlinesAvailable: bool
+
 class Brep(GeometryBase):
     @property
     def Faces(self) -> BrepFaceList: ...
@@ -1601,6 +1869,14 @@ class Mesh(GeometryBase):
     def Compact(self) -> bool: ...
     def Append(self, other: Mesh) -> None: ...
     def CreatePartitions(self, maximumVertexCount: int, maximumTriangleCount: int) -> bool: ...
+    def Simplify(self, targetRatio: float = 0.5, targetError: float = 0.0, preserveBorders: bool = True, preserveUVSeams: bool = True) -> Mesh: ...
+    def BuildLods(self, levels: int, ratio: float = 0.5, preserveBorders: bool = True, preserveUVSeams: bool = True) -> tuple[Mesh, ...]: ...
+    def Weld(self, tolerance: float, angleTolerance: float = 3.141592653589793, threadCount: int = 0) -> bool: ...
+    def GetAdjacency(self, threadCount: int = 0) -> MeshAdjacency: ...
+    def ComputeAcmr(self, cacheSize: int = 16) -> float: ...
+    def OptimizeForGpu(self, optimizeOverdraw: bool = True, cacheSize: int = 16) -> tuple[float, float]: ...
+    def ToQuantizedBuffers(self, options: MeshQuantizationOptions = None) -> MeshQuantizedBuffers: ...
+    def SplitIntoTiles(self, maxTriangles: int = 65535, gridSize: float = 0.0, threadCount: int = 0, levelOfDetail: bool = False) -> TileSet: ...
 
 class Point(GeometryBase):
     def __init__(self, location: Point3d) -> None: ...
@@ -1667,6 +1943,11 @@ class PointCloud(GeometryBase):
     def GetNormals(self) -> List[Vector3d]: ...
     def GetColors(self) -> List[tuple[int, int, int, int]]: ...
     def ClosestPoint(self, testPoint: Point3d) -> int: ...
+    def BuildTiles(self, maxPoints: int = 100000, threadCount: int = 0) -> TileSet: ...
+    def VoxelDownsample(self, cellSize: float, threadCount: int = 0) -> PointCloud: ...
+    def BuildLodOctree(self, maxPointsPerNode: int = 20000, threadCount: int = 0) -> TileSet: ...
+    def EstimateNormals(self, k: int = 16, radius: float = 0.0, orientTowards: Point3d = Point3d.Unset, threadCount: int = 0) -> bool: ...
+    def RemoveStatisticalOutliers(self, k: int = 16, stdRatio: float = 2.0, threadCount: int = 0) -> int: ...
 
 class PointGrid(GeometryBase): ...
 
@@ -1676,6 +1957,53 @@ class SubD(GeometryBase):
     def ClearEvaluationCache(self) -> None: ...
     def UpdateAllTagsAndSectorCoefficients(self) -> int: ...
     def Subdivide(self, count: int) -> bool: ...
+    @staticmethod
+    def CreateFromMesh(mesh: Mesh) -> SubD: ...
+    def GetSurfaceMeshBuffers(self, density: int = 4, multipleThreads: bool = True) -> SubDSurfaceMeshBuffers: ...
+    def ToBrep(self, parameters: SubDToBrepParameters = None) -> Brep: ...
+    @staticmethod
+    def ToBrepMany(subds: List[SubD], parameters: SubDToBrepParameters = None, threadCount: int = 0) -> SubDToBrepResults: ...
+
+class SubDSurfaceMeshBuffers:
+    @property
+    def VertexCount(self) -> int: ...
+    @property
+    def TriangleCount(self) -> int: ...
+    @property
+    def Positions(self) -> memoryview: ...
+    @property
+    def Normals(self) -> memoryview: ...
+    @property
+    def Indices(self) -> memoryview: ...
+    @property
+    def FaceIds(self) -> memoryview: ...
+
+class SubDToBrepParameters:
+    def __init__(self) -> None: ...
+    @property
+    def PackFaces(self) -> bool: ...
+    @PackFaces.setter
+    def PackFaces(self, value: bool) -> None: ...
+    @property
+    def ExtraordinaryVertexProcess(self) -> SubDToBrepVertexProcess: ...
+    @ExtraordinaryVertexProcess.setter
+    def ExtraordinaryVertexProcess(self, value: SubDToBrepVertexProcess) -> None: ...
+
+class SubDToBrepResults:
+    @property
+    def Count(self) -> int: ...
+    @property
+    def Breps(self) -> tuple[Brep, ...]: ...
+    @property
+    def Seconds(self) -> memoryview: ...
+    @property
+    def TotalSeconds(self) -> float: ...
+
+class SubDToBrepVertexProcess(Enum):
+    LocalG1 = 1
+    LocalG2 = 2
+    LocalG1x = 3
+    LocalG1xx = 4
 
 class Surface(GeometryBase):
     @property
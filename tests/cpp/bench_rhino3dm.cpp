@@ -0,0 +1,736 @@
+// Google Benchmark suite for the native code behind File3dm read, write
+// (serial, parallel and passthrough of unmodified records), Encode and
+// FromByteArray, CommonObject Encode/Decode, Draco compression and the
+// Transform.ApplyToPoints kernels. The binding sources are linked in, so
+// every File3dm, CommonObject and DracoCompression benchmark runs the same
+// BND_ functions python calls, inside an embedded interpreter. Mesh.toThreejsJSON
+// only exists in the web assembly build and is not covered here.
+//
+// Every operation runs on synthetic models (meshes, NURBS, point clouds,
+// blocks) and on each tests/models/*.3dm file. Results carry throughput
+// counters (MB/s, objects/s) and the peak resident set size reached while
+// the operation ran.
+//
+//   bench_rhino3dm [--bench_counts=100,1000] [--bench_models=<dir>]
+//                  [google benchmark flags]
+//
+// Output is JSON unless --benchmark_format is given; use
+// --benchmark_out=results.json to also write it to a file.
+
+#include <benchmark/benchmark.h>
+#include <pybind11/embed.h>
+#include "../../src/bindings/bindings.h"
+#include "../../src/bindings/base64.h"
+#include "../../src/bindings/point_transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+#if !defined(RHINO3DM_TEST_MODELS_DIR)
+#define RHINO3DM_TEST_MODELS_DIR "../models"
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// peak resident set size
+
+static size_t ReadProcStatusBytes(const char* key)
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    const size_t keylen = strlen(key);
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, keylen, key) == 0)
+            return (size_t)std::stoull(line.substr(keylen + 1)) * 1024; // reported in kB
+    }
+#else
+    (void)key;
+#endif
+    return 0;
+}
+
+static size_t CurrentRssBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.WorkingSetSize;
+    return 0;
+#else
+    return ReadProcStatusBytes("VmRSS:");
+#endif
+}
+
+// Linux can reset the high water mark so each benchmark reports its own
+// peak. Elsewhere the peak is for the lifetime of the process.
+static void ResetPeakRss()
+{
+#if defined(__linux__)
+    FILE* fp = fopen("/proc/self/clear_refs", "w");
+    if (fp)
+    {
+        fputs("5", fp);
+        fclose(fp);
+    }
+#endif
+}
+
+static size_t PeakRssBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize;
+    return 0;
+#elif defined(__linux__)
+    return ReadProcStatusBytes("VmHWM:");
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return (size_t)usage.ru_maxrss; // bytes on macOS
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+// Measures the peak RSS of the timed loop and sets the throughput counters
+// common to every benchmark in this file.
+class BenchScope
+{
+public:
+    explicit BenchScope(benchmark::State& state)
+        : m_state(state)
+    {
+        ResetPeakRss();
+        m_start_rss = CurrentRssBytes();
+    }
+
+    void Finish(double bytesPerIteration, double objectsPerIteration)
+    {
+        const double iterations = (double)m_state.iterations();
+        const size_t peak = PeakRssBytes();
+        m_state.SetBytesProcessed((int64_t)(iterations * bytesPerIteration));
+        m_state.SetItemsProcessed((int64_t)(iterations * objectsPerIteration));
+        m_state.counters["MB/s"] = benchmark::Counter(iterations * bytesPerIteration / 1.0e6, benchmark::Counter::kIsRate);
+        m_state.counters["objects/s"] = benchmark::Counter(iterations * objectsPerIteration, benchmark::Counter::kIsRate);
+        m_state.counters["peak_rss_MB"] = (double)peak / 1.0e6;
+        if (m_start_rss > 0 && peak >= m_start_rss)
+            m_state.counters["peak_rss_delta_MB"] = (double)(peak - m_start_rss) / 1.0e6;
+    }
+
+private:
+    benchmark::State& m_state;
+    size_t m_start_rss = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// synthetic models
+
+enum class SyntheticKind : int
+{
+    Meshes = 0,
+    Nurbs = 1,
+    PointClouds = 2,
+    Blocks = 3
+};
+
+static const char* SyntheticKindName(SyntheticKind kind)
+{
+    switch (kind)
+    {
+    case SyntheticKind::Meshes: return "meshes";
+    case SyntheticKind::Nurbs: return "nurbs";
+    case SyntheticKind::PointClouds: return "pointclouds";
+    case SyntheticKind::Blocks: return "blocks";
+    }
+    return "unknown";
+}
+
+// 32x32 quad grid with normals and texture coordinates
+static ON_Mesh CreateGridMesh(const ON_3dPoint& origin)
+{
+    const int n = 32;
+    ON_Mesh mesh(n * n, (n + 1) * (n + 1), true, true);
+    for (int j = 0; j <= n; j++)
+    {
+        for (int i = 0; i <= n; i++)
+        {
+            const double z = sin(0.3 * i) * cos(0.3 * j);
+            mesh.SetVertex(j * (n + 1) + i, origin + ON_3dVector(i, j, z));
+            mesh.SetTextureCoord(j * (n + 1) + i, (double)i / n, (double)j / n);
+        }
+    }
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            const int v = j * (n + 1) + i;
+            mesh.SetQuad(j * n + i, v, v + 1, v + n + 2, v + n + 1);
+        }
+    }
+    mesh.ComputeVertexNormals();
+    return mesh;
+}
+
+static ON_PointCloud CreatePointCloud(const ON_3dPoint& origin)
+{
+    ON_PointCloud cloud;
+    cloud.m_P.Reserve(4096);
+    for (int i = 0; i < 4096; i++)
+        cloud.m_P.Append(origin + ON_3dVector(i % 16, (i / 16) % 16, i / 256));
+    return cloud;
+}
+
+static ON_3dmObjectAttributes CreateAttributes(bool instanceDefinitionObject)
+{
+    ON_3dmObjectAttributes attributes;
+    attributes.m_uuid = ON_CreateId();
+    if (instanceDefinitionObject)
+        attributes.SetMode(ON::idef_object);
+    return attributes;
+}
+
+static std::shared_ptr<ONX_Model> CreateSyntheticModel(SyntheticKind kind, int count)
+{
+    std::shared_ptr<ONX_Model> model = std::make_shared<ONX_Model>();
+    if (SyntheticKind::Blocks == kind)
+    {
+        // one block definition holding a mesh and a surface, referenced count times
+        ON_InstanceDefinition idef;
+        idef.SetId();
+        idef.SetName(L"bench_block");
+        ON_SimpleArray<ON_UUID> ids;
+
+        ON_3dmObjectAttributes meshAttributes = CreateAttributes(true);
+        ON_Mesh mesh = CreateGridMesh(ON_3dPoint::Origin);
+        model->AddModelGeometryComponent(&mesh, &meshAttributes);
+        ids.Append(meshAttributes.m_uuid);
+
+        ON_3dmObjectAttributes surfaceAttributes = CreateAttributes(true);
+        ON_NurbsSurface surface;
+        ON_Sphere(ON_3dPoint(16, 16, 10), 5).GetNurbForm(surface);
+        model->AddModelGeometryComponent(&surface, &surfaceAttributes);
+        ids.Append(surfaceAttributes.m_uuid);
+
+        idef.SetInstanceGeometryIdList(ids);
+        model->AddModelComponent(idef);
+
+        for (int i = 0; i < count; i++)
+        {
+            ON_InstanceRef iref;
+            iref.m_instance_definition_uuid = idef.Id();
+            iref.m_xform = ON_Xform::TranslationTransformation(40.0 * (i % 100), 40.0 * (i / 100), 0);
+            ON_3dmObjectAttributes attributes = CreateAttributes(false);
+            model->AddModelGeometryComponent(&iref, &attributes);
+        }
+        return model;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const ON_3dPoint origin(40.0 * (i % 100), 40.0 * (i / 100), 0);
+        ON_3dmObjectAttributes attributes = CreateAttributes(false);
+        if (SyntheticKind::Meshes == kind)
+        {
+            ON_Mesh mesh = CreateGridMesh(origin);
+            model->AddModelGeometryComponent(&mesh, &attributes);
+        }
+        else if (SyntheticKind::Nurbs == kind)
+        {
+            ON_NurbsSurface surface;
+            ON_Sphere(origin, 10).GetNurbForm(surface);
+            model->AddModelGeometryComponent(&surface, &attributes);
+        }
+        else if (SyntheticKind::PointClouds == kind)
+        {
+            ON_PointCloud cloud = CreatePointCloud(origin);
+            model->AddModelGeometryComponent(&cloud, &attributes);
+        }
+    }
+    return model;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// helpers shared by the benchmarks
+
+static std::vector<const ON_Object*> ModelGeometry(const ONX_Model& model)
+{
+    std::vector<const ON_Object*> rc;
+    ONX_ModelComponentIterator iterator(model, ON_ModelComponent::Type::ModelGeometry);
+    for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+    {
+        const ON_ModelGeometryComponent* component = ON_ModelGeometryComponent::Cast(compref.ModelComponent());
+        const ON_Geometry* geometry = component ? component->Geometry(nullptr) : nullptr;
+        if (geometry)
+            rc.push_back(geometry);
+    }
+    return rc;
+}
+
+static std::vector<const ON_Mesh*> ModelMeshes(const ONX_Model& model)
+{
+    // meshes as they are, plus cached render meshes of breps and extrusions
+    std::vector<const ON_Mesh*> rc;
+    for (const ON_Object* object : ModelGeometry(model))
+    {
+        const ON_Mesh* mesh = ON_Mesh::Cast(object);
+        if (mesh)
+        {
+            rc.push_back(mesh);
+            continue;
+        }
+        const ON_Brep* brep = ON_Brep::Cast(object);
+        if (brep)
+        {
+            for (int fi = 0; fi < brep->m_F.Count(); fi++)
+            {
+                const ON_Mesh* render_mesh = brep->m_F[fi].Mesh(ON::render_mesh);
+                if (render_mesh)
+                    rc.push_back(render_mesh);
+            }
+        }
+    }
+    return rc;
+}
+
+static std::vector<unsigned char> WriteModelToBuffer(const ONX_Model& model)
+{
+    ON_Write3dmBufferArchive archive(0, 0, ON_BinaryArchive::CurrentArchiveVersion(), ON::Version());
+    model.Write(archive, 0, nullptr);
+    const unsigned char* buffer = (const unsigned char*)archive.Buffer();
+    return std::vector<unsigned char>(buffer, buffer + archive.SizeOfArchive());
+}
+
+// Wrappers as File3dm.Objects hands them out; they reference the model's
+// objects and do not own them
+static std::vector<std::unique_ptr<BND_CommonObject>> WrapModelGeometry(const ONX_Model& model)
+{
+    std::vector<std::unique_ptr<BND_CommonObject>> rc;
+    ONX_ModelComponentIterator iterator(model, ON_ModelComponent::Type::ModelGeometry);
+    for (ON_ModelComponentReference compref = iterator.FirstComponentReference(); !compref.IsEmpty(); compref = iterator.NextComponentReference())
+    {
+        BND_CommonObject* wrapper = BND_CommonObject::CreateWrapper(compref);
+        if (wrapper)
+            rc.emplace_back(wrapper);
+    }
+    return rc;
+}
+
+// Wrappers own copies, since render meshes of breps belong to the brep
+static std::vector<std::unique_ptr<BND_Mesh>> WrapModelMeshes(const ONX_Model& model)
+{
+    std::vector<std::unique_ptr<BND_Mesh>> rc;
+    for (const ON_Mesh* mesh : ModelMeshes(model))
+        rc.emplace_back(new BND_Mesh(new ON_Mesh(*mesh), nullptr));
+    return rc;
+}
+
+// File3dm over a benchmark model; the model is shared, not copied, and no
+// passthrough is set up, so writes serialize every record
+static std::unique_ptr<BND_ONXModel> WrapModel(std::shared_ptr<ONX_Model> model)
+{
+    std::unique_ptr<BND_ONXModel> rc(new BND_ONXModel());
+    rc->m_model = model;
+    return rc;
+}
+
+static std::wstring BenchOutputPath()
+{
+    return (fs::temp_directory_path() / "bench_rhino3dm.3dm").wstring();
+}
+
+static double FileBytes(const std::wstring& path)
+{
+    std::error_code ec;
+    const uintmax_t bytes = fs::file_size(fs::path(path), ec);
+    return ec ? 0.0 : (double)bytes;
+}
+
+static size_t EncodedLength(BND_DICT& encoded)
+{
+    return encoded["data"].cast<std::string>().length();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// benchmarks
+
+// File3dm.Write(path, options); threadCount as File3dmWriteOptions.ThreadCount
+static void BM_File3dmWrite(benchmark::State& state, std::shared_ptr<ONX_Model> model, int objectCount, int threadCount)
+{
+    std::unique_ptr<BND_ONXModel> file3dm = WrapModel(model);
+    BND_File3dmWriteOptions options;
+    options.SetThreadCount(threadCount);
+    const std::wstring path = BenchOutputPath();
+    if (!file3dm->Write2(path, &options))
+    {
+        state.SkipWithError("File3dm.Write failed");
+        return;
+    }
+    const double bytes = FileBytes(path);
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        if (!file3dm->Write2(path, &options))
+        {
+            state.SkipWithError("File3dm.Write failed");
+            break;
+        }
+    }
+    scope.Finish(bytes, objectCount);
+    std::error_code ec;
+    fs::remove(fs::path(path), ec);
+}
+
+// File3dm.Read(path).Write(path): unmodified object records are copied
+// from the source file instead of being serialized again
+static void BM_File3dmWritePassthrough(benchmark::State& state, std::wstring source, int objectCount)
+{
+    std::unique_ptr<BND_ONXModel> file3dm(BND_ONXModel::Read(source));
+    if (!file3dm)
+    {
+        state.SkipWithError("File3dm.Read failed");
+        return;
+    }
+    BND_File3dmWriteOptions options;
+    const std::wstring path = BenchOutputPath();
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        if (!file3dm->Write2(path, &options))
+        {
+            state.SkipWithError("File3dm.Write failed");
+            break;
+        }
+    }
+    scope.Finish(FileBytes(path), objectCount);
+    std::error_code ec;
+    fs::remove(fs::path(path), ec);
+}
+
+// File3dm.Encode(): the whole model as base64 text
+static void BM_File3dmEncode(benchmark::State& state, std::shared_ptr<ONX_Model> model, int objectCount)
+{
+    std::unique_ptr<BND_ONXModel> file3dm = WrapModel(model);
+    const double bytes = (double)file3dm->Encode2(nullptr).length();
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        std::string encoded = file3dm->Encode2(nullptr);
+        benchmark::DoNotOptimize(encoded.data());
+    }
+    scope.Finish(bytes, objectCount);
+}
+
+static void BM_File3dmFromByteArray(benchmark::State& state, std::shared_ptr<ONX_Model> model, int objectCount)
+{
+    const std::vector<unsigned char> buffer = WriteModelToBuffer(*model);
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        std::unique_ptr<BND_ONXModel> read(BND_ONXModel::FromByteArray((int)buffer.size(), buffer.data()));
+        if (!read)
+        {
+            state.SkipWithError("File3dm.FromByteArray failed");
+            break;
+        }
+    }
+    scope.Finish((double)buffer.size(), objectCount);
+}
+
+// File3dm.Read: parsed straight out of a memory mapping, plus the record
+// index that lets a later Write pass unmodified records through
+static void BM_File3dmRead(benchmark::State& state, std::wstring path, int objectCount)
+{
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        std::unique_ptr<BND_ONXModel> read(BND_ONXModel::Read(path));
+        if (!read)
+        {
+            state.SkipWithError("File3dm.Read failed");
+            break;
+        }
+    }
+    scope.Finish(FileBytes(path), objectCount);
+}
+
+static void BM_Encode(benchmark::State& state, std::shared_ptr<ONX_Model> model)
+{
+    const std::vector<std::unique_ptr<BND_CommonObject>> objects = WrapModelGeometry(*model);
+    double bytes = 0;
+    for (const auto& object : objects)
+    {
+        BND_DICT encoded = object->Encode();
+        bytes += (double)EncodedLength(encoded);
+    }
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        for (const auto& object : objects)
+        {
+            BND_DICT encoded = object->Encode();
+            benchmark::DoNotOptimize(encoded.ptr());
+        }
+    }
+    scope.Finish(bytes, (double)objects.size());
+}
+
+static void BM_Decode(benchmark::State& state, std::shared_ptr<ONX_Model> model)
+{
+    std::vector<BND_DICT> encoded;
+    double bytes = 0;
+    for (const auto& object : WrapModelGeometry(*model))
+    {
+        encoded.push_back(object->Encode());
+        bytes += (double)EncodedLength(encoded.back());
+    }
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        for (const BND_DICT& item : encoded)
+        {
+            std::unique_ptr<BND_CommonObject> object(BND_CommonObject::Decode(item));
+            benchmark::DoNotOptimize(object.get());
+        }
+    }
+    scope.Finish(bytes, (double)encoded.size());
+}
+
+// Codec alone on the bytes of the whole model, as File3dm.Encode/Decode see them
+static void BM_Base64Encode(benchmark::State& state, std::shared_ptr<ONX_Model> model)
+{
+    const std::vector<unsigned char> bytes = WriteModelToBuffer(*model);
+    std::string text(base64_encoded_length(bytes.size()), '\0');
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        base64_encode(bytes.data(), bytes.size(), &text[0]);
+        benchmark::DoNotOptimize(text.data());
+    }
+    scope.Finish((double)bytes.size(), 1);
+}
+
+static void BM_Base64Decode(benchmark::State& state, std::shared_ptr<ONX_Model> model)
+{
+    const std::vector<unsigned char> bytes = WriteModelToBuffer(*model);
+    const std::string text = base64_encode(bytes.data(), (unsigned int)bytes.size());
+    std::vector<unsigned char> decoded(base64_decoded_max_length(text.length()));
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(base64_decode(text.data(), text.length(), decoded.data()));
+    }
+    scope.Finish((double)bytes.size(), 1);
+}
+
+// Transform.ApplyToPoints kernels on a packed buffer; pointCount points
+static ON_Xform BenchTransform(bool affine)
+{
+    ON_Xform xform = ON_Xform::RotationTransformation(0.3, ON_3dVector::ZAxis, ON_3dPoint(10, 20, 0));
+    xform = ON_Xform::TranslationTransformation(2.5e6, 1.2e6, 300) * xform;
+    if (!affine)
+    {
+        xform.m_xform[3][0] = 1.0e-4;
+        xform.m_xform[3][2] = 2.0e-4;
+    }
+    return xform;
+}
+
+template<typename T>
+static void BM_PointTransform(benchmark::State& state, int pointCount, bool affine)
+{
+    const ON_Xform xform = BenchTransform(affine);
+    std::vector<T> points(3 * (size_t)pointCount);
+    for (size_t i = 0; i < points.size(); i++)
+        points[i] = (T)((i * 7919) % 1000) * (T)0.01;
+    std::vector<T> out(points.size());
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        point_transform(xform.m_xform, points.data(), out.data(), (size_t)pointCount);
+        benchmark::DoNotOptimize(out.data());
+    }
+    scope.Finish((double)(points.size() * sizeof(T)), (double)pointCount);
+}
+
+// the same work point by point through opennurbs, as Point3dList.Transform did
+static void BM_PointTransformOpenNurbs(benchmark::State& state, int pointCount, bool affine)
+{
+    const ON_Xform xform = BenchTransform(affine);
+    ON_3dPointArray points(pointCount);
+    for (int i = 0; i < pointCount; i++)
+        points.Append(ON_3dPoint((i * 7919) % 1000 * 0.01, (i * 104729) % 1000 * 0.01, i % 1000 * 0.01));
+    const ON_3dPointArray original(points);
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        for (int i = 0; i < pointCount; i++)
+            points[i] = xform * original[i];
+        benchmark::DoNotOptimize(points.Array());
+    }
+    scope.Finish((double)pointCount * 3 * sizeof(double), (double)pointCount);
+}
+
+static void RegisterPointTransformBenchmarks(int pointCount)
+{
+    const std::string count = std::to_string(pointCount);
+    for (int affine = 1; affine >= 0; affine--)
+    {
+        const std::string kind = affine ? "affine/" : "projective/";
+        benchmark::RegisterBenchmark(("Transform.ApplyToPoints/float64/" + kind + count).c_str(), BM_PointTransform<double>, pointCount, affine != 0)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("Transform.ApplyToPoints/float32/" + kind + count).c_str(), BM_PointTransform<float>, pointCount, affine != 0)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("Transform.ApplyToPoints/opennurbs/" + kind + count).c_str(), BM_PointTransformOpenNurbs, pointCount, affine != 0)->Unit(benchmark::kMillisecond);
+    }
+}
+
+#if defined(RHINO3DM_BENCHMARK_DRACO)
+static void BM_DracoCompress(benchmark::State& state, std::shared_ptr<ONX_Model> model)
+{
+    const std::vector<std::unique_ptr<BND_Mesh>> meshes = WrapModelMeshes(*model);
+    if (meshes.empty())
+    {
+        state.SkipWithError("no meshes");
+        return;
+    }
+    // throughput is measured on the uncompressed float positions and normals
+    double bytes = 0;
+    for (const auto& mesh : meshes)
+        bytes += (double)(mesh->m_mesh->m_V.UnsignedCount() + mesh->m_mesh->m_N.UnsignedCount()) * 3 * sizeof(float);
+    BenchScope scope(state);
+    for (auto _ : state)
+    {
+        for (const auto& mesh : meshes)
+        {
+            std::unique_ptr<BND_Draco> compressed(BND_Draco::CompressMesh(mesh.get()));
+            benchmark::DoNotOptimize(compressed.get());
+        }
+    }
+    scope.Finish(bytes, (double)meshes.size());
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void RegisterModelBenchmarks(const std::string& label, std::shared_ptr<ONX_Model> model, bool meshOperations)
+{
+    const int objectCount = (int)ModelGeometry(*model).size();
+    benchmark::RegisterBenchmark(("File3dm.Write/serial/" + label).c_str(), BM_File3dmWrite, model, objectCount, 1)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("File3dm.Write/parallel/" + label).c_str(), BM_File3dmWrite, model, objectCount, 0)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("File3dm.Encode/" + label).c_str(), BM_File3dmEncode, model, objectCount)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("File3dm.FromByteArray/" + label).c_str(), BM_File3dmFromByteArray, model, objectCount)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("Encode/" + label).c_str(), BM_Encode, model)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("Decode/" + label).c_str(), BM_Decode, model)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("Base64.Encode/" + label).c_str(), BM_Base64Encode, model)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark(("Base64.Decode/" + label).c_str(), BM_Base64Decode, model)->Unit(benchmark::kMillisecond);
+#if defined(RHINO3DM_BENCHMARK_DRACO)
+    if (meshOperations)
+        benchmark::RegisterBenchmark(("DracoCompression.Compress/" + label).c_str(), BM_DracoCompress, model)->Unit(benchmark::kMillisecond);
+#endif
+}
+
+static std::vector<int> ParseCounts(const std::string& text)
+{
+    std::vector<int> rc;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        const int count = atoi(item.c_str());
+        if (count > 0)
+            rc.push_back(count);
+    }
+    return rc;
+}
+
+int main(int argc, char** argv)
+{
+    ON::Begin();
+    // Encode/Decode build python dictionaries
+    pybind11::scoped_interpreter python;
+
+    std::vector<int> counts = { 100, 1000 };
+    std::string modelsDir = RHINO3DM_TEST_MODELS_DIR;
+    bool hasFormat = false;
+
+    // pull out our own flags before google benchmark sees the rest
+    std::vector<char*> args;
+    for (int i = 0; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg.rfind("--bench_counts=", 0) == 0)
+            counts = ParseCounts(arg.substr(strlen("--bench_counts=")));
+        else if (arg.rfind("--bench_models=", 0) == 0)
+            modelsDir = arg.substr(strlen("--bench_models="));
+        else
+        {
+            if (arg.rfind("--benchmark_format=", 0) == 0)
+                hasFormat = true;
+            args.push_back(argv[i]);
+        }
+    }
+    static char jsonFormat[] = "--benchmark_format=json";
+    if (!hasFormat)
+        args.push_back(jsonFormat);
+    int benchArgc = (int)args.size();
+    args.push_back(nullptr);
+
+    const SyntheticKind kinds[] = { SyntheticKind::Meshes, SyntheticKind::Nurbs, SyntheticKind::PointClouds, SyntheticKind::Blocks };
+    for (int count : counts)
+    {
+        for (SyntheticKind kind : kinds)
+        {
+            const std::string label = std::string("synthetic:") + SyntheticKindName(kind) + "/" + std::to_string(count);
+            RegisterModelBenchmarks(label, CreateSyntheticModel(kind, count), kind == SyntheticKind::Meshes);
+        }
+        RegisterPointTransformBenchmarks(count * 1000);
+    }
+
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::directory_iterator(fs::path(modelsDir), ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".3dm")
+            files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    for (const fs::path& file : files)
+    {
+        std::shared_ptr<ONX_Model> model = std::make_shared<ONX_Model>();
+        if (!model->Read(file.wstring().c_str()))
+            continue;
+        const std::string label = "model:" + file.filename().string();
+        const int objectCount = (int)ModelGeometry(*model).size();
+        benchmark::RegisterBenchmark(("File3dm.Read/" + label).c_str(), BM_File3dmRead, file.wstring(), objectCount)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("File3dm.Write/passthrough/" + label).c_str(), BM_File3dmWritePassthrough, file.wstring(), objectCount)->Unit(benchmark::kMillisecond);
+        RegisterModelBenchmarks(label, model, !ModelMeshes(*model).empty());
+    }
+
+    benchmark::Initialize(&benchArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    ON::End();
+    return 0;
+}
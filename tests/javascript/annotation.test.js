@@ -39,4 +39,68 @@ test('createAnnotation', async () => {
 
 
 
-})
\ No newline at end of file
+})
+
+//objective: text is tessellated into packed buffers, each distinct glyph once
+test('tessellateAnnotations', async () => {
+
+  const buffer = fs.readFileSync('../models/textEntities_r8.3dm')
+  const doc = rhino.File3dm.fromByteArray(new Uint8Array(buffer))
+
+  const filled = rhino.AnnotationTessellation.fromFile3dm(doc, true, 0.01)
+  expect(filled.glyphCount > 0).toBe(true)
+  expect(filled.uniqueGlyphCount <= filled.glyphCount).toBe(true)
+  expect(filled.indices.length).toBe(3 * filled.triangleCount)
+
+  const outlines = rhino.AnnotationTessellation.fromFile3dm(doc, false, 0.01)
+  expect(outlines.triangleCount).toBe(0)
+  expect(outlines.polylineOffsets.length).toBe(outlines.polylineCount + 1)
+
+  // builds without a font engine count glyphs but have no geometry for
+  // them, and say so
+  const available = rhino.AnnotationTessellation.glyphOutlinesAvailable()
+  expect(typeof available).toBe('boolean')
+  const objects = doc.objects()
+  let text = null
+  for (let i = 0; i < objects.count && text === null; i++) {
+    const geometry = objects.get(i).geometry()
+    if (geometry.objectType === rhino.ObjectType.Annotation && geometry.plainText === 'Hello World!')
+      text = geometry
+  }
+  expect(text !== null).toBe(true)
+  expect(rhino.AnnotationTessellation.fromAnnotation(text, null, true, 0.01).triangleCount > 0).toBe(available)
+  expect(rhino.AnnotationTessellation.fromAnnotation(text, null, false, 0.01).pointCount > 0).toBe(available)
+  expect(filled.triangleCount > 0).toBe(available)
+  expect(outlines.pointCount > 0).toBe(available)
+
+})
+
+//objective: text follows the model space scale of its dimension style
+test('tessellateScaledDimStyle', async () => {
+
+  const buffer = fs.readFileSync('../models/textEntities_r8.3dm')
+  const doc = rhino.File3dm.fromByteArray(new Uint8Array(buffer))
+  const objects = doc.objects()
+  let text = null
+  for (let i = 0; i < objects.count && text === null; i++) {
+    const geometry = objects.get(i).geometry()
+    if (geometry.objectType === rhino.ObjectType.Annotation && geometry.plainText === 'Hello World!')
+      text = geometry
+  }
+  expect(text !== null).toBe(true)
+
+  const style = new rhino.DimensionStyle()
+  const plain = rhino.AnnotationTessellation.fromAnnotation(text, style, false, 0.01)
+  style.dimensionScale = 2
+  const scaled = rhino.AnnotationTessellation.fromAnnotation(text, style, false, 0.01)
+
+  expect(scaled.glyphCount).toBe(plain.glyphCount)
+  expect(scaled.pointCount).toBe(plain.pointCount)
+  if (rhino.AnnotationTessellation.glyphOutlinesAvailable()) {
+    const plainSize = plain.boundingBox.diagonal
+    const scaledSize = scaled.boundingBox.diagonal
+    expect(Math.abs(scaledSize[0] - 2 * plainSize[0]) <= 1e-3 * scaledSize[0]).toBe(true)
+    expect(Math.abs(scaledSize[1] - 2 * plainSize[1]) <= 1e-3 * scaledSize[1]).toBe(true)
+  }
+
+})
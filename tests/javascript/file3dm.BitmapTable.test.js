@@ -30,4 +30,35 @@ test.skip('DeleteBitmap', async () => {
 
   expect(qtyBitmaps1 === 2 && qtyBitmaps2 === 1).toBe(true)
 
-})
\ No newline at end of file
+})
+
+//objective: bitmaps without uncompressed bits convert to empty pixel buffers
+test('toPixels', async () => {
+
+  const bitmap = new rhino.Bitmap()
+  expect(bitmap.toPixels(rhino.BitmapPixelFormat.Rgba8).length).toBe(0)
+  expect(bitmap.bits().length).toBe(0)
+
+  const file3dm = new rhino.File3dm()
+  expect(file3dm.bitmaps().toPixels(rhino.BitmapPixelFormat.Rgba8, 0).length).toBe(0)
+
+})
+
+//objective: a 2x2 DIB written through bits() converts to known pixels in every format
+test('toPixelsValues', async () => {
+
+  const bitmap = new rhino.Bitmap(2, 2, 32)
+  expect(bitmap.sizeOfImage).toBe(16)
+  // bits() is a view, so writing it changes the bitmap; scan lines are
+  // bottom row first, pixels blue, green, red, alpha
+  const bits = bitmap.bits()
+  expect(bits instanceof Uint8Array).toBe(true)
+  bits.set([0, 0, 255, 255, 0, 255, 0, 255, 255, 0, 0, 255, 255, 255, 255, 128])
+
+  // top row first: blue, half transparent white, then red, green
+  expect(Array.from(bitmap.toPixels(rhino.BitmapPixelFormat.Rgba8))).toEqual([0, 0, 255, 255, 255, 255, 255, 128, 255, 0, 0, 255, 0, 255, 0, 255])
+  expect(Array.from(bitmap.toPixels(rhino.BitmapPixelFormat.Bgra8))).toEqual([255, 0, 0, 255, 255, 255, 255, 128, 0, 0, 255, 255, 0, 255, 0, 255])
+  expect(Array.from(bitmap.toPixels(rhino.BitmapPixelFormat.Rgb8))).toEqual([0, 0, 255, 255, 255, 255, 255, 0, 0, 0, 255, 0])
+  expect(Array.from(bitmap.toPixels(rhino.BitmapPixelFormat.Gray8))).toEqual([29, 255, 76, 150])
+
+})
@@ -63,4 +63,100 @@ test('embeddedFilePaths', async () => {
   expect(Array.isArray(ef)).toBe(true)
   expect(typeof ef[0] === 'string').toBe(true)
 
-})
\ No newline at end of file
+  const bytes = doc.getEmbeddedFileBytes(ef[0], false)
+  expect(bytes.length > 0).toBe(true)
+  expect(Buffer.from(bytes).toString('base64')).toBe(doc.getEmbeddedFileAsBase64(ef[0]))
+
+})
+
+//objective: profiled read and write report per table statistics
+test('fromByteArrayWithProfile', async () => {
+
+  const buffer = fs.readFileSync('../models/file3dm_stuff.3dm')
+  const [doc, report] = rhino.File3dm.fromByteArrayWithProfile(new Uint8Array(buffer), 5)
+
+  expect(doc !== null).toBe(true)
+  expect(report.success).toBe(true)
+  expect(report.tables.objects.count).toBe(22)
+  expect(report.totalBytes > 0).toBe(true)
+  expect(report.slowestObjects.length <= 5).toBe(true)
+
+  const [bytes, writeReport] = doc.toByteArrayWithProfile(null)
+  expect(writeReport.success).toBe(true)
+  expect(bytes.length > 0).toBe(true)
+  expect(writeReport.tables.objects.seconds >= 0).toBe(true)
+
+})
+
+//objective: memory report lists tables and the largest objects
+test('memoryReport', async () => {
+
+  const buffer = fs.readFileSync('../models/file3dm_stuff.3dm')
+  const doc = rhino.File3dm.fromByteArray(new Uint8Array(buffer))
+  const report = doc.memoryReport(3)
+
+  expect(report.tables.objects.count).toBe(22)
+  // embedded file table entries plus the RDK embedded files
+  expect(report.embeddedFiles.count).toBe(doc.embeddedFiles().count + doc.embeddedFilePaths().length)
+  // the RDK files are taken out of the document user data they live in
+  expect(report.documentUserData.bytes < report.totalBytes).toBe(true)
+  expect(report.largestObjects.length).toBe(3)
+  expect(report.totalBytes > 0).toBe(true)
+
+})
+
+//objective: GLB export starts with the glTF header and a JSON chunk
+test('toGlb', async () => {
+
+  const buffer = fs.readFileSync('../models/file3dm_stuff.3dm')
+  const doc = rhino.File3dm.fromByteArray(new Uint8Array(buffer))
+  const options = new rhino.File3dmGlbOptions()
+  options.useDracoCompression = true
+  const glb = doc.toGlbOptions(options)
+
+  const view = new DataView(glb.buffer, glb.byteOffset, glb.byteLength)
+  expect(view.getUint32(0, true)).toBe(0x46546C67)
+  expect(view.getUint32(4, true)).toBe(2)
+  expect(view.getUint32(8, true)).toBe(glb.length)
+  expect(view.getUint32(16, true)).toBe(0x4E4F534A)
+
+  const jsonLength = view.getUint32(12, true)
+  const gltf = JSON.parse(new TextDecoder().decode(glb.subarray(20, 20 + jsonLength)))
+  expect(gltf.asset.version).toBe('2.0')
+  expect(gltf.scenes.length).toBe(1)
+
+})
+
+//objective: GLB export with meshes optimized for the GPU is still a valid glTF file
+test('toGlbOptimizeMeshes', async () => {
+
+  const buffer = fs.readFileSync('../models/file3dm_stuff.3dm')
+  const doc = rhino.File3dm.fromByteArray(new Uint8Array(buffer))
+  const options = new rhino.File3dmGlbOptions()
+  options.optimizeMeshes = true
+  expect(options.optimizeMeshes).toBe(true)
+  const glb = doc.toGlbOptions(options)
+
+  expect(glb instanceof Uint8Array).toBe(true)
+  const view = new DataView(glb.buffer, glb.byteOffset, glb.byteLength)
+  expect(view.getUint32(0, true)).toBe(0x46546C67)
+  expect(view.getUint32(8, true)).toBe(glb.length)
+  const jsonLength = view.getUint32(12, true)
+  const gltf = JSON.parse(new TextDecoder().decode(glb.subarray(20, 20 + jsonLength)))
+  expect(gltf.asset.version).toBe('2.0')
+
+})
+
+//objective: base64 text written while the model is saved decodes back to the same model
+test('encodeDecode', async () => {
+
+  const buffer = fs.readFileSync('../models/file3dm_stuff.3dm')
+  const doc = rhino.File3dm.fromByteArray(new Uint8Array(buffer))
+
+  const encoded = doc.encode()
+  expect(encoded.length % 4).toBe(0)
+
+  const decoded = rhino.File3dm.decode(encoded)
+  expect(decoded.objects().count).toBe(doc.objects().count)
+
+})
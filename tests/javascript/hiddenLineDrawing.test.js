@@ -0,0 +1,59 @@
+const rhino3dm = require('rhino3dm')
+
+let rhino
+
+beforeAll(async () => {
+    rhino = await rhino3dm()
+})
+
+function createModel() {
+    const file3dm = new rhino.File3dm()
+    const mesh = new rhino.Mesh()
+    mesh.vertices().add(-1, -1, 1)
+    mesh.vertices().add(1, -1, 1)
+    mesh.vertices().add(1, 1, 1)
+    mesh.vertices().add(-1, 1, 1)
+    mesh.faces().addQuadFace(0, 1, 2, 3)
+    file3dm.objects().addMesh(mesh, null)
+    file3dm.objects().addLine([-2, 0, 0], [2, 0, 0])
+    return file3dm
+}
+
+//objective: hidden line drawing of a line partially covered by a mesh, seen from the top
+test('ComputeHiddenLineDrawing', async () => {
+
+    const parameters = new rhino.HiddenLineDrawingParameters()
+    expect(parameters.setViewport(rhino.ViewportInfo.defaultTop())).toBe(true)
+    expect(parameters.addObjects(createModel())).toBe(2)
+
+    const drawing = rhino.HiddenLineDrawing.compute(parameters, true)
+    const count = drawing.polylineCount
+    const points = drawing.points
+    const offsets = drawing.polylineOffsets
+
+    expect(count > 0).toBe(true)
+    expect(points instanceof Float64Array).toBe(true)
+    expect(offsets.length).toBe(count + 1)
+    expect(offsets[count]).toBe(drawing.pointCount)
+    expect(drawing.visibility.length).toBe(count)
+    expect(drawing.segmentTypes.length).toBe(count)
+    expect(drawing.sourceIndices.length).toBe(count)
+    expect(drawing.sourceIds.length).toBe(2)
+
+    const hidden = []
+    for (let i = 0; i < count; i++) {
+        if (drawing.visibility[i] === rhino.HiddenLineSegmentVisibility.Hidden.value &&
+            drawing.segmentTypes[i] === rhino.HiddenLineSegmentType.Curve.value)
+            hidden.push(i)
+    }
+    expect(hidden.length).toBe(1)
+
+    let minX = Infinity, maxX = -Infinity
+    for (let j = offsets[hidden[0]]; j < offsets[hidden[0] + 1]; j++) {
+        minX = Math.min(minX, points[2 * j])
+        maxX = Math.max(maxX, points[2 * j])
+    }
+    expect(Math.abs(minX + 1) < 0.01).toBe(true)
+    expect(Math.abs(maxX - 1) < 0.01).toBe(true)
+
+})
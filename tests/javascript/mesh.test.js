@@ -129,3 +129,261 @@ test('getFaceVertices', async () => {
     expect(Array.isArray(faceVertices[4])).toBe(true)
 
 })
+
+//objective: simplify to a triangle budget without touching the source mesh
+test('simplify', async () => {
+
+    const faceCount = m.faces().count
+    const triangles = m.faces().triangleCount + 2 * m.faces().quadCount
+    const simplified = m.simplify(0.5, 0, false, false)
+
+    expect(simplified instanceof rhino.Mesh).toBe(true)
+    expect(m.faces().count).toBe(faceCount)
+    expect(simplified.faces().quadCount).toBe(0)
+    expect(simplified.faces().count > 0).toBe(true)
+    expect(simplified.faces().count < triangles).toBe(true)
+    expect(simplified.vertices().count <= m.vertices().count).toBe(true)
+
+})
+
+//objective: buildLods returns an array of meshes, each no larger than the one before it
+test('buildLods', async () => {
+
+    const lods = m.buildLods(3, 0.5, false, false)
+
+    expect(Array.isArray(lods)).toBe(true)
+    expect(lods.length).toBe(3)
+    for (let i = 0; i < lods.length; i++) {
+        expect(lods[i] instanceof rhino.Mesh).toBe(true)
+        if (i > 0)
+            expect(lods[i].faces().count <= lods[i - 1].faces().count).toBe(true)
+    }
+
+})
+
+//objective: a triangle soup of two quads welds into 6 vertices and 4 faces
+test('weld', async () => {
+
+    const mesh = new rhino.Mesh()
+    for (let i = 0; i < 2; i++) {
+        const corners = [[i, 0, 0], [i + 1, 0, 0], [i + 1, 1, 0], [i, 1, 0]]
+        for (const triangle of [[0, 1, 2], [0, 2, 3]]) {
+            for (const k of triangle)
+                mesh.vertices().add(corners[k][0] + 1e-6 * k, corners[k][1], corners[k][2])
+            const count = mesh.vertices().count
+            mesh.faces().addTriFace(count - 3, count - 2, count - 1)
+        }
+    }
+    //a flipped copy of the first triangle is a duplicate
+    mesh.faces().addTriFace(2, 1, 0)
+
+    const changed = mesh.weld(0.001, Math.PI, 0)
+
+    expect(typeof changed === 'boolean').toBe(true)
+    expect(changed).toBe(true)
+    expect(mesh.vertices().count).toBe(6)
+    expect(mesh.faces().count).toBe(4)
+    expect(mesh.weld(0.001, Math.PI, 0)).toBe(false)
+
+})
+
+//objective: adjacency of two triangles sharing an edge comes back as Uint32Array rows
+test('getAdjacency', async () => {
+
+    const mesh = new rhino.Mesh()
+    mesh.vertices().add(0, 0, 0)
+    mesh.vertices().add(1, 0, 0)
+    mesh.vertices().add(1, 1, 0)
+    mesh.vertices().add(0, 1, 0)
+    mesh.faces().addTriFace(0, 1, 2)
+    mesh.faces().addTriFace(0, 2, 3)
+
+    const adjacency = mesh.getAdjacency(0)
+
+    expect(adjacency.topologyVertexCount).toBe(4)
+    expect(adjacency.edgeCount).toBe(5)
+    expect(adjacency.faceCount).toBe(2)
+    const arrays = ['vertexMap', 'edgeVertices', 'vertexFacesOffsets', 'vertexFaces', 'vertexVerticesOffsets',
+        'vertexVertices', 'edgeFacesOffsets', 'edgeFaces', 'faceEdgesOffsets', 'faceEdges']
+    for (const name of arrays)
+        expect(adjacency[name] instanceof Uint32Array).toBe(true)
+    expect(adjacency.vertexFacesOffsets.length).toBe(5)
+    expect(adjacency.vertexFaces.length).toBe(6)
+    expect(adjacency.vertexVertices.length).toBe(10)
+    expect(adjacency.faceEdges.length).toBe(6)
+
+    //the diagonal is the only edge with two faces
+    const offsets = adjacency.edgeFacesOffsets
+    const shared = []
+    for (let e = 0; e < adjacency.edgeCount; e++) {
+        if (offsets[e + 1] - offsets[e] === 2)
+            shared.push(e)
+    }
+    expect(shared.length).toBe(1)
+    const faces = Array.from(adjacency.edgeFaces.subarray(offsets[shared[0]], offsets[shared[0] + 1])).sort()
+    expect(faces).toEqual([0, 1])
+
+})
+
+//objective: reordering a grid drawn column by column lowers the cache miss ratio
+test('optimizeForGpu', async () => {
+
+    const mesh = new rhino.Mesh()
+    const n = 20
+    for (let i = 0; i <= n; i++) {
+        for (let j = 0; j <= n; j++)
+            mesh.vertices().add(i, j, 0)
+    }
+    for (let j = 0; j < n; j++) {
+        for (let i = 0; i < n; i++) {
+            const a = i * (n + 1) + j
+            mesh.faces().addQuadFace(a, a + n + 1, a + n + 2, a + 1)
+        }
+    }
+    const faceCount = mesh.faces().count
+
+    const acmr = mesh.optimizeForGpu(true, 16)
+
+    expect(Array.isArray(acmr)).toBe(true)
+    expect(acmr.length).toBe(2)
+    expect(typeof acmr[0] === 'number').toBe(true)
+    expect(Math.abs(acmr[0] - 1.0) < 0.2).toBe(true)
+    expect(acmr[1] < acmr[0]).toBe(true)
+    expect(Math.abs(mesh.computeAcmr(16) - acmr[1]) < 1e-9).toBe(true)
+    expect(mesh.faces().count).toBe(faceCount)
+
+})
+
+//objective: quantized buffers come back as the typed arrays the options ask for
+test('toQuantizedBuffers', async () => {
+
+    const mesh = new rhino.Mesh()
+    for (let i = 0; i < 3; i++) {
+        for (let j = 0; j < 3; j++) {
+            mesh.vertices().add(i, j, 0.25 * i * j)
+            mesh.textureCoordinates().add(i / 2, j / 2)
+            mesh.vertexColors().add(80 * i, 80 * j, 0)
+        }
+    }
+    for (let i = 0; i < 2; i++) {
+        for (let j = 0; j < 2; j++) {
+            const a = i * 3 + j
+            mesh.faces().addQuadFace(a, a + 3, a + 4, a + 1)
+        }
+    }
+    mesh.normals().computeNormals()
+
+    const buffers = mesh.toQuantizedBuffers(null)
+    expect(buffers.vertexCount).toBe(9)
+    expect(buffers.triangleCount).toBe(8)
+    expect(buffers.positions instanceof Int16Array).toBe(true)
+    expect(buffers.normals instanceof Int8Array).toBe(true)
+    expect(buffers.textureCoordinates instanceof Uint16Array).toBe(true)
+    expect(buffers.colors instanceof Uint8Array).toBe(true)
+    expect(buffers.indices instanceof Uint16Array).toBe(true)
+    expect(buffers.positions.length).toBe(27)
+    expect(buffers.normals.length).toBe(18)
+    expect(buffers.textureCoordinates.length).toBe(18)
+    expect(buffers.colors.length).toBe(36)
+    expect(buffers.indices.length).toBe(24)
+    //signed octahedral components, so some are below zero on the curved part
+    expect(buffers.normals.some(v => v < 0)).toBe(true)
+    expect(buffers.dequantizationTransform instanceof rhino.Transform).toBe(true)
+
+    const options = new rhino.MeshQuantizationOptions()
+    options.unsignedPositions = true
+    options.normalBits = 12
+    options.halfFloatTextureCoordinates = false
+    const wide = mesh.toQuantizedBuffers(options)
+    expect(wide.normalBits).toBe(12)
+    expect(wide.positions instanceof Uint16Array).toBe(true)
+    expect(wide.normals instanceof Int16Array).toBe(true)
+    expect(wide.textureCoordinates instanceof Float32Array).toBe(true)
+    expect(wide.textureCoordinates[3]).toBe(0.5)
+
+    //types do not depend on the mesh having the attribute
+    const bare = new rhino.Mesh()
+    bare.vertices().add(0, 0, 0)
+    bare.vertices().add(1, 0, 0)
+    bare.vertices().add(0, 1, 0)
+    bare.faces().addTriFace(0, 1, 2)
+    const empty = bare.toQuantizedBuffers(null)
+    expect(empty.normals instanceof Int8Array).toBe(true)
+    expect(empty.normals.length).toBe(0)
+    expect(empty.textureCoordinates instanceof Uint16Array).toBe(true)
+    expect(empty.textureCoordinates.length).toBe(0)
+    expect(bare.toQuantizedBuffers(options).positions instanceof Uint16Array).toBe(true)
+
+})
+
+//objective: meshes with more vertices than 16 bit indices can address get Uint32Array indices
+test('toQuantizedBuffersLargeIndices', async () => {
+
+    const mesh = new rhino.Mesh()
+    const n = 256
+    for (let i = 0; i <= n; i++) {
+        for (let j = 0; j <= n; j++)
+            mesh.vertices().add(i, j, 0)
+    }
+    for (let i = 0; i < n; i++) {
+        for (let j = 0; j < n; j++) {
+            const a = i * (n + 1) + j
+            mesh.faces().addQuadFace(a, a + n + 1, a + n + 2, a + 1)
+        }
+    }
+
+    const buffers = mesh.toQuantizedBuffers(null)
+
+    expect(buffers.vertexCount > 0xFFFF).toBe(true)
+    expect(buffers.indices instanceof Uint32Array).toBe(true)
+    expect(buffers.indices.length).toBe(6 * n * n)
+    expect(Math.max(...buffers.indices.subarray(buffers.indices.length - 3))).toBe(buffers.vertexCount - 1)
+
+})
+
+//objective: every face lands in exactly one leaf tile and leaves respect the triangle limit
+test('splitIntoTiles', async () => {
+
+    const mesh = new rhino.Mesh()
+    const n = 20
+    for (let i = 0; i <= n; i++) {
+        for (let j = 0; j <= n; j++)
+            mesh.vertices().add(i, j, 0.1 * ((i * 7 + j * 3) % 5))
+    }
+    for (let i = 0; i < n; i++) {
+        for (let j = 0; j < n; j++) {
+            const a = i * (n + 1) + j
+            mesh.faces().addQuadFace(a, a + n + 1, a + n + 2, a + 1)
+        }
+    }
+
+    const tiles = mesh.splitIntoTiles(100, 0, 0, false)
+    expect(tiles instanceof rhino.TileSet).toBe(true)
+    expect(tiles.getParent(0)).toBe(-1)
+    const faces = []
+    for (let t = 0; t < tiles.tileCount; t++) {
+        const children = tiles.getChildren(t)
+        const indices = tiles.getItemIndices(t)
+        expect(Array.isArray(children)).toBe(true)
+        expect(indices instanceof Uint32Array).toBe(true)
+        expect(tiles.getBoundingBox(t) instanceof rhino.BoundingBox).toBe(true)
+        const content = tiles.getContent(t)
+        if (children.length > 0) {
+            expect(content).toBe(null)
+            continue
+        }
+        expect(content instanceof rhino.Mesh).toBe(true)
+        expect(2 * content.faces().count <= 100).toBe(true)
+        faces.push(...indices)
+    }
+    faces.sort((a, b) => a - b)
+    expect(faces).toEqual([...Array(mesh.faces().count).keys()])
+    expect(JSON.parse(tiles.toTilesetJson('tiles/{index}.glb')).asset.version).toBe('1.1')
+
+    //with level of detail inner tiles get a simplified mesh and replace refinement
+    const lod = mesh.splitIntoTiles(100, 0, 0, true)
+    expect(lod.getContent(0) instanceof rhino.Mesh).toBe(true)
+    expect(lod.getGeometricError(0) > 0).toBe(true)
+    expect(JSON.parse(lod.toTilesetJson('tiles/{index}.glb')).root.refine).toBe('REPLACE')
+
+})
@@ -37,4 +37,22 @@ test('objectUserString', async () => {
 
     expect(valueRead === value).toBe(true)
 
-})
\ No newline at end of file
+})
+//objective: binary encode round trips one object and many objects with random access
+test('objectEncodeBinary', async () => {
+
+    const line = new rhino.LineCurve([0, 0, 0], [1, 2, 3])
+    const data = line.encodeBinary()
+    expect(data instanceof Uint8Array).toBe(true)
+    const decoded = rhino.CommonObject.decodeBinary(data)
+    expect(decoded.pointAtEnd[2]).toBe(3)
+
+    const lines = []
+    for (let i = 1; i <= 10; i++)
+        lines.push(new rhino.LineCurve([0, 0, 0], [i, 0, 0]))
+    const packed = rhino.CommonObject.encodeMany(lines)
+    expect(rhino.CommonObject.encodedCount(packed)).toBe(10)
+    expect(rhino.CommonObject.decodeMany(packed).length).toBe(10)
+    expect(rhino.CommonObject.decodeAt(packed, 6).pointAtEnd[0]).toBe(7)
+
+})
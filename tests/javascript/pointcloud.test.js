@@ -135,4 +135,125 @@ test('members', async () => {
     expect(Array.isArray(vals)).toBe(true)
     expect(typeof vals[0] === 'number').toBe(true)
 
-})
\ No newline at end of file
+})
+//objective: leaf tiles split the points without losing any and hold them as point clouds
+test('buildTiles', async () => {
+
+    const points = []
+    for (let i = 0; i < 1000; i++)
+        points.push([i % 10, Math.floor(i / 10) % 10, Math.floor(i / 100)])
+    const pc = new rhino.PointCloud(points)
+
+    const tiles = pc.buildTiles(64, 0)
+
+    expect(tiles instanceof rhino.TileSet).toBe(true)
+    const indices = []
+    for (let t = 0; t < tiles.tileCount; t++) {
+        const children = tiles.getChildren(t)
+        expect(Array.isArray(children)).toBe(true)
+        expect(tiles.getItemIndices(t) instanceof Uint32Array).toBe(true)
+        if (children.length > 0)
+            continue
+        const content = tiles.getContent(t)
+        expect(content instanceof rhino.PointCloud).toBe(true)
+        expect(content.count <= 64).toBe(true)
+        indices.push(...tiles.getItemIndices(t))
+    }
+    indices.sort((a, b) => a - b)
+    expect(indices).toEqual([...Array(points.length).keys()])
+
+})
+
+//objective: voxel downsampling keeps one averaged point per occupied cell
+test('voxelDownsample', async () => {
+
+    const pc = new rhino.PointCloud()
+    for (let i = 0; i < 10; i++) {
+        for (let j = 0; j < 10; j++) {
+            pc.addPointValue([i + 0.25, j + 0.25, 0], 2 * i)
+            pc.addPointValue([i + 0.75, j + 0.75, 0], 2 * i + 1)
+        }
+    }
+
+    const reduced = pc.voxelDownsample(1.0, 0)
+
+    expect(reduced instanceof rhino.PointCloud).toBe(true)
+    expect(reduced.count).toBe(100)
+    expect(pc.count).toBe(200)
+    const values = reduced.getValues()
+    for (let k = 0; k < reduced.count; k++) {
+        const p = reduced.pointAt(k)
+        expect(Math.abs(p[0] - Math.floor(p[0]) - 0.5) < 1e-9).toBe(true)
+        expect(Math.abs(values[k] - (2 * Math.floor(p[0]) + 0.5)) < 1e-9).toBe(true)
+    }
+
+})
+
+//objective: every point is in exactly one octree tile and no tile holds more than the limit
+test('buildLodOctree', async () => {
+
+    const points = []
+    for (let i = 0; i < 8000; i++)
+        points.push([i % 40, Math.floor(i / 40) % 40, 0.1 * Math.floor(i / 1600)])
+    const pc = new rhino.PointCloud(points)
+
+    const tiles = pc.buildLodOctree(500, 0)
+
+    expect(tiles instanceof rhino.TileSet).toBe(true)
+    expect(tiles.getChildren(0).length > 0).toBe(true)
+    const indices = []
+    for (let t = 0; t < tiles.tileCount; t++) {
+        const content = tiles.getContent(t)
+        expect(content instanceof rhino.PointCloud).toBe(true)
+        expect(content.count <= 500).toBe(true)
+        const items = tiles.getItemIndices(t)
+        expect(items instanceof Uint32Array).toBe(true)
+        indices.push(...items)
+    }
+    indices.sort((a, b) => a - b)
+    expect(indices).toEqual([...Array(points.length).keys()])
+    expect(JSON.parse(tiles.toTilesetJson('{index}.pnts')).root.refine).toBe('ADD')
+
+})
+
+//objective: normals of a noisy plane point up when oriented towards a point above it
+test('estimateNormals', async () => {
+
+    const pc = new rhino.PointCloud()
+    for (let i = 0; i < 30; i++) {
+        for (let j = 0; j < 30; j++)
+            pc.add([i, j, 0.01 * ((i * 7 + j * 13) % 5)])
+    }
+    expect(pc.containsNormals).toBe(false)
+
+    const rc = pc.estimateNormals(12, 0, [15, 15, 100], 0)
+
+    expect(typeof rc === 'boolean').toBe(true)
+    expect(rc).toBe(true)
+    expect(pc.containsNormals).toBe(true)
+    const normals = pc.getNormals()
+    expect(normals.length).toBe(pc.count)
+    for (const n of normals)
+        expect(n[2] > 0.99).toBe(true)
+
+})
+
+//objective: isolated points are hidden and counted, the grid stays visible
+test('removeStatisticalOutliers', async () => {
+
+    const pc = new rhino.PointCloud()
+    for (let i = 0; i < 20; i++) {
+        for (let j = 0; j < 20; j++)
+            pc.add([i, j, 0])
+    }
+    pc.add([100, 100, 50])
+    pc.add([-80, 40, -60])
+
+    const count = pc.removeStatisticalOutliers(8, 2.0, 0)
+
+    expect(Number.isInteger(count)).toBe(true)
+    expect(count).toBe(2)
+    expect(pc.hiddenPointCount).toBe(2)
+    expect(pc.count).toBe(402)
+
+})
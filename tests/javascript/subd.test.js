@@ -0,0 +1,99 @@
+const rhino3dm = require('rhino3dm')
+
+let rhino
+
+beforeAll(async () => {
+    rhino = await rhino3dm()
+})
+
+// Unit cube control net with outward facing quads
+function cubeSubD() {
+    const mesh = new rhino.Mesh()
+    for (const z of [0, 1]) {
+        mesh.vertices().add(0, 0, z)
+        mesh.vertices().add(1, 0, z)
+        mesh.vertices().add(1, 1, z)
+        mesh.vertices().add(0, 1, z)
+    }
+    for (const face of [[0, 3, 2, 1], [4, 5, 6, 7], [0, 1, 5, 4], [1, 2, 6, 5], [2, 3, 7, 6], [3, 0, 4, 7]])
+        mesh.faces().addQuadFace(face[0], face[1], face[2], face[3])
+    return rhino.SubD.createFromMesh(mesh)
+}
+
+//objective: limit surface mesh buffers of a SubD
+test('GetSurfaceMeshBuffers', async () => {
+
+    const subd = new rhino.SubD()
+    const buffers = subd.getSurfaceMeshBuffers(2, true)
+
+    expect(buffers.positions instanceof Float32Array).toBe(true)
+    expect(buffers.indices instanceof Uint32Array).toBe(true)
+    expect(buffers.positions.length).toBe(3 * buffers.vertexCount)
+    expect(buffers.normals.length).toBe(3 * buffers.vertexCount)
+    expect(buffers.indices.length).toBe(3 * buffers.triangleCount)
+    expect(buffers.faceIds.length).toBe(buffers.triangleCount)
+
+})
+
+//objective: the limit surface of a cube SubD meshes every face with valid indices and unit normals
+test('GetSurfaceMeshBuffersCube', async () => {
+
+    const subd = cubeSubD()
+    expect(subd).not.toBe(null)
+    expect(subd.isSolid).toBe(true)
+    const buffers = subd.getSurfaceMeshBuffers(2, true)
+    expect(buffers.vertexCount > 0).toBe(true)
+    expect(buffers.triangleCount > 0).toBe(true)
+    expect(buffers.indices.every(i => i < buffers.vertexCount)).toBe(true)
+    for (let i = 0; i < buffers.vertexCount; i++) {
+        const n = buffers.normals.subarray(3 * i, 3 * i + 3)
+        expect(Math.hypot(n[0], n[1], n[2])).toBeCloseTo(1, 4)
+    }
+    expect(buffers.positions.every(p => p >= -1e-5 && p <= 1 + 1e-5)).toBe(true)
+    expect(new Set(buffers.faceIds).size).toBe(6)
+
+})
+
+//objective: convert SubDs to breps one at a time and in a batch
+test('ToBrepMany', async () => {
+
+    const parameters = new rhino.SubDToBrepParameters()
+    parameters.packFaces = false
+    expect(parameters.packFaces).toBe(false)
+    parameters.extraordinaryVertexProcess = rhino.SubDToBrepVertexProcess.LocalG1
+    expect(parameters.extraordinaryVertexProcess.value).toBe(rhino.SubDToBrepVertexProcess.LocalG1.value)
+
+    const subd = new rhino.SubD()
+    expect(subd.toBrep(parameters)).toBe(null)
+
+    const results = rhino.SubD.toBrepMany([subd, new rhino.SubD(), subd], parameters, 0)
+    expect(results.count).toBe(3)
+    expect(results.breps.length).toBe(3)
+    expect(results.seconds instanceof Float64Array).toBe(true)
+    expect(results.seconds.length).toBe(3)
+    expect(results.totalSeconds >= 0).toBe(true)
+
+})
+
+//objective: a cube SubD converts to a valid brep with one face per SubD face, singly and in a batch
+test('ToBrepCube', async () => {
+
+    const subd = cubeSubD()
+    const parameters = new rhino.SubDToBrepParameters()
+    parameters.packFaces = false
+
+    const brep = subd.toBrep(parameters)
+    expect(brep).not.toBe(null)
+    expect(brep.isValid).toBe(true)
+    expect(brep.isSolid).toBe(true)
+    expect(brep.faces().count).toBe(6)
+
+    const results = rhino.SubD.toBrepMany([subd, cubeSubD(), subd], parameters, 2)
+    expect(results.count).toBe(3)
+    for (const item of results.breps) {
+        expect(item).not.toBe(null)
+        expect(item.isValid).toBe(true)
+        expect(item.faces().count).toBe(6)
+    }
+
+})
@@ -16,3 +16,42 @@ test('toFloatArray', async () => {
     expect(typeof fa[0] === 'number').toBe(true)
 
 })
+
+//objective: packed points are transformed in place or into a new array of the same type
+test('applyToPoints', async () => {
+
+    const xform = rhino.Transform.translationXYZ(1, 2, 3)
+    const values = [0, 0, 0, 1, 1, 1, -2, 5, 10]
+    const expected = values.map((v, i) => v + (i % 3) + 1)
+
+    const points = new Float64Array(values)
+    const transformed = xform.applyToPoints(points, false)
+    expect(Array.from(points)).toEqual(values)
+    expect(transformed instanceof Float64Array).toBe(true)
+    expect(Array.from(transformed)).toEqual(expected)
+
+    expect(xform.applyToPoints(points, true)).toBe(points)
+    expect(Array.from(points)).toEqual(expected)
+
+    const floats = new Float32Array(values)
+    xform.applyToPoints(floats, true)
+    expect(Array.from(floats)).toEqual(expected)
+
+})
+
+//objective: many geometries are transformed by one or matching transforms
+test('transformMany', async () => {
+
+    const points = []
+    for (let i = 0; i < 10; i++)
+        points.push(new rhino.Point([i, 0, 0]))
+
+    const count = rhino.GeometryBase.transformMany(points, [rhino.Transform.translationXYZ(0, 1, 0)])
+    expect(count).toBe(10)
+    points.forEach((point, i) => {
+        expect(point.location[0]).toBe(i)
+        expect(point.location[1]).toBe(1)
+    })
+
+})
+
@@ -22,6 +22,51 @@ class TestAnnotation(unittest.TestCase):
                 if not any(x in geo.Text for x in plainText):
                         self.fail("Something wrong with TextDot.Text")
 
+    #objective: text is tessellated into packed buffers, each distinct glyph once
+    def test_tessellateAnnotations(self):
+        model = rhino3dm.File3dm.Read("../models/textEntities_r8.3dm")
+
+        filled = rhino3dm.AnnotationTessellation.FromFile3dm(model)
+        self.assertTrue(filled.GlyphCount > 0)
+        self.assertTrue(filled.UniqueGlyphCount <= filled.GlyphCount)
+        self.assertTrue(rhino3dm.AnnotationTessellation.GlyphCacheCount() >= filled.UniqueGlyphCount)
+        self.assertEqual(len(filled.Indices), 3 * filled.TriangleCount)
+        self.assertEqual(len(filled.TriangleSourceIndices), filled.TriangleCount)
+
+        outlines = rhino3dm.AnnotationTessellation.FromFile3dm(model, False)
+        self.assertEqual(outlines.TriangleCount, 0)
+        self.assertEqual(len(outlines.PolylineOffsets), outlines.PolylineCount + 1)
+        self.assertEqual(outlines.GlyphCount, filled.GlyphCount)
+
+        # builds without a font engine count glyphs but have no geometry for
+        # them, and say so
+        available = rhino3dm.AnnotationTessellation.GlyphOutlinesAvailable
+        self.assertTrue(type(available) == bool)
+        text = next(obj.Geometry for obj in model.Objects
+                    if obj.Geometry.ObjectType == rhino3dm.ObjectType.Annotation and "Hello World!" in obj.Geometry.PlainText)
+        self.assertEqual(rhino3dm.AnnotationTessellation.FromAnnotation(text).TriangleCount > 0, available)
+        self.assertEqual(rhino3dm.AnnotationTessellation.FromAnnotation(text, None, False).PointCount > 0, available)
+        self.assertEqual(filled.TriangleCount > 0, available)
+        self.assertEqual(outlines.PointCount > 0, available)
+
+    #objective: text follows the model space scale of its dimension style
+    def test_tessellateScaledDimStyle(self):
+        model = rhino3dm.File3dm.Read("../models/textEntities_r8.3dm")
+        text = next(obj.Geometry for obj in model.Objects
+                    if obj.Geometry.ObjectType == rhino3dm.ObjectType.Annotation and "Hello World!" in obj.Geometry.PlainText)
+        style = rhino3dm.DimensionStyle()
+        plain = rhino3dm.AnnotationTessellation.FromAnnotation(text, style, False)
+        style.DimensionScale = 2.0
+        scaled = rhino3dm.AnnotationTessellation.FromAnnotation(text, style, False)
+
+        self.assertEqual(scaled.GlyphCount, plain.GlyphCount)
+        self.assertEqual(scaled.PointCount, plain.PointCount)
+        if rhino3dm.AnnotationTessellation.GlyphOutlinesAvailable:
+            plainSize = plain.BoundingBox.Diagonal
+            scaledSize = scaled.BoundingBox.Diagonal
+            self.assertAlmostEqual(scaledSize.X, 2.0 * plainSize.X, delta=1e-3 * scaledSize.X)
+            self.assertAlmostEqual(scaledSize.Y, 2.0 * plainSize.Y, delta=1e-3 * scaledSize.Y)
+
 if __name__ == '__main__':
     print("running tests")
     unittest.main()
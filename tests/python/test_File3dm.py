@@ -1,4 +1,9 @@
+import base64
+import json
+import os
 import rhino3dm
+import struct
+import tempfile
 import unittest
 
 
@@ -43,7 +48,221 @@ class TestFile3dmTables(unittest.TestCase):
 
         self.assertTrue(type(embeddedFiles) == list)
         self.assertTrue(type(embeddedFiles[0]) == str)
-        
+
+    #objective: embedded files come back as raw bytes and can be extracted to a folder
+    def test_file3dmEmbeddedFileBytes(self):
+        file3dm = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        path = file3dm.EmbeddedFilePaths2()[0]
+
+        data = file3dm.GetEmbeddedFileBytes(path)
+        self.assertTrue(len(data) > 0)
+        self.assertEqual(data, base64.b64decode(file3dm.GetEmbeddedFileAsBase64(path)))
+
+        with tempfile.TemporaryDirectory() as directory:
+            written = file3dm.ExtractAllEmbeddedFiles(directory)
+            self.assertEqual(len(written), len(file3dm.EmbeddedFilePaths2()))
+            with open(written[0], 'rb') as f:
+                self.assertEqual(f.read(), data)
+
+    #objective: profiled read reports per table statistics and the slowest objects
+    def test_readWithProfile(self):
+        file3dm, report = rhino3dm.File3dm.ReadWithProfile('../models/file3dm_stuff.3dm', 5)
+
+        self.assertTrue(file3dm is not None)
+        self.assertTrue(report['success'])
+        self.assertEqual(report['operation'], 'read')
+        self.assertEqual(len(file3dm.Objects), 22)
+        self.assertEqual(report['tables']['objects']['count'], 22)
+        self.assertEqual(report['tables']['layers']['count'], 6)
+        self.assertGreater(report['totalBytes'], 0)
+        self.assertLessEqual(len(report['slowestObjects']), 5)
+        self.assertEqual(sum(t['count'] for t in report['objectTypes'].values()), 22)
+
+    def test_readWithProfileMissingFile(self):
+        file3dm, report = rhino3dm.File3dm.ReadWithProfile('../models/does_not_exist.3dm')
+        self.assertTrue(file3dm is None)
+        self.assertFalse(report['success'])
+        self.assertTrue(len(report['errorLog']) > 0)
+
+    #objective: memory report totals add up and list the largest objects
+    def test_memoryReport(self):
+        file3dm = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        report = file3dm.MemoryReport(3)
+
+        self.assertEqual(report['tables']['objects']['count'], 22)
+        self.assertEqual(report['tables']['layers']['count'], 6)
+        # embedded file table entries plus the RDK embedded files
+        self.assertEqual(report['embeddedFiles']['count'], len(file3dm.EmbeddedFiles) + len(file3dm.EmbeddedFilePaths2()))
+        # the RDK files are taken out of the document user data they live in
+        self.assertLess(report['documentUserData']['bytes'], report['totalBytes'])
+        self.assertEqual(len(report['largestObjects']), 3)
+        self.assertGreaterEqual(report['largestObjects'][0]['bytes'], report['largestObjects'][2]['bytes'])
+        parts = sum(t['bytes'] for t in report['tables'].values())
+        parts += report['renderMeshes']['bytes'] + report['userData']['bytes']
+        parts += report['documentUserData']['bytes'] + report['embeddedFiles']['bytes']
+        self.assertEqual(report['totalBytes'], parts)
+
+    #objective: GLB export writes a valid header, one mesh for a block and GPU instances for its placements
+    def test_toGlb(self):
+        file3dm = rhino3dm.File3dm()
+        mesh = rhino3dm.Mesh()
+        mesh.Vertices.Add(0, 0, 0)
+        mesh.Vertices.Add(1, 0, 0)
+        mesh.Vertices.Add(1, 1, 0)
+        mesh.Vertices.Add(0, 1, 0)
+        mesh.Faces.AddFace(0, 1, 2, 3)
+        index = file3dm.InstanceDefinitions.Add('block', '', '', '', rhino3dm.Point3d(0, 0, 0), (mesh,), (rhino3dm.ObjectAttributes(),))
+        idefId = file3dm.InstanceDefinitions.FindIndex(index).Id
+        for i in range(3):
+            file3dm.Objects.AddInstanceObject(rhino3dm.InstanceReference(idefId, rhino3dm.Transform.Translation(2 * i, 0, 0)))
+
+        options = rhino3dm.File3dmGlbOptions()
+        options.QuantizeAttributes = True
+        glb = file3dm.ToGlb(options)
+
+        magic, version, length = struct.unpack_from('<4sII', glb, 0)
+        self.assertEqual(magic, b'glTF')
+        self.assertEqual(version, 2)
+        self.assertEqual(length, len(glb))
+        jsonLength, jsonType = struct.unpack_from('<I4s', glb, 12)
+        self.assertEqual(jsonType, b'JSON')
+        gltf = json.loads(glb[20:20 + jsonLength])
+        self.assertEqual(len(gltf['meshes']), 1)
+        self.assertIn('KHR_mesh_quantization', gltf['extensionsRequired'])
+        self.assertIn('EXT_mesh_gpu_instancing', gltf['extensionsUsed'])
+        instanced = [n for n in gltf['nodes'] if 'extensions' in n]
+        self.assertEqual(len(instanced), 1)
+
+    #objective: a sheared placement is baked into its own mesh and every node stays translation / rotation / scale
+    def test_toGlbShear(self):
+        file3dm = rhino3dm.File3dm()
+        mesh = rhino3dm.Mesh()
+        mesh.Vertices.Add(0, 0, 0)
+        mesh.Vertices.Add(1, 0, 0)
+        mesh.Vertices.Add(1, 1, 0)
+        mesh.Faces.AddFace(0, 1, 2)
+        index = file3dm.InstanceDefinitions.Add('block', '', '', '', rhino3dm.Point3d(0, 0, 0), (mesh,), (rhino3dm.ObjectAttributes(),))
+        idefId = file3dm.InstanceDefinitions.FindIndex(index).Id
+        shear = rhino3dm.Transform(1.0)
+        shear.M01 = 0.5
+        file3dm.Objects.AddInstanceObject(rhino3dm.InstanceReference(idefId, rhino3dm.Transform.Translation(2, 0, 0)))
+        file3dm.Objects.AddInstanceObject(rhino3dm.InstanceReference(idefId, shear))
+
+        glb = file3dm.ToGlb(rhino3dm.File3dmGlbOptions())
+        jsonLength, = struct.unpack_from('<I', glb, 12)
+        gltf = json.loads(glb[20:20 + jsonLength])
+        self.assertEqual(len(gltf['meshes']), 2)
+        for node in gltf['nodes']:
+            self.assertNotIn('matrix', node)
+        # the sheared copy keeps the vertex count and moves the (1, 1) corner to x = 1.5
+        positions = [gltf['accessors'][m['primitives'][0]['attributes']['POSITION']] for m in gltf['meshes']]
+        self.assertEqual([a['count'] for a in positions], [3, 3])
+        self.assertIn(1.5, [a['max'][0] for a in positions])
+
+    #objective: base64 text written while the model is saved decodes back to the same model
+    def test_encodeDecode(self):
+        file3dm = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        encoded = file3dm.Encode()
+        self.assertEqual(len(encoded) % 4, 0)
+
+        decoded = rhino3dm.File3dm.Decode(encoded)
+        self.assertEqual(len(decoded.Objects), len(file3dm.Objects))
+        self.assertEqual(len(decoded.Layers), len(file3dm.Layers))
+
+    #objective: re-saving a read model keeps untouched objects and picks up attribute, geometry and table edits
+    def test_writeAfterEdit(self):
+        file3dm = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        file3dm.Objects[0].Attributes.Name = 'renamed'
+        moved = file3dm.Objects[1]
+        moved.Geometry.Translate(rhino3dm.Vector3d(0, 0, 10))
+        movedBox = moved.Geometry.GetBoundingBox()
+        file3dm.Objects.Delete(file3dm.Objects[2].Attributes.Id)
+        file3dm.Objects.AddPoint(1, 2, 3)
+
+        with tempfile.TemporaryDirectory() as directory:
+            path = directory + '/edited.3dm'
+            self.assertTrue(file3dm.Write(path, 8))
+            saved = rhino3dm.File3dm.Read(path)
+            self.assertEqual(len(saved.Objects), 22)
+            self.assertEqual(len(saved.Layers), 6)
+            self.assertEqual(saved.Objects[0].Attributes.Name, 'renamed')
+            self.assertAlmostEqual(saved.Objects[1].Geometry.GetBoundingBox().Min.Z, movedBox.Min.Z)
+
+            # saving over the file just written, then with a table edit
+            saved.Objects[0].Attributes.Name = 'again'
+            self.assertTrue(saved.Write(path, 8))
+            saved.Layers[0].Name = 'edited layer'
+            self.assertTrue(saved.Write(path, 8))
+            again = rhino3dm.File3dm.Read(path)
+            self.assertEqual(again.Objects[0].Attributes.Name, 'again')
+            self.assertEqual(again.Layers[0].Name, 'edited layer')
+
+            # untouched records are copied with the compression they were read
+            # with, while a full rewrite compresses them: a re-save of a stored
+            # source stays close to the stored size
+            options = rhino3dm.File3dmWriteOptions()
+            options.CompressBuffers = False
+            stored = directory + '/stored.3dm'
+            self.assertTrue(again.Write(stored, options))
+            source = rhino3dm.File3dm.Read(stored)
+            source.Objects[0].Attributes.Name = 'reused'
+            reused = directory + '/reused.3dm'
+            self.assertTrue(source.Write(reused, 8))
+            threshold = (os.path.getsize(stored) + os.path.getsize(path)) / 2
+            self.assertGreater(os.path.getsize(reused), threshold)
+            self.assertEqual(rhino3dm.File3dm.Read(reused).Objects[0].Attributes.Name, 'reused')
+
+    #objective: threaded writes produce the same bytes as serial ones and stored writes read back
+    def test_writeOptions(self):
+        # only points, curves and surfaces with sequential indices, so the
+        # threaded write splits the object table into blocks rather than
+        # falling back to the serial write models with lights take
+        file3dm = rhino3dm.File3dm()
+        for i in range(100):
+            file3dm.Objects.AddPoint(i, 0, 0)
+            file3dm.Objects.AddLine(rhino3dm.Point3d(i, 1, 0), rhino3dm.Point3d(i, 2, 0))
+            file3dm.Objects.AddSphere(rhino3dm.Sphere(rhino3dm.Point3d(i, 4, 0), 0.5))
+        options = rhino3dm.File3dmWriteOptions()
+        self.assertTrue(options.CompressBuffers)
+        self.assertEqual(options.ThreadCount, 1)
+        serial = file3dm.Encode(options)
+        options.ThreadCount = 4
+        self.assertEqual(file3dm.Encode(options), serial)
+        self.assertEqual(len(rhino3dm.File3dm.Decode(serial).Objects), 300)
+
+        # a model with lights is written serially whatever the thread count
+        lights = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        options.ThreadCount = 1
+        lightsSerial = lights.Encode(options)
+        options.ThreadCount = 4
+        self.assertEqual(lights.Encode(options), lightsSerial)
+
+        options.CompressBuffers = False
+        stored = file3dm.Encode(options)
+        self.assertGreater(len(stored), len(serial))
+        decoded = rhino3dm.File3dm.Decode(stored)
+        self.assertEqual(len(decoded.Objects), len(file3dm.Objects))
+
+        with tempfile.TemporaryDirectory() as directory:
+            path = directory + '/options.3dm'
+            self.assertTrue(file3dm.Write(path, options))
+            self.assertEqual(len(rhino3dm.File3dm.Read(path).Objects), len(file3dm.Objects))
+
+    #objective: indexing keeps following the table through random access, deletes and adds
+    def test_objectTableIndex(self):
+        file3dm = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        ids = [obj.Attributes.Id for obj in file3dm.Objects]
+        self.assertEqual(len(ids), len(file3dm.Objects))
+        self.assertEqual(file3dm.Objects[7].Attributes.Id, ids[7])
+        self.assertEqual(file3dm.Objects[3].Attributes.Id, ids[3])
+        self.assertEqual(file3dm.Objects[-1].Attributes.Id, ids[-1])
+        self.assertEqual(file3dm.Objects.FindId(ids[5]).Attributes.Id, ids[5])
+
+        file3dm.Objects.Delete(ids[3])
+        self.assertEqual(file3dm.Objects[3].Attributes.Id, ids[4])
+        added = file3dm.Objects.AddPoint(1, 2, 3)
+        self.assertEqual(len(file3dm.Objects), len(ids))
+        self.assertIn(added, [obj.Attributes.Id for obj in file3dm.Objects])
 
 if __name__ == '__main__':
     print("running tests")
@@ -30,6 +30,38 @@ class TestFile3dmBitmapTable(unittest.TestCase):
 
         self.assertTrue(qtyBitmaps1 == 2 and qtyBitmaps2 == 1)
 
+#objective: bitmaps without uncompressed bits convert to empty pixel buffers
+class TestBitmapPixels(unittest.TestCase):
+
+    def test_toPixels(self):
+        bitmap = rhino3dm.Bitmap()
+        pixels = bitmap.ToPixels(rhino3dm.BitmapPixelFormat.Rgba8)
+        self.assertEqual(len(pixels), 0)
+        self.assertEqual(len(memoryview(bitmap)), 0)
+
+        file3dm = rhino3dm.File3dm.Read('../models/file3dm_stuff.3dm')
+        converted = file3dm.Bitmaps.ToPixels(rhino3dm.BitmapPixelFormat.Bgra8, 2)
+        self.assertEqual(len(converted), len(file3dm.Bitmaps))
+
+    #objective: a 2x2 DIB written through its buffer converts to known pixels in every format
+    def test_toPixelsValues(self):
+        bitmap = rhino3dm.Bitmap(2, 2, 32)
+        self.assertEqual(bitmap.SizeOfImage, 16)
+        # DIB scan lines are bottom row first, pixels blue, green, red, alpha
+        bits = memoryview(bitmap).cast('B')
+        bits[:] = bytes([0, 0, 255, 255,   0, 255, 0, 255,
+                         255, 0, 0, 255,   255, 255, 255, 128])
+
+        # top row first: blue, half transparent white, then red, green
+        self.assertEqual(bytes(bitmap.ToPixels(rhino3dm.BitmapPixelFormat.Rgba8)),
+                         bytes([0, 0, 255, 255, 255, 255, 255, 128, 255, 0, 0, 255, 0, 255, 0, 255]))
+        self.assertEqual(bytes(bitmap.ToPixels(rhino3dm.BitmapPixelFormat.Bgra8)),
+                         bytes([255, 0, 0, 255, 255, 255, 255, 128, 0, 0, 255, 255, 0, 255, 0, 255]))
+        self.assertEqual(bytes(bitmap.ToPixels(rhino3dm.BitmapPixelFormat.Rgb8)),
+                         bytes([0, 0, 255, 255, 255, 255, 255, 0, 0, 0, 255, 0]))
+        self.assertEqual(bytes(bitmap.ToPixels(rhino3dm.BitmapPixelFormat.Gray8)),
+                         bytes([29, 255, 76, 150]))
+
 if __name__ == '__main__':
     print("running tests")
     unittest.main()
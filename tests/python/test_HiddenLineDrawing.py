@@ -0,0 +1,71 @@
+import rhino3dm
+import unittest
+import uuid
+
+#objective: hidden line drawing of a line partially covered by a mesh, seen from the top
+class TestHiddenLineDrawing(unittest.TestCase):
+
+    def createModel(self):
+        file3dm = rhino3dm.File3dm()
+        mesh = rhino3dm.Mesh()
+        mesh.Vertices.Add(-1, -1, 1)
+        mesh.Vertices.Add(1, -1, 1)
+        mesh.Vertices.Add(1, 1, 1)
+        mesh.Vertices.Add(-1, 1, 1)
+        mesh.Faces.AddFace(0, 1, 2, 3)
+        file3dm.Objects.AddMesh(mesh)
+        file3dm.Objects.AddLine(rhino3dm.Point3d(-2, 0, 0), rhino3dm.Point3d(2, 0, 0))
+        return file3dm
+
+    def compute(self, multipleThreads):
+        parameters = rhino3dm.HiddenLineDrawingParameters()
+        self.assertTrue(parameters.SetViewport(rhino3dm.ViewportInfo.DefaultTop()))
+        self.assertEqual(parameters.AddObjects(self.createModel()), 2)
+        return rhino3dm.HiddenLineDrawing.Compute(parameters, multipleThreads)
+
+    def test_packedBuffers(self):
+        drawing = self.compute(True)
+        count = drawing.PolylineCount
+        self.assertTrue(count > 0)
+        self.assertEqual(len(drawing.PolylineOffsets), count + 1)
+        self.assertEqual(len(drawing.Visibility), count)
+        self.assertEqual(len(drawing.SegmentTypes), count)
+        self.assertEqual(len(drawing.SourceIndices), count)
+        self.assertEqual(len(drawing.Points), 2 * drawing.PointCount)
+        self.assertEqual(drawing.PolylineOffsets[count], drawing.PointCount)
+        self.assertEqual(len(drawing.SourceIds), 2)
+        self.assertTrue(type(drawing.SourceIds[0]) == uuid.UUID)
+
+    def test_hiddenSegment(self):
+        drawing = self.compute(True)
+        hidden = int(rhino3dm.HiddenLineSegmentVisibility.Hidden)
+        curve = int(rhino3dm.HiddenLineSegmentType.Curve)
+        points = drawing.Points
+        offsets = drawing.PolylineOffsets
+        hiddenCurves = [i for i in range(drawing.PolylineCount) if drawing.Visibility[i] == hidden and drawing.SegmentTypes[i] == curve]
+        self.assertEqual(len(hiddenCurves), 1)
+        i = hiddenCurves[0]
+        xs = [points[2 * j] for j in range(offsets[i], offsets[i + 1])]
+        self.assertAlmostEqual(min(xs), -1.0, delta=0.01)
+        self.assertAlmostEqual(max(xs), 1.0, delta=0.01)
+
+    def test_singleThreadMatches(self):
+        a = self.compute(True)
+        b = self.compute(False)
+        self.assertEqual(a.Points.tobytes(), b.Points.tobytes())
+        self.assertEqual(a.Visibility.tobytes(), b.Visibility.tobytes())
+
+    def test_clippingPlane(self):
+        parameters = rhino3dm.HiddenLineDrawingParameters()
+        parameters.SetViewport(rhino3dm.ViewportInfo.DefaultTop())
+        parameters.AddObjects(self.createModel())
+        # keep x >= 1.5 only
+        parameters.AddClippingPlane(rhino3dm.Plane(rhino3dm.Point3d(1.5, 0, 0), rhino3dm.Vector3d(1, 0, 0)))
+        drawing = rhino3dm.HiddenLineDrawing.Compute(parameters)
+        self.assertEqual(drawing.PolylineCount, 1)
+        self.assertAlmostEqual(drawing.BoundingBox.Min.X, 1.5, delta=0.001)
+
+if __name__ == '__main__':
+    print("running tests")
+    unittest.main()
+    print("tests complete")
@@ -1,3 +1,4 @@
+import math
 import unittest
 import rhino3dm
 
@@ -44,6 +45,183 @@ class TestMesh(unittest.TestCase):
         self.assertTrue(type(faceVertices[3]) == rhino3dm.Point3f)
         self.assertTrue(type(faceVertices[4]) == rhino3dm.Point3f)
 
+    def test_meshSimplify(self):
+
+        #objective: simplify to a triangle budget without touching the source mesh
+        faceCount = self.mesh.Faces.Count
+        triangles = self.mesh.Faces.TriangleCount + 2 * self.mesh.Faces.QuadCount
+        simplified = self.mesh.Simplify(0.5)
+
+        self.assertTrue(type(simplified) == rhino3dm.Mesh)
+        self.assertTrue(self.mesh.Faces.Count == faceCount)
+        # the result is all triangles, at the ratio of the input triangles
+        self.assertTrue(simplified.Faces.QuadCount == 0)
+        self.assertTrue(simplified.Faces.Count > 0)
+        self.assertTrue(simplified.Faces.Count < triangles)
+        self.assertTrue(simplified.Faces.Count <= math.ceil(0.5 * triangles) + 2)
+        self.assertTrue(simplified.Vertices.Count <= self.mesh.Vertices.Count)
+
+    def test_meshBuildLods(self):
+
+        #objective: every level has no more triangles than the one before it
+        lods = self.mesh.BuildLods(3)
+
+        self.assertTrue(type(lods) == tuple)
+        self.assertTrue(len(lods) == 3)
+        for i in range(1, len(lods)):
+            self.assertTrue(lods[i].Faces.Count <= lods[i - 1].Faces.Count)
+
+    def test_meshWeld(self):
+
+        #objective: a triangle soup of two quads welds into 6 vertices and 4 faces
+        mesh = rhino3dm.Mesh()
+        for i in range(2):
+            corners = [(i, 0, 0), (i + 1, 0, 0), (i + 1, 1, 0), (i, 1, 0)]
+            for triangle in [(0, 1, 2), (0, 2, 3)]:
+                for k in triangle:
+                    x, y, z = corners[k]
+                    mesh.Vertices.Add(x + 1e-6 * k, y, z)
+                count = len(mesh.Vertices)
+                mesh.Faces.AddFace(count - 3, count - 2, count - 1)
+        #a flipped copy of the first triangle is a duplicate
+        mesh.Faces.AddFace(2, 1, 0)
+
+        self.assertTrue(mesh.Weld(0.001))
+        self.assertTrue(len(mesh.Vertices) == 6)
+        self.assertTrue(len(mesh.Faces) == 4)
+        self.assertFalse(mesh.Weld(0.001))
+
+    def test_meshGetAdjacency(self):
+
+        #objective: two triangles sharing an edge
+        mesh = rhino3dm.Mesh()
+        mesh.Vertices.Add(0, 0, 0)
+        mesh.Vertices.Add(1, 0, 0)
+        mesh.Vertices.Add(1, 1, 0)
+        mesh.Vertices.Add(0, 1, 0)
+        mesh.Faces.AddFace(0, 1, 2)
+        mesh.Faces.AddFace(0, 2, 3)
+
+        adjacency = mesh.GetAdjacency()
+
+        self.assertTrue(adjacency.TopologyVertexCount == 4)
+        self.assertTrue(adjacency.EdgeCount == 5)
+        self.assertTrue(adjacency.FaceCount == 2)
+        self.assertTrue(len(adjacency.VertexFacesOffsets) == 5)
+        self.assertTrue(len(adjacency.VertexFaces) == 6)
+        self.assertTrue(len(adjacency.VertexVertices) == 10)
+        self.assertTrue(len(adjacency.FaceEdges) == 6)
+        #the diagonal is the only edge with two faces
+        edgeFaces = list(adjacency.EdgeFaces)
+        offsets = list(adjacency.EdgeFacesOffsets)
+        shared = [e for e in range(adjacency.EdgeCount) if offsets[e + 1] - offsets[e] == 2]
+        self.assertTrue(len(shared) == 1)
+        self.assertTrue(sorted(edgeFaces[offsets[shared[0]]:offsets[shared[0] + 1]]) == [0, 1])
+
+    def test_meshOptimizeForGpu(self):
+
+        #objective: reordering never makes the cache miss ratio worse on a grid drawn column by column
+        mesh = rhino3dm.Mesh()
+        n = 20
+        for i in range(n + 1):
+            for j in range(n + 1):
+                mesh.Vertices.Add(i, j, 0)
+        for j in range(n):
+            for i in range(n):
+                a = i * (n + 1) + j
+                mesh.Faces.AddFace(a, a + n + 1, a + n + 2, a + 1)
+        faceCount = len(mesh.Faces)
+
+        before, after = mesh.OptimizeForGpu()
+
+        self.assertTrue(abs(before - 1.0) < 0.2)
+        self.assertTrue(after < before)
+        self.assertTrue(abs(mesh.ComputeAcmr() - after) < 1e-9)
+        self.assertTrue(len(mesh.Faces) == faceCount)
+
+    def test_meshToQuantizedBuffers(self):
+
+        #objective: dequantized positions land within half a grid step of the vertices
+        buffers = self.mesh.ToQuantizedBuffers()
+        xform = buffers.DequantizationTransform
+        positions = buffers.Positions
+        step = xform.M00
+
+        self.assertTrue(buffers.VertexCount == len(self.mesh.Vertices))
+        self.assertTrue(len(positions) == 3 * buffers.VertexCount)
+        self.assertTrue(positions.format == 'h')
+        self.assertTrue(buffers.Normals.format == 'b')
+        self.assertTrue(buffers.TextureCoordinates.format == 'H')
+        for i in range(0, buffers.VertexCount, max(1, buffers.VertexCount // 50)):
+            p = rhino3dm.Point3d(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2])
+            p.Transform(xform)
+            v = self.mesh.Vertices[i]
+            self.assertTrue(abs(p.X - v.X) <= step and abs(p.Y - v.Y) <= step and abs(p.Z - v.Z) <= step)
+
+        options = rhino3dm.MeshQuantizationOptions()
+        options.UnsignedPositions = True
+        options.NormalBits = 12
+        buffers = self.mesh.ToQuantizedBuffers(options)
+        self.assertTrue(buffers.Positions.format == 'H')
+        self.assertTrue(buffers.NormalBits == 12)
+        self.assertTrue(buffers.Normals.format == 'h')
+
+    def test_meshSplitIntoTiles(self):
+
+        #objective: every face lands in exactly one leaf tile and leaves respect the triangle limit
+        mesh = rhino3dm.Mesh()
+        n = 20
+        for i in range(n + 1):
+            for j in range(n + 1):
+                mesh.Vertices.Add(i, j, 0)
+        for i in range(n):
+            for j in range(n):
+                a = i * (n + 1) + j
+                mesh.Faces.AddFace(a, a + n + 1, a + n + 2, a + 1)
+
+        tiles = mesh.SplitIntoTiles(100)
+        faces = []
+        for t in range(tiles.TileCount):
+            content = tiles.GetContent(t)
+            if len(tiles.GetChildren(t)) > 0:
+                self.assertTrue(content is None)
+                continue
+            self.assertTrue(2 * len(content.Faces) <= 100)
+            faces.extend(tiles.GetItemIndices(t))
+
+        self.assertTrue(sorted(faces) == list(range(len(mesh.Faces))))
+        self.assertTrue('"version":"1.1"' in tiles.ToTilesetJson())
+
+    def test_meshSplitIntoTilesLevelOfDetail(self):
+
+        #objective: inner tiles hold a coarser mesh than their children and a geometric error at least theirs
+        mesh = rhino3dm.Mesh()
+        n = 20
+        for i in range(n + 1):
+            for j in range(n + 1):
+                mesh.Vertices.Add(i, j, 0.1 * ((i * 7 + j * 3) % 5))
+        for i in range(n):
+            for j in range(n):
+                a = i * (n + 1) + j
+                mesh.Faces.AddFace(a, a + n + 1, a + n + 2, a + 1)
+
+        tiles = mesh.SplitIntoTiles(100, 0.0, 2, True)
+        self.assertTrue(len(tiles.GetChildren(0)) > 0)
+        for t in range(tiles.TileCount):
+            children = tiles.GetChildren(t)
+            if len(children) == 0:
+                self.assertTrue(tiles.GetGeometricError(t) == 0.0)
+                continue
+            content = tiles.GetContent(t)
+            self.assertTrue(content is not None)
+            triangles = lambda m: m.Faces.TriangleCount + 2 * m.Faces.QuadCount
+            childTriangles = sum(triangles(tiles.GetContent(c)) for c in children)
+            self.assertTrue(0 < triangles(content) < childTriangles)
+            for c in children:
+                self.assertTrue(tiles.GetGeometricError(t) >= tiles.GetGeometricError(c))
+        self.assertTrue(tiles.GetGeometricError(0) > 0.0)
+        self.assertTrue('"refine":"REPLACE"' in tiles.ToTilesetJson())
+
     @unittest.skip("Not implemented")
     def test_meshCachedTextureCoordinates_TryGetAt(self):
 
@@ -37,6 +37,23 @@ class TestObject(unittest.TestCase):
         self.assertTrue(type(userStrings[0][0]) == str)
         self.assertTrue(type(userStrings[0][1]) == str)
 
+    #objective: binary encode round trips one object and many objects with random access
+    def test_objectEncodeBinary(self):
+
+        line = rhino3dm.LineCurve(rhino3dm.Point3d(0,0,0), rhino3dm.Point3d(1,2,3))
+        data = line.EncodeBinary()
+        self.assertTrue(type(data) == bytes)
+        decoded = rhino3dm.CommonObject.DecodeBinary(data)
+        self.assertTrue(type(decoded) == rhino3dm.LineCurve)
+        self.assertEqual(decoded.PointAtEnd.Z, 3)
+
+        lines = [rhino3dm.LineCurve(rhino3dm.Point3d(0,0,0), rhino3dm.Point3d(i,0,0)) for i in range(1, 11)]
+        packed = rhino3dm.CommonObject.EncodeMany(lines)
+        self.assertEqual(rhino3dm.CommonObject.EncodedCount(packed), 10)
+        self.assertEqual(len(rhino3dm.CommonObject.DecodeMany(packed)), 10)
+        self.assertEqual(rhino3dm.CommonObject.DecodeAt(packed, 6).PointAtEnd.X, 7)
+        self.assertTrue(rhino3dm.CommonObject.DecodeBinary(b'not an archive') is None)
+
 
 if __name__ == '__main__':
     print("running tests")
@@ -62,6 +62,91 @@ class TestPointCloud(unittest.TestCase):
             self.assertTrue(type(vals) == list)
             self.assertTrue(type(vals[0]) == float)
 
+    def test_buildTiles(self):
+
+        # objective: leaf tiles split the points without losing any and stay inside their parents
+        points = [rhino3dm.Point3d(i % 10, (i // 10) % 10, i // 100) for i in range(1000)]
+        pc = rhino3dm.PointCloud(points)
+        tiles = pc.BuildTiles(64)
+
+        count = 0
+        for t in range(tiles.TileCount):
+            box = tiles.GetBoundingBox(t)
+            parent = tiles.GetParent(t)
+            if parent >= 0:
+                outer = tiles.GetBoundingBox(parent)
+                self.assertTrue(outer.Min.X <= box.Min.X and box.Max.X <= outer.Max.X)
+            if len(tiles.GetChildren(t)) == 0:
+                self.assertTrue(len(tiles.GetContent(t)) <= 64)
+                count += len(tiles.GetContent(t))
+
+        self.assertEqual(count, len(points))
+
+    def test_voxelDownsample(self):
+
+        # objective: one averaged point per occupied cell
+        pc = rhino3dm.PointCloud()
+        for i in range(10):
+            for j in range(10):
+                pc.Add(rhino3dm.Point3d(i + 0.25, j + 0.25, 0), 2.0 * i)
+                pc.Add(rhino3dm.Point3d(i + 0.75, j + 0.75, 0), 2.0 * i + 1.0)
+
+        reduced = pc.VoxelDownsample(1.0)
+
+        self.assertEqual(len(reduced), 100)
+        for k in range(len(reduced)):
+            p = reduced.PointAt(k)
+            self.assertAlmostEqual(p.X - int(p.X), 0.5)
+            self.assertAlmostEqual(reduced[k].Value, 2.0 * int(p.X) + 0.5)
+
+    def test_buildLodOctree(self):
+
+        # objective: every point is in exactly one tile and no tile holds more than the limit
+        points = [rhino3dm.Point3d(i % 40, (i // 40) % 40, 0.1 * (i // 1600)) for i in range(8000)]
+        pc = rhino3dm.PointCloud(points)
+        tiles = pc.BuildLodOctree(500)
+
+        indices = []
+        for t in range(tiles.TileCount):
+            content = tiles.GetContent(t)
+            self.assertTrue(content is not None and len(content) <= 500)
+            indices.extend(tiles.GetItemIndices(t))
+
+        self.assertTrue(len(tiles.GetChildren(0)) > 0)
+        self.assertTrue(sorted(indices) == list(range(len(points))))
+
+    def test_estimateNormals(self):
+
+        # objective: normals of a noisy plane point up when oriented towards a point above it
+        pc = rhino3dm.PointCloud()
+        for i in range(30):
+            for j in range(30):
+                pc.Add(rhino3dm.Point3d(i, j, 0.01 * ((i * 7 + j * 13) % 5)))
+        self.assertFalse(pc.ContainsNormals)
+
+        self.assertTrue(pc.EstimateNormals(12, 0.0, rhino3dm.Point3d(15, 15, 100)))
+
+        self.assertTrue(pc.ContainsNormals)
+        for n in pc.GetNormals2():
+            self.assertTrue(n.Z > 0.99)
+
+    def test_removeStatisticalOutliers(self):
+
+        # objective: isolated points are hidden, the grid stays visible
+        pc = rhino3dm.PointCloud()
+        for i in range(20):
+            for j in range(20):
+                pc.Add(rhino3dm.Point3d(i, j, 0))
+        pc.Add(rhino3dm.Point3d(100, 100, 50))
+        pc.Add(rhino3dm.Point3d(-80, 40, -60))
+
+        count = pc.RemoveStatisticalOutliers(8, 2.0)
+
+        self.assertEqual(count, 2)
+        self.assertEqual(pc.HiddenPointCount, 2)
+        self.assertTrue(pc[400].Hidden and pc[401].Hidden)
+        self.assertFalse(pc[0].Hidden)
+
 
 
 if __name__ == "__main__":
@@ -0,0 +1,97 @@
+import math
+import rhino3dm
+import unittest
+
+# Unit cube control net with outward facing quads
+def cubeSubD():
+    mesh = rhino3dm.Mesh()
+    for z in (0, 1):
+        mesh.Vertices.Add(0, 0, z)
+        mesh.Vertices.Add(1, 0, z)
+        mesh.Vertices.Add(1, 1, z)
+        mesh.Vertices.Add(0, 1, z)
+    for face in ((0, 3, 2, 1), (4, 5, 6, 7), (0, 1, 5, 4), (1, 2, 6, 5), (2, 3, 7, 6), (3, 0, 4, 7)):
+        mesh.Faces.AddFace(*face)
+    return rhino3dm.SubD.CreateFromMesh(mesh)
+
+#objective: limit surface mesh buffers of a SubD
+class TestSubD(unittest.TestCase):
+
+    def test_getSurfaceMeshBuffersEmpty(self):
+        subd = rhino3dm.SubD()
+        buffers = subd.GetSurfaceMeshBuffers(2)
+        self.assertEqual(buffers.VertexCount, 0)
+        self.assertEqual(buffers.TriangleCount, 0)
+        self.assertEqual(len(buffers.Positions), 0)
+        self.assertEqual(len(buffers.Indices), 0)
+
+    def test_getSurfaceMeshBuffersLayout(self):
+        subd = rhino3dm.SubD()
+        buffers = subd.GetSurfaceMeshBuffers(density=3, multipleThreads=False)
+        self.assertEqual(len(buffers.Positions), 3 * buffers.VertexCount)
+        self.assertEqual(len(buffers.Normals), 3 * buffers.VertexCount)
+        self.assertEqual(len(buffers.Indices), 3 * buffers.TriangleCount)
+        self.assertEqual(len(buffers.FaceIds), buffers.TriangleCount)
+        self.assertEqual(buffers.Positions.format, 'f')
+        self.assertEqual(buffers.Indices.format, 'I')
+
+    #objective: the limit surface of a cube SubD meshes every face with valid indices and unit normals
+    def test_getSurfaceMeshBuffersCube(self):
+        subd = cubeSubD()
+        self.assertIsNotNone(subd)
+        self.assertTrue(subd.IsSolid)
+        for multipleThreads in (False, True):
+            buffers = subd.GetSurfaceMeshBuffers(density=2, multipleThreads=multipleThreads)
+            self.assertGreater(buffers.VertexCount, 0)
+            self.assertGreater(buffers.TriangleCount, 0)
+            indices = buffers.Indices.tolist()
+            self.assertEqual(len(indices), 3 * buffers.TriangleCount)
+            self.assertTrue(all(0 <= i < buffers.VertexCount for i in indices))
+            normals = buffers.Normals.tolist()
+            for i in range(buffers.VertexCount):
+                length = math.sqrt(sum(n * n for n in normals[3 * i:3 * i + 3]))
+                self.assertAlmostEqual(length, 1.0, places=4)
+            # the limit surface stays inside the control net
+            self.assertTrue(all(-1e-5 <= p <= 1 + 1e-5 for p in buffers.Positions.tolist()))
+            self.assertEqual(len(set(buffers.FaceIds.tolist())), 6)
+    def test_toBrepParameters(self):
+        parameters = rhino3dm.SubDToBrepParameters()
+        parameters.PackFaces = False
+        self.assertFalse(parameters.PackFaces)
+        parameters.ExtraordinaryVertexProcess = rhino3dm.SubDToBrepVertexProcess.LocalG1
+        self.assertEqual(parameters.ExtraordinaryVertexProcess, rhino3dm.SubDToBrepVertexProcess.LocalG1)
+
+    def test_toBrepManyEmpty(self):
+        subd = rhino3dm.SubD()
+        self.assertIsNone(subd.ToBrep())
+        results = rhino3dm.SubD.ToBrepMany([subd, rhino3dm.SubD(), subd], threadCount=2)
+        self.assertEqual(results.Count, 3)
+        self.assertEqual(len(results.Breps), 3)
+        self.assertEqual(len(results.Seconds), 3)
+        self.assertTrue(all(brep is None for brep in results.Breps))
+        self.assertGreaterEqual(results.TotalSeconds, 0.0)
+
+    #objective: a cube SubD converts to a valid closed brep with one face per SubD face, serially and on threads
+    def test_toBrepCube(self):
+        subd = cubeSubD()
+        parameters = rhino3dm.SubDToBrepParameters()
+        parameters.PackFaces = False
+
+        brep = subd.ToBrep(parameters)
+        self.assertIsNotNone(brep)
+        self.assertTrue(brep.IsValid)
+        self.assertTrue(brep.IsSolid)
+        self.assertEqual(len(brep.Faces), 6)
+
+        for threadCount in (1, 3):
+            results = rhino3dm.SubD.ToBrepMany([subd, cubeSubD(), subd], parameters, threadCount)
+            self.assertEqual(results.Count, 3)
+            for brep in results.Breps:
+                self.assertIsNotNone(brep)
+                self.assertTrue(brep.IsValid)
+                self.assertEqual(len(brep.Faces), 6)
+
+if __name__ == '__main__':
+    print("running tests")
+    unittest.main()
+    print("tests complete")
@@ -1,4 +1,5 @@
 import unittest
+import array
 import rhino3dm
 
 class TestXform(unittest.TestCase):
@@ -12,7 +13,56 @@ class TestXform(unittest.TestCase):
         self.assertTrue( type(fa) == list )
         self.assertTrue( type(fa[0]) == float )
 
+    #objective: packed points are transformed in place or into a new buffer of the same type
+    def test_applyToPoints(self):
+
+        xform = rhino3dm.Transform.Translation(1, 2, 3)
+        values = [0, 0, 0, 1, 1, 1, -2, 5, 10]
+        expected = [v + i % 3 + 1 for i, v in enumerate(values)]
+
+        points = array.array('d', values)
+        transformed = xform.ApplyToPoints(points, False)
+        self.assertEqual(list(points), values)
+        self.assertEqual(transformed.format, 'd')
+        self.assertEqual(list(transformed), expected)
+
+        xform.ApplyToPoints(points)
+        self.assertEqual(list(points), expected)
+
+        floats = array.array('f', values)
+        xform.ApplyToPoints(floats)
+        self.assertEqual(list(floats), expected)
+
+        # projective transforms divide by w
+        projective = rhino3dm.Transform(1.0)
+        projective.M33 = 2.0
+        halves = projective.ApplyToPoints(array.array('d', [2, 4, 6]), False)
+        self.assertEqual(list(halves), [1, 2, 3])
+
+        with self.assertRaises(ValueError):
+            xform.ApplyToPoints(array.array('i', [1, 2, 3]))
+
+    #objective: many geometries are transformed by one or matching transforms
+    def test_transformMany(self):
+
+        points = [rhino3dm.Point(rhino3dm.Point3d(i, 0, 0)) for i in range(10)]
+        count = rhino3dm.GeometryBase.TransformMany(points, [rhino3dm.Transform.Translation(0, 1, 0)])
+        self.assertEqual(count, 10)
+        for i, point in enumerate(points):
+            self.assertEqual(point.Location.X, i)
+            self.assertEqual(point.Location.Y, 1)
+
+        xforms = [rhino3dm.Transform.Translation(0, 0, i) for i in range(10)]
+        count = rhino3dm.GeometryBase.TransformMany(points, xforms, 2)
+        self.assertEqual(count, 10)
+        for i, point in enumerate(points):
+            self.assertEqual(point.Location.Z, i)
+
+        with self.assertRaises(ValueError):
+            rhino3dm.GeometryBase.TransformMany(points, xforms[:2])
+
+
 if __name__ == '__main__':
     print("running tests")
     unittest.main()
-    print("tests complete")
\ No newline at end of file
+    print("tests complete")